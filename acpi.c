@@ -0,0 +1,202 @@
+#include "acpi.h"
+#include "multiboot.h"
+#include "vmm.h"
+#include "pmm.h"
+
+// Типи записів MADT
+#define MADT_LOCAL_APIC         0
+#define MADT_IO_APIC            1
+#define MADT_IRQ_OVERRIDE       2
+#define MADT_LAPIC_OVERRIDE     5
+
+#define MADT_CPU_ENABLED        0x1
+#define MADT_PCAT_COMPAT        0x1
+
+// Сегмент EBDA у BIOS Data Area
+#define BDA_EBDA_SEGMENT        0x40E
+
+struct acpi_madt {
+    struct acpi_sdt_header header;
+    uint32_t lapic_address;
+    uint32_t flags;
+    uint8_t entries[];
+} __attribute__((packed));
+
+static struct acpi_sdt_header* root_table = NULL;
+static int root_is_xsdt = false;
+static acpi_madt_info_t madt_info;
+
+// === ДОПОМІЖНІ ФУНКЦІЇ ===
+
+static int checksum_ok(const void* data, size_t length) {
+    const uint8_t* bytes = data;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += bytes[i];
+    }
+    return sum == 0;
+}
+
+static int signature_eq(const char* a, const char* b, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Таблиці можуть лежати поза identity-відображенням RAM
+static void* acpi_map(uintptr_t phys, size_t length) {
+    for (uintptr_t page = phys & ~(uintptr_t)(PAGE_SIZE - 1); page < phys + length; page += PAGE_SIZE) {
+        if (vmm_translate(page) == 0) {
+            vmm_map_mmio(page, PAGE_SIZE, 0);
+        }
+    }
+    return (void*)phys;
+}
+
+static struct acpi_sdt_header* map_table(uintptr_t phys) {
+    struct acpi_sdt_header* header = acpi_map(phys, sizeof(struct acpi_sdt_header));
+    acpi_map(phys, header->length);
+    if (!checksum_ok(header, header->length)) {
+        return NULL;
+    }
+    return header;
+}
+
+static struct acpi_rsdp* scan_rsdp(uintptr_t start, uintptr_t end) {
+    for (uintptr_t p = start; p + 20 <= end; p += 16) {
+        struct acpi_rsdp* rsdp = (struct acpi_rsdp*)p;
+        if (signature_eq(rsdp->signature, "RSD PTR ", 8) && checksum_ok(rsdp, 20)) {
+            return rsdp;
+        }
+    }
+    return NULL;
+}
+
+static struct acpi_rsdp* find_rsdp(void) {
+    // GRUB кладе копію RSDP у теги Multiboot2
+    struct multiboot_tag* tag = multiboot_find_tag(MULTIBOOT_TAG_TYPE_ACPI_NEW);
+    if (!tag) {
+        tag = multiboot_find_tag(MULTIBOOT_TAG_TYPE_ACPI_OLD);
+    }
+    if (tag) {
+        return (struct acpi_rsdp*)((uintptr_t)tag + sizeof(struct multiboot_tag));
+    }
+
+    // Інакше - перший КБ EBDA та область BIOS 0xE0000-0xFFFFF;
+    // сегмент EBDA лежить у BDA на сторінці 0, яку тимчасово відображаємо
+    vmm_map(0, 0, PAGE_SIZE, 0);
+    volatile uint16_t* bda_ebda = (volatile uint16_t*)BDA_EBDA_SEGMENT;
+    asm("" : "+r"(bda_ebda));       // GCC вважає адреси сторінки 0 недійсними
+    uintptr_t ebda = (uintptr_t)*bda_ebda << 4;
+    vmm_unmap(0, PAGE_SIZE);
+    struct acpi_rsdp* rsdp = NULL;
+    if (ebda >= 0x80000 && ebda < 0xA0000) {
+        rsdp = scan_rsdp(ebda, ebda + 1024);
+    }
+    if (!rsdp) {
+        rsdp = scan_rsdp(0xE0000, 0x100000);
+    }
+    return rsdp;
+}
+
+static void parse_madt(struct acpi_madt* madt) {
+    madt_info.lapic_address = madt->lapic_address;
+    madt_info.has_8259 = (madt->flags & MADT_PCAT_COMPAT) != 0;
+
+    uint8_t* p = madt->entries;
+    uint8_t* end = (uint8_t*)madt + madt->header.length;
+    while (p + 2 <= end && p[1] >= 2) {
+        switch (p[0]) {
+            case MADT_LOCAL_APIC:
+                // p[2] - ACPI id процесора, p[3] - APIC id, далі прапори
+                if ((*(uint32_t*)(p + 4) & MADT_CPU_ENABLED) && madt_info.cpu_count < ACPI_MAX_CPUS) {
+                    madt_info.cpu_apic_ids[madt_info.cpu_count++] = p[3];
+                }
+                break;
+            case MADT_IO_APIC:
+                if (madt_info.ioapic_count < ACPI_MAX_IOAPICS) {
+                    acpi_ioapic_t* ioapic = &madt_info.ioapics[madt_info.ioapic_count++];
+                    ioapic->id = p[2];
+                    ioapic->address = *(uint32_t*)(p + 4);
+                    ioapic->gsi_base = *(uint32_t*)(p + 8);
+                }
+                break;
+            case MADT_IRQ_OVERRIDE:
+                if (madt_info.override_count < ACPI_MAX_OVERRIDES) {
+                    acpi_irq_override_t* override = &madt_info.overrides[madt_info.override_count++];
+                    override->source = p[3];
+                    override->gsi = *(uint32_t*)(p + 4);
+                    override->flags = *(uint16_t*)(p + 8);
+                }
+                break;
+            case MADT_LAPIC_OVERRIDE: {
+                uint64_t address = *(uint64_t*)(p + 4);
+                if ((address >> 32) == 0) {
+                    madt_info.lapic_address = (uintptr_t)address;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        p += p[1];
+    }
+}
+
+// === ПУБЛІЧНИЙ API ===
+
+int acpi_init(void) {
+    struct acpi_rsdp* rsdp = find_rsdp();
+    if (!rsdp) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    root_table = NULL;
+    if (rsdp->revision >= 2 && rsdp->xsdt_address && (rsdp->xsdt_address >> 32) == 0) {
+        root_table = map_table((uintptr_t)rsdp->xsdt_address);
+        root_is_xsdt = root_table != NULL;
+    }
+    if (!root_table) {
+        root_table = map_table(rsdp->rsdt_address);
+        root_is_xsdt = false;
+    }
+    if (!root_table) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    struct acpi_madt* madt = (struct acpi_madt*)acpi_find_table("APIC");
+    if (!madt) {
+        return ERROR_INVALID_INPUT;
+    }
+    parse_madt(madt);
+    return SUCCESS;
+}
+
+struct acpi_sdt_header* acpi_find_table(const char* signature) {
+    if (!root_table) {
+        return NULL;
+    }
+
+    uint32_t entry_size = root_is_xsdt ? 8 : 4;
+    uint32_t count = (root_table->length - sizeof(struct acpi_sdt_header)) / entry_size;
+    uint8_t* entries = (uint8_t*)root_table + sizeof(struct acpi_sdt_header);
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t address = root_is_xsdt ? *(uint64_t*)(entries + i * 8) : *(uint32_t*)(entries + i * 4);
+        if (address == 0 || (address >> 32) != 0) {
+            continue;
+        }
+        struct acpi_sdt_header* header = acpi_map((uintptr_t)address, sizeof(struct acpi_sdt_header));
+        if (signature_eq(header->signature, signature, 4)) {
+            return map_table((uintptr_t)address);
+        }
+    }
+    return NULL;
+}
+
+const acpi_madt_info_t* acpi_madt(void) {
+    return madt_info.cpu_count ? &madt_info : NULL;
+}
@@ -0,0 +1,66 @@
+#ifndef ACPI_H
+#define ACPI_H
+
+#include "kernel.h"
+
+#define ACPI_MAX_CPUS       16
+#define ACPI_MAX_IOAPICS    4
+#define ACPI_MAX_OVERRIDES  16
+
+// Заголовок кожної системної таблиці ACPI
+struct acpi_sdt_header {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed));
+
+struct acpi_rsdp {
+    char signature[8];
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt_address;
+    // ACPI 2.0+
+    uint32_t length;
+    uint64_t xsdt_address;
+    uint8_t extended_checksum;
+    uint8_t reserved[3];
+} __attribute__((packed));
+
+// Перевизначення ISA IRQ на глобальне переривання (MADT тип 2)
+typedef struct {
+    uint8_t source;
+    uint32_t gsi;
+    uint16_t flags;
+} acpi_irq_override_t;
+
+typedef struct {
+    uint8_t id;
+    uint32_t address;
+    uint32_t gsi_base;
+} acpi_ioapic_t;
+
+// Вміст MADT, потрібний для SMP та маршрутизації переривань
+typedef struct {
+    uintptr_t lapic_address;
+    uint32_t cpu_count;
+    uint8_t cpu_apic_ids[ACPI_MAX_CPUS];
+    uint32_t ioapic_count;
+    acpi_ioapic_t ioapics[ACPI_MAX_IOAPICS];
+    uint32_t override_count;
+    acpi_irq_override_t overrides[ACPI_MAX_OVERRIDES];
+    int has_8259;
+} acpi_madt_info_t;
+
+// Пошук RSDP та розбір MADT
+int acpi_init(void);
+struct acpi_sdt_header* acpi_find_table(const char* signature);
+const acpi_madt_info_t* acpi_madt(void);
+
+#endif
@@ -0,0 +1,177 @@
+#include "apic.h"
+#include "acpi.h"
+#include "cpu.h"
+#include "multiboot.h"
+#include "pmm.h"
+#include "vmm.h"
+
+static volatile uint32_t* lapic = NULL;
+static int x2apic = false;
+
+// Регістри локального APIC: у x2APIC - MSR, без звернень до MMIO
+static inline uint32_t lapic_read(uint32_t reg) {
+    if (x2apic) {
+        return (uint32_t)rdmsr(X2APIC_MSR_BASE + (reg >> 4));
+    }
+    return lapic[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    if (x2apic) {
+        wrmsr(X2APIC_MSR_BASE + (reg >> 4), value);
+        return;
+    }
+    lapic[reg / 4] = value;
+}
+
+int lapic_init(uintptr_t base) {
+    // Регістри APIC - лише некешоване відображення
+    lapic = vmm_map_mmio(base, PAGE_SIZE, VMM_UC);
+    if (!lapic) {
+        return ERROR_INVALID_INPUT;
+    }
+    x2apic = (cpu_features & CPU_FEATURE_X2APIC) && !multiboot_cmdline_has("nox2apic");
+    lapic_enable();
+    return SUCCESS;
+}
+
+void lapic_enable(void) {
+    // Режим x2APIC перемикається на кожному процесорі окремо; AP після INIT - у xAPIC
+    if (x2apic) {
+        wrmsr(MSR_APIC_BASE, rdmsr(MSR_APIC_BASE) | APIC_BASE_ENABLE | APIC_BASE_X2APIC);
+    }
+    // Програмне увімкнення та вектор фальшивих переривань; LVT від BIOS лишаються
+    lapic_write(LAPIC_REG_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_REG_TPR, 0);
+}
+
+int lapic_present(void) {
+    return lapic != NULL;
+}
+
+int lapic_x2apic(void) {
+    return x2apic;
+}
+
+uint32_t lapic_id(void) {
+    if (!lapic) {
+        return 0;
+    }
+    // x2APIC повертає повний 32-бітний id, xAPIC - у старшому байті
+    return x2apic ? lapic_read(LAPIC_REG_ID) : lapic_read(LAPIC_REG_ID) >> 24;
+}
+
+void lapic_eoi(void) {
+    lapic_write(LAPIC_REG_EOI, 0);
+}
+
+void lapic_send_ipi(uint32_t apic_id, uint32_t icr) {
+    // Пара записів ICR не повинна перериватися іншим IPI з цього ж процесора
+    unsigned long flags = interrupts_save();
+    if (x2apic) {
+        // Один запис MSR, біта очікування доставки немає
+        wrmsr(X2APIC_MSR_ICR, ((uint64_t)apic_id << 32) | icr);
+    } else {
+        lapic_write(LAPIC_REG_ICR_HIGH, apic_id << 24);
+        lapic_write(LAPIC_REG_ICR_LOW, icr);
+        while (lapic_read(LAPIC_REG_ICR_LOW) & ICR_DELIVERY_PENDING) {
+            asm volatile("pause");
+        }
+    }
+    interrupts_restore(flags);
+}
+
+// === IOAPIC ===
+
+typedef struct {
+    volatile uint32_t* regs;
+    uint32_t gsi_base;
+    uint32_t inputs;
+} ioapic_t;
+
+static ioapic_t ioapics[ACPI_MAX_IOAPICS];
+static uint32_t ioapic_count = 0;
+static spinlock_t ioapic_lock = SPINLOCK_INIT;
+
+static uint32_t ioapic_read(ioapic_t* ioapic, uint32_t reg) {
+    ioapic->regs[IOAPIC_REG_SELECT / 4] = reg;
+    return ioapic->regs[IOAPIC_REG_WINDOW / 4];
+}
+
+static void ioapic_write(ioapic_t* ioapic, uint32_t reg, uint32_t value) {
+    ioapic->regs[IOAPIC_REG_SELECT / 4] = reg;
+    ioapic->regs[IOAPIC_REG_WINDOW / 4] = value;
+}
+
+static ioapic_t* ioapic_for_gsi(uint32_t gsi) {
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        if (gsi >= ioapics[i].gsi_base && gsi < ioapics[i].gsi_base + ioapics[i].inputs) {
+            return &ioapics[i];
+        }
+    }
+    return NULL;
+}
+
+int ioapic_init(void) {
+    const acpi_madt_info_t* madt = acpi_madt();
+    ioapic_count = 0;
+    if (!madt) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    for (uint32_t i = 0; i < madt->ioapic_count; i++) {
+        ioapic_t* ioapic = &ioapics[ioapic_count];
+        ioapic->regs = vmm_map_mmio(madt->ioapics[i].address, PAGE_SIZE, VMM_UC);
+        if (!ioapic->regs) {
+            continue;
+        }
+        ioapic->gsi_base = madt->ioapics[i].gsi_base;
+        ioapic->inputs = ((ioapic_read(ioapic, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+
+        // Усе замасковане, доки драйвер не встановить обробник
+        for (uint32_t input = 0; input < ioapic->inputs; input++) {
+            ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + input * 2, IOAPIC_MASKED);
+            ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + input * 2 + 1, 0);
+        }
+        ioapic_count++;
+    }
+    return ioapic_count ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+uint32_t ioapic_gsi_count(void) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        total += ioapics[i].inputs;
+    }
+    return total;
+}
+
+int ioapic_route(uint32_t gsi, uint8_t vector, uint32_t apic_id, uint32_t flags) {
+    ioapic_t* ioapic = ioapic_for_gsi(gsi);
+    // Без перенаправлення переривань IOAPIC адресує лише 8-бітні APIC id
+    if (!ioapic || apic_id > 0xFF) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint32_t input = gsi - ioapic->gsi_base;
+
+    // Фізичний режим адресації, фіксована доставка; старше слово - до зняття маски
+    unsigned long irq_flags = spin_lock_irqsave(&ioapic_lock);
+    ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + input * 2, IOAPIC_MASKED);
+    ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + input * 2 + 1, apic_id << 24);
+    ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + input * 2, vector | flags);
+    spin_unlock_irqrestore(&ioapic_lock, irq_flags);
+    return SUCCESS;
+}
+
+void ioapic_set_masked(uint32_t gsi, int masked) {
+    ioapic_t* ioapic = ioapic_for_gsi(gsi);
+    if (!ioapic) {
+        return;
+    }
+    uint32_t reg = IOAPIC_REG_REDIRECTION + (gsi - ioapic->gsi_base) * 2;
+
+    unsigned long flags = spin_lock_irqsave(&ioapic_lock);
+    uint32_t low = ioapic_read(ioapic, reg);
+    ioapic_write(ioapic, reg, masked ? (low | IOAPIC_MASKED) : (low & ~IOAPIC_MASKED));
+    spin_unlock_irqrestore(&ioapic_lock, flags);
+}
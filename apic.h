@@ -0,0 +1,63 @@
+#ifndef APIC_H
+#define APIC_H
+
+#include "kernel.h"
+
+#define LAPIC_DEFAULT_BASE      0xFEE00000
+
+// Регістри локального APIC (зміщення в MMIO)
+#define LAPIC_REG_ID            0x020
+#define LAPIC_REG_VERSION       0x030
+#define LAPIC_REG_TPR           0x080
+#define LAPIC_REG_EOI           0x0B0
+#define LAPIC_REG_SVR           0x0F0
+#define LAPIC_REG_ICR_LOW       0x300
+#define LAPIC_REG_ICR_HIGH      0x310
+
+#define LAPIC_SVR_ENABLE        0x100
+
+// x2APIC: ті самі регістри через MSR 0x800 + зміщення/16, ICR - один 64-бітний MSR
+#define MSR_APIC_BASE           0x1B
+#define APIC_BASE_ENABLE        (1u << 11)
+#define APIC_BASE_X2APIC        (1u << 10)
+#define X2APIC_MSR_BASE         0x800
+#define X2APIC_MSR_ICR          0x830
+
+// Регістри IOAPIC: непрямий доступ через вікно
+#define IOAPIC_REG_SELECT       0x00
+#define IOAPIC_REG_WINDOW       0x10
+#define IOAPIC_REG_VERSION      0x01
+#define IOAPIC_REG_REDIRECTION  0x10
+
+// Поля запису перенаправлення (молодше слово)
+#define IOAPIC_ACTIVE_LOW       0x02000
+#define IOAPIC_LEVEL            0x08000
+#define IOAPIC_MASKED           0x10000
+
+// Поля ICR
+#define ICR_FIXED               0x00000
+#define ICR_INIT                0x00500
+#define ICR_STARTUP             0x00600
+#define ICR_DELIVERY_PENDING    0x01000
+#define ICR_LEVEL_ASSERT        0x04000
+
+// Вектори, зарезервовані за APIC
+#define IPI_WORK_VECTOR         0xF0
+#define APIC_SPURIOUS_VECTOR    0xFF
+
+// Локальний APIC; x2APIC вмикається, якщо його має процесор (параметр ядра "nox2apic" - ні)
+int lapic_init(uintptr_t base);
+void lapic_enable(void);
+int lapic_present(void);
+int lapic_x2apic(void);
+uint32_t lapic_id(void);
+void lapic_eoi(void);
+void lapic_send_ipi(uint32_t apic_id, uint32_t icr);
+
+// IOAPIC з MADT: усі входи замасковані до ioapic_route
+int ioapic_init(void);
+uint32_t ioapic_gsi_count(void);
+int ioapic_route(uint32_t gsi, uint8_t vector, uint32_t apic_id, uint32_t flags);
+void ioapic_set_masked(uint32_t gsi, int masked);
+
+#endif
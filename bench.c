@@ -0,0 +1,309 @@
+#include "bench.h"
+#include "timer.h"
+#include "expr.h"
+#include "bignum.h"
+#include "irq.h"
+#include "ramfs.h"
+#include "command.h"
+#include "fpu.h"
+
+
+static bench_t benches[BENCH_MAX];
+static uint32_t bench_count = 0;
+static uint32_t samples[BENCH_SAMPLES];
+static uint32_t rdtsc_overhead = 0;
+static volatile uint32_t bench_irqs = 0;
+
+int bench_register(const char* name, bench_fn_t fn, void* arg, uint32_t batch) {
+    if (bench_count >= BENCH_MAX || batch == 0) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    bench_t* bench = &benches[bench_count++];
+    bench->name = name;
+    bench->fn = fn;
+    bench->arg = arg;
+    bench->batch = batch;
+    return SUCCESS;
+}
+
+// === ВИМІРЮВАННЯ ===
+
+static void sort_samples(uint32_t* values, uint32_t count) {
+    // Shell sort: без рекурсії та додаткової пам'яті
+    for (uint32_t gap = count / 2; gap > 0; gap /= 2) {
+        for (uint32_t i = gap; i < count; i++) {
+            uint32_t value = values[i];
+            uint32_t j = i;
+            while (j >= gap && values[j - gap] > value) {
+                values[j] = values[j - gap];
+                j -= gap;
+            }
+            values[j] = value;
+        }
+    }
+}
+
+// Власна ціна пари rdtsc, яку віднімаємо від кожного вимірювання
+static void calibrate_overhead(void) {
+    uint64_t best = ~0ull;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t start = rdtsc();
+        uint64_t end = rdtsc();
+        if (end - start < best) {
+            best = end - start;
+        }
+    }
+    rdtsc_overhead = (uint32_t)best;
+}
+
+static uint32_t measure_batch(const bench_t* bench) {
+    uint64_t start = rdtsc();
+    for (uint32_t i = 0; i < bench->batch; i++) {
+        bench->fn(bench->arg);
+    }
+    uint64_t cycles = rdtsc() - start;
+    cycles = cycles > rdtsc_overhead ? cycles - rdtsc_overhead : 0;
+    cycles = div64_u32(cycles, bench->batch, NULL);
+    return cycles > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)cycles;
+}
+
+static void run_one(const bench_t* bench, bench_result_t* result) {
+    for (int i = 0; i < BENCH_WARMUP; i++) {
+        measure_batch(bench);
+    }
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        samples[i] = measure_batch(bench);
+    }
+    sort_samples(samples, BENCH_SAMPLES);
+    result->min = samples[0];
+    result->median = samples[BENCH_SAMPLES / 2];
+    result->p99 = samples[BENCH_SAMPLES * 99 / 100];
+}
+
+// === ВИВІД ===
+
+static void write_padded(const char* text, size_t width) {
+    terminal_writestring(text);
+    for (size_t len = strlen(text); len < width; len++) {
+        terminal_putchar(' ');
+    }
+}
+
+static void print_machine(const bench_t* bench, const bench_result_t* r) {
+    terminal_writestring("BENCH ");
+    terminal_writestring(bench->name);
+    uint32_t values[3] = { r->min, r->median, r->p99 };
+    for (int i = 0; i < 3; i++) {
+        terminal_writestring(" ");
+        terminal_writeuint(values[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        terminal_writestring(" ");
+        terminal_writeuint(tsc_cycles_to_ns(values[i]));
+    }
+    terminal_writestring("\n");
+}
+
+static void print_row(const bench_t* bench, const bench_result_t* r) {
+    write_padded(bench->name, 22);
+    terminal_writeuint_width(r->min, 9);
+    terminal_writeuint_width(r->median, 9);
+    terminal_writeuint_width(r->p99, 9);
+    terminal_writeuint_width(tsc_cycles_to_ns(r->median), 10);
+    terminal_writestring("\n");
+}
+
+// filter - префікс імені (NULL або "" - усі); повертає кількість виконаних
+int bench_run(const char* filter, int output) {
+    size_t filter_len = filter ? strlen(filter) : 0;
+    int executed = 0;
+
+    calibrate_overhead();
+    if (output == BENCH_OUTPUT_MACHINE) {
+        terminal_writestring("BENCH-BEGIN arch=" KERNEL_ARCH " tsc_khz=");
+        terminal_writeuint(tsc_khz());
+        terminal_writestring(" samples=");
+        terminal_writeuint(BENCH_SAMPLES);
+        terminal_writestring("\n");
+    } else {
+        terminal_writestring("Бенчмарк                   мін.     мед.      p99   мед. нс\n");
+    }
+
+    for (uint32_t i = 0; i < bench_count; i++) {
+        const bench_t* bench = &benches[i];
+        if (filter_len && strncmp(bench->name, filter, filter_len) != 0) {
+            continue;
+        }
+
+        // Бенчмарки терміналу не повинні засмічувати COM1, де читаються результати
+        bench_result_t result;
+        terminal_set_serial_mirror(false);
+        run_one(bench, &result);
+        terminal_set_serial_mirror(true);
+
+        if (output == BENCH_OUTPUT_MACHINE) {
+            print_machine(bench, &result);
+        } else {
+            print_row(bench, &result);
+        }
+        executed++;
+    }
+
+    if (output == BENCH_OUTPUT_MACHINE) {
+        terminal_writestring("BENCH-END\n");
+    }
+    return executed;
+}
+
+// === ВБУДОВАНІ БЕНЧМАРКИ ===
+
+static char bench_text[] = "Nexus OS benchmark string for strlen and strchr: 0123456789!";
+static uint8_t bench_src[4096];
+static uint8_t bench_dst[4096];
+static uint8_t bench_cmp[4096];
+
+static void bench_putchar(void* arg) {
+    (void)arg;
+    terminal_putchar('.');
+}
+
+static void bench_scroll(void* arg) {
+    (void)arg;
+    terminal_putchar('\n');
+}
+
+static void bench_math(void* arg) {
+    volatile int result = parse_math_expression((const char*)arg);
+    (void)result;
+}
+
+// Один вираз на трьох рівнях: розбір і компіляція, байткод, машинний код
+#define BENCH_EXPR      "(x*x+3)*(x-7)%1000+x/3"
+
+static expr_t expr_bytecode;
+static expr_t expr_native;
+
+static void bench_expr_compile(void* arg) {
+    expr_t expr;
+    volatile math_result_t error = expr_compile((const char*)arg, &expr);
+    (void)error;
+}
+
+static void bench_expr_interp(void* arg) {
+    int32_t value;
+    volatile math_result_t error = expr_interpret((const expr_t*)arg, 1234, &value);
+    (void)error;
+}
+
+static void bench_expr_jit(void* arg) {
+    math_result_t error;
+    volatile int32_t value = ((const expr_t*)arg)->jit(1234, &error);
+    (void)value;
+}
+
+// Довга арифметика: 256x256 лімбів (Карацуба) та 1000! деревом добутків
+static bignum_t bench_big_a, bench_big_b, bench_big_r;
+
+static void bench_bignum_mul(void* arg) {
+    (void)arg;
+    bignum_mul(&bench_big_r, &bench_big_a, &bench_big_b);
+}
+
+static void bench_bignum_fact(void* arg) {
+    (void)arg;
+    bignum_factorial(&bench_big_r, 1000);
+}
+
+static void bench_strlen(void* arg) {
+    volatile size_t len = strlen((const char*)arg);
+    (void)len;
+}
+
+static void bench_strchr(void* arg) {
+    char* volatile found = strchr((const char*)arg, '!');
+    (void)found;
+}
+
+static void bench_memcpy(void* arg) {
+    (void)arg;
+    memcpy(bench_dst, bench_src, sizeof(bench_dst));
+}
+
+static void bench_memset(void* arg) {
+    (void)arg;
+    memset(bench_dst, 0x5A, sizeof(bench_dst));
+}
+
+static void bench_memcmp(void* arg) {
+    (void)arg;
+    // Рівні буфери - порівняння проходить до кінця
+    volatile int result = memcmp(bench_cmp, bench_src, sizeof(bench_cmp));
+    (void)result;
+}
+
+// Порожня секція: ціна, яку платить кожен SIMD-виклик mem*/str*
+static void bench_kernel_fpu(void* arg) {
+    (void)arg;
+    kernel_fpu_begin();
+    kernel_fpu_end();
+}
+
+// Файл зі згенерованої частини initrd (tools/mkinitrd.py)
+#define BENCH_RAMFS_PATH    "/bench/d31/f04127.txt"
+
+static void bench_ramfs_lookup(void* arg) {
+    ramfs_node_t* volatile node = ramfs_lookup((const char*)arg);
+    (void)node;
+}
+
+// Команда з кінця колишнього ланцюжка strcmp
+#define BENCH_COMMAND       "serialbench"
+
+static void bench_command_lookup(void* arg) {
+    const command_t* volatile command = command_lookup((const char*)arg, sizeof(BENCH_COMMAND) - 1);
+    (void)command;
+}
+
+void bench_irq_handler(irq_frame_t* frame) {
+    (void)frame;
+    bench_irqs++;
+}
+
+// Шлях як у IRQ: заглушка, irq_dispatch, обробник, iret - без EOI
+static void bench_irq(void* arg) {
+    (void)arg;
+    asm volatile("int %0" : : "i"(BENCH_IRQ_VECTOR) : "memory");
+}
+
+void bench_init(void) {
+    irq_register(BENCH_IRQ_VECTOR, "bench", bench_irq_handler, IRQ_FLAG_NO_EOI);
+
+    bench_register("terminal_putchar", bench_putchar, NULL, 64);
+    bench_register("terminal_scroll", bench_scroll, NULL, 16);
+    bench_register("parse_math", bench_math, "12345*678", 256);
+    bench_register("expr_compile", bench_expr_compile, BENCH_EXPR, 64);
+    if (expr_compile(BENCH_EXPR, &expr_bytecode) == MATH_SUCCESS) {
+        bench_register("expr_interp", bench_expr_interp, &expr_bytecode, 256);
+    }
+    if (expr_compile(BENCH_EXPR, &expr_native) == MATH_SUCCESS && expr_jit_compile(&expr_native) == SUCCESS) {
+        bench_register("expr_jit", bench_expr_jit, &expr_native, 256);
+    }
+    // 7^2850 та 3^5387 - приблизно по 256 лімбів
+    bignum_set_int(&bench_big_a, 7);
+    bignum_set_int(&bench_big_b, 3);
+    if (bignum_pow(&bench_big_a, &bench_big_a, 2850) == SUCCESS && bignum_pow(&bench_big_b, &bench_big_b, 5387) == SUCCESS) {
+        bench_register("bignum_mul_256", bench_bignum_mul, NULL, 16);
+    }
+    bench_register("bignum_fact_1000", bench_bignum_fact, NULL, 4);
+    bench_register("strlen_60", bench_strlen, bench_text, 256);
+    bench_register("strchr_60", bench_strchr, bench_text, 256);
+    bench_register("memcpy_4k", bench_memcpy, NULL, 16);
+    bench_register("memset_4k", bench_memset, NULL, 16);
+    bench_register("memcmp_4k", bench_memcmp, NULL, 16);
+    bench_register("kernel_fpu", bench_kernel_fpu, NULL, 256);
+    bench_register("irq_entry_exit", bench_irq, NULL, 64);
+    if (ramfs_lookup(BENCH_RAMFS_PATH)) {
+        bench_register("ramfs_lookup", bench_ramfs_lookup, BENCH_RAMFS_PATH, 256);
+    }
+    bench_register("command_lookup", bench_command_lookup, BENCH_COMMAND, 256);
+}
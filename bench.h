@@ -0,0 +1,41 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "kernel.h"
+
+#define BENCH_MAX               32
+#define BENCH_SAMPLES           1000
+#define BENCH_WARMUP            100
+
+// Програмне переривання для вимірювання входу/виходу з IRQ
+#define BENCH_IRQ_VECTOR        0xE0
+
+// Один виклик - одна операція; вимірюється пакет із batch викликів
+typedef void (*bench_fn_t)(void* arg);
+
+typedef struct {
+    const char* name;
+    bench_fn_t fn;
+    void* arg;
+    uint32_t batch;
+} bench_t;
+
+typedef struct {
+    uint32_t min;
+    uint32_t median;
+    uint32_t p99;
+} bench_result_t;
+
+// Режими виводу: таблиця для людини або рядки BENCH для скриптів
+#define BENCH_OUTPUT_TABLE      0
+#define BENCH_OUTPUT_MACHINE    1
+
+// Реєстрація та запуск
+void bench_init(void);
+int bench_register(const char* name, bench_fn_t fn, void* arg, uint32_t batch);
+int bench_run(const char* filter, int output);
+
+// Обробник BENCH_IRQ_VECTOR (irq_dispatch)
+void bench_irq_handler(irq_frame_t* frame);
+
+#endif
@@ -0,0 +1,880 @@
+#include "bignum.h"
+#include "heap.h"
+#include "pmm.h"
+#include "timer.h"
+
+// Найбільший степінь 10, що влазить у лімб: текст переводимо по 9 цифр
+#define DECIMAL_CHUNK           1000000000u
+#define DECIMAL_CHUNK_DIGITS    9
+
+// Довші числа bignum_write скорочує до початку та кінця
+#define BIGNUM_PRINT_DIGITS     2000
+#define BIGNUM_PRINT_EDGE       60
+
+// Листя дерева добутків у факторіалі множимо на одне слово
+#define FACTORIAL_LEAF          16
+
+// === ПАМ'ЯТЬ ===
+
+// Малі масиви - з kmalloc, більші за KMALLOC_MAX_SIZE - неперервними сторінками
+static uint32_t* limbs_alloc(uint32_t count, uint32_t* capacity) {
+    *capacity = 0;
+    if (count * sizeof(uint32_t) <= KMALLOC_MAX_SIZE) {
+        *capacity = count;
+        return kmalloc(count * sizeof(uint32_t));
+    }
+    uint32_t pages = (count * sizeof(uint32_t) + PAGE_SIZE - 1) / PAGE_SIZE;
+    uintptr_t frames = pmm_alloc_frames(pages);
+    if (!frames) {
+        return NULL;
+    }
+    *capacity = pages * (PAGE_SIZE / sizeof(uint32_t));
+    return (uint32_t*)frames;
+}
+
+static void limbs_free(uint32_t* limbs, uint32_t capacity) {
+    if (!limbs) {
+        return;
+    }
+    if (capacity * sizeof(uint32_t) <= KMALLOC_MAX_SIZE) {
+        kfree(limbs);
+    } else {
+        pmm_free_frames((uintptr_t)limbs, capacity * sizeof(uint32_t) / PAGE_SIZE);
+    }
+}
+
+void bignum_init(bignum_t* n) {
+    n->limbs = NULL;
+    n->size = 0;
+    n->capacity = 0;
+    n->negative = false;
+}
+
+void bignum_free(bignum_t* n) {
+    limbs_free(n->limbs, n->capacity);
+    bignum_init(n);
+}
+
+static int reserve(bignum_t* n, uint32_t count) {
+    if (count <= n->capacity) {
+        return SUCCESS;
+    }
+    if (count > BIGNUM_MAX_LIMBS + 2) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (count < 4) {
+        count = 4;
+    }
+
+    uint32_t capacity;
+    uint32_t* limbs = limbs_alloc(count, &capacity);
+    if (!limbs) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (n->size) {
+        memcpy(limbs, n->limbs, n->size * sizeof(uint32_t));
+    }
+    limbs_free(n->limbs, n->capacity);
+    n->limbs = limbs;
+    n->capacity = capacity;
+    return SUCCESS;
+}
+
+static void trim(bignum_t* n) {
+    while (n->size && n->limbs[n->size - 1] == 0) {
+        n->size--;
+    }
+    if (n->size == 0) {
+        n->negative = false;
+    }
+}
+
+// Результат операції рахуємо в тимчасовому числі й лише потім віддаємо r,
+// тож r може збігатися з операндом
+static void replace(bignum_t* r, bignum_t* result) {
+    bignum_free(r);
+    *r = *result;
+}
+
+int bignum_set_int(bignum_t* n, int64_t value) {
+    if (reserve(n, 2) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    n->limbs[0] = (uint32_t)magnitude;
+    n->limbs[1] = (uint32_t)(magnitude >> 32);
+    n->size = 2;
+    n->negative = value < 0;
+    trim(n);
+    return SUCCESS;
+}
+
+int bignum_copy(bignum_t* dst, const bignum_t* src) {
+    if (dst == src) {
+        return SUCCESS;
+    }
+    if (reserve(dst, src->size) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (src->size) {
+        memcpy(dst->limbs, src->limbs, src->size * sizeof(uint32_t));
+    }
+    dst->size = src->size;
+    dst->negative = src->negative;
+    return SUCCESS;
+}
+
+// === ОПЕРАЦІЇ НАД МОДУЛЯМИ ===
+
+static int mag_cmp(const uint32_t* a, uint32_t an, const uint32_t* b, uint32_t bn) {
+    if (an != bn) {
+        return an > bn ? 1 : -1;
+    }
+    while (an--) {
+        if (a[an] != b[an]) {
+            return a[an] > b[an] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+// r = a + b, an >= bn; r має an лімбів і може збігатися з a. Повертає перенос
+static uint32_t mag_add(uint32_t* r, const uint32_t* a, uint32_t an, const uint32_t* b, uint32_t bn) {
+    uint32_t carry = 0;
+    uint32_t i = 0;
+    for (; i < bn; i++) {
+        uint64_t sum = (uint64_t)a[i] + b[i] + carry;
+        r[i] = (uint32_t)sum;
+        carry = (uint32_t)(sum >> 32);
+    }
+    for (; i < an; i++) {
+        if (!carry && r == a) {
+            break;
+        }
+        uint64_t sum = (uint64_t)a[i] + carry;
+        r[i] = (uint32_t)sum;
+        carry = (uint32_t)(sum >> 32);
+    }
+    return carry;
+}
+
+// r = a - b, a >= b за модулем; r має an лімбів і може збігатися з a
+static void mag_sub(uint32_t* r, const uint32_t* a, uint32_t an, const uint32_t* b, uint32_t bn) {
+    uint32_t borrow = 0;
+    uint32_t i = 0;
+    for (; i < bn; i++) {
+        uint64_t diff = (uint64_t)a[i] - b[i] - borrow;
+        r[i] = (uint32_t)diff;
+        borrow = (uint32_t)(diff >> 63);
+    }
+    for (; i < an; i++) {
+        if (!borrow && r == a) {
+            break;
+        }
+        uint64_t diff = (uint64_t)a[i] - borrow;
+        r[i] = (uint32_t)diff;
+        borrow = (uint32_t)(diff >> 63);
+    }
+}
+
+// r = a * m + add; r може збігатися з a. Повертає старший лімб
+static uint32_t mag_mul_small(uint32_t* r, const uint32_t* a, uint32_t n, uint32_t m, uint32_t add) {
+    uint32_t carry = add;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t product = (uint64_t)a[i] * m + carry;
+        r[i] = (uint32_t)product;
+        carry = (uint32_t)(product >> 32);
+    }
+    return carry;
+}
+
+// q = a / d; q може збігатися з a. Повертає остачу
+static uint32_t mag_div_small(uint32_t* q, const uint32_t* a, uint32_t n, uint32_t d) {
+    uint32_t rem = 0;
+    while (n--) {
+        uint32_t quotient;
+        asm ( "divl %4" : "=a"(quotient), "=d"(rem) : "a"(a[n]), "d"(rem), "rm"(d) );
+        q[n] = quotient;
+    }
+    return rem;
+}
+
+// Шкільне множення: r[0 .. an+bn) = a * b, r не перетинається з операндами
+static void mag_mul_school(uint32_t* r, const uint32_t* a, uint32_t an, const uint32_t* b, uint32_t bn) {
+    memset(r, 0, (an + bn) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < bn; i++) {
+        uint32_t carry = 0;
+        uint32_t bi = b[i];
+        if (bi == 0) {
+            continue;
+        }
+        for (uint32_t j = 0; j < an; j++) {
+            uint64_t t = (uint64_t)a[j] * bi + r[i + j] + carry;
+            r[i + j] = (uint32_t)t;
+            carry = (uint32_t)(t >> 32);
+        }
+        r[i + an] = carry;
+    }
+}
+
+// Розмір робочого буфера Карацуби для операндів по n лімбів
+static uint32_t karatsuba_scratch(uint32_t n) {
+    uint32_t total = 0;
+    while (n >= BIGNUM_KARATSUBA_THRESHOLD) {
+        uint32_t high = n - n / 2;
+        total += 4 * (high + 1);
+        n = high + 1;
+    }
+    return total;
+}
+
+// r[0 .. 2n) = a * b для операндів однакової довжини n
+static void karatsuba(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t n, uint32_t* scratch) {
+    if (n < BIGNUM_KARATSUBA_THRESHOLD) {
+        mag_mul_school(r, a, n, b, n);
+        return;
+    }
+
+    // a = a1 * B^low + a0; старша половина не коротша за молодшу
+    uint32_t low = n / 2;
+    uint32_t high = n - low;
+
+    // z0 = a0 * b0 та z2 = a1 * b1 одразу на своїх місцях у r
+    karatsuba(r, a, b, low, scratch);
+    karatsuba(r + 2 * low, a + low, b + low, high, scratch);
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    uint32_t* sum_a = scratch;
+    uint32_t* sum_b = sum_a + high + 1;
+    uint32_t* middle = sum_b + high + 1;
+    uint32_t middle_size = 2 * (high + 1);
+    sum_a[high] = mag_add(sum_a, a + low, high, a, low);
+    sum_b[high] = mag_add(sum_b, b + low, high, b, low);
+    karatsuba(middle, sum_a, sum_b, high + 1, middle + middle_size);
+    mag_sub(middle, middle, middle_size, r, 2 * low);
+    mag_sub(middle, middle, middle_size, r + 2 * low, 2 * high);
+
+    while (middle_size && middle[middle_size - 1] == 0) {
+        middle_size--;
+    }
+    mag_add(r + low, r + low, 2 * n - low, middle, middle_size);
+}
+
+// r[0 .. an+bn) = a * b; Карацуба для довгих операндів, нерівні - шматками
+static int mag_mul(uint32_t* r, const uint32_t* a, uint32_t an, const uint32_t* b, uint32_t bn) {
+    if (an < bn) {
+        const uint32_t* t = a; a = b; b = t;
+        uint32_t tn = an; an = bn; bn = tn;
+    }
+    if (bn < BIGNUM_KARATSUBA_THRESHOLD) {
+        mag_mul_school(r, a, an, b, bn);
+        return SUCCESS;
+    }
+
+    uint32_t scratch_capacity, tmp_capacity = 0;
+    uint32_t* scratch = limbs_alloc(karatsuba_scratch(bn), &scratch_capacity);
+    if (!scratch) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (an == bn) {
+        karatsuba(r, a, b, bn, scratch);
+        limbs_free(scratch, scratch_capacity);
+        return SUCCESS;
+    }
+
+    uint32_t* tmp = limbs_alloc(2 * bn, &tmp_capacity);
+    if (!tmp) {
+        limbs_free(scratch, scratch_capacity);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    int result = SUCCESS;
+    memset(r, 0, (an + bn) * sizeof(uint32_t));
+    for (uint32_t offset = 0; offset < an && result == SUCCESS; offset += bn) {
+        uint32_t length = an - offset < bn ? an - offset : bn;
+        if (length == bn) {
+            karatsuba(tmp, a + offset, b, bn, scratch);
+        } else {
+            result = mag_mul(tmp, b, bn, a + offset, length);
+        }
+        mag_add(r + offset, r + offset, an + bn - offset, tmp, bn + length);
+    }
+
+    limbs_free(tmp, tmp_capacity);
+    limbs_free(scratch, scratch_capacity);
+    return result;
+}
+
+// Ділення Кнута (алгоритм D): u (un лімбів) на v (vn >= 2 лімбів).
+// q отримує un - vn + 1 лімбів, r - vn лімбів
+static int mag_divmod(uint32_t* q, uint32_t* r, const uint32_t* u, uint32_t un, const uint32_t* v, uint32_t vn) {
+    uint32_t un_capacity, vn_capacity;
+    uint32_t* nu = limbs_alloc(un + 1, &un_capacity);
+    uint32_t* nv = limbs_alloc(vn, &vn_capacity);
+    if (!nu || !nv) {
+        limbs_free(nu, un_capacity);
+        limbs_free(nv, vn_capacity);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    // Нормалізація: старший біт дільника = 1, тоді оцінка qhat помиляється не більше ніж на 2
+    uint32_t shift = (uint32_t)__builtin_clz(v[vn - 1]);
+    for (uint32_t i = vn - 1; i > 0; i--) {
+        nv[i] = shift ? (v[i] << shift) | (v[i - 1] >> (32 - shift)) : v[i];
+    }
+    nv[0] = v[0] << shift;
+    nu[un] = shift ? u[un - 1] >> (32 - shift) : 0;
+    for (uint32_t i = un - 1; i > 0; i--) {
+        nu[i] = shift ? (u[i] << shift) | (u[i - 1] >> (32 - shift)) : u[i];
+    }
+    nu[0] = u[0] << shift;
+
+    uint32_t top = nv[vn - 1];
+    uint32_t next = nv[vn - 2];
+    for (int32_t j = (int32_t)(un - vn); j >= 0; j--) {
+        uint64_t numerator = ((uint64_t)nu[j + vn] << 32) | nu[j + vn - 1];
+        uint32_t rem32;
+        uint64_t qhat = div64_u32(numerator, top, &rem32);
+        uint64_t rhat = rem32;
+
+        while (qhat > 0xFFFFFFFFull || qhat * next > ((rhat << 32) | nu[j + vn - 2])) {
+            qhat--;
+            rhat += top;
+            if (rhat > 0xFFFFFFFFull) {
+                break;
+            }
+        }
+
+        // nu[j .. j+vn] -= qhat * nv
+        int64_t t;
+        uint32_t borrow = 0;
+        for (uint32_t i = 0; i < vn; i++) {
+            uint64_t product = qhat * nv[i];
+            t = (int64_t)nu[i + j] - borrow - (int64_t)(uint32_t)product;
+            nu[i + j] = (uint32_t)t;
+            borrow = (uint32_t)(product >> 32) - (uint32_t)(t >> 32);
+        }
+        t = (int64_t)nu[j + vn] - borrow;
+        nu[j + vn] = (uint32_t)t;
+
+        // Рідкісний випадок: qhat на одиницю більший - додаємо дільник назад
+        if (t < 0) {
+            qhat--;
+            uint32_t carry = 0;
+            for (uint32_t i = 0; i < vn; i++) {
+                uint64_t sum = (uint64_t)nu[i + j] + nv[i] + carry;
+                nu[i + j] = (uint32_t)sum;
+                carry = (uint32_t)(sum >> 32);
+            }
+            nu[j + vn] += carry;
+        }
+        if (q) {
+            q[j] = (uint32_t)qhat;
+        }
+    }
+
+    if (r) {
+        for (uint32_t i = 0; i < vn - 1; i++) {
+            r[i] = shift ? (nu[i] >> shift) | (nu[i + 1] << (32 - shift)) : nu[i];
+        }
+        r[vn - 1] = nu[vn - 1] >> shift;
+    }
+
+    limbs_free(nu, un_capacity);
+    limbs_free(nv, vn_capacity);
+    return SUCCESS;
+}
+
+// === ЗНАКОВА АРИФМЕТИКА ===
+
+int bignum_cmp(const bignum_t* a, const bignum_t* b) {
+    if (a->negative != b->negative) {
+        return a->negative ? -1 : 1;
+    }
+    int cmp = mag_cmp(a->limbs, a->size, b->limbs, b->size);
+    return a->negative ? -cmp : cmp;
+}
+
+int bignum_is_zero(const bignum_t* n) {
+    return n->size == 0;
+}
+
+int bignum_to_int32(const bignum_t* n, int32_t* value) {
+    if (n->size == 0) {
+        *value = 0;
+        return SUCCESS;
+    }
+    if (n->size > 1 || n->limbs[0] > 0x80000000u || (n->limbs[0] == 0x80000000u && !n->negative)) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    *value = n->negative ? (int32_t)(0u - n->limbs[0]) : (int32_t)n->limbs[0];
+    return SUCCESS;
+}
+
+// a + b, де знак b заданий окремо (для віднімання - інвертований)
+static int add_signed(bignum_t* r, const bignum_t* a, const bignum_t* b, int b_negative) {
+    bignum_t t;
+    bignum_init(&t);
+
+    const bignum_t* big = a;
+    const bignum_t* small = b;
+    if (mag_cmp(a->limbs, a->size, b->limbs, b->size) < 0) {
+        big = b;
+        small = a;
+    }
+    int big_negative = big == a ? a->negative : b_negative;
+
+    if (reserve(&t, big->size + 1) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (a->negative == b_negative) {
+        t.limbs[big->size] = mag_add(t.limbs, big->limbs, big->size, small->limbs, small->size);
+        t.size = big->size + 1;
+    } else {
+        mag_sub(t.limbs, big->limbs, big->size, small->limbs, small->size);
+        t.size = big->size;
+    }
+    t.negative = big_negative;
+    trim(&t);
+    replace(r, &t);
+    return SUCCESS;
+}
+
+int bignum_add(bignum_t* r, const bignum_t* a, const bignum_t* b) {
+    return add_signed(r, a, b, b->negative);
+}
+
+int bignum_sub(bignum_t* r, const bignum_t* a, const bignum_t* b) {
+    return add_signed(r, a, b, !b->negative && b->size);
+}
+
+int bignum_mul(bignum_t* r, const bignum_t* a, const bignum_t* b) {
+    bignum_t t;
+    bignum_init(&t);
+
+    if (a->size == 0 || b->size == 0) {
+        replace(r, &t);
+        return SUCCESS;
+    }
+    if (a->size + b->size > BIGNUM_MAX_LIMBS || reserve(&t, a->size + b->size) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (mag_mul(t.limbs, a->limbs, a->size, b->limbs, b->size) != SUCCESS) {
+        bignum_free(&t);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    t.size = a->size + b->size;
+    t.negative = a->negative != b->negative;
+    trim(&t);
+    replace(r, &t);
+    return SUCCESS;
+}
+
+int bignum_divmod(bignum_t* q, bignum_t* rem, const bignum_t* a, const bignum_t* b) {
+    if (b->size == 0) {
+        return ERROR_DIVISION_BY_ZERO;
+    }
+
+    bignum_t qt, rt;
+    bignum_init(&qt);
+    bignum_init(&rt);
+
+    if (mag_cmp(a->limbs, a->size, b->limbs, b->size) < 0) {
+        // |a| < |b|: частка 0, остача - саме a
+        if (bignum_copy(&rt, a) != SUCCESS) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+    } else if (reserve(&qt, a->size - b->size + 1) != SUCCESS || reserve(&rt, b->size) != SUCCESS) {
+        bignum_free(&qt);
+        bignum_free(&rt);
+        return ERROR_BUFFER_OVERFLOW;
+    } else {
+        if (b->size == 1) {
+            rt.limbs[0] = mag_div_small(qt.limbs, a->limbs, a->size, b->limbs[0]);
+        } else if (mag_divmod(qt.limbs, rt.limbs, a->limbs, a->size, b->limbs, b->size) != SUCCESS) {
+            bignum_free(&qt);
+            bignum_free(&rt);
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        qt.size = a->size - b->size + 1;
+        rt.size = b->size;
+        // Як у C: частка до нуля, знак остачі - від діленого
+        qt.negative = a->negative != b->negative;
+        rt.negative = a->negative;
+        trim(&qt);
+        trim(&rt);
+    }
+
+    if (q) {
+        replace(q, &qt);
+    } else {
+        bignum_free(&qt);
+    }
+    if (rem) {
+        replace(rem, &rt);
+    } else {
+        bignum_free(&rt);
+    }
+    return SUCCESS;
+}
+
+static uint32_t bit_length(const bignum_t* n) {
+    if (n->size == 0) {
+        return 0;
+    }
+    return n->size * 32 - (uint32_t)__builtin_clz(n->limbs[n->size - 1]);
+}
+
+int bignum_pow(bignum_t* r, const bignum_t* base, uint32_t exp) {
+    // Оцінка розміру результату до обчислень
+    if ((uint64_t)bit_length(base) * exp > (uint64_t)BIGNUM_MAX_LIMBS * 32) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    bignum_t result, square;
+    bignum_init(&result);
+    bignum_init(&square);
+    int status = bignum_set_int(&result, 1);
+    if (status == SUCCESS) {
+        status = bignum_copy(&square, base);
+    }
+
+    // Піднесення квадратами від старшого біта: множимо на основу, а не на квадрати
+    for (int bit = 31; bit >= 0 && status == SUCCESS; bit--) {
+        // Нуль має size 0 без лімбів - limbs[0] читаємо лише при size 1
+        if (result.size != 1 || result.limbs[0] != 1 || result.negative) {
+            status = bignum_mul(&result, &result, &result);
+        }
+        if (status == SUCCESS && (exp >> bit) & 1) {
+            status = bignum_mul(&result, &result, &square);
+        }
+    }
+
+    bignum_free(&square);
+    if (status != SUCCESS) {
+        bignum_free(&result);
+        return status;
+    }
+    replace(r, &result);
+    return SUCCESS;
+}
+
+static int mul_small(bignum_t* n, uint32_t m) {
+    if (reserve(n, n->size + 1) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    n->limbs[n->size] = mag_mul_small(n->limbs, n->limbs, n->size, m, 0);
+    n->size++;
+    trim(n);
+    return SUCCESS;
+}
+
+// Добуток lo * (lo+1) * ... * hi деревом: множники схожого розміру йдуть у Карацубу
+static int range_product(bignum_t* r, uint32_t lo, uint32_t hi) {
+    if (hi - lo < FACTORIAL_LEAF) {
+        int status = bignum_set_int(r, lo);
+        for (uint32_t i = lo + 1; i <= hi && status == SUCCESS; i++) {
+            status = mul_small(r, i);
+        }
+        return status;
+    }
+
+    uint32_t mid = lo + (hi - lo) / 2;
+    bignum_t right;
+    bignum_init(&right);
+    int status = range_product(r, lo, mid);
+    if (status == SUCCESS) {
+        status = range_product(&right, mid + 1, hi);
+    }
+    if (status == SUCCESS) {
+        status = bignum_mul(r, r, &right);
+    }
+    bignum_free(&right);
+    return status;
+}
+
+int bignum_factorial(bignum_t* r, uint32_t n) {
+    // log2(n!) < n * log2(n)
+    if ((uint64_t)n * (32 - (uint32_t)__builtin_clz(n | 1)) > (uint64_t)BIGNUM_MAX_LIMBS * 32) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (n < 2) {
+        return bignum_set_int(r, 1);
+    }
+    return range_product(r, 1, n);
+}
+
+// === ДЕСЯТКОВЕ ПРЕДСТАВЛЕННЯ ===
+
+int bignum_from_string(bignum_t* n, const char* text, size_t length) {
+    bignum_t t;
+    bignum_init(&t);
+    if (length == 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Кожні 9 цифр: t = t * 10^k + шматок
+    size_t i = 0;
+    while (i < length) {
+        uint32_t chunk = 0, scale = 1;
+        for (uint32_t k = 0; k < DECIMAL_CHUNK_DIGITS && i < length; k++, i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                bignum_free(&t);
+                return ERROR_INVALID_INPUT;
+            }
+            chunk = chunk * 10 + (uint32_t)(text[i] - '0');
+            scale *= 10;
+        }
+        if (reserve(&t, t.size + 1) != SUCCESS) {
+            bignum_free(&t);
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        t.limbs[t.size] = mag_mul_small(t.limbs, t.limbs, t.size, scale, chunk);
+        t.size++;
+        trim(&t);
+    }
+
+    replace(n, &t);
+    return SUCCESS;
+}
+
+size_t bignum_decimal_size(const bignum_t* n) {
+    // 32 * log10(2) < 9.64 цифри на лімб, плюс знак і нуль-термінатор
+    return (size_t)n->size * 10 + 3;
+}
+
+int bignum_to_string(const bignum_t* n, char* buffer, size_t size) {
+    if (size < bignum_decimal_size(n)) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    if (n->size == 0) {
+        strcpy(buffer, "0");
+        return SUCCESS;
+    }
+
+    // Ділимо копію модуля на 10^9, шматки - від молодших до старших
+    uint32_t work_capacity, chunks_capacity;
+    uint32_t* work = limbs_alloc(n->size, &work_capacity);
+    uint32_t* chunks = limbs_alloc(n->size * 2 + 1, &chunks_capacity);
+    if (!work || !chunks) {
+        limbs_free(work, work_capacity);
+        limbs_free(chunks, chunks_capacity);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    memcpy(work, n->limbs, n->size * sizeof(uint32_t));
+
+    uint32_t count = 0;
+    uint32_t length = n->size;
+    while (length) {
+        chunks[count++] = mag_div_small(work, work, length, DECIMAL_CHUNK);
+        while (length && work[length - 1] == 0) {
+            length--;
+        }
+    }
+
+    char* p = buffer;
+    if (n->negative) {
+        *p++ = '-';
+    }
+    uint64toa(chunks[count - 1], p, 10);
+    p += strlen(p);
+    for (int32_t i = (int32_t)count - 2; i >= 0; i--) {
+        uint32_t chunk = chunks[i];
+        for (int32_t d = DECIMAL_CHUNK_DIGITS - 1; d >= 0; d--) {
+            p[d] = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+        p += DECIMAL_CHUNK_DIGITS;
+    }
+    *p = '\0';
+
+    limbs_free(work, work_capacity);
+    limbs_free(chunks, chunks_capacity);
+    return SUCCESS;
+}
+
+void bignum_write(const bignum_t* n) {
+    size_t size = bignum_decimal_size(n);
+    uint32_t capacity;
+    char* text = (char*)limbs_alloc((uint32_t)((size + 3) / 4), &capacity);
+    if (!text || bignum_to_string(n, text, size) != SUCCESS) {
+        limbs_free((uint32_t*)text, capacity);
+        terminal_writestring("(недостатньо пам'яті)");
+        return;
+    }
+
+    size_t length = strlen(text);
+    if (length <= BIGNUM_PRINT_DIGITS) {
+        terminal_writestring(text);
+    } else {
+        terminal_write(text, BIGNUM_PRINT_EDGE);
+        terminal_writestring("...");
+        terminal_writestring(text + length - BIGNUM_PRINT_EDGE);
+        terminal_writestring(" (");
+        terminal_writeuint(length - (n->negative ? 1 : 0));
+        terminal_writestring(" цифр)");
+    }
+    limbs_free((uint32_t*)text, capacity);
+}
+
+// === БЕНЧМАРК ===
+
+static uint32_t bench_seed;
+
+static void fill_random(uint32_t* limbs, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        bench_seed ^= bench_seed << 13;
+        bench_seed ^= bench_seed >> 17;
+        bench_seed ^= bench_seed << 5;
+        limbs[i] = bench_seed;
+    }
+}
+
+// Лімбів результату за мілісекунду
+static void write_throughput(uint32_t limbs, uint64_t cycles) {
+    uint64_t ns = tsc_cycles_to_ns(cycles);
+    while (ns > 0xFFFFFFFFull) {
+        ns >>= 1;
+        limbs >>= 1;
+    }
+    terminal_writestring(", ");
+    terminal_writeuint(ns ? div64_u32((uint64_t)limbs * NS_PER_MS, (uint32_t)ns, NULL) : 0);
+    terminal_writestring(" лімбів/мс");
+}
+
+static void write_result_line(const char* label, const bignum_t* n, uint64_t cycles) {
+    terminal_writestring(label);
+    terminal_writems(tsc_cycles_to_ns(cycles), 0);
+    terminal_writestring(" мс, ");
+    terminal_writeuint(n->size);
+    terminal_writestring(" лімбів");
+    write_throughput(n->size, cycles);
+    terminal_writestring("\n");
+}
+
+void bignum_benchmark(void) {
+    static const uint32_t sizes[] = { 32, 128, 512, 2048 };
+    bench_seed = (uint32_t)rdtsc() | 1;
+
+    // Шкільне множення проти Карацуби на однакових операндах
+    terminal_writestring("Множення NxN лімбів:  шкільне      Карацуба    прискорення\n");
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t n = sizes[s];
+        uint32_t caps[5];
+        uint32_t* a = limbs_alloc(n, &caps[0]);
+        uint32_t* b = limbs_alloc(n, &caps[1]);
+        uint32_t* r1 = limbs_alloc(2 * n, &caps[2]);
+        uint32_t* r2 = limbs_alloc(2 * n, &caps[3]);
+        uint32_t* scratch = limbs_alloc(karatsuba_scratch(n) + 1, &caps[4]);
+        if (!a || !b || !r1 || !r2 || !scratch) {
+            terminal_writestring("Недостатньо пам'яті\n");
+            limbs_free(a, caps[0]);
+            limbs_free(b, caps[1]);
+            limbs_free(r1, caps[2]);
+            limbs_free(r2, caps[3]);
+            limbs_free(scratch, caps[4]);
+            return;
+        }
+        fill_random(a, n);
+        fill_random(b, n);
+
+        // Повтори, щоб малі розміри вимірювалися не одиничним запуском
+        uint32_t reps = (2048 / n) * (2048 / n) / 16 + 1;
+        uint64_t start = rdtsc();
+        for (uint32_t i = 0; i < reps; i++) {
+            mag_mul_school(r1, a, n, b, n);
+        }
+        uint64_t school = div64_u32(rdtsc() - start, reps, NULL);
+        start = rdtsc();
+        for (uint32_t i = 0; i < reps; i++) {
+            karatsuba(r2, a, b, n, scratch);
+        }
+        uint64_t kara = div64_u32(rdtsc() - start, reps, NULL);
+
+        terminal_writeuint_width(n, 6);
+        terminal_writestring("              ");
+        terminal_writems(tsc_cycles_to_ns(school), 0);
+        terminal_writestring(" мс    ");
+        terminal_writems(tsc_cycles_to_ns(kara), 0);
+        terminal_writestring(" мс    ");
+        uint32_t tenths;
+        uint64_t ratio = kara ? div64_u32(school * 10, (uint32_t)kara, NULL) : 0;
+        terminal_writeuint(div64_u32(ratio, 10, &tenths));
+        terminal_writestring(".");
+        terminal_writeuint(tenths);
+        terminal_writestring(memcmp(r1, r2, 2 * n * sizeof(uint32_t)) == 0 ? "x\n" : "x  РОЗБІЖНІСТЬ!\n");
+
+        limbs_free(a, caps[0]);
+        limbs_free(b, caps[1]);
+        limbs_free(r1, caps[2]);
+        limbs_free(r2, caps[3]);
+        limbs_free(scratch, caps[4]);
+    }
+
+    bignum_t fact, half, q, r, check, power, base;
+    bignum_init(&fact);
+    bignum_init(&half);
+    bignum_init(&q);
+    bignum_init(&r);
+    bignum_init(&check);
+    bignum_init(&power);
+    bignum_init(&base);
+
+    uint64_t start = rdtsc();
+    int status = bignum_factorial(&fact, 10000);
+    uint64_t cycles = rdtsc() - start;
+    if (status == SUCCESS) {
+        write_result_line("10000!:        ", &fact, cycles);
+    }
+
+    bignum_set_int(&base, 3);
+    start = rdtsc();
+    if (bignum_pow(&power, &base, 100000) == SUCCESS) {
+        write_result_line("3^100000:      ", &power, rdtsc() - start);
+    }
+
+    // Ділення з перевіркою q * b + r == a
+    if (status == SUCCESS && bignum_factorial(&half, 5000) == SUCCESS) {
+        half.limbs[0] |= 1;     // дільник не кратний 2^32 - остача ненульова
+        start = rdtsc();
+        status = bignum_divmod(&q, &r, &fact, &half);
+        cycles = rdtsc() - start;
+        if (status == SUCCESS) {
+            bignum_mul(&check, &q, &half);
+            bignum_add(&check, &check, &r);
+            terminal_writestring("10000!/(5000!+1): ");
+            terminal_writems(tsc_cycles_to_ns(cycles), 0);
+            terminal_writestring(" мс, частка ");
+            terminal_writeuint(q.size);
+            terminal_writestring(" лімбів");
+            write_throughput(q.size, cycles);
+            terminal_writestring(bignum_cmp(&check, &fact) == 0 ? ", перевірка OK\n" : ", ПОМИЛКА перевірки\n");
+        }
+    }
+
+    // Десятковий запис 10000!
+    if (fact.size) {
+        size_t size = bignum_decimal_size(&fact);
+        uint32_t capacity;
+        char* text = (char*)limbs_alloc((uint32_t)((size + 3) / 4), &capacity);
+        if (text) {
+            start = rdtsc();
+            bignum_to_string(&fact, text, size);
+            cycles = rdtsc() - start;
+            terminal_writestring("Текст 10000!:  ");
+            terminal_writems(tsc_cycles_to_ns(cycles), 0);
+            terminal_writestring(" мс, ");
+            terminal_writeuint(strlen(text));
+            terminal_writestring(" цифр\n");
+            limbs_free((uint32_t*)text, capacity);
+        }
+    }
+
+    bignum_free(&fact);
+    bignum_free(&half);
+    bignum_free(&q);
+    bignum_free(&r);
+    bignum_free(&check);
+    bignum_free(&power);
+    bignum_free(&base);
+}
@@ -0,0 +1,49 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include "kernel.h"
+
+// Від цієї довжини (у лімбах) множення йде за Карацубою
+#define BIGNUM_KARATSUBA_THRESHOLD  32
+
+// Верхня межа розміру результату: 65536 лімбів ~ 631 тис. десяткових цифр
+#define BIGNUM_MAX_LIMBS            65536
+
+// Ціле довільної точності: модуль у 32-бітних лімбах (молодший перший) та знак
+typedef struct {
+    uint32_t* limbs;
+    uint32_t size;              // значущі лімби, 0 для нуля
+    uint32_t capacity;
+    int negative;
+} bignum_t;
+
+// Життєвий цикл; пам'ять з kmalloc, великі масиви - сторінками pmm
+void bignum_init(bignum_t* n);
+void bignum_free(bignum_t* n);
+int bignum_set_int(bignum_t* n, int64_t value);
+int bignum_copy(bignum_t* dst, const bignum_t* src);
+int bignum_from_string(bignum_t* n, const char* text, size_t length);
+
+// Порівняння та перетворення
+int bignum_cmp(const bignum_t* a, const bignum_t* b);
+int bignum_is_zero(const bignum_t* n);
+int bignum_to_int32(const bignum_t* n, int32_t* value);
+
+// Арифметика; результат може збігатися з операндом.
+// Ділення з відкиданням дробової частини, як у C
+int bignum_add(bignum_t* r, const bignum_t* a, const bignum_t* b);
+int bignum_sub(bignum_t* r, const bignum_t* a, const bignum_t* b);
+int bignum_mul(bignum_t* r, const bignum_t* a, const bignum_t* b);
+int bignum_divmod(bignum_t* q, bignum_t* rem, const bignum_t* a, const bignum_t* b);
+int bignum_pow(bignum_t* r, const bignum_t* base, uint32_t exp);
+int bignum_factorial(bignum_t* r, uint32_t n);
+
+// Десятковий вивід (заміна itoa для великих значень)
+size_t bignum_decimal_size(const bignum_t* n);
+int bignum_to_string(const bignum_t* n, char* buffer, size_t size);
+void bignum_write(const bignum_t* n);
+
+// Бенчмарк: множення, факторіал, степінь, ділення, перетворення в текст
+void bignum_benchmark(void);
+
+#endif
@@ -0,0 +1,544 @@
+#include "blk.h"
+#include "virtio.h"
+#include "apic.h"
+#include "cpu.h"
+#include "irq.h"
+#include "pmm.h"
+#include "timer.h"
+
+static virtio_device_t device;
+static virtq_t queue;
+static spinlock_t queue_lock = SPINLOCK_INIT;
+
+static int present = false;
+static int use_interrupts = false;
+static int polling = false;
+static int read_only = false;
+static uint64_t capacity = 0;
+static uint32_t block_size = BLK_SECTOR_SIZE;
+static int vector = -1;
+static uint32_t in_flight = 0;
+
+// Статистика
+static uint64_t requests_submitted = 0;
+static uint64_t requests_completed = 0;
+static uint64_t requests_failed = 0;
+static uint64_t batches = 0;
+static uint64_t interrupts = 0;
+static uint64_t polled = 0;
+static uint64_t bytes_read = 0;
+static uint64_t bytes_written = 0;
+static uint64_t latency_cycles = 0;
+static uint64_t max_latency_cycles = 0;
+
+// === ЗАВЕРШЕННЯ ===
+
+// Переривання після BLK_COALESCE_NUM/DEN запитів, що зараз у польоті
+static uint16_t coalesce_threshold(void) {
+    uint32_t after = in_flight * BLK_COALESCE_NUM / BLK_COALESCE_DEN;
+    return (uint16_t)(after ? after : 1);
+}
+
+// Під queue_lock: забрати всі завершені та знову взвести переривання.
+// Повертає список для complete_list - колбеки викликаються вже без блокування
+static blk_request_t* reap_locked(uint32_t* count) {
+    blk_request_t* list = NULL;
+    blk_request_t** tail = &list;
+    uint64_t now = rdtsc();
+    *count = 0;
+    do {
+        blk_request_t* request;
+        while ((request = virtq_get(&queue, NULL)) != NULL) {
+            uint64_t latency = now - request->submitted;
+            latency_cycles += latency;
+            if (latency > max_latency_cycles) {
+                max_latency_cycles = latency;
+            }
+            if (request->device_status != 0) {
+                requests_failed++;
+            } else if (request->type == BLK_READ) {
+                bytes_read += (uint64_t)request->count * BLK_SECTOR_SIZE;
+            } else if (request->type == BLK_WRITE) {
+                bytes_written += (uint64_t)request->count * BLK_SECTOR_SIZE;
+            }
+            in_flight--;
+            requests_completed++;
+            (*count)++;
+            request->next = NULL;
+            *tail = request;
+            tail = &request->next;
+        }
+    } while (use_interrupts && !polling && virtq_enable_interrupts(&queue, coalesce_threshold()));
+    return list;
+}
+
+// Викликається з вимкненими перериваннями: власник запиту не виконується між
+// встановленням статусу та колбеком
+static void complete_list(blk_request_t* list) {
+    while (list) {
+        blk_request_t* request = list;
+        list = request->next;
+        thread_t* waiter = request->waiter;
+        blk_done_t done = request->done;
+        request->status = request->device_status == 0 ? SUCCESS : ERROR_IO;
+        if (done) {
+            done(request);
+        }
+        sched_wakeup(waiter);
+    }
+}
+
+static void blk_irq(irq_frame_t* frame) {
+    (void)frame;
+    uint32_t count;
+    spin_lock(&queue_lock);
+    interrupts++;
+    blk_request_t* list = reap_locked(&count);
+    spin_unlock(&queue_lock);
+    complete_list(list);
+}
+
+uint32_t blk_poll(void) {
+    if (!present) {
+        return 0;
+    }
+    uint32_t count;
+    unsigned long flags = spin_lock_irqsave(&queue_lock);
+    blk_request_t* list = reap_locked(&count);
+    polled += count;
+    spin_unlock(&queue_lock);
+    complete_list(list);
+    interrupts_restore(flags);
+    return count;
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int blk_init(void) {
+    pci_device_t* pci = virtio_find(VIRTIO_ID_BLOCK, 0);
+    if (!pci) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint64_t wanted = (1ull << VIRTIO_F_EVENT_IDX) | (1ull << VIRTIO_BLK_F_RO) |
+                      (1ull << VIRTIO_BLK_F_BLK_SIZE) | (1ull << VIRTIO_BLK_F_FLUSH);
+    if (virtio_init(&device, pci, wanted) != SUCCESS || !device.config) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // MSI-X прямо в локальний APIC BSP: обробник будить потоки
+    uint16_t entry = VIRTIO_MSI_NO_VECTOR;
+    if (lapic_present() && virtio_enable_msix(&device) == SUCCESS) {
+        vector = irq_alloc_vector("virtio-blk", blk_irq, 0);
+        if (vector >= 0 && pci_msix_route(&device.msix, 0, (uint8_t)vector, cpus[0].apic_id) == SUCCESS) {
+            entry = 0;
+        }
+    }
+    if (virtio_queue_setup(&device, &queue, 0, BLK_QUEUE_SIZE, entry) != SUCCESS) {
+        return ERROR_INVALID_INPUT;
+    }
+    use_interrupts = entry != VIRTIO_MSI_NO_VECTOR;
+    if (!use_interrupts) {
+        virtq_disable_interrupts(&queue);
+    }
+
+    capacity = virtio_config_read64(&device, VIRTIO_BLK_CFG_CAPACITY);
+    if (virtio_has_feature(&device, VIRTIO_BLK_F_BLK_SIZE)) {
+        block_size = virtio_config_read32(&device, VIRTIO_BLK_CFG_BLK_SIZE);
+    }
+    read_only = virtio_has_feature(&device, VIRTIO_BLK_F_RO);
+    virtio_ready(&device);
+    present = true;
+    return SUCCESS;
+}
+
+int blk_present(void) {
+    return present;
+}
+
+uint64_t blk_capacity(void) {
+    return capacity;
+}
+
+int blk_read_only(void) {
+    return read_only;
+}
+
+// === ЗАПИТИ ===
+
+static int validate(const blk_request_t* request) {
+    if (request->type == BLK_FLUSH) {
+        return virtio_has_feature(&device, VIRTIO_BLK_F_FLUSH) ? SUCCESS : ERROR_INVALID_INPUT;
+    }
+    if (request->type != BLK_READ && request->type != BLK_WRITE) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (request->type == BLK_WRITE && read_only) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (request->count == 0 || request->count > BLK_MAX_SECTORS || !request->buffer ||
+        request->sector >= capacity || capacity - request->sector < request->count) {
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+int blk_submit(blk_request_t** requests, uint32_t count) {
+    if (!present) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint32_t descriptors = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (validate(requests[i]) != SUCCESS) {
+            return ERROR_INVALID_INPUT;
+        }
+        descriptors += requests[i]->type == BLK_FLUSH ? 2 : 3;
+    }
+
+    unsigned long flags = spin_lock_irqsave(&queue_lock);
+    if (queue.num_free < descriptors) {
+        spin_unlock_irqrestore(&queue_lock, flags);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    uint64_t now = rdtsc();
+    for (uint32_t i = 0; i < count; i++) {
+        blk_request_t* request = requests[i];
+        request->header.type = request->type;
+        request->header.reserved = 0;
+        request->header.sector = request->sector;
+        request->device_status = 0xFF;
+        request->status = BLK_PENDING;
+        request->waiter = NULL;
+        request->submitted = now;
+
+        // Заголовок (читає пристрій), дані, байт статусу (пише пристрій)
+        virtq_buf_t bufs[3];
+        uint32_t out = 1;
+        uint32_t in = 1;
+        bufs[0].addr = (uintptr_t)&request->header;
+        bufs[0].len = sizeof(request->header);
+        if (request->type != BLK_FLUSH) {
+            bufs[1].addr = (uintptr_t)request->buffer;
+            bufs[1].len = request->count * BLK_SECTOR_SIZE;
+            if (request->type == BLK_WRITE) {
+                out++;
+            } else {
+                in++;
+            }
+        }
+        bufs[out + in - 1].addr = (uintptr_t)&request->device_status;
+        bufs[out + in - 1].len = 1;
+        virtq_add(&queue, bufs, out, in, request);
+    }
+    in_flight += count;
+    requests_submitted += count;
+    batches++;
+    virtq_kick(&queue);
+    spin_unlock_irqrestore(&queue_lock, flags);
+    return SUCCESS;
+}
+
+int blk_wait(blk_request_t* request) {
+    while (request->status == BLK_PENDING) {
+        if (polling || !use_interrupts) {
+            if (!blk_poll()) {
+                asm volatile("pause");
+            }
+            continue;
+        }
+        // Перевірка і сон з вимкненими перериваннями - завершення не проскочить
+        unsigned long flags = interrupts_save();
+        if (request->status == BLK_PENDING) {
+            request->waiter = sched_current();
+            sched_block();
+        }
+        interrupts_restore(flags);
+    }
+    return request->status;
+}
+
+void blk_set_polling(int enabled) {
+    if (!present) {
+        return;
+    }
+    unsigned long flags = spin_lock_irqsave(&queue_lock);
+    polling = enabled;
+    if (enabled) {
+        virtq_disable_interrupts(&queue);
+    } else if (use_interrupts) {
+        virtq_enable_interrupts(&queue, coalesce_threshold());
+    }
+    spin_unlock_irqrestore(&queue_lock, flags);
+    // Те, що завершилось без переривання, забираємо одразу
+    blk_poll();
+}
+
+int blk_polling(void) {
+    return polling || !use_interrupts;
+}
+
+static int blk_sync(uint32_t type, uint64_t sector, void* buffer, uint32_t count) {
+    blk_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.type = type;
+    request.sector = sector;
+    request.buffer = buffer;
+    request.count = count;
+    blk_request_t* batch = &request;
+    int result = blk_submit(&batch, 1);
+    return result == SUCCESS ? blk_wait(&request) : result;
+}
+
+int blk_read(uint64_t sector, void* buffer, uint32_t count) {
+    return blk_sync(BLK_READ, sector, buffer, count);
+}
+
+int blk_write(uint64_t sector, const void* buffer, uint32_t count) {
+    return blk_sync(BLK_WRITE, sector, (void*)buffer, count);
+}
+
+int blk_flush(void) {
+    return blk_sync(BLK_FLUSH, 0, NULL, 0);
+}
+
+// === СТАТИСТИКА ===
+
+void blk_print_stats(void) {
+    if (!present) {
+        terminal_writestring("virtio-blk не знайдено (QEMU -drive file=...,if=virtio)\n");
+        return;
+    }
+    char buffer[24];
+    terminal_writestring("virtio-blk ");
+    uint64toa(device.pci->bus, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_putchar(':');
+    uint64toa(device.pci->slot, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_putchar('.');
+    terminal_writeuint(device.pci->function);
+    terminal_writestring(": ");
+    terminal_writeuint(capacity >> 11);
+    terminal_writestring(" МБ (");
+    terminal_writeuint(capacity);
+    terminal_writestring(" секторів), блок ");
+    terminal_writeuint(block_size);
+    terminal_writestring(read_only ? " Б, лише читання\n" : " Б\n");
+
+    terminal_writestring("Черга: ");
+    terminal_writeuint(queue.size);
+    terminal_writestring(" дескрипторів, вільних ");
+    terminal_writeuint(queue.num_free);
+    terminal_writestring(", у польоті ");
+    terminal_writeuint(in_flight);
+    terminal_writestring(queue.event_idx ? ", EVENT_IDX" : "");
+    terminal_writestring("\nЗавершення: ");
+    if (!use_interrupts) {
+        terminal_writestring("лише опитування (немає MSI-X/APIC)\n");
+    } else {
+        terminal_writestring(polling ? "опитування" : "переривання");
+        terminal_writestring(", MSI-X вектор ");
+        terminal_writeuint((uint32_t)vector);
+        terminal_writestring("\n");
+    }
+
+    terminal_writestring("Запитів: ");
+    terminal_writeuint(requests_submitted);
+    terminal_writestring(" подано, ");
+    terminal_writeuint(requests_completed);
+    terminal_writestring(" завершено, ");
+    terminal_writeuint(requests_failed);
+    terminal_writestring(" з помилкою\n");
+    terminal_writestring("Пакетів: ");
+    terminal_writeuint(batches);
+    terminal_writestring(", дзвінків: ");
+    terminal_writeuint(queue.kicks);
+    terminal_writestring(" (пропущено ");
+    terminal_writeuint(queue.kicks_suppressed);
+    terminal_writestring(")\nПереривань: ");
+    terminal_writeuint(interrupts);
+    if (interrupts) {
+        terminal_writestring(", завершень на переривання ");
+        terminal_writetenths(div64_u32((requests_completed - polled) * 10, (uint32_t)interrupts, NULL));
+    }
+    terminal_writestring("\nОпитуванням забрано: ");
+    terminal_writeuint(polled);
+    terminal_writestring("\nПрочитано ");
+    terminal_writeuint(bytes_read >> 10);
+    terminal_writestring(" КБ, записано ");
+    terminal_writeuint(bytes_written >> 10);
+    terminal_writestring(" КБ\n");
+    if (requests_completed) {
+        terminal_writestring("Затримка: середня ");
+        uint64_t average_ns = div64_u32(tsc_cycles_to_ns(latency_cycles), (uint32_t)requests_completed, NULL);
+        terminal_writetenths(div64_u32(average_ns, 100, NULL));
+        terminal_writestring(" мкс, найбільша ");
+        terminal_writetenths(div64_u32(tsc_cycles_to_ns(max_latency_cycles), 100, NULL));
+        terminal_writestring(" мкс\n");
+    }
+}
+
+// === БЕНЧМАРК ===
+
+static blk_request_t bench_requests[BLK_BENCH_MAX_DEPTH];
+static blk_request_t* volatile bench_completed = NULL;
+static thread_t* bench_waiter = NULL;
+static uint32_t bench_seed = 2463534242u;
+
+static void bench_done(blk_request_t* request) {
+    request->next = bench_completed;
+    bench_completed = request;
+    sched_wakeup(bench_waiter);
+}
+
+static uint64_t bench_random_sector(uint32_t sectors) {
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+    uint64_t blocks = div64_u32(capacity, sectors, NULL);
+    uint32_t limit = blocks > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)blocks;
+    return (uint64_t)(bench_seed % limit) * sectors;
+}
+
+// Глибина depth тримається до кінця: завершені подаються знову одним пакетом
+static int bench_run_depth(uint32_t depth, uint32_t sectors, uint64_t* cycles) {
+    blk_request_t* batch[BLK_BENCH_MAX_DEPTH];
+    uint32_t issued = 0;
+    uint32_t finished = 0;
+    int result = SUCCESS;
+
+    bench_completed = NULL;
+    bench_waiter = sched_current();
+    for (uint32_t i = 0; i < depth; i++) {
+        bench_requests[i].sector = bench_random_sector(sectors);
+        batch[i] = &bench_requests[i];
+    }
+    uint64_t start = rdtsc();
+    if (blk_submit(batch, depth) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    issued = depth;
+
+    while (finished < BLK_BENCH_REQUESTS) {
+        unsigned long flags = interrupts_save();
+        while (!bench_completed) {
+            if (blk_polling()) {
+                interrupts_restore(flags);
+                blk_poll();
+                flags = interrupts_save();
+            } else {
+                sched_block();
+            }
+        }
+        blk_request_t* list = bench_completed;
+        bench_completed = NULL;
+        interrupts_restore(flags);
+
+        uint32_t count = 0;
+        for (; list; list = list->next) {
+            finished++;
+            if (list->status != SUCCESS) {
+                result = ERROR_IO;
+            }
+            if (issued < BLK_BENCH_REQUESTS) {
+                list->sector = bench_random_sector(sectors);
+                batch[count++] = list;
+                issued++;
+            }
+        }
+        if (count && blk_submit(batch, count) != SUCCESS) {
+            result = ERROR_BUFFER_OVERFLOW;
+            break;
+        }
+    }
+    *cycles = rdtsc() - start;
+
+    // Після помилки подачі дочікуємося решти, щоб буфери не лишились у польоті
+    while (in_flight) {
+        blk_poll();
+    }
+    bench_waiter = NULL;
+    return result;
+}
+
+static void bench_mode(uint32_t sectors, uint32_t max_depth) {
+    terminal_writestring(" Глибина      IOPS     МБ/с  Затримка, мкс  Переривань/запит  Дзвінків/запит\n");
+    for (uint32_t depth = 1; depth <= max_depth; depth *= 2) {
+        uint64_t irq_before = interrupts;
+        uint64_t kicks_before = queue.kicks;
+        uint64_t latency_before = latency_cycles;
+        uint64_t cycles;
+        if (bench_run_depth(depth, sectors, &cycles) != SUCCESS) {
+            terminal_writestring("Помилка вводу-виводу на глибині ");
+            terminal_writeuint(depth);
+            terminal_writestring("\n");
+            return;
+        }
+        uint64_t iops = tsc_per_second(BLK_BENCH_REQUESTS, cycles);
+        uint64_t bytes_per_second = iops * sectors * BLK_SECTOR_SIZE;
+        uint64_t latency_ns = tsc_cycles_to_ns(latency_cycles - latency_before);
+
+        terminal_writeuint_width(depth, 8);
+        terminal_writeuint_width(iops, 10);
+        terminal_writeuint_width(bytes_per_second >> 20, 9);
+        terminal_writestring("    ");
+        terminal_writeuint_width(div64_u32(latency_ns, 1000 * BLK_BENCH_REQUESTS, NULL), 11);
+        terminal_writestring("    ");
+        terminal_writeuint_width(div64_u32((interrupts - irq_before) * 100, BLK_BENCH_REQUESTS, NULL), 11);
+        terminal_writestring("%    ");
+        terminal_writeuint_width(div64_u32((queue.kicks - kicks_before) * 100, BLK_BENCH_REQUESTS, NULL), 11);
+        terminal_writestring("%\n");
+    }
+}
+
+void blk_benchmark(uint32_t block_kb) {
+    if (!present) {
+        terminal_writestring("virtio-blk не знайдено (QEMU -drive file=...,if=virtio)\n");
+        return;
+    }
+    uint32_t sectors = block_kb * 1024 / BLK_SECTOR_SIZE;
+    uint32_t pages = (block_kb * 1024 + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (capacity < sectors) {
+        terminal_writestring("Диск менший за блок\n");
+        return;
+    }
+    // Три дескриптори на запит - глибина обмежена розміром черги
+    uint32_t max_depth = BLK_BENCH_MAX_DEPTH;
+    while (max_depth * 3 > queue.size) {
+        max_depth /= 2;
+    }
+
+    uint32_t allocated = 0;
+    for (; allocated < max_depth; allocated++) {
+        blk_request_t* request = &bench_requests[allocated];
+        memset(request, 0, sizeof(*request));
+        request->buffer = (void*)pmm_alloc_frames(pages);
+        if (!request->buffer) {
+            break;
+        }
+        request->type = BLK_READ;
+        request->count = sectors;
+        request->done = bench_done;
+    }
+    if (allocated < max_depth) {
+        terminal_writestring("Недостатньо пам'яті для буферів\n");
+    } else {
+        int was_polling = polling;
+        terminal_writestring("virtio-blk: випадкове читання блоками ");
+        terminal_writeuint(block_kb);
+        terminal_writestring(" КБ, ");
+        terminal_writeuint(BLK_BENCH_REQUESTS);
+        terminal_writestring(" запитів на глибину\n");
+        if (use_interrupts) {
+            terminal_writestring("\nПереривання MSI-X (поріг - 3/4 запитів у польоті):\n");
+            blk_set_polling(false);
+            bench_mode(sectors, max_depth);
+        }
+        terminal_writestring("\nОпитування (переривання черги вимкнені):\n");
+        blk_set_polling(true);
+        bench_mode(sectors, max_depth);
+        blk_set_polling(was_polling);
+    }
+    for (uint32_t i = 0; i < allocated; i++) {
+        pmm_free_frames((uintptr_t)bench_requests[i].buffer, pages);
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef BLK_H
+#define BLK_H
+
+#include "kernel.h"
+#include "sched.h"
+
+// Блоковий пристрій virtio-blk (QEMU -drive if=virtio): асинхронні запити
+// в одній черзі, пакетна подача одним дзвінком, завершення з перериванням
+// MSI-X після кількох запитів (EVENT_IDX) або опитуванням
+
+#define BLK_SECTOR_SIZE         512
+#define BLK_QUEUE_SIZE          256
+
+// Найбільший запит: один дескриптор даних на неперервний буфер
+#define BLK_MAX_SECTORS         8192
+
+// Типи запитів (коди virtio-blk)
+#define BLK_READ                0
+#define BLK_WRITE               1
+#define BLK_FLUSH               4
+
+// Стан запиту до завершення; далі SUCCESS або ERROR_*
+#define BLK_PENDING             1
+
+// Можливості virtio-blk (номери бітів)
+#define VIRTIO_BLK_F_RO         5
+#define VIRTIO_BLK_F_BLK_SIZE   6
+#define VIRTIO_BLK_F_FLUSH      9
+
+// Конфігурація пристрою: ємність у секторах, розмір блока
+#define VIRTIO_BLK_CFG_CAPACITY 0x00
+#define VIRTIO_BLK_CFG_BLK_SIZE 0x14
+
+// Переривання - коли завершиться 3/4 запитів у польоті (як відкладений
+// callback у Linux); знаменник - дріб порогу
+#define BLK_COALESCE_NUM        3
+#define BLK_COALESCE_DEN        4
+
+// Бенчмарк: запитів на кожну глибину черги
+#define BLK_BENCH_REQUESTS      4096
+#define BLK_BENCH_MAX_DEPTH     64
+
+typedef struct blk_request blk_request_t;
+typedef void (*blk_done_t)(blk_request_t* request);
+
+// Запит і буфер - у пам'яті з identity-відображенням (купа, pmm, стеки
+// потоків): їхні адреси передаються пристрою як фізичні
+struct blk_request {
+    uint32_t type;
+    uint32_t count;                 // секторів
+    uint64_t sector;
+    void* buffer;
+    blk_done_t done;                // з переривання або blk_poll, поза блокуванням черги
+    void* arg;
+    volatile int status;
+
+    // Службові поля драйвера
+    struct {
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t sector;
+    } __attribute__((packed)) header;
+    volatile uint8_t device_status;
+    thread_t* waiter;
+    uint64_t submitted;
+    blk_request_t* next;
+};
+
+// Пошук пристрою, узгодження, черга та MSI-X
+int blk_init(void);
+int blk_present(void);
+uint64_t blk_capacity(void);
+int blk_read_only(void);
+
+// Пакет запитів: усі або жоден, один дзвінок пристрою
+int blk_submit(blk_request_t** requests, uint32_t count);
+
+// Забрати завершені запити без переривання; повертає їх кількість
+uint32_t blk_poll(void);
+
+// Дочекатися запиту: сон до переривання або опитування; повертає статус
+int blk_wait(blk_request_t* request);
+
+// Режим опитування: переривання черги вимкнені, blk_wait крутиться на кільці
+void blk_set_polling(int enabled);
+int blk_polling(void);
+
+// Синхронні обгортки
+int blk_read(uint64_t sector, void* buffer, uint32_t count);
+int blk_write(uint64_t sector, const void* buffer, uint32_t count);
+int blk_flush(void);
+
+// Статистика та бенчмарк (IOPS і МБ/с на глибинах 1-64)
+void blk_print_stats(void);
+void blk_benchmark(uint32_t block_kb);
+
+#endif
@@ -0,0 +1,159 @@
+#include "boot.h"
+#include "multiboot.h"
+#include "sched.h"
+#include "timer.h"
+
+typedef struct {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    int deferred;
+} boot_phase_t;
+
+typedef struct {
+    const char* name;
+    boot_fn_t fn;
+} boot_deferred_t;
+
+// Заповнюють _start у kernel.asm/kernel64.asm до будь-якого коду на C
+uint32_t boot_stub_marker;
+uint64_t boot_stub_tsc;
+uint64_t boot_entry_tsc;
+
+static boot_phase_t phases[BOOT_PHASES_MAX];
+static uint32_t phase_count = 0;
+static uint64_t last_tsc = 0;
+
+static boot_deferred_t deferred[BOOT_DEFERRED_MAX];
+static uint32_t deferred_count = 0;
+static uint32_t deferred_left = 0;
+
+static int fastboot = false;
+static uint64_t ready_tsc = 0;
+
+static void record(const char* name, uint64_t start, uint64_t end, int is_deferred) {
+    unsigned long flags = interrupts_save();
+    if (phase_count < BOOT_PHASES_MAX) {
+        phases[phase_count].name = name;
+        phases[phase_count].start = start;
+        phases[phase_count].end = end;
+        phases[phase_count].deferred = is_deferred;
+        phase_count++;
+    }
+    interrupts_restore(flags);
+}
+
+void boot_init(void) {
+    fastboot = multiboot_cmdline_has("fastboot");
+}
+
+int boot_fastboot(void) {
+    return fastboot;
+}
+
+void boot_phase(const char* name) {
+    uint64_t now = rdtsc();
+    record(name, last_tsc ? last_tsc : boot_entry_tsc, now, false);
+    last_tsc = now;
+}
+
+void boot_run(const char* name, boot_fn_t fn) {
+    if (fastboot && deferred_count < BOOT_DEFERRED_MAX) {
+        deferred[deferred_count].name = name;
+        deferred[deferred_count].fn = fn;
+        deferred_count++;
+        deferred_left++;
+        return;
+    }
+    fn();
+    boot_phase(name);
+}
+
+// === ВІДКЛАДЕНІ ФАЗИ ===
+
+static void run_deferred(void) {
+    for (uint32_t i = 0; i < deferred_count; i++) {
+        uint64_t start = rdtsc();
+        deferred[i].fn();
+        record(deferred[i].name, start, rdtsc(), true);
+        deferred_left--;
+    }
+}
+
+// Нижчий пріоритет за shell: виконується, поки shell чекає на ввід, а
+// надруковане вклинюється між запрошенням і відновленим рядком
+static void deferred_thread(void* arg) {
+    (void)arg;
+    int at_prompt = shell_at_prompt();
+    if (at_prompt) {
+        terminal_putchar('\n');
+    }
+    run_deferred();
+    if (at_prompt && shell_at_prompt()) {
+        shell_redraw_prompt();
+    }
+}
+
+void boot_ready(void) {
+    ready_tsc = rdtsc();
+    record("запрошення shell", last_tsc ? last_tsc : boot_entry_tsc, ready_tsc, false);
+    last_tsc = ready_tsc;
+
+    if (deferred_count == 0) {
+        return;
+    }
+    if (!sched_active() || !thread_create("boot-deferred", deferred_thread, NULL, SCHED_PRIO_DEFAULT)) {
+        run_deferred();
+    }
+}
+
+// === ХРОНОЛОГІЯ ===
+
+static void write_row(const char* name, uint64_t end, uint64_t duration, int is_deferred) {
+    size_t length = 0;
+    for (const char* p = name; *p; p++) {
+        // Символів, а не байтів UTF-8
+        length += ((uint8_t)*p & 0xC0) != 0x80;
+    }
+    terminal_writestring("  ");
+    terminal_writestring(name);
+    for (; length < 26; length++) {
+        terminal_putchar(' ');
+    }
+    terminal_writems(tsc_cycles_to_ns(end), 6);
+    terminal_writems(tsc_cycles_to_ns(duration), 9);
+    terminal_writestring(is_deferred ? "  відкладено\n" : "\n");
+}
+
+void boot_print_timeline(void) {
+    int packed = boot_stub_marker == BOOT_STUB_MARKER;
+
+    terminal_writestring("Хронологія завантаження (мс від скидання, тривалість фази):\n");
+    if (packed) {
+        write_row("прошивка та GRUB", boot_stub_tsc, boot_stub_tsc, false);
+        write_row("розпакування LZ4", boot_entry_tsc, boot_entry_tsc - boot_stub_tsc, false);
+    } else {
+        write_row("прошивка та GRUB", boot_entry_tsc, boot_entry_tsc, false);
+    }
+
+    unsigned long flags = interrupts_save();
+    uint32_t count = phase_count;
+    interrupts_restore(flags);
+    for (uint32_t i = 0; i < count; i++) {
+        write_row(phases[i].name, phases[i].end, phases[i].end - phases[i].start, phases[i].deferred);
+    }
+
+    terminal_writestring("Ядро до запрошення: ");
+    terminal_writems(tsc_cycles_to_ns(ready_tsc - boot_entry_tsc), 0);
+    terminal_writestring(" мс, від скидання: ");
+    terminal_writems(tsc_cycles_to_ns(ready_tsc), 0);
+    terminal_writestring(" мс (");
+    terminal_writestring(packed ? "стиснуте ядро" : "нестиснуте ядро");
+    terminal_writestring(fastboot ? ", fastboot" : "");
+    terminal_writestring(")\n");
+    if (deferred_left) {
+        terminal_writestring("Відкладених фаз ще виконується: ");
+        terminal_writeuint(deferred_left);
+        terminal_writestring("\n");
+    }
+}
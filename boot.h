@@ -0,0 +1,33 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "kernel.h"
+
+// Хронологія завантаження: мітки TSC фаз kernel_main від входу в _start,
+// а для стиснутого ядра - ще й від входу в розпакувальник stub. TSC у QEMU
+// рахує від скидання машини, тож перша мітка показує і час до ядра
+// (прошивка та GRUB). Параметр ядра fastboot відкладає логотип, звіти
+// пам'яті та опитування PCI-пристроїв до появи запрошення shell
+
+#define BOOT_PHASES_MAX         32
+#define BOOT_DEFERRED_MAX       8
+
+// Мітка, з якою stub/lz4stub.c передає керування ядру (ECX)
+#define BOOT_STUB_MARKER        0x345A4C4E
+
+typedef void (*boot_fn_t)(void);
+
+// Після multiboot_init: режим fastboot з командного рядка
+void boot_init(void);
+int boot_fastboot(void);
+
+// Мітка кінця фази; boot_run виконує фазу одразу або відкладає у fastboot
+void boot_phase(const char* name);
+void boot_run(const char* name, boot_fn_t fn);
+
+// Перед запрошенням shell: мітка готовності, потік відкладених фаз
+void boot_ready(void);
+
+void boot_print_timeline(void);
+
+#endif
@@ -0,0 +1,985 @@
+#include "cache.h"
+#include "pmm.h"
+#include "sched.h"
+#include "timer.h"
+#include "string.h"
+
+typedef struct {
+    uint32_t device;                // CACHE_MAX_DEVICES - вільний слот
+    uint16_t hash_next;
+    uint64_t block;
+} cache_ghost_t;
+
+typedef struct {
+    int present;
+    int read_only;
+    uint64_t blocks;
+
+    // Read-ahead: останній блок, перший ще не запитаний, поточне вікно
+    uint64_t ra_last;
+    uint64_t ra_end;
+    uint32_t ra_window;
+} cache_device_t;
+
+static cache_page_t pages[CACHE_PAGES];
+static uint16_t hash_table[CACHE_HASH_SIZE];
+static cache_ghost_t ghosts[CACHE_GHOSTS];
+static uint16_t ghost_table[CACHE_GHOST_HASH_SIZE];
+static uint32_t ghost_next = 0;
+static cache_device_t devices[CACHE_MAX_DEVICES];
+static spinlock_t cache_lock = SPINLOCK_INIT;
+static int initialized = false;
+static int readahead_enabled = true;
+
+// Сторінки з кадрами: [0, pages_allocated); вільні зв'язані через next
+static uint32_t pages_allocated = 0;
+static uint16_t free_head = CACHE_NONE;
+
+// A1in - FIFO нових сторінок, Am - кільце CLOCK гарячих
+static uint16_t a1in_head = CACHE_NONE;     // найстаріша
+static uint16_t a1in_tail = CACHE_NONE;
+static uint32_t a1in_count = 0;
+static uint16_t am_hand = CACHE_NONE;
+static uint32_t am_count = 0;
+
+static uint32_t dirty_count = 0;
+static volatile uint32_t writes_in_flight = 0;
+static uint32_t writeback_cursor = 0;
+
+// Потік фонового запису
+static thread_t* flusher = NULL;
+static timer_event_t flush_timer;
+static volatile int flush_requested = false;
+
+// Статистика
+static uint64_t hits = 0;
+static uint64_t misses = 0;
+static uint64_t ghost_hits = 0;
+static uint64_t evictions = 0;
+static uint64_t read_requests = 0;
+static uint64_t readahead_pages = 0;
+static uint64_t readahead_used = 0;
+static uint64_t readahead_wasted = 0;
+static uint64_t writeback_pages = 0;
+static uint64_t writeback_batches = 0;
+static uint64_t read_errors = 0;
+static uint64_t write_errors = 0;
+
+// === ХЕШ-ІНДЕКС ===
+
+static uint32_t hash_key(uint32_t device, uint64_t block) {
+    uint64_t key = (block ^ ((uint64_t)device << 48)) * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(key >> 32);
+}
+
+static uint16_t lookup_locked(uint32_t device, uint64_t block) {
+    uint16_t index = hash_table[hash_key(device, block) & (CACHE_HASH_SIZE - 1)];
+    while (index != CACHE_NONE && (pages[index].block != block || pages[index].device != device)) {
+        index = pages[index].hash_next;
+    }
+    return index;
+}
+
+static void hash_insert(uint16_t index) {
+    uint16_t* bucket = &hash_table[hash_key(pages[index].device, pages[index].block) & (CACHE_HASH_SIZE - 1)];
+    pages[index].hash_next = *bucket;
+    *bucket = index;
+}
+
+static void hash_remove(uint16_t index) {
+    uint16_t* link = &hash_table[hash_key(pages[index].device, pages[index].block) & (CACHE_HASH_SIZE - 1)];
+    while (*link != index) {
+        link = &pages[*link].hash_next;
+    }
+    *link = pages[index].hash_next;
+}
+
+// === ПРИВИДИ (A1out) ===
+
+// Ключі нещодавно витіснених з A1in: повторне звернення йде одразу в Am
+static void ghost_unlink(uint16_t slot) {
+    cache_ghost_t* ghost = &ghosts[slot];
+    uint16_t* link = &ghost_table[hash_key(ghost->device, ghost->block) & (CACHE_GHOST_HASH_SIZE - 1)];
+    while (*link != slot) {
+        link = &ghosts[*link].hash_next;
+    }
+    *link = ghost->hash_next;
+    ghost->device = CACHE_MAX_DEVICES;
+}
+
+static void ghost_insert(uint32_t device, uint64_t block) {
+    uint16_t slot = (uint16_t)ghost_next;
+    if (++ghost_next == CACHE_GHOSTS) {
+        ghost_next = 0;
+    }
+    // Кільце: найстаріший привид поступається місцем
+    if (ghosts[slot].device != CACHE_MAX_DEVICES) {
+        ghost_unlink(slot);
+    }
+    uint16_t* bucket = &ghost_table[hash_key(device, block) & (CACHE_GHOST_HASH_SIZE - 1)];
+    ghosts[slot].device = device;
+    ghosts[slot].block = block;
+    ghosts[slot].hash_next = *bucket;
+    *bucket = slot;
+}
+
+static int ghost_take(uint32_t device, uint64_t block) {
+    uint16_t slot = ghost_table[hash_key(device, block) & (CACHE_GHOST_HASH_SIZE - 1)];
+    while (slot != CACHE_NONE) {
+        if (ghosts[slot].device == device && ghosts[slot].block == block) {
+            ghost_unlink(slot);
+            return true;
+        }
+        slot = ghosts[slot].hash_next;
+    }
+    return false;
+}
+
+static void ghosts_clear(void) {
+    memset(ghost_table, 0xFF, sizeof(ghost_table));
+    for (uint32_t i = 0; i < CACHE_GHOSTS; i++) {
+        ghosts[i].device = CACHE_MAX_DEVICES;
+    }
+    ghost_next = 0;
+}
+
+// === ЧЕРГИ 2Q ===
+
+static void queue_insert(uint16_t index) {
+    cache_page_t* page = &pages[index];
+    if (page->flags & CACHE_PAGE_HOT) {
+        // Нова гаряча сторінка - перед стрілкою, стрілка дійде до неї останньою
+        if (am_hand == CACHE_NONE) {
+            page->prev = page->next = index;
+            am_hand = index;
+        } else {
+            uint16_t prev = pages[am_hand].prev;
+            page->prev = prev;
+            page->next = am_hand;
+            pages[prev].next = index;
+            pages[am_hand].prev = index;
+        }
+        am_count++;
+    } else {
+        page->prev = a1in_tail;
+        page->next = CACHE_NONE;
+        if (a1in_tail != CACHE_NONE) {
+            pages[a1in_tail].next = index;
+        } else {
+            a1in_head = index;
+        }
+        a1in_tail = index;
+        a1in_count++;
+    }
+}
+
+static void queue_remove(uint16_t index) {
+    cache_page_t* page = &pages[index];
+    if (page->flags & CACHE_PAGE_HOT) {
+        if (page->next == index) {
+            am_hand = CACHE_NONE;
+        } else {
+            pages[page->prev].next = page->next;
+            pages[page->next].prev = page->prev;
+            if (am_hand == index) {
+                am_hand = page->next;
+            }
+        }
+        am_count--;
+    } else {
+        if (page->prev != CACHE_NONE) {
+            pages[page->prev].next = page->next;
+        } else {
+            a1in_head = page->next;
+        }
+        if (page->next != CACHE_NONE) {
+            pages[page->next].prev = page->prev;
+        } else {
+            a1in_tail = page->prev;
+        }
+        a1in_count--;
+    }
+}
+
+// === ВИТІСНЕННЯ ===
+
+static int evictable(const cache_page_t* page) {
+    return page->pin == 0 && !(page->flags & (CACHE_PAGE_DIRTY | CACHE_PAGE_IO));
+}
+
+// Найстаріша вільна для витіснення сторінка A1in
+static uint16_t victim_a1in(void) {
+    for (uint16_t index = a1in_head; index != CACHE_NONE; index = pages[index].next) {
+        if (evictable(&pages[index])) {
+            return index;
+        }
+    }
+    return CACHE_NONE;
+}
+
+// CLOCK: стрілка знімає біт звернення, жертва - перша без нього
+static uint16_t victim_am(void) {
+    for (uint32_t step = 0; am_hand != CACHE_NONE && step < 2 * am_count; step++) {
+        uint16_t index = am_hand;
+        cache_page_t* page = &pages[index];
+        am_hand = page->next;
+        if (page->flags & CACHE_PAGE_REFERENCED) {
+            page->flags &= ~CACHE_PAGE_REFERENCED;
+        } else if (evictable(page)) {
+            return index;
+        }
+    }
+    return CACHE_NONE;
+}
+
+static void drop_locked(uint16_t index) {
+    queue_remove(index);
+    hash_remove(index);
+    pages[index].flags = 0;
+    pages[index].next = free_head;
+    free_head = index;
+}
+
+// Брудні, закріплені та сторінки в польоті не витісняються; NONE - таких немає
+static uint16_t evict_locked(void) {
+    uint16_t victim = CACHE_NONE;
+    if (a1in_count * 100 > CACHE_PAGES * CACHE_A1IN_PERCENT || am_count == 0) {
+        victim = victim_a1in();
+    }
+    if (victim == CACHE_NONE) {
+        victim = victim_am();
+    }
+    if (victim == CACHE_NONE) {
+        victim = victim_a1in();
+    }
+    if (victim == CACHE_NONE) {
+        return CACHE_NONE;
+    }
+
+    cache_page_t* page = &pages[victim];
+    if (!(page->flags & CACHE_PAGE_HOT)) {
+        ghost_insert(page->device, page->block);
+    }
+    if (page->flags & CACHE_PAGE_READAHEAD) {
+        readahead_wasted++;
+    }
+    evictions++;
+    queue_remove(victim);
+    hash_remove(victim);
+    page->flags = 0;
+    return victim;
+}
+
+static uint16_t alloc_locked(void) {
+    if (free_head != CACHE_NONE) {
+        uint16_t index = free_head;
+        free_head = pages[index].next;
+        return index;
+    }
+    if (pages_allocated < CACHE_PAGES) {
+        uintptr_t frame = pmm_alloc_frames(1);
+        if (frame) {
+            pages[pages_allocated].data = (void*)frame;
+            return (uint16_t)pages_allocated++;
+        }
+    }
+    return evict_locked();
+}
+
+static cache_page_t* insert_locked(uint16_t index, uint32_t device, uint64_t block, uint16_t flags) {
+    cache_page_t* page = &pages[index];
+    page->device = device;
+    page->block = block;
+    page->flags = flags;
+    page->pin = 0;
+    page->waiter = NULL;
+    hash_insert(index);
+    queue_insert(index);
+    return page;
+}
+
+// === ВВІД-ВИВІД ===
+
+// Завершення з переривання або blk_poll, переривання вимкнені
+static void page_io_done(blk_request_t* request) {
+    cache_page_t* page = (cache_page_t*)request->arg;
+    spin_lock(&cache_lock);
+    if (request->type == BLK_READ) {
+        if (request->status == SUCCESS) {
+            page->flags |= CACHE_PAGE_VALID;
+        } else {
+            page->flags |= CACHE_PAGE_ERROR;
+            read_errors++;
+        }
+    } else {
+        writes_in_flight--;
+        if (request->status != SUCCESS) {
+            write_errors++;
+            if (!(page->flags & CACHE_PAGE_DIRTY)) {
+                page->flags |= CACHE_PAGE_DIRTY;
+                dirty_count++;
+            }
+        }
+    }
+    page->flags &= ~CACHE_PAGE_IO;
+    thread_t* waiter = page->waiter;
+    page->waiter = NULL;
+    // Невдале читання наперед нікому не потрібне
+    if ((page->flags & CACHE_PAGE_ERROR) && page->pin == 0) {
+        drop_locked((uint16_t)(page - pages));
+    }
+    spin_unlock(&cache_lock);
+    sched_wakeup(waiter);
+}
+
+static void prepare_request(cache_page_t* page, uint32_t type) {
+    blk_request_t* request = &page->request;
+    request->type = type;
+    request->count = CACHE_BLOCK_SECTORS;
+    request->sector = page->block * CACHE_BLOCK_SECTORS;
+    request->buffer = page->data;
+    request->done = page_io_done;
+    request->arg = page;
+}
+
+// Черга пристрою повна - звільнити місце завершеннями і спробувати ще
+static int submit(blk_request_t** batch, uint32_t count) {
+    for (uint32_t attempt = 0; ; attempt++) {
+        int result = blk_submit(batch, count);
+        if (result != ERROR_BUFFER_OVERFLOW || attempt == 10000) {
+            return result;
+        }
+        if (!blk_poll()) {
+            sched_yield();
+        }
+    }
+}
+
+// Потоки лише на BSP, куди йде й MSI-X: з вимкненими перериваннями
+// завершення не проскочить між перевіркою прапорця та сном
+static void wait_io(cache_page_t* page) {
+    thread_t* self = sched_current();
+    while (page->flags & CACHE_PAGE_IO) {
+        if (blk_polling()) {
+            if (!blk_poll()) {
+                asm volatile("pause");
+            }
+            continue;
+        }
+        unsigned long flags = interrupts_save();
+        if ((page->flags & CACHE_PAGE_IO) && (!page->waiter || page->waiter == self)) {
+            page->waiter = self;
+            sched_block();
+            interrupts_restore(flags);
+        } else {
+            // Сторінку вже чекає інший потік
+            interrupts_restore(flags);
+            sched_yield();
+        }
+    }
+}
+
+// Невдала подача: сторінки без читачів повертаються у вільні
+static void fail_reads(blk_request_t** batch, uint32_t count) {
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    for (uint32_t i = 0; i < count; i++) {
+        cache_page_t* page = (cache_page_t*)batch[i]->arg;
+        page->flags = (uint16_t)((page->flags & ~CACHE_PAGE_IO) | CACHE_PAGE_ERROR);
+        read_errors++;
+        if (page->pin == 0) {
+            drop_locked((uint16_t)(page - pages));
+        }
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+}
+
+// === READ-AHEAD ===
+
+// Друге послідовне звернення запитує вікно наперед; наступне, вдвічі більше,
+// - коли до кінця прочитаного наперед лишається менше половини вікна
+static void readahead_locked(cache_device_t* dev, uint32_t device, uint64_t block,
+                             blk_request_t** batch, uint32_t* count) {
+    if (block == dev->ra_last) {
+        return;
+    }
+    int sequential = block == dev->ra_last + 1;
+    dev->ra_last = block;
+    if (!sequential) {
+        dev->ra_window = 0;
+        dev->ra_end = block + 1;
+        return;
+    }
+    if (dev->ra_window && dev->ra_end > block + dev->ra_window / 2) {
+        return;
+    }
+    if (dev->ra_window == 0) {
+        dev->ra_window = CACHE_READAHEAD_MIN;
+    } else if (dev->ra_window < CACHE_READAHEAD_MAX) {
+        dev->ra_window *= 2;
+    }
+
+    uint64_t next = dev->ra_end > block + 1 ? dev->ra_end : block + 1;
+    uint64_t end = block + 1 + dev->ra_window;
+    if (end > dev->blocks) {
+        end = dev->blocks;
+    }
+    for (; next < end; next++) {
+        if (lookup_locked(device, next) != CACHE_NONE) {
+            continue;
+        }
+        uint16_t index = alloc_locked();
+        if (index == CACHE_NONE) {
+            break;
+        }
+        cache_page_t* page = insert_locked(index, device, next, CACHE_PAGE_IO | CACHE_PAGE_READAHEAD);
+        prepare_request(page, BLK_READ);
+        batch[(*count)++] = &page->request;
+        readahead_pages++;
+        read_requests++;
+    }
+    dev->ra_end = next;
+}
+
+// === ДОСТУП ===
+
+// fill = false: викликач перезапише всю сторінку, читати пристрій не треба
+static cache_page_t* get_page(uint32_t device, uint64_t block, int fill) {
+    if (device >= CACHE_MAX_DEVICES || !devices[device].present || block >= devices[device].blocks) {
+        return NULL;
+    }
+    cache_device_t* dev = &devices[device];
+    blk_request_t* batch[1 + CACHE_READAHEAD_MAX];
+    uint32_t count = 0;
+    cache_page_t* page;
+
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    for (;;) {
+        uint16_t index = lookup_locked(device, block);
+        if (index != CACHE_NONE) {
+            page = &pages[index];
+            page->pin++;
+            page->flags |= CACHE_PAGE_REFERENCED;
+            if (page->flags & CACHE_PAGE_READAHEAD) {
+                page->flags &= ~CACHE_PAGE_READAHEAD;
+                readahead_used++;
+            }
+            hits++;
+            break;
+        }
+        index = alloc_locked();
+        if (index != CACHE_NONE) {
+            // Нещодавно витіснена з A1in - отже, не разова: одразу в Am
+            int hot = ghost_take(device, block);
+            ghost_hits += (uint64_t)hot;
+            misses++;
+            page = insert_locked(index, device, block, hot ? CACHE_PAGE_HOT : 0);
+            page->pin = 1;
+            if (fill) {
+                page->flags |= CACHE_PAGE_IO;
+                prepare_request(page, BLK_READ);
+                batch[count++] = &page->request;
+                read_requests++;
+            } else {
+                page->flags |= CACHE_PAGE_VALID;
+            }
+            break;
+        }
+        // Усі сторінки брудні або закріплені: записати пакет і повторити
+        spin_unlock_irqrestore(&cache_lock, flags);
+        if (!cache_writeback(CACHE_WRITEBACK_BATCH, true)) {
+            return NULL;
+        }
+        flags = spin_lock_irqsave(&cache_lock);
+    }
+    if (fill && readahead_enabled) {
+        readahead_locked(dev, device, block, batch, &count);
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+
+    // Промах і вікно read-ahead - один пакет, один дзвінок пристрою
+    if (count && submit(batch, count) != SUCCESS) {
+        fail_reads(batch, count);
+    }
+    if (!(page->flags & CACHE_PAGE_VALID)) {
+        wait_io(page);
+    }
+    if (page->flags & CACHE_PAGE_ERROR) {
+        cache_put(page);
+        return NULL;
+    }
+    return page;
+}
+
+cache_page_t* cache_get(uint32_t device, uint64_t block) {
+    return get_page(device, block, true);
+}
+
+void cache_put(cache_page_t* page) {
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    page->pin--;
+    if (page->pin == 0 && (page->flags & CACHE_PAGE_ERROR) && !(page->flags & CACHE_PAGE_IO)) {
+        drop_locked((uint16_t)(page - pages));
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+}
+
+void cache_mark_dirty(cache_page_t* page) {
+    int wake = false;
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    if (!(page->flags & CACHE_PAGE_DIRTY)) {
+        page->flags |= CACHE_PAGE_DIRTY;
+        dirty_count++;
+        wake = dirty_count >= CACHE_DIRTY_HIGH && !flush_requested;
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+    if (wake && flusher) {
+        flush_requested = true;
+        sched_wakeup(flusher);
+    }
+}
+
+int cache_read(uint32_t device, uint64_t offset, void* buffer, size_t size) {
+    uint8_t* out = (uint8_t*)buffer;
+    while (size) {
+        uint32_t in_page = (uint32_t)offset & (CACHE_BLOCK_SIZE - 1);
+        size_t chunk = CACHE_BLOCK_SIZE - in_page;
+        if (chunk > size) {
+            chunk = size;
+        }
+        cache_page_t* page = cache_get(device, offset / CACHE_BLOCK_SIZE);
+        if (!page) {
+            return ERROR_IO;
+        }
+        memcpy(out, (uint8_t*)page->data + in_page, chunk);
+        cache_put(page);
+        out += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+    return SUCCESS;
+}
+
+int cache_write(uint32_t device, uint64_t offset, const void* buffer, size_t size) {
+    if (device >= CACHE_MAX_DEVICES || devices[device].read_only) {
+        return ERROR_INVALID_INPUT;
+    }
+    const uint8_t* in = (const uint8_t*)buffer;
+    while (size) {
+        uint32_t in_page = (uint32_t)offset & (CACHE_BLOCK_SIZE - 1);
+        size_t chunk = CACHE_BLOCK_SIZE - in_page;
+        if (chunk > size) {
+            chunk = size;
+        }
+        // Ціла сторінка перезаписується без читання
+        cache_page_t* page = get_page(device, offset / CACHE_BLOCK_SIZE, chunk != CACHE_BLOCK_SIZE);
+        if (!page) {
+            return ERROR_IO;
+        }
+        memcpy((uint8_t*)page->data + in_page, in, chunk);
+        cache_mark_dirty(page);
+        cache_put(page);
+        in += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+    return SUCCESS;
+}
+
+// === ЗАПИС ===
+
+uint32_t cache_writeback(uint32_t max, int wait) {
+    blk_request_t* batch[CACHE_WRITEBACK_BATCH];
+    uint32_t count = 0;
+    if (max > CACHE_WRITEBACK_BATCH) {
+        max = CACHE_WRITEBACK_BATCH;
+    }
+
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    for (uint32_t scanned = 0; scanned < pages_allocated && count < max && dirty_count; scanned++) {
+        cache_page_t* page = &pages[writeback_cursor];
+        if (++writeback_cursor >= pages_allocated) {
+            writeback_cursor = 0;
+        }
+        if ((page->flags & (CACHE_PAGE_DIRTY | CACHE_PAGE_IO)) != CACHE_PAGE_DIRTY) {
+            continue;
+        }
+        // Зміни під час запису знову позначать сторінку брудною
+        page->flags = (uint16_t)((page->flags & ~CACHE_PAGE_DIRTY) | CACHE_PAGE_IO);
+        dirty_count--;
+        writes_in_flight++;
+        prepare_request(page, BLK_WRITE);
+        batch[count++] = &page->request;
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+    if (!count) {
+        return 0;
+    }
+
+    // Пакет за зростанням секторів: пристрій бачить послідовний прохід
+    for (uint32_t i = 1; i < count; i++) {
+        blk_request_t* request = batch[i];
+        uint32_t j = i;
+        for (; j > 0 && batch[j - 1]->sector > request->sector; j--) {
+            batch[j] = batch[j - 1];
+        }
+        batch[j] = request;
+    }
+
+    if (submit(batch, count) != SUCCESS) {
+        flags = spin_lock_irqsave(&cache_lock);
+        for (uint32_t i = 0; i < count; i++) {
+            cache_page_t* page = (cache_page_t*)batch[i]->arg;
+            page->flags = (uint16_t)((page->flags & ~CACHE_PAGE_IO) | CACHE_PAGE_DIRTY);
+        }
+        dirty_count += count;
+        writes_in_flight -= count;
+        write_errors += count;
+        spin_unlock_irqrestore(&cache_lock, flags);
+        return 0;
+    }
+    writeback_pages += count;
+    writeback_batches++;
+    if (wait) {
+        for (uint32_t i = 0; i < count; i++) {
+            wait_io((cache_page_t*)batch[i]->arg);
+        }
+    }
+    return count;
+}
+
+static void flush_timer_expired(void* arg) {
+    (void)arg;
+    flush_requested = true;
+    sched_wakeup(flusher);
+}
+
+// Раз на CACHE_WRITEBACK_MS або при CACHE_DIRTY_HIGH брудних: усі брудні пакетами
+static void flusher_thread(void* arg) {
+    (void)arg;
+    for (;;) {
+        unsigned long flags = interrupts_save();
+        if (!flush_requested) {
+            timer_cancel(&flush_timer);
+            if (timer_arm(&flush_timer, time_now_ns() + CACHE_WRITEBACK_MS * 1000000ull) == SUCCESS) {
+                sched_block();
+            }
+        }
+        flush_requested = false;
+        interrupts_restore(flags);
+
+        uint64_t errors = write_errors;
+        while (cache_writeback(CACHE_WRITEBACK_BATCH, true) && write_errors == errors) {
+        }
+    }
+}
+
+int cache_sync(void) {
+    if (!initialized) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint64_t errors = write_errors;
+    while (cache_writeback(CACHE_WRITEBACK_BATCH, true) && write_errors == errors) {
+    }
+    // Сторінки, які зараз пише фоновий потік
+    while (writes_in_flight) {
+        if (!blk_poll()) {
+            sched_yield();
+        }
+    }
+    if (write_errors != errors) {
+        return ERROR_IO;
+    }
+    return blk_flush() == ERROR_IO ? ERROR_IO : SUCCESS;
+}
+
+int cache_drop(void) {
+    int result = cache_sync();
+    if (result == ERROR_INVALID_INPUT) {
+        return result;
+    }
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    for (uint32_t i = 0; i < pages_allocated; i++) {
+        if (pages[i].flags && evictable(&pages[i])) {
+            drop_locked((uint16_t)i);
+        }
+    }
+    ghosts_clear();
+    for (uint32_t i = 0; i < CACHE_MAX_DEVICES; i++) {
+        devices[i].ra_last = devices[i].ra_end = 0;
+        devices[i].ra_window = 0;
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+    return result;
+}
+
+void cache_set_readahead(int enabled) {
+    readahead_enabled = enabled;
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int cache_init(void) {
+    if (!blk_present()) {
+        return ERROR_INVALID_INPUT;
+    }
+    memset(hash_table, 0xFF, sizeof(hash_table));
+    ghosts_clear();
+    devices[CACHE_DEV_BLK].present = true;
+    devices[CACHE_DEV_BLK].read_only = blk_read_only();
+    devices[CACHE_DEV_BLK].blocks = blk_capacity() / CACHE_BLOCK_SECTORS;
+    initialized = true;
+
+    if (sched_active()) {
+        timer_event_init(&flush_timer, flush_timer_expired, NULL);
+        flusher = thread_create("cache-flush", flusher_thread, NULL, SCHED_PRIO_DEFAULT);
+    }
+    return SUCCESS;
+}
+
+// === СТАТИСТИКА ===
+
+static uint64_t permille(uint64_t part, uint64_t total) {
+    if (total == 0) {
+        return 0;
+    }
+    // Обидва до 32 біт, щоб ділити через div64_u32
+    while (total > 0xFFFFFFFFull) {
+        part >>= 1;
+        total >>= 1;
+    }
+    return div64_u32(part * 1000, (uint32_t)total, NULL);
+}
+
+void cache_print_stats(void) {
+    if (!initialized) {
+        terminal_writestring("Кеш блоків вимкнено: немає диска virtio-blk\n");
+        return;
+    }
+    uint32_t used = 0;
+    uint32_t pinned = 0;
+    unsigned long flags = spin_lock_irqsave(&cache_lock);
+    for (uint32_t i = 0; i < pages_allocated; i++) {
+        used += pages[i].flags != 0;
+        pinned += pages[i].pin != 0;
+    }
+    uint32_t ghost_count = 0;
+    for (uint32_t i = 0; i < CACHE_GHOSTS; i++) {
+        ghost_count += ghosts[i].device != CACHE_MAX_DEVICES;
+    }
+    spin_unlock_irqrestore(&cache_lock, flags);
+
+    terminal_writestring("Кеш блоків: ");
+    terminal_writeuint(used);
+    terminal_writestring("/");
+    terminal_writeuint(CACHE_PAGES);
+    terminal_writestring(" сторінок (");
+    terminal_writeuint((uint64_t)CACHE_PAGES * CACHE_BLOCK_SIZE >> 20);
+    terminal_writestring(" МБ), диск ");
+    terminal_writeuint(devices[CACHE_DEV_BLK].blocks);
+    terminal_writestring(" блоків\n");
+    terminal_writestring("2Q: A1in ");
+    terminal_writeuint(a1in_count);
+    terminal_writestring(", Am ");
+    terminal_writeuint(am_count);
+    terminal_writestring(", привидів ");
+    terminal_writeuint(ghost_count);
+    terminal_writestring(", брудних ");
+    terminal_writeuint(dirty_count);
+    terminal_writestring(", закріплених ");
+    terminal_writeuint(pinned);
+    terminal_writestring("\n");
+
+    terminal_writestring("Влучань: ");
+    terminal_writeuint(hits);
+    terminal_writestring(", промахів: ");
+    terminal_writeuint(misses);
+    terminal_writestring(" (");
+    terminal_writetenths(permille(hits, hits + misses));
+    terminal_writestring("% влучань), з привидів у Am: ");
+    terminal_writeuint(ghost_hits);
+    terminal_writestring("\nВитіснень: ");
+    terminal_writeuint(evictions);
+    terminal_writestring(", читань з диска: ");
+    terminal_writeuint(read_requests);
+    terminal_writestring("\nRead-ahead: ");
+    terminal_writestring(readahead_enabled ? "увімкнено" : "вимкнено");
+    terminal_writestring(", сторінок ");
+    terminal_writeuint(readahead_pages);
+    terminal_writestring(", використано ");
+    terminal_writeuint(readahead_used);
+    terminal_writestring(", витіснено невикористаними ");
+    terminal_writeuint(readahead_wasted);
+    terminal_writestring("\nЗапис: сторінок ");
+    terminal_writeuint(writeback_pages);
+    terminal_writestring(", пакетів ");
+    terminal_writeuint(writeback_batches);
+    terminal_writestring(", у польоті ");
+    terminal_writeuint(writes_in_flight);
+    terminal_writestring("\nПомилок: читання ");
+    terminal_writeuint(read_errors);
+    terminal_writestring(", запису ");
+    terminal_writeuint(write_errors);
+    terminal_writestring("\n");
+}
+
+void cache_reset_stats(void) {
+    hits = misses = ghost_hits = evictions = read_requests = 0;
+    readahead_pages = readahead_used = readahead_wasted = 0;
+    writeback_pages = writeback_batches = 0;
+    read_errors = write_errors = 0;
+}
+
+// === БЕНЧМАРК ===
+
+// Траса: послідовні проходи по всьому диску впереміш з випадковими
+// читаннями й записами в гарячій області на 3/4 кешу
+typedef struct {
+    uint32_t seed;
+    uint32_t run_left;
+    uint64_t run_block;
+    uint64_t hot_base;
+    uint32_t hot_blocks;
+    uint32_t blocks;
+} cache_trace_t;
+
+static uint32_t trace_random(cache_trace_t* trace, uint32_t limit) {
+    trace->seed ^= trace->seed << 13;
+    trace->seed ^= trace->seed >> 17;
+    trace->seed ^= trace->seed << 5;
+    return trace->seed % limit;
+}
+
+static void trace_start(cache_trace_t* trace, uint64_t blocks) {
+    trace->seed = 2463534242u;
+    trace->run_left = 0;
+    trace->blocks = blocks > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)blocks;
+    trace->hot_blocks = CACHE_PAGES * 3 / 4;
+    trace->hot_base = (trace->blocks - trace->hot_blocks) / 2;
+}
+
+// Повертає true для запису
+static int trace_next(cache_trace_t* trace, uint64_t* block) {
+    if (trace->run_left == 0) {
+        uint32_t kind = trace_random(trace, 100);
+        if (kind >= 3) {
+            *block = trace->hot_base + trace_random(trace, trace->hot_blocks);
+            return kind >= 85;
+        }
+        trace->run_block = trace_random(trace, trace->blocks - 64);
+        trace->run_left = 16 + trace_random(trace, 49);
+    }
+    trace->run_left--;
+    *block = trace->run_block++;
+    return false;
+}
+
+// Запис повертає ті самі дані - вміст образу не змінюється
+static uint64_t replay(void* scratch, uint32_t* failed) {
+    cache_trace_t trace;
+    trace_start(&trace, devices[CACHE_DEV_BLK].blocks);
+    *failed = 0;
+    uint64_t start = rdtsc();
+    for (uint32_t op = 0; op < CACHE_BENCH_OPS; op++) {
+        uint64_t block;
+        int write = trace_next(&trace, &block);
+        if (scratch) {
+            uint64_t sector = block * CACHE_BLOCK_SECTORS;
+            if (blk_read(sector, scratch, CACHE_BLOCK_SECTORS) != SUCCESS ||
+                (write && blk_write(sector, scratch, CACHE_BLOCK_SECTORS) != SUCCESS)) {
+                (*failed)++;
+            }
+            continue;
+        }
+        cache_page_t* page = cache_get(CACHE_DEV_BLK, block);
+        if (!page) {
+            (*failed)++;
+            continue;
+        }
+        if (write) {
+            cache_mark_dirty(page);
+        }
+        cache_put(page);
+    }
+    if (!scratch && cache_sync() != SUCCESS) {
+        (*failed)++;
+    }
+    return rdtsc() - start;
+}
+
+static void bench_report(const char* name, uint64_t cycles, uint32_t failed, int cached) {
+    uint64_t ops = tsc_per_second(CACHE_BENCH_OPS, cycles);
+    terminal_writestring(name);
+    terminal_writeuint_width(ops, 9);
+    terminal_writeuint_width(ops * CACHE_BLOCK_SIZE >> 20, 7);
+    if (cached) {
+        terminal_writestring("  ");
+        terminal_writetenths(permille(hits, hits + misses));
+        terminal_writestring("%");
+        terminal_writeuint_width(read_requests, 9);
+        terminal_writeuint_width(writeback_pages, 8);
+        terminal_writeuint_width(evictions, 10);
+    } else {
+        terminal_writestring("      -");
+        terminal_writeuint_width(CACHE_BENCH_OPS, 9);
+        terminal_writestring("       -         -");
+    }
+    if (failed) {
+        terminal_writestring("  помилок: ");
+        terminal_writeuint(failed);
+    }
+    terminal_writestring("\n");
+}
+
+void cache_benchmark(void) {
+    if (!initialized) {
+        terminal_writestring("Кеш блоків вимкнено: немає диска virtio-blk\n");
+        return;
+    }
+    if (devices[CACHE_DEV_BLK].blocks < CACHE_PAGES * 2) {
+        terminal_writestring("Диск замалий для траси: потрібно щонайменше ");
+        terminal_writeuint((uint64_t)CACHE_PAGES * 2 * CACHE_BLOCK_SIZE >> 20);
+        terminal_writestring(" МБ\n");
+        return;
+    }
+    if (devices[CACHE_DEV_BLK].read_only) {
+        terminal_writestring("Диск лише для читання\n");
+        return;
+    }
+    void* scratch = (void*)pmm_alloc_frames(1);
+    if (!scratch) {
+        terminal_writestring("Недостатньо пам'яті\n");
+        return;
+    }
+    int was_readahead = readahead_enabled;
+    uint32_t failed;
+
+    terminal_writestring("Траса: ");
+    terminal_writeuint(CACHE_BENCH_OPS);
+    terminal_writestring(" звернень по 4 КБ, послідовні проходи + випадкові читання/записи в ");
+    terminal_writeuint((uint64_t)CACHE_PAGES * 3 / 4 * CACHE_BLOCK_SIZE >> 20);
+    terminal_writestring(" МБ\n");
+    terminal_writestring("Режим                  опер./с   МБ/с  влучань  читань  записів  витіснень\n");
+
+    uint64_t cycles = replay(scratch, &failed);
+    bench_report("Без кешу              ", cycles, failed, false);
+
+    cache_set_readahead(false);
+    cache_drop();
+    cache_reset_stats();
+    cycles = replay(NULL, &failed);
+    bench_report("Кеш, без read-ahead   ", cycles, failed, true);
+
+    cache_set_readahead(true);
+    cache_drop();
+    cache_reset_stats();
+    cycles = replay(NULL, &failed);
+    bench_report("Кеш + read-ahead      ", cycles, failed, true);
+
+    // Та сама траса ще раз поверх прогрітого кешу
+    cache_reset_stats();
+    cycles = replay(NULL, &failed);
+    bench_report("Теплий кеш, повтор    ", cycles, failed, true);
+
+    cache_set_readahead(was_readahead);
+    pmm_free_frames((uintptr_t)scratch, 1);
+}
@@ -0,0 +1,90 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "kernel.h"
+#include "blk.h"
+
+// Кеш блоків пристроїв сторінками по 4 КБ за ключем (пристрій, блок):
+// хеш-індекс, витіснення 2Q (FIFO для нових сторінок, CLOCK для гарячих,
+// "привиди" нещодавно витіснених), послідовний read-ahead, фоновий пакетний
+// запис брудних сторінок та закріплення сторінок для доступу без копіювання
+
+#define CACHE_BLOCK_SIZE        4096
+#define CACHE_BLOCK_SECTORS     (CACHE_BLOCK_SIZE / BLK_SECTOR_SIZE)
+
+// Пристрої кешу; поки що лише virtio-blk
+#define CACHE_DEV_BLK           0
+#define CACHE_MAX_DEVICES       1
+
+// 8 МБ даних; кадри беруться з pmm при першому використанні
+#define CACHE_PAGES             2048
+#define CACHE_HASH_SIZE         4096
+#define CACHE_NONE              0xFFFF
+
+// 2Q: частка нових сторінок (A1in) та кількість привидів (A1out)
+#define CACHE_A1IN_PERCENT      25
+#define CACHE_GHOSTS            (CACHE_PAGES / 2)
+#define CACHE_GHOST_HASH_SIZE   2048
+
+// Read-ahead: вікно подвоюється з кожним новим запитом наперед
+#define CACHE_READAHEAD_MIN     4
+#define CACHE_READAHEAD_MAX     32
+
+// Запис: пакет за раз, період фонового потоку, поріг брудних для пробудження
+#define CACHE_WRITEBACK_BATCH   32
+#define CACHE_WRITEBACK_MS      500
+#define CACHE_DIRTY_HIGH        (CACHE_PAGES / 4)
+
+// Бенчмарк: операцій у трасі
+#define CACHE_BENCH_OPS         16384
+
+// Стан сторінки
+#define CACHE_PAGE_VALID        0x01    // дані прочитано
+#define CACHE_PAGE_DIRTY        0x02    // змінена, ще не записана
+#define CACHE_PAGE_IO           0x04    // запит до пристрою в польоті
+#define CACHE_PAGE_REFERENCED   0x08    // біт CLOCK
+#define CACHE_PAGE_READAHEAD    0x10    // прочитана наперед і ще не використана
+#define CACHE_PAGE_HOT          0x20    // у черзі Am, інакше в A1in
+#define CACHE_PAGE_ERROR        0x40    // читання не вдалося
+
+typedef struct {
+    uint32_t device;
+    uint64_t block;
+    void* data;                     // CACHE_BLOCK_SIZE байт, identity-пам'ять
+    volatile uint16_t flags;
+    uint16_t pin;
+    uint16_t hash_next;
+    uint16_t prev;                  // черга A1in або Am
+    uint16_t next;
+    thread_t* waiter;               // чекає кінця читання
+    blk_request_t request;
+} cache_page_t;
+
+// Реєструє наявні пристрої та запускає потік запису
+int cache_init(void);
+
+// Закріплена сторінка з даними блока (читання з пристрою при промаху);
+// NULL - помилка. data можна читати і змінювати до cache_put
+cache_page_t* cache_get(uint32_t device, uint64_t block);
+void cache_put(cache_page_t* page);
+void cache_mark_dirty(cache_page_t* page);
+
+// Копіювання через кеш за байтовим зміщенням
+int cache_read(uint32_t device, uint64_t offset, void* buffer, size_t size);
+int cache_write(uint32_t device, uint64_t offset, const void* buffer, size_t size);
+
+// Записати до max брудних сторінок одним пакетом; повертає кількість
+uint32_t cache_writeback(uint32_t max, int wait);
+
+// Усі брудні сторінки на пристрій і flush; drop ще й витісняє незакріплені
+int cache_sync(void);
+int cache_drop(void);
+
+void cache_set_readahead(int enabled);
+
+// Статистика та бенчмарк
+void cache_print_stats(void);
+void cache_reset_stats(void);
+void cache_benchmark(void);
+
+#endif
@@ -0,0 +1,382 @@
+#include "command.h"
+#include "ramfs.h"
+#include "timer.h"
+#include "trace.h"
+#include "vga.h"
+
+// Довідка: ім'я з аргументами вирівнюється до цієї ширини
+#define HELP_NAME_WIDTH     12
+
+// Вузол trie; діти - список братів, відсортований за символом
+typedef struct {
+    char c;
+    uint16_t command;       // індекс у commands + 1, 0 - не кінець імені
+    uint16_t child;         // 0 - немає (вузол 0 - корінь)
+    uint16_t sibling;
+    uint16_t count;         // команд у піддереві
+} trie_node_t;
+
+static const command_t* commands[COMMAND_MAX];
+static uint32_t command_count = 0;
+
+static trie_node_t trie[COMMAND_TRIE_NODES];
+static uint32_t trie_used = 1;
+
+// Скрипти, що виконуються зараз (вкладені через "run")
+static uint32_t script_depth = 0;
+static uint32_t script_failures = 0;
+
+// Вивід останньої команди скрипта для "expect"; переповнення - лишається хвіст
+static char captured[COMMAND_CAPTURE_MAX];
+static size_t captured_length = 0;
+static int capturing = false;
+
+// === ПРЕФІКСНЕ ДЕРЕВО ===
+
+// Дитина вузла з символом c; create - додати, якщо немає. 0 - немає/нема місця
+static uint32_t trie_child(uint32_t node, char c, int create) {
+    uint16_t* link = &trie[node].child;
+    while (*link && trie[*link].c < c) {
+        link = &trie[*link].sibling;
+    }
+    if (*link && trie[*link].c == c) {
+        return *link;
+    }
+    if (!create || trie_used >= COMMAND_TRIE_NODES) {
+        return 0;
+    }
+    uint32_t fresh = trie_used++;
+    trie[fresh].c = c;
+    trie[fresh].command = 0;
+    trie[fresh].child = 0;
+    trie[fresh].sibling = *link;
+    trie[fresh].count = 0;
+    *link = (uint16_t)fresh;
+    return fresh;
+}
+
+// Вузол префікса: корінь для порожнього, -1 - жодне ім'я так не починається
+static int32_t trie_find(const char* prefix, size_t length) {
+    uint32_t node = 0;
+    for (size_t i = 0; i < length; i++) {
+        node = trie_child(node, prefix[i], false);
+        if (!node) {
+            return -1;
+        }
+    }
+    return (int32_t)node;
+}
+
+int command_register(const command_t* table, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        const command_t* command = &table[i];
+        if (!command->name[0] || !command->handler) {
+            return ERROR_INVALID_INPUT;
+        }
+        if (command_count >= COMMAND_MAX) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+
+        uint32_t node = 0;
+        for (const char* p = command->name; *p; p++) {
+            node = trie_child(node, *p, true);
+            if (!node) {
+                return ERROR_BUFFER_OVERFLOW;
+            }
+        }
+        if (trie[node].command) {
+            return ERROR_INVALID_INPUT;
+        }
+        commands[command_count++] = command;
+        trie[node].command = (uint16_t)command_count;
+
+        // Лічильники піддерев для доповнення
+        node = 0;
+        trie[0].count++;
+        for (const char* p = command->name; *p; p++) {
+            node = trie_child(node, *p, false);
+            trie[node].count++;
+        }
+    }
+    return SUCCESS;
+}
+
+const command_t* command_lookup(const char* name, size_t length) {
+    int32_t node = trie_find(name, length);
+    if (node < 0 || !trie[node].command) {
+        return NULL;
+    }
+    return commands[trie[node].command - 1];
+}
+
+uint32_t command_complete(const char* prefix, size_t length, char* suffix, size_t size) {
+    int32_t found = trie_find(prefix, length);
+    size_t written = 0;
+    if (found < 0) {
+        if (size) {
+            suffix[0] = '\0';
+        }
+        return 0;
+    }
+
+    // Спускаємось, поки шлях однозначний: одна дитина і тут ім'я не закінчується
+    uint32_t node = (uint32_t)found;
+    while (!trie[node].command && trie[node].child && !trie[trie[node].child].sibling &&
+           written + 1 < size) {
+        node = trie[node].child;
+        suffix[written++] = trie[node].c;
+    }
+    if (size) {
+        suffix[written] = '\0';
+    }
+    return trie[found].count;
+}
+
+// Обхід піддерева в алфавітному порядку
+static void print_subtree(uint32_t node) {
+    if (trie[node].command) {
+        terminal_writestring(commands[trie[node].command - 1]->name);
+        terminal_writestring("  ");
+    }
+    for (uint32_t child = trie[node].child; child; child = trie[child].sibling) {
+        print_subtree(child);
+    }
+}
+
+void command_print_matches(const char* prefix, size_t length) {
+    int32_t node = trie_find(prefix, length);
+    if (node >= 0) {
+        print_subtree((uint32_t)node);
+    }
+    terminal_writestring("\n");
+}
+
+// Ширина в символах: байти продовження UTF-8 не рахуються
+static size_t text_width(const char* text) {
+    size_t width = 0;
+    for (; *text; text++) {
+        if (((uint8_t)*text & 0xC0) != 0x80) {
+            width++;
+        }
+    }
+    return width;
+}
+
+void command_print_help(void) {
+    for (uint32_t i = 0; i < command_count; i++) {
+        const command_t* command = commands[i];
+        size_t width = text_width(command->name);
+        terminal_writestring("  ");
+        terminal_writestring(command->name);
+        if (command->usage) {
+            terminal_writestring(" ");
+            terminal_writestring(command->usage);
+            width += 1 + text_width(command->usage);
+        }
+        do {
+            terminal_putchar(' ');
+        } while (++width < HELP_NAME_WIDTH);
+        terminal_writestring("- ");
+        terminal_writestring(command->help);
+        terminal_writestring("\n");
+    }
+}
+
+// === ВИКОНАННЯ ===
+
+// Перші 4 байти команди для точки трасування (декодує tools/symbolize.py)
+static uint32_t command_tag(const char* command) {
+    uint32_t tag = 0;
+    for (int i = 0; i < 4 && command[i]; i++) {
+        tag |= (uint32_t)(uint8_t)command[i] << (i * 8);
+    }
+    return tag;
+}
+
+int command_execute(const char* line) {
+    // Пропускаємо пробіли на початку
+    while (*line == ' ') {
+        line++;
+    }
+    if (!*line) {
+        return SUCCESS;
+    }
+
+    size_t length = 0;
+    while (line[length] && line[length] != ' ') {
+        length++;
+    }
+    const char* args = line + length;
+    while (*args == ' ') {
+        args++;
+    }
+
+    uint64_t start = rdtsc();
+    trace(TRACE_CMD_BEGIN, command_tag(line), 0);
+    const command_t* command = command_lookup(line, length);
+    int status;
+    if (command) {
+        status = command->handler(args);
+    } else {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Невідома команда: ");
+        terminal_writestring(line);
+        terminal_writestring("\n");
+        terminal_writestring("Введіть 'help' для списку команд.\n");
+        status = ERROR_INVALID_INPUT;
+    }
+    trace(TRACE_CMD_END, (uint32_t)(rdtsc() - start), 0);
+
+    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
+    return status;
+}
+
+// === СКРИПТИ ===
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+int command_run_script(const char* path) {
+    ramfs_node_t* node = ramfs_lookup(path);
+    if (!node || node->type != RAMFS_FILE) {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Немає такого скрипта: ");
+        terminal_writestring(path);
+        terminal_writestring("\n");
+        return ERROR_INVALID_INPUT;
+    }
+    if (script_depth >= COMMAND_SCRIPT_DEPTH) {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Забагато вкладених скриптів\n");
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    // Текст читається прямо з initrd; рядок копіюється лише заради '\0'
+    const void* data;
+    size_t length = ramfs_read(node, 0, node->extent.length, &data);
+    const char* text = data;
+    char line[COMMAND_LINE_MAX];
+    uint32_t executed = 0;
+    uint32_t failed = 0;
+
+    if (script_depth++ == 0) {
+        script_failures = 0;
+        vga_set_batch(true);
+    }
+    uint64_t start = rdtsc();
+    size_t pos = 0;
+    while (pos < length) {
+        size_t end = pos;
+        while (end < length && text[end] != '\n') {
+            end++;
+        }
+        size_t next = end + 1;
+        while (pos < end && is_blank(text[pos])) {
+            pos++;
+        }
+        while (end > pos && is_blank(text[end - 1])) {
+            end--;
+        }
+
+        if (pos < end && text[pos] != '#') {
+            size_t size = end - pos;
+            int status = ERROR_BUFFER_OVERFLOW;
+            if (size < sizeof(line)) {
+                memcpy(line, text + pos, size);
+                line[size] = '\0';
+                // Ехо як в інтерактивному shell - лог читається так само
+                terminal_writestring("nexus> ");
+                terminal_writestring(line);
+                terminal_writestring("\n");
+                // "expect" перевіряє вивід попередньої команди, тож його не чіпає
+                int check = strncmp(line, "expect", 6) == 0 && (line[6] == ' ' || !line[6]);
+                if (!check) {
+                    captured_length = 0;
+                    capturing = true;
+                }
+                status = command_execute(line);
+                capturing = false;
+            } else {
+                terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+                terminal_writestring("Задовгий рядок скрипта\n");
+                terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
+            }
+            executed++;
+            if (status != SUCCESS) {
+                failed++;
+                script_failures++;
+            }
+        }
+        pos = next;
+    }
+    uint64_t cycles = rdtsc() - start;
+
+    terminal_setcolor(vga_entry_color(failed ? VGA_COLOR_LIGHT_RED : VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+    terminal_writestring("Скрипт ");
+    terminal_writestring(path);
+    terminal_writestring(": команд ");
+    terminal_writeuint(executed);
+    terminal_writestring(", невдалих ");
+    terminal_writeuint(failed);
+    terminal_writestring(", ");
+    terminal_writems(tsc_cycles_to_ns(cycles), 0);
+    terminal_writestring(" мс\n");
+    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
+
+    if (--script_depth == 0) {
+        vga_set_batch(false);
+    }
+    return (int)failed;
+}
+
+int command_script_failed(void) {
+    return script_failures != 0;
+}
+
+// === ПЕРЕВІРКА ВИВОДУ ===
+
+void command_capture(const char* data, size_t size) {
+    if (!capturing) {
+        return;
+    }
+    unsigned long flags = interrupts_save();
+    if (size > COMMAND_CAPTURE_MAX) {
+        data += size - COMMAND_CAPTURE_MAX;
+        size = COMMAND_CAPTURE_MAX;
+    }
+    if (captured_length + size > COMMAND_CAPTURE_MAX) {
+        // Відкидаємо щонайменше половину, щоб не зсувати буфер на кожен символ
+        size_t drop = captured_length + size - COMMAND_CAPTURE_MAX;
+        if (drop < COMMAND_CAPTURE_MAX / 2) {
+            drop = COMMAND_CAPTURE_MAX / 2;
+        }
+        if (drop > captured_length) {
+            drop = captured_length;
+        }
+        memmove(captured, captured + drop, captured_length - drop);
+        captured_length -= drop;
+    }
+    memcpy(captured + captured_length, data, size);
+    captured_length += size;
+    interrupts_restore(flags);
+}
+
+int command_expect(const char* text) {
+    if (script_depth == 0) {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("expect працює лише у скриптах\n");
+        return ERROR_INVALID_INPUT;
+    }
+    size_t length = strlen(text);
+    for (size_t i = 0; length <= captured_length && i <= captured_length - length; i++) {
+        if (memcmp(captured + i, text, length) == 0) {
+            return SUCCESS;
+        }
+    }
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("Очікувалося у виводі: ");
+    terminal_writestring(text);
+    terminal_writestring("\n");
+    return ERROR_INVALID_INPUT;
+}
@@ -0,0 +1,63 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "kernel.h"
+
+// Реєстр команд shell: ім'я, обробник, синтаксис і довідка в одній таблиці.
+// Пошук і доповнення Tab - через префіксне дерево (trie) імен
+
+#define COMMAND_MAX             64
+#define COMMAND_TRIE_NODES      512
+#define COMMAND_LINE_MAX        256
+
+// Вкладені "run" у скриптах
+#define COMMAND_SCRIPT_DEPTH    4
+
+// Скільки останніх байтів виводу команди скрипта бачить "expect"
+#define COMMAND_CAPTURE_MAX     4096
+
+// Обробник отримує аргументи без пробілів на початку ("" - без аргументів)
+// і повертає SUCCESS або ERROR_* - скрипт рахує невдалі команди
+typedef int (*command_handler_t)(const char* args);
+
+typedef struct {
+    const char* name;
+    const char* usage;          // аргументи для довідки, NULL - без аргументів
+    const char* help;
+    command_handler_t handler;
+} command_t;
+
+// Реєстрація таблиці команд (таблиця має жити весь час роботи ядра)
+int command_register(const command_t* commands, uint32_t count);
+
+// Точний пошук за іменем довжини length; NULL - немає такої команди
+const command_t* command_lookup(const char* name, size_t length);
+
+// Виконання рядка "ім'я аргументи"; невідома команда - ERROR_INVALID_INPUT
+int command_execute(const char* line);
+
+// Доповнення префікса імені: у suffix - спільне продовження всіх збігів,
+// повертає кількість команд з таким префіксом
+uint32_t command_complete(const char* prefix, size_t length, char* suffix, size_t size);
+
+// Список команд з префіксом (друге натискання Tab)
+void command_print_matches(const char* prefix, size_t length);
+
+// Довідка з таблиці в порядку реєстрації
+void command_print_help(void);
+
+// Скрипт з initrd: рядок - команда, '#' - коментар. Вивід пакетний, у кінці -
+// підсумок; повертає кількість невдалих команд або ERROR_INVALID_INPUT
+int command_run_script(const char* path);
+
+// Чи були невдалі команди у скриптах, що виконуються
+int command_script_failed(void);
+
+// Вивід терміналу під час команди скрипта (викликає terminal_write)
+void command_capture(const char* data, size_t size);
+
+// "expect": чи містить вивід попередньої команди скрипта text. Невдача
+// друкує очікуване і повертає ERROR_INVALID_INPUT - скрипт її порахує
+int command_expect(const char* text);
+
+#endif
@@ -0,0 +1,197 @@
+#include "cpu.h"
+
+cpu_t cpus[SMP_MAX_CPUS];
+uint32_t cpu_features = 0;
+
+// Біти CPUID
+#define CPUID_EDX_FXSR          (1u << 24)
+#define CPUID_EDX_SSE2          (1u << 26)
+#define CPUID_ECX_MONITOR       (1u << 3)
+#define CPUID_ECX_X2APIC        (1u << 21)
+#define CPUID_ECX_XSAVE         (1u << 26)
+#define CPUID_ECX_AVX           (1u << 28)
+#define CPUID_7_EBX_AVX2        (1u << 5)
+#define CPUID_7_EBX_ERMS        (1u << 9)
+
+#define CR0_MP                  (1u << 1)
+#define CR0_EM                  (1u << 2)
+#define CR4_OSFXSR              (1u << 9)
+#define CR4_OSXMMEXCPT          (1u << 10)
+#define CR4_OSXSAVE             (1u << 18)
+
+// XCR0: x87, SSE, AVX
+#define XCR0_X87_SSE            0x3
+#define XCR0_X87_SSE_AVX        0x7
+
+// Доступ: присутній, кільце 0, код (виконання/читання) або дані (читання/запис);
+// DPL 3 - сегменти кільця 3; доступний TSS
+#define GDT_ACCESS_CODE     0x9A
+#define GDT_ACCESS_DATA     0x92
+#define GDT_ACCESS_DPL3     0x60
+#define GDT_ACCESS_TSS      0x89
+// Гранулярність 4 КБ, 32-бітний сегмент; L=1 - 64-бітний код
+#define GDT_FLAGS_32        0xC
+#define GDT_FLAGS_64        0xA
+
+// База GS у long mode задається MSR, а не дескриптором; swapgs міняє її з
+// KERNEL_GS_BASE при вході з кільця 3 і виході в нього
+#define MSR_GS_BASE         0xC0000101
+#define MSR_KERNEL_GS_BASE  0xC0000102
+
+struct gdt_ptr {
+    uint16_t limit;
+    uintptr_t base;
+} __attribute__((packed));
+
+static uint64_t gdt_entry(uint32_t base, uint32_t limit, uint8_t access, uint8_t flags) {
+    uint64_t entry = 0;
+    entry |= limit & 0xFFFF;
+    entry |= (uint64_t)(base & 0xFFFFFF) << 16;
+    entry |= (uint64_t)access << 40;
+    entry |= (uint64_t)((limit >> 16) & 0xF) << 48;
+    entry |= (uint64_t)(flags & 0xF) << 52;
+    entry |= (uint64_t)((base >> 24) & 0xFF) << 56;
+    return entry;
+}
+
+void cpu_init(uint32_t index) {
+    cpu_t* cpu = &cpus[index];
+    cpu->self = cpu;
+    cpu->index = index;
+
+    // TSS без карти портів: in/out з кільця 3 дають #GP
+    uintptr_t tss = (uintptr_t)&cpu->tss;
+    memset(&cpu->tss, 0, sizeof(cpu->tss));
+    cpu->tss.iomap_base = sizeof(cpu->tss);
+
+#ifdef __x86_64__
+    // Плоскі сегменти ядра і кільця 3; база GS (cpu_t) - через MSR_GS_BASE
+    cpu->gdt[0] = 0;
+    cpu->gdt[GDT_KERNEL_CODE / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_CODE, GDT_FLAGS_64);
+    cpu->gdt[GDT_KERNEL_DATA / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_DATA, GDT_FLAGS_32);
+    cpu->gdt[GDT_USER_DATA / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_DATA | GDT_ACCESS_DPL3, GDT_FLAGS_32);
+    cpu->gdt[GDT_USER_CODE / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_CODE | GDT_ACCESS_DPL3, GDT_FLAGS_64);
+    cpu->gdt[GDT_PERCPU / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_DATA, GDT_FLAGS_32);
+    cpu->gdt[GDT_TSS / 8] = gdt_entry((uint32_t)tss, sizeof(cpu->tss) - 1, GDT_ACCESS_TSS, 0);
+    cpu->gdt[GDT_TSS / 8 + 1] = (uint64_t)tss >> 32;
+#else
+    // Плоскі сегменти ядра і кільця 3 + сегмент GS з базою на власний cpu_t
+    cpu->gdt[0] = 0;
+    cpu->gdt[GDT_KERNEL_CODE / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_CODE, GDT_FLAGS_32);
+    cpu->gdt[GDT_KERNEL_DATA / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_DATA, GDT_FLAGS_32);
+    cpu->gdt[GDT_USER_CODE / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_CODE | GDT_ACCESS_DPL3, GDT_FLAGS_32);
+    cpu->gdt[GDT_USER_DATA / 8] = gdt_entry(0, 0xFFFFF, GDT_ACCESS_DATA | GDT_ACCESS_DPL3, GDT_FLAGS_32);
+    cpu->gdt[GDT_PERCPU / 8] = gdt_entry((uint32_t)(uintptr_t)cpu, sizeof(cpu_t) - 1, GDT_ACCESS_DATA, 0x4);
+    cpu->gdt[GDT_TSS / 8] = gdt_entry((uint32_t)tss, sizeof(cpu->tss) - 1, GDT_ACCESS_TSS, 0);
+    cpu->tss.ss0 = GDT_KERNEL_DATA;
+#endif
+
+    struct gdt_ptr gdtr;
+    gdtr.limit = sizeof(cpu->gdt) - 1;
+    gdtr.base = (uintptr_t)cpu->gdt;
+
+#ifdef __x86_64__
+    // Далекого jmp з безпосереднім селектором у long mode немає - CS через lretq
+    asm volatile (
+        "lgdt %0\n\t"
+        "pushq %1\n\t"
+        "leaq 1f(%%rip), %%rax\n\t"
+        "pushq %%rax\n\t"
+        "lretq\n\t"
+        "1:\n\t"
+        "mov %2, %%ds\n\t"
+        "mov %2, %%es\n\t"
+        "mov %2, %%ss\n\t"
+        "mov %2, %%fs\n\t"
+        "mov %3, %%gs"
+        : : "m"(gdtr), "i"(GDT_KERNEL_CODE), "r"(GDT_KERNEL_DATA), "r"(GDT_PERCPU)
+        : "rax", "memory"
+    );
+    wrmsr(MSR_GS_BASE, (uintptr_t)cpu);
+    wrmsr(MSR_KERNEL_GS_BASE, 0);
+#else
+    asm volatile (
+        "lgdt %0\n\t"
+        "ljmp %1, $1f\n\t"
+        "1:\n\t"
+        "mov %2, %%ds\n\t"
+        "mov %2, %%es\n\t"
+        "mov %2, %%ss\n\t"
+        "mov %2, %%fs\n\t"
+        "mov %3, %%gs"
+        : : "m"(gdtr), "i"(GDT_KERNEL_CODE), "r"(GDT_KERNEL_DATA), "r"(GDT_PERCPU)
+        : "memory"
+    );
+#endif
+    asm volatile("ltr %w0" : : "r"(GDT_TSS));
+}
+
+void cpu_set_kernel_stack(uintptr_t top) {
+    cpu_t* cpu = this_cpu();
+#ifdef __x86_64__
+    cpu->tss.rsp0 = top;
+#else
+    cpu->tss.esp0 = top;
+#endif
+    cpu->syscall_stack = top;
+}
+
+// === SSE/AVX ===
+
+void cpu_detect_features(void) {
+    uint32_t max_leaf, a, b, c, d;
+    cpuid(0, &max_leaf, &b, &c, &d);
+    cpuid(1, &a, &b, &c, &d);
+    uint32_t ecx1 = c;
+
+    cpu_features = 0;
+    if ((d & CPUID_EDX_FXSR) && (d & CPUID_EDX_SSE2)) {
+        cpu_features |= CPU_FEATURE_SSE2;
+    }
+    if (ecx1 & CPUID_ECX_MONITOR) {
+        cpu_features |= CPU_FEATURE_MONITOR;
+    }
+    if (ecx1 & CPUID_ECX_XSAVE) {
+        cpu_features |= CPU_FEATURE_XSAVE;
+    }
+    if (ecx1 & CPUID_ECX_X2APIC) {
+        cpu_features |= CPU_FEATURE_X2APIC;
+    }
+    if (max_leaf >= 7) {
+        uint32_t a7, b7, c7, d7;
+        cpuid(7, &a7, &b7, &c7, &d7);
+        if (b7 & CPUID_7_EBX_ERMS) {
+            cpu_features |= CPU_FEATURE_ERMS;
+        }
+        // AVX2 придатний лише разом із XSAVE, інакше стан YMM не ввімкнути
+        if ((b7 & CPUID_7_EBX_AVX2) && (ecx1 & CPUID_ECX_AVX) && (ecx1 & CPUID_ECX_XSAVE)) {
+            cpu_features |= CPU_FEATURE_AVX2;
+        }
+    }
+}
+
+void cpu_enable_simd(void) {
+    if (!(cpu_features & CPU_FEATURE_SSE2)) {
+        return;
+    }
+
+    unsigned long cr0, cr4;
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 = (cr0 & ~CR0_EM) | CR0_MP;
+    asm volatile("mov %0, %%cr0" : : "r"(cr0));
+
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+    if (cpu_features & CPU_FEATURE_XSAVE) {
+        cr4 |= CR4_OSXSAVE;
+    }
+    asm volatile("mov %0, %%cr4" : : "r"(cr4));
+    asm volatile("fninit");
+
+    // Без біта SSE у XCR0 XSAVE не зберіг би XMM (fpu.c)
+    if (cpu_features & CPU_FEATURE_AVX2) {
+        asm volatile("xsetbv" : : "a"(XCR0_X87_SSE_AVX), "d"(0), "c"(0));
+    } else if (cpu_features & CPU_FEATURE_XSAVE) {
+        asm volatile("xsetbv" : : "a"(XCR0_X87_SSE), "d"(0), "c"(0));
+    }
+}
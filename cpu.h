@@ -0,0 +1,115 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include "kernel.h"
+
+#define SMP_MAX_CPUS        16
+
+// Селектори GDT (однакові на всіх процесорах). Порядок сегментів кільця 3
+// задають SYSEXIT (код = SYSENTER_CS + 16, стек = + 24) та SYSRET (стек = база
+// + 8, код = база + 16); дублюються в kernel.asm / kernel64.asm
+#define GDT_KERNEL_CODE     0x08
+#define GDT_KERNEL_DATA     0x10
+#ifdef __x86_64__
+#define GDT_USER_DATA       0x18
+#define GDT_USER_CODE       0x20
+#else
+#define GDT_USER_CODE       0x18
+#define GDT_USER_DATA       0x20
+#endif
+#define GDT_PERCPU          0x28
+#define GDT_TSS             0x30
+#ifdef __x86_64__
+#define GDT_ENTRIES         8       // дескриптор TSS у long mode 16-байтний
+#else
+#define GDT_ENTRIES         7
+#endif
+#define GDT_RPL_USER        3
+
+// Можливості процесора, визначені через CPUID на BSP
+#define CPU_FEATURE_SSE2    0x01
+#define CPU_FEATURE_ERMS    0x02    // швидкі rep movsb/stosb
+#define CPU_FEATURE_AVX2    0x04    // разом з увімкненим ОС станом AVX (XCR0)
+#define CPU_FEATURE_XSAVE   0x08
+#define CPU_FEATURE_MONITOR 0x10
+#define CPU_FEATURE_X2APIC  0x20
+
+typedef void (*cpu_work_t)(void* arg);
+
+// TSS: лише стек ядра для входу з кільця 3, без карти портів введення-виведення
+#ifdef __x86_64__
+typedef struct {
+    uint32_t reserved0;
+    uint64_t rsp0;
+    uint64_t rsp1;
+    uint64_t rsp2;
+    uint64_t reserved1;
+    uint64_t ist[7];
+    uint64_t reserved2;
+    uint16_t reserved3;
+    uint16_t iomap_base;
+} __attribute__((packed)) tss_t;
+#else
+typedef struct {
+    uint32_t link;
+    uint32_t esp0;
+    uint32_t ss0;
+    uint32_t unused[22];
+    uint16_t trap;
+    uint16_t iomap_base;
+} __attribute__((packed)) tss_t;
+#endif
+
+// Дані окремого процесора; доступ до власних - через сегмент GS
+typedef struct cpu {
+    struct cpu* self;               // %gs:0
+    uintptr_t syscall_stack;        // %gs:8 - стек ядра для SYSCALL (x86_64)
+    uintptr_t syscall_user_sp;      // %gs:16 - збережений RSP кільця 3
+    uint32_t index;
+    uint32_t apic_id;
+    volatile uint32_t online;
+    uintptr_t stack;
+
+    // Поштова скринька для роботи з інших процесорів
+    volatile cpu_work_t work;
+    void* volatile work_arg;
+    volatile uint32_t work_pending;
+    volatile uint32_t halted;       // процесор спить у hlt і потребує IPI
+    int use_mwait;
+    volatile uint32_t tlb_pending;  // очікує інвалідації TLB від іншого процесора
+
+    // Трасування: власне кільце подій та кадр поточного переривання
+    struct trace_ring* trace_ring;
+    irq_frame_t* irq_frame;
+    uint64_t irq_enter_tsc;
+
+    // Статистика
+    uint64_t work_done;
+    uint64_t ipis_received;
+    uint64_t idle_wakeups;
+    uint64_t tlb_shootdowns;
+
+    uint64_t gdt[GDT_ENTRIES];
+    tss_t tss;
+} cpu_t;
+
+extern cpu_t cpus[SMP_MAX_CPUS];
+extern uint32_t cpu_features;
+
+// Побудова та завантаження GDT з per-CPU сегментом, сегментами кільця 3 і TSS
+void cpu_init(uint32_t index);
+
+// Стек ядра, на який процесор перемикається при вході з кільця 3
+void cpu_set_kernel_stack(uintptr_t top);
+
+// SSE/AVX: визначення на BSP, увімкнення в CR0/CR4/XCR0 на кожному процесорі
+void cpu_detect_features(void);
+void cpu_enable_simd(void);
+
+static inline cpu_t* this_cpu(void) {
+    cpu_t* cpu;
+    asm volatile ( "mov %%gs:0, %0" : "=r"(cpu) );
+    return cpu;
+}
+
+#endif
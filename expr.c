@@ -0,0 +1,1254 @@
+#include "expr.h"
+#include "heap.h"
+#include "timer.h"
+
+#define INT32_MIN_VALUE     ((int32_t)0x80000000)
+#define INT32_MAX_VALUE     0x7FFFFFFF
+
+// Сили зв'язування Pratt-парсера: ^ праворуч асоціативний і сильніший за унарний мінус
+#define BP_ADD              10
+#define BP_MUL              20
+#define BP_PREFIX           25
+#define BP_POW              30
+#define BP_POSTFIX          40
+
+// Кеш належить потоку shell; вказівник на вираз дійсний до наступного expr_lookup
+typedef struct {
+    char source[EXPR_MAX_SOURCE];
+    uint32_t hash;
+    uint32_t last_used;
+    int valid;
+    expr_t expr;
+} expr_cache_entry_t;
+
+static expr_cache_entry_t cache[EXPR_CACHE_SIZE];
+static uint32_t cache_tick = 0;
+
+// Статистика
+static uint64_t cache_hits = 0;
+static uint64_t cache_misses = 0;
+static uint64_t compiles = 0;
+static uint64_t folded_ops = 0;
+static uint32_t jit_compiles = 0;
+
+// === АРИФМЕТИКА З ПЕРЕВІРКОЮ ПЕРЕПОВНЕННЯ ===
+
+// Спільна для інтерпретатора, згортання констант та JIT (OP_POW)
+static int32_t expr_pow(int32_t base, int32_t exp, math_result_t* error) {
+    if (exp < 0) {
+        // Цілочисельне ділення 1 / base^|exp|
+        if (base == 0) {
+            *error = MATH_ERROR_DIV_BY_ZERO;
+            return 0;
+        }
+        if (base == 1) return 1;
+        if (base == -1) return (exp & 1) ? -1 : 1;
+        return 0;
+    }
+
+    int32_t result = 1;
+    while (exp) {
+        if (exp & 1) {
+            if (__builtin_mul_overflow(result, base, &result)) {
+                *error = MATH_ERROR_OVERFLOW;
+                return 0;
+            }
+        }
+        exp >>= 1;
+        if (exp && __builtin_mul_overflow(base, base, &base)) {
+            *error = MATH_ERROR_OVERFLOW;
+            return 0;
+        }
+    }
+    return result;
+}
+
+// n! в int32: 12! - найбільший, що влазить
+static int32_t expr_fact(int32_t n, math_result_t* error) {
+    if (n < 0) {
+        *error = MATH_ERROR_INVALID_EXPR;
+        return 0;
+    }
+    if (n > 12) {
+        *error = MATH_ERROR_OVERFLOW;
+        return 0;
+    }
+    int32_t result = 1;
+    for (int32_t i = 2; i <= n; i++) {
+        result *= i;
+    }
+    return result;
+}
+
+static inline math_result_t apply_op(uint8_t op, int32_t a, int32_t b, int32_t* result) {
+    math_result_t error = MATH_SUCCESS;
+    switch (op) {
+        case OP_ADD:
+            if (__builtin_add_overflow(a, b, result)) return MATH_ERROR_OVERFLOW;
+            return MATH_SUCCESS;
+        case OP_SUB:
+            if (__builtin_sub_overflow(a, b, result)) return MATH_ERROR_OVERFLOW;
+            return MATH_SUCCESS;
+        case OP_MUL:
+            if (__builtin_mul_overflow(a, b, result)) return MATH_ERROR_OVERFLOW;
+            return MATH_SUCCESS;
+        case OP_DIV:
+        case OP_MOD:
+            if (b == 0) return MATH_ERROR_DIV_BY_ZERO;
+            // INT_MIN / -1 - єдиний випадок, коли idiv видає #DE
+            if (b == -1 && a == INT32_MIN_VALUE) return MATH_ERROR_OVERFLOW;
+            *result = op == OP_DIV ? a / b : a % b;
+            return MATH_SUCCESS;
+        case OP_POW:
+            *result = expr_pow(a, b, &error);
+            return error;
+        default:
+            return MATH_ERROR_INVALID_EXPR;
+    }
+}
+
+// === PRATT-ПАРСЕР ===
+
+typedef struct {
+    const char* source;
+    const char* p;
+    expr_t* expr;
+    uint32_t depth;             // поточна глибина стеку машини
+    uint32_t nesting;
+    math_result_t error;
+} parser_t;
+
+// Результат розбору підвиразу: де починається його код і чи це константа
+typedef struct {
+    uint16_t start;
+    int constant;
+    int32_t value;
+} operand_t;
+
+static void skip_spaces(parser_t* parser) {
+    while (*parser->p == ' ' || *parser->p == '\t') {
+        parser->p++;
+    }
+}
+
+static int is_ident_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static void fail(parser_t* parser, math_result_t error) {
+    if (parser->error == MATH_SUCCESS) {
+        parser->error = error;
+    }
+}
+
+static void emit(parser_t* parser, uint8_t byte) {
+    expr_t* expr = parser->expr;
+    // Останній байт завжди лишаємо під OP_END
+    if (expr->length >= EXPR_MAX_CODE - 1) {
+        fail(parser, MATH_ERROR_INVALID_EXPR);
+        return;
+    }
+    expr->code[expr->length++] = byte;
+}
+
+static void stack_push(parser_t* parser) {
+    parser->depth++;
+    if (parser->depth > EXPR_MAX_STACK) {
+        fail(parser, MATH_ERROR_INVALID_EXPR);
+    } else if (parser->depth > parser->expr->max_stack) {
+        parser->expr->max_stack = (uint8_t)parser->depth;
+    }
+}
+
+static void emit_push(parser_t* parser, int32_t value) {
+    if (value >= -128 && value <= 127) {
+        emit(parser, OP_PUSH8);
+        emit(parser, (uint8_t)value);
+    } else {
+        emit(parser, OP_PUSH32);
+        for (int i = 0; i < 4; i++) {
+            emit(parser, (uint8_t)((uint32_t)value >> (i * 8)));
+        }
+    }
+    stack_push(parser);
+}
+
+// Замінює код константних операндів, що починається зі start, однією константою
+static void fold(parser_t* parser, operand_t* out, uint16_t start, uint32_t operands, int32_t value) {
+    parser->expr->length = start;
+    parser->depth -= operands;
+    emit_push(parser, value);
+    out->start = start;
+    out->constant = true;
+    out->value = value;
+    folded_ops++;
+}
+
+// Десятковий літерал поза int32: байткод посилається на його текст,
+// число будує лише довга арифметика
+static void parse_big_number(parser_t* parser, operand_t* out, const char* digits) {
+    const char* p = digits;
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    if (is_ident_char(*p)) {
+        fail(parser, MATH_ERROR_PARSE_FAIL);
+        return;
+    }
+    if (p - parser->source > 0xFF) {
+        fail(parser, MATH_ERROR_INVALID_EXPR);
+        return;
+    }
+
+    parser->p = p;
+    out->start = parser->expr->length;
+    out->constant = false;
+    parser->expr->uses_big = true;
+    emit(parser, OP_PUSHBIG);
+    emit(parser, (uint8_t)(digits - parser->source));
+    emit(parser, (uint8_t)(p - digits));
+    stack_push(parser);
+}
+
+static void parse_number(parser_t* parser, operand_t* out) {
+    const char* p = parser->p;
+    uint32_t base = 10;
+    uint32_t value = 0;
+
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        base = 16;
+        p += 2;
+    }
+
+    const char* digits = p;
+    while (1) {
+        uint32_t digit;
+        if (*p >= '0' && *p <= '9') {
+            digit = (uint32_t)(*p - '0');
+        } else if (base == 16 && *p >= 'a' && *p <= 'f') {
+            digit = (uint32_t)(*p - 'a' + 10);
+        } else if (base == 16 && *p >= 'A' && *p <= 'F') {
+            digit = (uint32_t)(*p - 'A' + 10);
+        } else {
+            break;
+        }
+        // Мінус - окремий унарний оператор; шістнадцятковий літерал має влазити в int32
+        if (value > (INT32_MAX_VALUE - digit) / base) {
+            if (base == 10) {
+                parse_big_number(parser, out, digits);
+                return;
+            }
+            fail(parser, MATH_ERROR_OVERFLOW);
+            return;
+        }
+        value = value * base + digit;
+        p++;
+    }
+
+    if (p == digits || is_ident_char(*p)) {
+        fail(parser, MATH_ERROR_PARSE_FAIL);
+        return;
+    }
+
+    parser->p = p;
+    out->start = parser->expr->length;
+    out->constant = true;
+    out->value = (int32_t)value;
+    emit_push(parser, out->value);
+}
+
+static void parse_expression(parser_t* parser, int min_bp, operand_t* out);
+
+static void parse_prefix(parser_t* parser, operand_t* out) {
+    skip_spaces(parser);
+    char c = *parser->p;
+
+    if (c >= '0' && c <= '9') {
+        parse_number(parser, out);
+    } else if (c == 'x' && !is_ident_char(parser->p[1])) {
+        parser->p++;
+        out->start = parser->expr->length;
+        out->constant = false;
+        parser->expr->uses_x = true;
+        emit(parser, OP_LOADX);
+        stack_push(parser);
+    } else if (c == '(') {
+        parser->p++;
+        if (++parser->nesting > EXPR_MAX_DEPTH) {
+            fail(parser, MATH_ERROR_INVALID_EXPR);
+            return;
+        }
+        parse_expression(parser, 0, out);
+        parser->nesting--;
+        skip_spaces(parser);
+        if (*parser->p != ')') {
+            fail(parser, MATH_ERROR_PARSE_FAIL);
+            return;
+        }
+        parser->p++;
+    } else if (c == '-' || c == '+') {
+        parser->p++;
+        if (++parser->nesting > EXPR_MAX_DEPTH) {
+            fail(parser, MATH_ERROR_INVALID_EXPR);
+            return;
+        }
+        parse_expression(parser, BP_PREFIX, out);
+        parser->nesting--;
+        if (c == '+' || parser->error != MATH_SUCCESS) {
+            return;
+        }
+        if (out->constant && out->value != INT32_MIN_VALUE) {
+            fold(parser, out, out->start, 1, -out->value);
+        } else {
+            emit(parser, OP_NEG);
+            out->constant = false;
+        }
+    } else {
+        fail(parser, MATH_ERROR_PARSE_FAIL);
+    }
+}
+
+static int infix_op(char c, int* left_bp, int* right_bp) {
+    switch (c) {
+        case '+': *left_bp = BP_ADD; *right_bp = BP_ADD + 1; return OP_ADD;
+        case '-': *left_bp = BP_ADD; *right_bp = BP_ADD + 1; return OP_SUB;
+        case '*': *left_bp = BP_MUL; *right_bp = BP_MUL + 1; return OP_MUL;
+        case '/': *left_bp = BP_MUL; *right_bp = BP_MUL + 1; return OP_DIV;
+        case '%': *left_bp = BP_MUL; *right_bp = BP_MUL + 1; return OP_MOD;
+        case '^': *left_bp = BP_POW + 1; *right_bp = BP_POW; return OP_POW;
+        default: return OP_END;
+    }
+}
+
+static void parse_expression(parser_t* parser, int min_bp, operand_t* out) {
+    parse_prefix(parser, out);
+
+    while (parser->error == MATH_SUCCESS) {
+        skip_spaces(parser);
+
+        // Постфіксний факторіал зв'язує найсильніше: -3! = -(3!), 2^3! = 2^6
+        if (*parser->p == '!') {
+            parser->p++;
+            if (out->constant) {
+                math_result_t error = MATH_SUCCESS;
+                int32_t value = expr_fact(out->value, &error);
+                if (error == MATH_SUCCESS) {
+                    fold(parser, out, out->start, 1, value);
+                    continue;
+                }
+                if (error != MATH_ERROR_OVERFLOW) {
+                    fail(parser, error);
+                    return;
+                }
+            }
+            emit(parser, OP_FACT);
+            out->constant = false;
+            continue;
+        }
+
+        int left_bp, right_bp;
+        int op = infix_op(*parser->p, &left_bp, &right_bp);
+        if (op == OP_END || left_bp < min_bp) {
+            return;
+        }
+        parser->p++;
+
+        operand_t right;
+        parse_expression(parser, right_bp, &right);
+        if (parser->error != MATH_SUCCESS) {
+            return;
+        }
+
+        if (out->constant && right.constant) {
+            // Обидва операнди відомі - обчислюємо зараз. Переповнення int32 лишаємо
+            // на час виконання (його порахує довга арифметика), решта помилок - компіляції
+            int32_t value;
+            math_result_t error = apply_op((uint8_t)op, out->value, right.value, &value);
+            if (error == MATH_SUCCESS) {
+                fold(parser, out, out->start, 2, value);
+                continue;
+            }
+            if (error != MATH_ERROR_OVERFLOW) {
+                fail(parser, error);
+                return;
+            }
+        }
+        emit(parser, (uint8_t)op);
+        parser->depth--;
+        out->constant = false;
+    }
+}
+
+math_result_t expr_compile(const char* source, expr_t* expr) {
+    parser_t parser;
+    operand_t result;
+
+    memset(expr, 0, sizeof(*expr));
+    parser.source = source;
+    parser.p = source;
+    parser.expr = expr;
+    parser.depth = 0;
+    parser.nesting = 0;
+    parser.error = MATH_SUCCESS;
+
+    parse_expression(&parser, 0, &result);
+    skip_spaces(&parser);
+    if (parser.error == MATH_SUCCESS && *parser.p != '\0') {
+        parser.error = MATH_ERROR_PARSE_FAIL;
+    }
+    if (parser.error != MATH_SUCCESS) {
+        return parser.error;
+    }
+
+    expr->code[expr->length++] = OP_END;
+    compiles++;
+    return MATH_SUCCESS;
+}
+
+// === ІНТЕРПРЕТАТОР ===
+
+static inline int32_t read_imm32(const uint8_t* p) {
+    return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+math_result_t expr_interpret(const expr_t* expr, int32_t x, int32_t* result) {
+    int32_t stack[EXPR_MAX_STACK];
+    int32_t* sp = stack;
+    const uint8_t* pc = expr->code;
+
+    while (1) {
+        uint8_t op = *pc++;
+        switch (op) {
+            case OP_END:
+                *result = sp[-1];
+                return MATH_SUCCESS;
+            case OP_PUSH8:
+                *sp++ = (int8_t)*pc++;
+                break;
+            case OP_PUSH32:
+                *sp++ = read_imm32(pc);
+                pc += 4;
+                break;
+            case OP_LOADX:
+                *sp++ = x;
+                break;
+            case OP_NEG:
+                if (sp[-1] == INT32_MIN_VALUE) {
+                    return MATH_ERROR_OVERFLOW;
+                }
+                sp[-1] = -sp[-1];
+                break;
+            case OP_FACT: {
+                math_result_t error = MATH_SUCCESS;
+                sp[-1] = expr_fact(sp[-1], &error);
+                if (error != MATH_SUCCESS) {
+                    return error;
+                }
+                break;
+            }
+            case OP_PUSHBIG:
+                return MATH_ERROR_OVERFLOW;
+            default: {
+                math_result_t error = apply_op(op, sp[-2], sp[-1], &sp[-2]);
+                if (error != MATH_SUCCESS) {
+                    return error;
+                }
+                sp--;
+                break;
+            }
+        }
+    }
+}
+
+// === JIT ===
+
+// Вершина стеку машини живе в EAX, решта - у стеку x86; x - в EBX.
+// Перевірки переповнення та ділення ведуть на спільні заглушки в кінці коду.
+// Арифметика 32-бітна в обох режимах, тож її кодування однакові (push/pop у
+// long mode працюють з 8-байтними слотами); відрізняються пролог, доступ до
+// error та виклики expr_pow/expr_fact (cdecl на i386, System V на x86_64).
+enum { JIT_TARGET_OVERFLOW, JIT_TARGET_DIV_ZERO, JIT_TARGET_FAIL, JIT_TARGETS };
+
+typedef struct {
+    uint8_t* code;
+    uint32_t length;
+    uint32_t fixups[EXPR_MAX_CODE * 2];
+    uint8_t fixup_target[EXPR_MAX_CODE * 2];
+    uint32_t fixup_count;
+} jit_t;
+
+static uint8_t jit_buffer[EXPR_JIT_MAX_CODE];
+
+static void jit_bytes(jit_t* jit, const uint8_t* bytes, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        jit->code[jit->length++] = bytes[i];
+    }
+}
+
+static void jit_imm32(jit_t* jit, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        jit->code[jit->length++] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+// jcc rel32 на заглушку; зміщення дописується після генерації
+static void jit_branch(jit_t* jit, uint8_t condition, int target) {
+    jit->code[jit->length++] = 0x0F;
+    jit->code[jit->length++] = condition;
+    jit->fixups[jit->fixup_count] = jit->length;
+    jit->fixup_target[jit->fixup_count++] = (uint8_t)target;
+    jit_imm32(jit, 0);
+}
+
+static void jit_jump(jit_t* jit, int target) {
+    jit->code[jit->length++] = 0xE9;                            // jmp rel32
+    jit->fixups[jit->fixup_count] = jit->length;
+    jit->fixup_target[jit->fixup_count++] = (uint8_t)target;
+    jit_imm32(jit, 0);
+}
+
+#define JCC_O       0x80
+#define JCC_E       0x84
+#define JCC_NE      0x85
+
+#ifdef __x86_64__
+// Вказівник error збережено в [rbp-16]
+#define JIT_LOAD_ERROR_RDX  0x48, 0x8B, 0x55, 0xF0     // mov rdx, [rbp-16]
+
+// Стек перед call має бути вирівняний на 16: після прологу він вирівняний,
+// кожне значення в стеку x86 додає 8 байт
+static void jit_align_call(jit_t* jit, uint32_t pushed, int before) {
+    static const uint8_t sub[] = { 0x48, 0x83, 0xEC, 0x08 };   // sub rsp, 8
+    static const uint8_t add[] = { 0x48, 0x83, 0xC4, 0x08 };   // add rsp, 8
+    if (pushed & 1) {
+        jit_bytes(jit, before ? sub : add, 4);
+    }
+}
+#else
+#define JIT_LOAD_ERROR_RDX  0x8B, 0x55, 0x0C           // mov edx, [ebp+12]
+#endif
+
+static void jit_emit(jit_t* jit, const expr_t* expr) {
+#ifdef __x86_64__
+    static const uint8_t prologue[] = {
+        0x55,                           // push rbp
+        0x48, 0x89, 0xE5,               // mov rbp, rsp
+        0x53,                           // push rbx
+        0x56,                           // push rsi              ; error
+        0x89, 0xFB,                     // mov ebx, edi          ; x
+        0xC7, 0x06, 0, 0, 0, 0,         // mov dword [rsi], MATH_SUCCESS
+    };
+    static const uint8_t epilogue[] = {
+        0x48, 0x8D, 0x65, 0xF8,         // lea rsp, [rbp-8]
+        0x5B,                           // pop rbx
+        0x5D,                           // pop rbp
+        0xC3,                           // ret
+    };
+#else
+    static const uint8_t prologue[] = {
+        0x55,                           // push ebp
+        0x89, 0xE5,                     // mov ebp, esp
+        0x53,                           // push ebx
+        0x8B, 0x5D, 0x08,               // mov ebx, [ebp+8]      ; x
+        0x8B, 0x55, 0x0C,               // mov edx, [ebp+12]     ; error
+        0xC7, 0x02, 0, 0, 0, 0,         // mov dword [edx], MATH_SUCCESS
+    };
+    static const uint8_t epilogue[] = {
+        0x8D, 0x65, 0xFC,               // lea esp, [ebp-4]
+        0x5B,                           // pop ebx
+        0x5D,                           // pop ebp
+        0xC3,                           // ret
+    };
+#endif
+    // Після виклику: чи записала функція помилку в *error
+    static const uint8_t check_error[] = {
+        JIT_LOAD_ERROR_RDX,
+        0x83, 0x3A, 0x00,               // cmp dword [edx], 0
+    };
+    uint32_t targets[JIT_TARGETS];
+    uint32_t depth = 0;
+    const uint8_t* pc = expr->code;
+
+    jit->length = 0;
+    jit->fixup_count = 0;
+    jit_bytes(jit, prologue, sizeof(prologue));
+
+    while (*pc != OP_END) {
+        uint8_t op = *pc++;
+        switch (op) {
+            case OP_PUSH8:
+            case OP_PUSH32: {
+                int32_t value = op == OP_PUSH8 ? (int8_t)*pc : read_imm32(pc);
+                pc += op == OP_PUSH8 ? 1 : 4;
+                if (depth++) {
+                    jit->code[jit->length++] = 0x50;                // push eax
+                }
+                jit->code[jit->length++] = 0xB8;                    // mov eax, imm32
+                jit_imm32(jit, (uint32_t)value);
+                break;
+            }
+            case OP_LOADX: {
+                static const uint8_t load[] = { 0x89, 0xD8 };      // mov eax, ebx
+                if (depth++) {
+                    jit->code[jit->length++] = 0x50;
+                }
+                jit_bytes(jit, load, sizeof(load));
+                break;
+            }
+            case OP_ADD: {
+                static const uint8_t add[] = { 0x59, 0x01, 0xC8 }; // pop ecx; add eax, ecx
+                jit_bytes(jit, add, sizeof(add));
+                jit_branch(jit, JCC_O, JIT_TARGET_OVERFLOW);
+                depth--;
+                break;
+            }
+            case OP_SUB: {
+                static const uint8_t sub[] = { 0x59, 0x29, 0xC1 }; // pop ecx; sub ecx, eax
+                static const uint8_t mov[] = { 0x89, 0xC8 };       // mov eax, ecx
+                jit_bytes(jit, sub, sizeof(sub));
+                jit_branch(jit, JCC_O, JIT_TARGET_OVERFLOW);
+                jit_bytes(jit, mov, sizeof(mov));
+                depth--;
+                break;
+            }
+            case OP_MUL: {
+                static const uint8_t mul[] = { 0x59, 0x0F, 0xAF, 0xC1 };   // pop ecx; imul eax, ecx
+                jit_bytes(jit, mul, sizeof(mul));
+                jit_branch(jit, JCC_O, JIT_TARGET_OVERFLOW);
+                depth--;
+                break;
+            }
+            case OP_DIV:
+            case OP_MOD: {
+                static const uint8_t head[] = {
+                    0x89, 0xC1,                 // mov ecx, eax  ; дільник
+                    0x58,                       // pop eax       ; ділене
+                    0x85, 0xC9,                 // test ecx, ecx
+                };
+                static const uint8_t check[] = {
+                    0x83, 0xF9, 0xFF,           // cmp ecx, -1
+                    0x75, 0x0B,                 // jne +11 (через cmp/je)
+                    0x3D, 0x00, 0x00, 0x00, 0x80,   // cmp eax, INT_MIN
+                };
+                static const uint8_t divide[] = {
+                    0x99,                       // cdq
+                    0xF7, 0xF9,                 // idiv ecx
+                };
+                static const uint8_t rem[] = { 0x89, 0xD0 };   // mov eax, edx
+                jit_bytes(jit, head, sizeof(head));
+                jit_branch(jit, JCC_E, JIT_TARGET_DIV_ZERO);
+                jit_bytes(jit, check, sizeof(check));
+                jit_branch(jit, JCC_E, JIT_TARGET_OVERFLOW);
+                jit_bytes(jit, divide, sizeof(divide));
+                if (op == OP_MOD) {
+                    jit_bytes(jit, rem, sizeof(rem));
+                }
+                depth--;
+                break;
+            }
+            case OP_POW: {
+#ifdef __x86_64__
+                static const uint8_t pop_base[] = { 0x5F };     // pop rdi       ; основа
+                static const uint8_t call_head[] = {
+                    0x89, 0xC6,                 // mov esi, eax  ; степінь
+                    JIT_LOAD_ERROR_RDX,
+                    0xB8,                       // mov eax, expr_pow (ядро нижче 4 ГБ)
+                };
+                static const uint8_t call_tail[] = {
+                    0xFF, 0xD0,                 // call rax
+                };
+                jit_bytes(jit, pop_base, sizeof(pop_base));
+                jit_align_call(jit, depth - 2, true);
+                jit_bytes(jit, call_head, sizeof(call_head));
+                jit_imm32(jit, (uint32_t)(uintptr_t)expr_pow);
+                jit_bytes(jit, call_tail, sizeof(call_tail));
+                jit_align_call(jit, depth - 2, false);
+#else
+                static const uint8_t call_head[] = {
+                    0x59,                       // pop ecx       ; основа
+                    0xFF, 0x75, 0x0C,           // push dword [ebp+12]
+                    0x50,                       // push eax      ; степінь
+                    0x51,                       // push ecx
+                    0xB8,                       // mov eax, expr_pow
+                };
+                static const uint8_t call_tail[] = {
+                    0xFF, 0xD0,                 // call eax
+                    0x83, 0xC4, 0x0C,           // add esp, 12
+                };
+                jit_bytes(jit, call_head, sizeof(call_head));
+                jit_imm32(jit, (uint32_t)(uintptr_t)expr_pow);
+                jit_bytes(jit, call_tail, sizeof(call_tail));
+#endif
+                jit_bytes(jit, check_error, sizeof(check_error));
+                jit_branch(jit, JCC_NE, JIT_TARGET_FAIL);
+                depth--;
+                break;
+            }
+            case OP_NEG: {
+                static const uint8_t neg[] = { 0xF7, 0xD8 };       // neg eax
+                jit_bytes(jit, neg, sizeof(neg));
+                jit_branch(jit, JCC_O, JIT_TARGET_OVERFLOW);
+                break;
+            }
+            case OP_FACT: {
+#ifdef __x86_64__
+                static const uint8_t call_head[] = {
+                    0x89, 0xC7,                 // mov edi, eax  ; n
+                    0x48, 0x8B, 0x75, 0xF0,     // mov rsi, [rbp-16]
+                    0xB8,                       // mov eax, expr_fact
+                };
+                static const uint8_t call_tail[] = {
+                    0xFF, 0xD0,                 // call rax
+                };
+                jit_align_call(jit, depth - 1, true);
+                jit_bytes(jit, call_head, sizeof(call_head));
+                jit_imm32(jit, (uint32_t)(uintptr_t)expr_fact);
+                jit_bytes(jit, call_tail, sizeof(call_tail));
+                jit_align_call(jit, depth - 1, false);
+#else
+                static const uint8_t call_head[] = {
+                    0xFF, 0x75, 0x0C,           // push dword [ebp+12]
+                    0x50,                       // push eax      ; n
+                    0xB8,                       // mov eax, expr_fact
+                };
+                static const uint8_t call_tail[] = {
+                    0xFF, 0xD0,                 // call eax
+                    0x83, 0xC4, 0x08,           // add esp, 8
+                };
+                jit_bytes(jit, call_head, sizeof(call_head));
+                jit_imm32(jit, (uint32_t)(uintptr_t)expr_fact);
+                jit_bytes(jit, call_tail, sizeof(call_tail));
+#endif
+                jit_bytes(jit, check_error, sizeof(check_error));
+                jit_branch(jit, JCC_NE, JIT_TARGET_FAIL);
+                break;
+            }
+            case OP_PUSHBIG:
+                // Як і в інтерпретаторі: у int32 такий літерал - лише переповнення
+                pc += 2;
+                if (depth++) {
+                    jit->code[jit->length++] = 0x50;
+                }
+                jit_jump(jit, JIT_TARGET_OVERFLOW);
+                break;
+        }
+    }
+    jit_bytes(jit, epilogue, sizeof(epilogue));
+
+    // Заглушки помилок: код у *error, EAX = 0, спільний вихід
+    static const uint8_t store_error[] = { JIT_LOAD_ERROR_RDX, 0xC7, 0x02 };   // mov dword [edx], imm32
+    static const uint8_t jmp_fail[] = { 0xEB };                             // jmp rel8
+    targets[JIT_TARGET_OVERFLOW] = jit->length;
+    jit_bytes(jit, store_error, sizeof(store_error));
+    jit_imm32(jit, MATH_ERROR_OVERFLOW);
+    jit_bytes(jit, jmp_fail, sizeof(jmp_fail));
+    jit->code[jit->length++] = sizeof(store_error) + 4;        // через заглушку ділення
+
+    targets[JIT_TARGET_DIV_ZERO] = jit->length;
+    jit_bytes(jit, store_error, sizeof(store_error));
+    jit_imm32(jit, MATH_ERROR_DIV_BY_ZERO);
+
+    targets[JIT_TARGET_FAIL] = jit->length;
+    jit->code[jit->length++] = 0x31;                            // xor eax, eax
+    jit->code[jit->length++] = 0xC0;
+    jit_bytes(jit, epilogue, sizeof(epilogue));
+
+    for (uint32_t i = 0; i < jit->fixup_count; i++) {
+        uint32_t at = jit->fixups[i];
+        uint32_t rel = targets[jit->fixup_target[i]] - (at + 4);
+        for (int b = 0; b < 4; b++) {
+            jit->code[at + b] = (uint8_t)(rel >> (b * 8));
+        }
+    }
+}
+
+int expr_jit_compile(expr_t* expr) {
+    if (expr->jit) {
+        return SUCCESS;
+    }
+
+    jit_t jit;
+    jit.code = jit_buffer;
+    jit_emit(&jit, expr);
+
+    // Сторінки купи виконувані: на i386 без PAE біта NX немає, на x86_64
+    // EFER.NXE не вмикається
+    uint8_t* code = kmalloc(jit.length);
+    if (!code) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    memcpy(code, jit.code, jit.length);
+
+    expr->jit = (expr_jit_fn_t)(uintptr_t)code;
+    expr->jit_size = (uint16_t)jit.length;
+    jit_compiles++;
+    return SUCCESS;
+}
+
+void expr_release(expr_t* expr) {
+    if (expr->jit) {
+        kfree((void*)(uintptr_t)expr->jit);
+        expr->jit = NULL;
+        expr->jit_size = 0;
+    }
+}
+
+math_result_t expr_eval(expr_t* expr, int32_t x, int32_t* result) {
+    if (expr->jit) {
+        math_result_t error;
+        *result = expr->jit(x, &error);
+        return error;
+    }
+    if (++expr->evals == EXPR_JIT_THRESHOLD) {
+        expr_jit_compile(expr);
+    }
+    return expr_interpret(expr, x, result);
+}
+
+// === КЕШ ===
+
+static uint32_t hash_source(const char* source) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*source) {
+        hash ^= (uint8_t)*source++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+math_result_t expr_lookup(const char* source, expr_t** expr) {
+    if (strlen(source) >= EXPR_MAX_SOURCE) {
+        return MATH_ERROR_INVALID_EXPR;
+    }
+
+    uint32_t hash = hash_source(source);
+    expr_cache_entry_t* victim = &cache[0];
+    cache_tick++;
+
+    for (uint32_t i = 0; i < EXPR_CACHE_SIZE; i++) {
+        expr_cache_entry_t* entry = &cache[i];
+        if (entry->valid && entry->hash == hash && strcmp(entry->source, source) == 0) {
+            entry->last_used = cache_tick;
+            cache_hits++;
+            *expr = &entry->expr;
+            return MATH_SUCCESS;
+        }
+        if (!entry->valid || (victim->valid && entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
+    }
+    cache_misses++;
+
+    // Помилкові вирази не кешуємо
+    expr_t compiled;
+    math_result_t error = expr_compile(source, &compiled);
+    if (error != MATH_SUCCESS) {
+        return error;
+    }
+
+    if (victim->valid) {
+        expr_release(&victim->expr);
+    }
+    strcpy(victim->source, source);
+    victim->hash = hash;
+    victim->last_used = cache_tick;
+    victim->valid = true;
+    victim->expr = compiled;
+    *expr = &victim->expr;
+    return MATH_SUCCESS;
+}
+
+// === ДОВГА АРИФМЕТИКА ===
+
+static math_result_t big_error(int status) {
+    switch (status) {
+        case SUCCESS: return MATH_SUCCESS;
+        case ERROR_DIVISION_BY_ZERO: return MATH_ERROR_DIV_BY_ZERO;
+        default: return MATH_ERROR_OVERFLOW;
+    }
+}
+
+// Ті самі правила, що й expr_pow: від'ємний показник - ціла частина 1 / base^|exp|
+static math_result_t big_pow(bignum_t* base, const bignum_t* exp) {
+    int32_t e, b;
+    if (bignum_to_int32(base, &b) == SUCCESS && b >= -1 && b <= 1) {
+        // 0, 1 та -1 у будь-якому степені не ростуть
+        if (b == 0 && bignum_cmp(exp, base) < 0) {
+            return MATH_ERROR_DIV_BY_ZERO;
+        }
+        int odd = exp->size && (exp->limbs[0] & 1);
+        int zero = bignum_is_zero(exp);
+        return big_error(bignum_set_int(base, zero ? 1 : (b == -1 && !odd) ? 1 : b));
+    }
+    if (bignum_to_int32(exp, &e) != SUCCESS) {
+        return exp->negative ? big_error(bignum_set_int(base, 0)) : MATH_ERROR_OVERFLOW;
+    }
+    if (e < 0) {
+        return big_error(bignum_set_int(base, 0));
+    }
+    return big_error(bignum_pow(base, base, (uint32_t)e));
+}
+
+static math_result_t big_fact(bignum_t* n) {
+    int32_t value;
+    if (bignum_to_int32(n, &value) != SUCCESS) {
+        return n->negative ? MATH_ERROR_INVALID_EXPR : MATH_ERROR_OVERFLOW;
+    }
+    if (value < 0) {
+        return MATH_ERROR_INVALID_EXPR;
+    }
+    return big_error(bignum_factorial(n, (uint32_t)value));
+}
+
+static math_result_t big_binary(uint8_t op, bignum_t* a, const bignum_t* b) {
+    switch (op) {
+        case OP_ADD: return big_error(bignum_add(a, a, b));
+        case OP_SUB: return big_error(bignum_sub(a, a, b));
+        case OP_MUL: return big_error(bignum_mul(a, a, b));
+        case OP_DIV: return big_error(bignum_divmod(a, NULL, a, b));
+        case OP_MOD: return big_error(bignum_divmod(NULL, a, a, b));
+        case OP_POW: return big_pow(a, b);
+        default: return MATH_ERROR_INVALID_EXPR;
+    }
+}
+
+// Той самий байткод на стеку довгих чисел; OP_PUSHBIG читає літерал з тексту
+static math_result_t interpret_big(const expr_t* expr, const char* source, int32_t x, bignum_t* result) {
+    bignum_t stack[EXPR_MAX_STACK];
+    uint32_t sp = 0;
+    math_result_t error = MATH_SUCCESS;
+    const uint8_t* pc = expr->code;
+
+    for (uint32_t i = 0; i < expr->max_stack; i++) {
+        bignum_init(&stack[i]);
+    }
+
+    while (error == MATH_SUCCESS && *pc != OP_END) {
+        uint8_t op = *pc++;
+        switch (op) {
+            case OP_PUSH8:
+                error = big_error(bignum_set_int(&stack[sp++], (int8_t)*pc++));
+                break;
+            case OP_PUSH32:
+                error = big_error(bignum_set_int(&stack[sp++], read_imm32(pc)));
+                pc += 4;
+                break;
+            case OP_LOADX:
+                error = big_error(bignum_set_int(&stack[sp++], x));
+                break;
+            case OP_PUSHBIG:
+                error = big_error(bignum_from_string(&stack[sp++], source + pc[0], pc[1]));
+                pc += 2;
+                break;
+            case OP_NEG:
+                stack[sp - 1].negative = !stack[sp - 1].negative && !bignum_is_zero(&stack[sp - 1]);
+                break;
+            case OP_FACT:
+                error = big_fact(&stack[sp - 1]);
+                break;
+            default:
+                error = big_binary(op, &stack[sp - 2], &stack[sp - 1]);
+                sp--;
+                break;
+        }
+    }
+
+    if (error == MATH_SUCCESS) {
+        // Вершину віддаємо без копіювання
+        bignum_free(result);
+        *result = stack[sp - 1];
+        bignum_init(&stack[sp - 1]);
+    }
+    for (uint32_t i = 0; i < expr->max_stack; i++) {
+        bignum_free(&stack[i]);
+    }
+    return error;
+}
+
+math_result_t expr_eval_big(const char* source, bignum_t* result) {
+    expr_t* expr;
+    math_result_t error = expr_lookup(source, &expr);
+    if (error != MATH_SUCCESS) {
+        return error;
+    }
+    if (expr->uses_x) {
+        return MATH_ERROR_INVALID_EXPR;
+    }
+    return interpret_big(expr, source, 0, result);
+}
+
+const char* expr_error_string(math_result_t error) {
+    switch (error) {
+        case MATH_SUCCESS: return "успіх";
+        case MATH_ERROR_DIV_BY_ZERO: return "ділення на нуль";
+        case MATH_ERROR_OVERFLOW: return "переповнення int32";
+        case MATH_ERROR_PARSE_FAIL: return "синтаксична помилка";
+        default: return "некоректний вираз";
+    }
+}
+
+// === КОМАНДА CALC ===
+
+static void write_int64(int64_t value) {
+    if (value < 0) {
+        terminal_writestring("-");
+        terminal_writeuint((uint64_t)0 - (uint64_t)value);
+    } else {
+        terminal_writeuint((uint64_t)value);
+    }
+}
+
+static void write_error(math_result_t error) {
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("Помилка: ");
+    terminal_writestring(expr_error_string(error));
+    terminal_writestring("\n");
+}
+
+// Межа діапазону - константний вираз (наприклад, 10^7)
+static math_result_t eval_bound(const char* text, int32_t* value) {
+    expr_t bound;
+    math_result_t error = expr_compile(text, &bound);
+    if (error != MATH_SUCCESS) {
+        return error;
+    }
+    if (bound.uses_x) {
+        return MATH_ERROR_INVALID_EXPR;
+    }
+    return expr_interpret(&bound, 0, value);
+}
+
+// Сума f(x) для x у [from, to] одним із рівнів; при помилці - x, де вона сталася
+static math_result_t sum_range(expr_t* expr, int use_jit, int32_t from, int32_t to,
+                               int64_t* sum, int32_t* failed_x, uint64_t* cycles) {
+    int64_t total = 0;
+    int32_t value;
+    math_result_t error = MATH_SUCCESS;
+    uint64_t start = rdtsc();
+
+    for (int32_t x = from; ; x++) {
+        if (use_jit) {
+            value = expr->jit(x, &error);
+        } else {
+            error = expr_interpret(expr, x, &value);
+        }
+        if (error != MATH_SUCCESS) {
+            *failed_x = x;
+            break;
+        }
+        total += value;
+        if (x == to) {
+            break;
+        }
+    }
+
+    *cycles = rdtsc() - start;
+    *sum = total;
+    return error;
+}
+
+static void write_timing(const char* label, uint64_t cycles, uint32_t count) {
+    uint32_t rem;
+    uint64_t per_eval = div64_u32(cycles, count, &rem);
+    terminal_writestring(label);
+    terminal_writeuint(div64_u32(tsc_cycles_to_ns(cycles), NS_PER_MS, NULL));
+    terminal_writestring(" мс, ");
+    terminal_writeuint(per_eval);
+    terminal_writestring(".");
+    terminal_writeuint((uint32_t)div64_u32((uint64_t)rem * 10, count, NULL));
+    terminal_writestring(" тактів/x");
+}
+
+// Значення, що не влізло в int32: повторне обчислення довгою арифметикою
+static void write_big_value(const char* source) {
+    bignum_t value;
+    bignum_init(&value);
+    uint64_t start = rdtsc();
+    math_result_t error = expr_eval_big(source, &value);
+    uint64_t cycles = rdtsc() - start;
+
+    if (error != MATH_SUCCESS) {
+        write_error(error);
+    } else {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+        terminal_writestring("= ");
+        bignum_write(&value);
+        terminal_writestring("\n");
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
+        terminal_writestring("Довга арифметика: ");
+        terminal_writeuint(value.size);
+        terminal_writestring(" лімбів, ");
+        terminal_writeuint(div64_u32(tsc_cycles_to_ns(cycles), 1000, NULL));
+        terminal_writestring(" мкс\n");
+    }
+    bignum_free(&value);
+}
+
+void expr_calc(const char* args) {
+    char source[EXPR_MAX_SOURCE];
+    int32_t from = 0, to = 0;
+    int ranged = false;
+
+    // calc <вираз> [x=A..B]
+    size_t len = strlen(args);
+    if (len >= EXPR_MAX_SOURCE) {
+        write_error(MATH_ERROR_INVALID_EXPR);
+        return;
+    }
+    strcpy(source, args);
+
+    for (char* p = source; *p; p++) {
+        if (p[0] == 'x' && p[1] == '=' && (p == source || p[-1] == ' ')) {
+            char* dots = p + 2;
+            while (*dots && !(dots[0] == '.' && dots[1] == '.')) {
+                dots++;
+            }
+            if (!*dots) {
+                write_error(MATH_ERROR_PARSE_FAIL);
+                return;
+            }
+            *p = '\0';
+            *dots = '\0';
+            math_result_t error = eval_bound(p + 2, &from);
+            if (error == MATH_SUCCESS) {
+                error = eval_bound(dots + 2, &to);
+            }
+            if (error != MATH_SUCCESS) {
+                write_error(error);
+                return;
+            }
+            ranged = true;
+            break;
+        }
+    }
+
+    expr_t* expr;
+    math_result_t error = expr_lookup(source, &expr);
+    if (error != MATH_SUCCESS) {
+        write_error(error);
+        return;
+    }
+
+    if (!ranged) {
+        if (expr->uses_x) {
+            terminal_writestring("Вираз містить x - вкажіть діапазон x=A..B\n");
+            return;
+        }
+        int32_t value;
+        error = expr_eval(expr, 0, &value);
+        if (error == MATH_ERROR_OVERFLOW) {
+            write_big_value(source);
+            return;
+        }
+        if (error != MATH_SUCCESS) {
+            write_error(error);
+            return;
+        }
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+        terminal_writestring("= ");
+        write_int64(value);
+        terminal_writestring("\n");
+        return;
+    }
+
+    if (to < from || (int64_t)to - from >= 0x80000000ll) {
+        terminal_writestring("Діапазон: A <= B, не більше 2^31 значень\n");
+        return;
+    }
+    uint32_t count = (uint32_t)((int64_t)to - from + 1);
+
+    if (expr_jit_compile(expr) != SUCCESS) {
+        terminal_writestring("Недостатньо пам'яті для машинного коду\n");
+        return;
+    }
+
+    terminal_writestring("Байткод: ");
+    terminal_writeuint(expr->length);
+    terminal_writestring(" Б, глибина стеку ");
+    terminal_writeuint(expr->max_stack);
+    terminal_writestring(", машинний код: ");
+    terminal_writeuint(expr->jit_size);
+    terminal_writestring(" Б\n");
+
+    int64_t sum_interp, sum_jit;
+    int32_t failed_interp = 0, failed_jit = 0;
+    uint64_t cycles_interp, cycles_jit;
+    math_result_t error_interp = sum_range(expr, false, from, to, &sum_interp, &failed_interp, &cycles_interp);
+    math_result_t error_jit = sum_range(expr, true, from, to, &sum_jit, &failed_jit, &cycles_jit);
+
+    if (error_interp != error_jit || sum_interp != sum_jit || failed_interp != failed_jit) {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Розбіжність інтерпретатора та JIT!\n");
+        return;
+    }
+    if (error_interp != MATH_SUCCESS) {
+        write_error(error_interp);
+        terminal_writestring("  при x = ");
+        write_int64(failed_interp);
+        terminal_writestring("\n");
+        return;
+    }
+
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+    terminal_writestring("Сума f(x) для x = ");
+    write_int64(from);
+    terminal_writestring("..");
+    write_int64(to);
+    terminal_writestring(": ");
+    write_int64(sum_interp);
+    terminal_writestring("\n");
+
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
+    write_timing("Інтерпретатор: ", cycles_interp, count);
+    terminal_writestring("\n");
+    write_timing("JIT:           ", cycles_jit, count);
+
+    // Прискорення з одним знаком після коми; дільник має влазити в 32 біти
+    while (cycles_jit > 0xFFFFFFFFull) {
+        cycles_jit >>= 1;
+        cycles_interp >>= 1;
+    }
+    if (cycles_jit) {
+        uint32_t rem;
+        uint64_t speedup = div64_u32(cycles_interp * 10, (uint32_t)cycles_jit, &rem);
+        uint32_t tenths;
+        terminal_writestring(", прискорення ");
+        terminal_writeuint(div64_u32(speedup, 10, &tenths));
+        terminal_writestring(".");
+        terminal_writeuint(tenths);
+        terminal_writestring("x");
+    }
+    terminal_writestring("\n");
+}
+
+void expr_print_stats(void) {
+    terminal_writestring("Кеш виразів: ");
+    terminal_writeuint(cache_hits);
+    terminal_writestring(" влучань, ");
+    terminal_writeuint(cache_misses);
+    terminal_writestring(" промахів; компіляцій: ");
+    terminal_writeuint(compiles);
+    terminal_writestring(", згорнуто операцій: ");
+    terminal_writeuint(folded_ops);
+    terminal_writestring(", JIT: ");
+    terminal_writeuint(jit_compiles);
+    terminal_writestring("\n");
+
+    for (uint32_t i = 0; i < EXPR_CACHE_SIZE; i++) {
+        if (!cache[i].valid) {
+            continue;
+        }
+        terminal_writestring("  ");
+        terminal_writestring(cache[i].source);
+        terminal_writestring(" - ");
+        terminal_writeuint(cache[i].expr.length);
+        terminal_writestring(" Б байткоду");
+        if (cache[i].expr.jit) {
+            terminal_writestring(", JIT ");
+            terminal_writeuint(cache[i].expr.jit_size);
+            terminal_writestring(" Б");
+        }
+        terminal_writestring("\n");
+    }
+}
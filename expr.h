@@ -0,0 +1,79 @@
+#ifndef EXPR_H
+#define EXPR_H
+
+#include "kernel.h"
+#include "bignum.h"
+
+// Обмеження виразу: текст, байткод, глибина стеку та вкладеності дужок
+#define EXPR_MAX_SOURCE         128
+#define EXPR_MAX_CODE           96
+#define EXPR_MAX_STACK          32
+#define EXPR_MAX_DEPTH          32
+
+// Кеш скомпільованих виразів за текстом (LRU)
+#define EXPR_CACHE_SIZE         16
+
+// Після стількох обчислень вираз компілюється в машинний код
+#define EXPR_JIT_THRESHOLD      64
+
+// Найдовша послідовність x86 на одну інструкцію байткоду (OP_POW на x86_64)
+#define EXPR_JIT_MAX_OP         40
+#define EXPR_JIT_MAX_CODE       (EXPR_MAX_CODE * EXPR_JIT_MAX_OP + 64)
+
+// Інструкції стекової машини; PUSH8/PUSH32 несуть безпосередній операнд
+typedef enum {
+    OP_END = 0,
+    OP_PUSH8,           // знакове 8-бітне число
+    OP_PUSH32,          // 32-бітне число, little-endian
+    OP_LOADX,           // змінна x
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_POW,
+    OP_NEG,
+    OP_FACT,            // постфіксний n!
+    OP_PUSHBIG          // десятковий літерал поза int32: зміщення та довжина в тексті
+} expr_op_t;
+
+// int fn(int x, math_result_t* error) - згенерований JIT код
+typedef int32_t (*expr_jit_fn_t)(int32_t x, math_result_t* error);
+
+typedef struct expr {
+    uint8_t code[EXPR_MAX_CODE];
+    uint16_t length;
+    uint8_t max_stack;
+    uint8_t uses_x;
+    uint8_t uses_big;           // OP_PUSHBIG: у int32 лише переповнення
+    uint32_t evals;
+    expr_jit_fn_t jit;          // NULL, доки вираз не став гарячим
+    uint16_t jit_size;
+} expr_t;
+
+// Компіляція тексту в байткод зі згортанням констант
+math_result_t expr_compile(const char* source, expr_t* expr);
+
+// Скомпільований вираз з кешу (компілюється при промаху)
+math_result_t expr_lookup(const char* source, expr_t** expr);
+
+// Обчислення: через JIT, коли вираз гарячий, інакше інтерпретатором
+math_result_t expr_eval(expr_t* expr, int32_t x, int32_t* result);
+math_result_t expr_interpret(const expr_t* expr, int32_t x, int32_t* result);
+
+// Обчислення в довгій арифметиці (після MATH_ERROR_OVERFLOW у int32);
+// source - той самий текст, з якого скомпільовано вираз
+math_result_t expr_eval_big(const char* source, bignum_t* result);
+
+// Машинний код для виразу; SUCCESS, якщо expr->jit готовий
+int expr_jit_compile(expr_t* expr);
+void expr_release(expr_t* expr);
+
+// Текст помилки для користувача
+const char* expr_error_string(math_result_t error);
+
+// Команда calc: одне значення або сума f(x) на діапазоні з порівнянням рівнів
+void expr_calc(const char* args);
+void expr_print_stats(void);
+
+#endif
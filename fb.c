@@ -0,0 +1,485 @@
+#include "fb.h"
+#include "cpu.h"
+#include "fpu.h"
+#include "multiboot.h"
+#include "pmm.h"
+#include "string.h"
+#include "timer.h"
+#include "vmm.h"
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+
+// Значення drawn[]: код гліфа | атрибут << 8, курсор - окремий біт
+#define CELL_CURSOR         0x10000u
+#define CELL_INVALID        0xFFFFFFFFu
+
+#define SLOT_FREE           0xFFFF
+
+// Стандартна палітра текстового режиму VGA (0xRRGGBB)
+static const uint32_t vga_palette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+    0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF,
+};
+
+// Растр гліфів однієї пари кольорів; гліф растеризується при першому використанні
+typedef struct {
+    uint32_t* pixels;                   // FONT_GLYPHS гліфів по FB_GLYPH_BYTES
+    uint64_t last_use;
+    uint32_t valid[FONT_GLYPHS / 32];
+    uint16_t attr;                      // атрибут VGA або SLOT_FREE
+} glyph_slot_t;
+
+static int active = false;
+static int use_sse2 = false;
+
+static uint8_t* framebuffer;            // write-combining відображення
+static uint32_t fb_pitch;               // байтів у рядку пікселів
+static uint32_t fb_width;
+static uint32_t fb_height;
+
+// Задній буфер у кешованій RAM: лише область текстової сітки
+static uint32_t* back;
+static uint32_t back_pitch;             // пікселів у рядку
+static uint32_t columns;
+static uint32_t rows;
+
+static uint32_t palette[16];            // кольори у форматі пікселя буфера
+
+// Що зараз намальовано в кожній клітинці заднього буфера
+static uint32_t drawn[FB_MAX_ROWS][FB_MAX_COLUMNS];
+
+// Пошкоджений проміжок клітинок кожного рядка: [start, end)
+static uint16_t damage_start[FB_MAX_ROWS];
+static uint16_t damage_end[FB_MAX_ROWS];
+
+static uint32_t cursor_column;
+static uint32_t cursor_row;
+static int cursor_visible = false;
+
+static glyph_slot_t slots[FB_GLYPH_SLOTS];
+static glyph_slot_t* last_slot;
+static uint64_t use_clock = 0;
+
+// Статистика
+static uint64_t glyphs_drawn = 0;
+static uint64_t glyphs_skipped = 0;
+static uint64_t glyphs_rasterized = 0;
+static uint64_t slot_evictions = 0;
+static uint64_t presents = 0;
+static uint64_t rects_presented = 0;
+static uint64_t bytes_presented = 0;
+static uint64_t scrolls = 0;
+
+static inline uint32_t* glyph_pixels(glyph_slot_t* slot, uint8_t glyph) {
+    return slot->pixels + (uint32_t)glyph * FONT_WIDTH * FONT_HEIGHT;
+}
+
+static inline uint32_t* cell_pixels(uint32_t column, uint32_t row) {
+    return back + row * FONT_HEIGHT * back_pitch + column * FONT_WIDTH;
+}
+
+static uint32_t pack_color(const struct multiboot_tag_framebuffer* tag, uint32_t rgb) {
+    uint32_t r = (rgb >> 16) & 0xFF;
+    uint32_t g = (rgb >> 8) & 0xFF;
+    uint32_t b = rgb & 0xFF;
+    return (r >> (8 - tag->red_mask_size)) << tag->red_field_position |
+           (g >> (8 - tag->green_mask_size)) << tag->green_field_position |
+           (b >> (8 - tag->blue_mask_size)) << tag->blue_field_position;
+}
+
+static void damage_cell(uint32_t column, uint32_t row) {
+    if (column < damage_start[row]) {
+        damage_start[row] = (uint16_t)column;
+    }
+    if (column >= damage_end[row]) {
+        damage_end[row] = (uint16_t)(column + 1);
+    }
+}
+
+static void damage_all(void) {
+    for (uint32_t y = 0; y < rows; y++) {
+        damage_start[y] = 0;
+        damage_end[y] = (uint16_t)columns;
+    }
+}
+
+// === КЕШ ГЛІФІВ ===
+
+// Останній слот перевіряється першим: текст майже завжди одного кольору
+static glyph_slot_t* slot_for(uint8_t attr) {
+    if (last_slot->attr == attr) {
+        return last_slot;
+    }
+    glyph_slot_t* victim = &slots[0];
+    glyph_slot_t* slot = NULL;
+    for (uint32_t i = 0; i < FB_GLYPH_SLOTS; i++) {
+        if (slots[i].attr == attr) {
+            slot = &slots[i];
+            break;
+        }
+        if (slots[i].last_use < victim->last_use) {
+            victim = &slots[i];
+        }
+    }
+    if (!slot) {
+        // Витісняємо найдавніше використану пару кольорів
+        if (victim->attr != SLOT_FREE) {
+            slot_evictions++;
+        }
+        slot = victim;
+        slot->attr = attr;
+        memset(slot->valid, 0, sizeof(slot->valid));
+    }
+    slot->last_use = ++use_clock;
+    last_slot = slot;
+    return slot;
+}
+
+static void rasterize(glyph_slot_t* slot, uint8_t glyph) {
+    uint32_t fg = palette[slot->attr & 0x0F];
+    uint32_t bg = palette[(slot->attr >> 4) & 0x0F];
+    uint32_t* out = glyph_pixels(slot, glyph);
+    for (uint32_t y = 0; y < FONT_HEIGHT; y++) {
+        uint8_t bits = font8x16[glyph][y];
+        for (uint32_t x = 0; x < FONT_WIDTH; x++) {
+            *out++ = (bits & (0x80 >> x)) ? fg : bg;
+        }
+    }
+    slot->valid[glyph >> 5] |= 1u << (glyph & 31);
+    glyphs_rasterized++;
+}
+
+// === БЛІТ ===
+
+// Рядок гліфа - 32 байти: два вирівняні 16-байтні записи SSE2. Викликається
+// в секції kernel_fpu (draw_cell), рядок екрана - одна зовнішня секція
+SSE2_TARGET
+static void blit_sse2(uint32_t* dest, const uint32_t* glyph) {
+    size_t pitch = back_pitch * sizeof(uint32_t);
+    uint32_t count = FONT_HEIGHT;
+    asm volatile(
+        "1:\n\t"
+        "movdqa (%[s]), %%xmm0\n\t"
+        "movdqa 16(%[s]), %%xmm1\n\t"
+        "movdqa %%xmm0, (%[d])\n\t"
+        "movdqa %%xmm1, 16(%[d])\n\t"
+        "add $32, %[s]\n\t"
+        "add %[p], %[d]\n\t"
+        "dec %[c]\n\t"
+        "jnz 1b"
+        : [s] "+r"(glyph), [d] "+r"(dest), [c] "+r"(count)
+        : [p] "r"(pitch)
+        : "xmm0", "xmm1", "memory", "cc");
+}
+
+static void blit_generic(uint32_t* dest, const uint32_t* glyph) {
+    for (uint32_t y = 0; y < FONT_HEIGHT; y++) {
+        for (uint32_t x = 0; x < FONT_WIDTH; x++) {
+            dest[x] = glyph[x];
+        }
+        dest += back_pitch;
+        glyph += FONT_WIDTH;
+    }
+}
+
+static void draw_cell(uint32_t column, uint32_t row, uint32_t cell) {
+    uint8_t glyph = cell & 0xFF;
+    uint8_t attr = (cell >> 8) & 0xFF;
+    glyph_slot_t* slot = slot_for(attr);
+    if (!(slot->valid[glyph >> 5] & (1u << (glyph & 31)))) {
+        rasterize(slot, glyph);
+    }
+
+    uint32_t* dest = cell_pixels(column, row);
+    if (use_sse2) {
+        kernel_fpu_begin();
+        blit_sse2(dest, glyph_pixels(slot, glyph));
+        kernel_fpu_end();
+    } else {
+        blit_generic(dest, glyph_pixels(slot, glyph));
+    }
+
+    if (cell & CELL_CURSOR) {
+        uint32_t* line = dest + (FONT_HEIGHT - FB_CURSOR_HEIGHT) * back_pitch;
+        for (uint32_t y = 0; y < FB_CURSOR_HEIGHT; y++, line += back_pitch) {
+            for (uint32_t x = 0; x < FONT_WIDTH; x++) {
+                line[x] = palette[attr & 0x0F];
+            }
+        }
+    }
+
+    drawn[row][column] = cell;
+    damage_cell(column, row);
+    glyphs_drawn++;
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int fb_init(void) {
+    struct multiboot_tag_framebuffer* tag =
+        (struct multiboot_tag_framebuffer*)multiboot_find_tag(MULTIBOOT_TAG_TYPE_FRAMEBUFFER);
+    // Текстовий режим (gfxpayload=text) або формат, який ми не малюємо
+    if (!tag || tag->framebuffer_type != MULTIBOOT_FRAMEBUFFER_TYPE_RGB || tag->framebuffer_bpp != 32 ||
+        tag->red_mask_size > 8 || tag->green_mask_size > 8 || tag->blue_mask_size > 8) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Буфер відображається identity, тож має лежати нижче 4 ГБ і поза
+    // віртуальними областями ядра
+    uint64_t start = tag->framebuffer_addr;
+    uint64_t end = start + (uint64_t)tag->framebuffer_pitch * tag->framebuffer_height;
+    if (end > 0x100000000ull || (start < VMM_HEAP_LIMIT && end > VMM_BENCH_BASE)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    fb_width = tag->framebuffer_width;
+    fb_height = tag->framebuffer_height;
+    fb_pitch = tag->framebuffer_pitch;
+    columns = fb_width / FONT_WIDTH < FB_MAX_COLUMNS ? fb_width / FONT_WIDTH : FB_MAX_COLUMNS;
+    rows = fb_height / FONT_HEIGHT < FB_MAX_ROWS ? fb_height / FONT_HEIGHT : FB_MAX_ROWS;
+    // Менший за текстовий режим екран не вмістить звичний вивід
+    if (columns < VGA_WIDTH || rows < VGA_HEIGHT) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    framebuffer = vmm_map_mmio((uintptr_t)start, (size_t)(end - start), VMM_WC);
+    if (!framebuffer) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    back_pitch = columns * FONT_WIDTH;
+    size_t back_bytes = (size_t)back_pitch * rows * FONT_HEIGHT * sizeof(uint32_t);
+    size_t back_frames = (back_bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t cache_frames = FB_GLYPH_SLOTS * FONT_GLYPHS * FB_GLYPH_BYTES / PAGE_SIZE;
+    back = (uint32_t*)pmm_alloc_frames(back_frames);
+    uint8_t* cache = (uint8_t*)pmm_alloc_frames(cache_frames);
+    if (!back || !cache) {
+        if (back) {
+            pmm_free_frames((uintptr_t)back, back_frames);
+        }
+        if (cache) {
+            pmm_free_frames((uintptr_t)cache, cache_frames);
+        }
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    for (uint32_t i = 0; i < 16; i++) {
+        palette[i] = pack_color(tag, vga_palette[i]);
+    }
+    for (uint32_t i = 0; i < FB_GLYPH_SLOTS; i++) {
+        slots[i].pixels = (uint32_t*)(cache + i * FONT_GLYPHS * FB_GLYPH_BYTES);
+        slots[i].attr = SLOT_FREE;
+        slots[i].last_use = 0;
+    }
+    last_slot = &slots[0];
+
+    // Нульовий піксель чорний у будь-якому RGB-форматі; поле поза сіткою
+    // очищується один раз
+    memset(back, 0, back_bytes);
+    memset(framebuffer, 0, (size_t)(end - start));
+    for (uint32_t y = 0; y < FB_MAX_ROWS; y++) {
+        for (uint32_t x = 0; x < FB_MAX_COLUMNS; x++) {
+            drawn[y][x] = CELL_INVALID;
+        }
+        damage_start[y] = FB_MAX_COLUMNS;
+        damage_end[y] = 0;
+    }
+
+    use_sse2 = (cpu_features & CPU_FEATURE_SSE2) != 0;
+    active = true;
+    return SUCCESS;
+}
+
+int fb_active(void) {
+    return active;
+}
+
+uint32_t fb_columns(void) {
+    return columns;
+}
+
+uint32_t fb_rows(void) {
+    return rows;
+}
+
+// === РЕНДЕР ===
+
+void fb_draw_row(uint32_t row, const uint16_t* cells, uint32_t count) {
+    if (!active || row >= rows) {
+        return;
+    }
+    if (count > columns) {
+        count = columns;
+    }
+    kernel_fpu_begin();
+    for (uint32_t x = 0; x < count; x++) {
+        uint32_t cell = cells[x];
+        if (cursor_visible && row == cursor_row && x == cursor_column) {
+            cell |= CELL_CURSOR;
+        }
+        // Незмінена клітинка не растеризується і не пошкоджує рядок
+        if (cell == drawn[row][x]) {
+            glyphs_skipped++;
+            continue;
+        }
+        draw_cell(x, row, cell);
+    }
+    kernel_fpu_end();
+}
+
+// Апаратного зсуву в лінійному буфері немає: зсуваємо задній буфер і drawn[],
+// після чого весь екран копіюється у відеопам'ять одним проходом
+void fb_scroll(uint32_t lines) {
+    if (!active || lines == 0) {
+        return;
+    }
+    scrolls++;
+    // Зсув на весь екран нічого не зберігає - drawn[] і так описує задній буфер
+    if (lines >= rows) {
+        return;
+    }
+
+    size_t row_pixels = (size_t)back_pitch * FONT_HEIGHT;
+    memmove(back, back + lines * row_pixels, (rows - lines) * row_pixels * sizeof(uint32_t));
+    memmove(drawn[0], drawn[lines], (rows - lines) * sizeof(drawn[0]));
+    if (cursor_visible) {
+        if (cursor_row >= lines) {
+            cursor_row -= lines;
+        } else {
+            cursor_visible = false;
+        }
+    }
+    damage_all();
+}
+
+void fb_set_cursor(uint32_t column, uint32_t row, int visible) {
+    if (!active) {
+        return;
+    }
+    if (column >= columns || row >= rows) {
+        visible = false;
+    }
+    if (cursor_visible) {
+        uint32_t cell = drawn[cursor_row][cursor_column];
+        if (cell != CELL_INVALID && (cell & CELL_CURSOR)) {
+            draw_cell(cursor_column, cursor_row, cell & ~CELL_CURSOR);
+        }
+    }
+    cursor_column = column;
+    cursor_row = row;
+    cursor_visible = visible;
+    if (visible) {
+        uint32_t cell = drawn[row][column];
+        if (cell != CELL_INVALID && !(cell & CELL_CURSOR)) {
+            draw_cell(column, row, cell | CELL_CURSOR);
+        }
+    }
+}
+
+void fb_present(void) {
+    if (!active) {
+        return;
+    }
+    size_t back_bytes = (size_t)back_pitch * sizeof(uint32_t);
+    for (uint32_t y = 0; y < rows; y++) {
+        if (damage_end[y] <= damage_start[y]) {
+            continue;
+        }
+        size_t offset = (size_t)damage_start[y] * FONT_WIDTH * sizeof(uint32_t);
+        size_t bytes = (size_t)(damage_end[y] - damage_start[y]) * FONT_WIDTH * sizeof(uint32_t);
+        const uint8_t* src = (const uint8_t*)cell_pixels(0, y) + offset;
+        uint8_t* dest = framebuffer + (size_t)y * FONT_HEIGHT * fb_pitch + offset;
+
+        if (bytes == back_bytes && fb_pitch == back_bytes) {
+            // Повний рядок при однаковому кроці - одна суцільна ділянка
+            memcpy(dest, src, bytes * FONT_HEIGHT);
+        } else {
+            for (uint32_t line = 0; line < FONT_HEIGHT; line++) {
+                memcpy(dest, src, bytes);
+                src += back_bytes;
+                dest += fb_pitch;
+            }
+        }
+        rects_presented++;
+        bytes_presented += bytes * FONT_HEIGHT;
+        damage_start[y] = FB_MAX_COLUMNS;
+        damage_end[y] = 0;
+    }
+    // Блокована операція виштовхує буфери write-combining
+    __sync_synchronize();
+    presents++;
+}
+
+// === СТАТИСТИКА ===
+
+void fb_print_stats(void) {
+    terminal_writestring("Буфер кадрів: ");
+    terminal_writeuint(fb_width);
+    terminal_writestring("x");
+    terminal_writeuint(fb_height);
+    terminal_writestring(", сітка ");
+    terminal_writeuint(columns);
+    terminal_writestring("x");
+    terminal_writeuint(rows);
+    terminal_writestring(use_sse2 ? ", бліт SSE2\n" : ", бліт скалярний\n");
+    terminal_writestring("Гліфів намальовано: ");
+    terminal_writeuint(glyphs_drawn);
+    terminal_writestring(", пропущено незмінених: ");
+    terminal_writeuint(glyphs_skipped);
+    terminal_writestring("\nКеш гліфів: растеризовано ");
+    terminal_writeuint(glyphs_rasterized);
+    terminal_writestring(", витіснень пар кольорів: ");
+    terminal_writeuint(slot_evictions);
+    terminal_writestring("\nПоказів: ");
+    terminal_writeuint(presents);
+    terminal_writestring(", прямокутників: ");
+    terminal_writeuint(rects_presented);
+    terminal_writestring(", КБ у відеопам'ять: ");
+    terminal_writeuint(bytes_presented / 1024);
+    terminal_writestring(", прокруток: ");
+    terminal_writeuint(scrolls);
+    terminal_writestring("\n");
+}
+
+// === БЕНЧМАРК ===
+
+void fb_benchmark(uint32_t glyphs, uint64_t* direct_cycles, uint64_t* cached_cycles) {
+    uint32_t cells = columns * rows;
+
+    // Наївний шлях: кожен піксель гліфа окремим записом у відеопам'ять
+    uint32_t fg = palette[VGA_COLOR_LIGHT_GREY];
+    uint32_t bg = palette[VGA_COLOR_BLACK];
+    uint64_t start = rdtsc();
+    for (uint32_t i = 0; i < glyphs; i++) {
+        uint32_t cell = i % cells;
+        const uint8_t* bits = font8x16[0x20 + i % 95];
+        uint8_t* dest = framebuffer + (size_t)(cell / columns) * FONT_HEIGHT * fb_pitch +
+                        (cell % columns) * FONT_WIDTH * sizeof(uint32_t);
+        for (uint32_t y = 0; y < FONT_HEIGHT; y++, dest += fb_pitch) {
+            volatile uint32_t* line = (volatile uint32_t*)dest;
+            for (uint32_t x = 0; x < FONT_WIDTH; x++) {
+                line[x] = (bits[y] & (0x80 >> x)) ? fg : bg;
+            }
+        }
+    }
+    __sync_synchronize();
+    *direct_cycles = rdtsc() - start;
+
+    // Кеш гліфів і SSE2 у задній буфер, показ після кожного рядка сітки
+    uint32_t attr = vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
+    start = rdtsc();
+    kernel_fpu_begin();
+    for (uint32_t i = 0; i < glyphs; i++) {
+        uint32_t cell = i % cells;
+        draw_cell(cell % columns, cell / columns, (0x20 + i % 95) | attr << 8);
+        if (cell % columns == columns - 1) {
+            fb_present();
+        }
+    }
+    kernel_fpu_end();
+    fb_present();
+    *cached_cycles = rdtsc() - start;
+
+    // drawn[] описує задній буфер, але відеопам'ять перезаписана наївним шляхом
+    damage_all();
+}
@@ -0,0 +1,49 @@
+#ifndef FB_H
+#define FB_H
+
+#include "kernel.h"
+#include "font.h"
+
+// Графічна консоль поверх лінійного буфера кадрів з Multiboot2 (RGB, 32 біти):
+// клітинки рендеряться в задній буфер у RAM, у відеопам'ять ідуть лише
+// пошкоджені прямокутники
+
+// Найбільша текстова сітка (1024x768 гліфами 8x16); більший екран
+// використовується лише в лівому верхньому куті
+#define FB_MAX_COLUMNS          128
+#define FB_MAX_ROWS             48
+
+// Кеш гліфів: растр 8x16 у форматі пікселя буфера для кількох пар кольорів
+#define FB_GLYPH_SLOTS          8
+#define FB_GLYPH_BYTES          (FONT_WIDTH * FONT_HEIGHT * sizeof(uint32_t))
+
+// Курсор - підкреслення в нижніх рядках клітинки
+#define FB_CURSOR_HEIGHT        2
+
+// Розбір тегу Multiboot2, відображення буфера як write-combining, задній буфер
+int fb_init(void);
+int fb_active(void);
+uint32_t fb_columns(void);
+uint32_t fb_rows(void);
+
+// Рендер рядка клітинок VGA (символ | атрибут << 8); змінені клітинки
+// розширюють пошкоджений проміжок рядка
+void fb_draw_row(uint32_t row, const uint16_t* cells, uint32_t count);
+
+// Зсув вмісту на lines рядків угору одним memmove заднього буфера
+void fb_scroll(uint32_t lines);
+
+// Курсор у клітинці (column, row); visible = false ховає його
+void fb_set_cursor(uint32_t column, uint32_t row, int visible);
+
+// Копіювання пошкоджених прямокутників у відеопам'ять
+void fb_present(void);
+
+// Статистика
+void fb_print_stats(void);
+
+// Бенчмарк гліфів (під vga_lock): наївний попіксельний вивід у відеопам'ять
+// проти кешу гліфів з SSE2-блітом і показом пошкоджених рядків
+void fb_benchmark(uint32_t glyphs, uint64_t* direct_cycles, uint64_t* cached_cycles);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include "kernel.h"
+
+// Растровий шрифт 8x16: рядок гліфа - байт, старший біт - лівий піксель
+#define FONT_WIDTH          8
+#define FONT_HEIGHT         16
+#define FONT_GLYPHS         256
+
+// Розкладка кодів - CP1125: ASCII, кирилиця на місцях CP866, Ґ/Є/І/Ї у 0xF2-0xF9
+#define FONT_REPLACEMENT    0xFE    // ■ для символів без гліфа
+
+extern const uint8_t font8x16[FONT_GLYPHS][FONT_HEIGHT];
+
+// Код гліфа для символу Unicode (декодований UTF-8)
+uint8_t font_glyph(uint32_t codepoint);
+
+#endif
@@ -0,0 +1,489 @@
+#include "fpu.h"
+#include "cpu.h"
+#include "heap.h"
+#include "irq.h"
+#include "multiboot.h"
+#include "timer.h"
+
+#define CR0_TS                  (1u << 3)
+
+// CPUID.(0Dh,1):EAX - XSAVEOPT
+#define CPUID_D1_XSAVEOPT       (1u << 0)
+
+// Поля області FXSAVE (спільні з легасі-частиною XSAVE) та початкові значення
+#define FXSAVE_FCW              0
+#define FXSAVE_MXCSR            24
+#define FPU_INIT_FCW            0x037F
+#define FPU_INIT_MXCSR          0x1F80
+
+// Формат з 64-бітними вказівниками FPU IP/DP у long mode
+#ifdef __x86_64__
+#define FPU_INSN(name)          name "64"
+#else
+#define FPU_INSN(name)          name
+#endif
+
+typedef enum {
+    FPU_SAVE_FXSAVE,
+    FPU_SAVE_XSAVE,
+    FPU_SAVE_XSAVEOPT
+} fpu_save_t;
+
+// Секція kernel_fpu процесора: вкладеність, прапорці та чий стан повернути
+typedef struct {
+    uint32_t depth;
+    unsigned long flags;
+    thread_t* restore;
+    uint64_t regions;
+    uint64_t region_saves;
+} fpu_cpu_t;
+
+static fpu_mode_t mode = FPU_MODE_NONE;
+static fpu_save_t save_kind = FPU_SAVE_FXSAVE;
+static uint32_t area_size = FPU_FXSAVE_SIZE;
+static kmem_cache_t* area_cache = NULL;
+static uint8_t* init_area = NULL;
+
+// Стан регістрів BSP: власник у lazy і програмна копія CR0.TS
+static thread_t* owner = NULL;
+static int ts_on = 0;
+
+static fpu_cpu_t percpu[SMP_MAX_CPUS];
+
+// Статистика перемикань (лише BSP)
+static uint64_t switch_saves = 0;
+static uint64_t switch_restores = 0;
+static uint64_t nm_traps = 0;
+
+static const char* mode_names[] = { "немає", "eager", "lazy" };
+static const char* save_names[] = { "FXSAVE", "XSAVE", "XSAVEOPT" };
+
+// === РЕГІСТРИ ===
+
+// Маска компонентів - усе, що дозволено в XCR0
+static inline void area_save(void* area) {
+    switch (save_kind) {
+    case FPU_SAVE_XSAVEOPT:
+        asm volatile(FPU_INSN("xsaveopt") " (%0)" : : "r"(area), "a"(0xFFFFFFFFu), "d"(0xFFFFFFFFu) : "memory");
+        break;
+    case FPU_SAVE_XSAVE:
+        asm volatile(FPU_INSN("xsave") " (%0)" : : "r"(area), "a"(0xFFFFFFFFu), "d"(0xFFFFFFFFu) : "memory");
+        break;
+    case FPU_SAVE_FXSAVE:
+        asm volatile(FPU_INSN("fxsave") " (%0)" : : "r"(area) : "memory");
+        break;
+    }
+}
+
+static inline void area_restore(const void* area) {
+    if (save_kind == FPU_SAVE_FXSAVE) {
+        asm volatile(FPU_INSN("fxrstor") " (%0)" : : "r"(area) : "memory");
+    } else {
+        asm volatile(FPU_INSN("xrstor") " (%0)" : : "r"(area), "a"(0xFFFFFFFFu), "d"(0xFFFFFFFFu) : "memory");
+    }
+}
+
+static inline void ts_set(void) {
+    if (!ts_on) {
+        unsigned long cr0;
+        asm volatile("mov %%cr0, %0" : "=r"(cr0));
+        asm volatile("mov %0, %%cr0" : : "r"(cr0 | CR0_TS));
+        ts_on = 1;
+    }
+}
+
+static inline void ts_clear(void) {
+    if (ts_on) {
+        asm volatile("clts");
+        ts_on = 0;
+    }
+}
+
+// Чиї значення зараз у регістрах BSP
+static inline int owns_registers(thread_t* thread) {
+    return mode == FPU_MODE_EAGER ? thread->fpu_used : thread == owner;
+}
+
+// TS скинуто тоді й лише тоді, коли регістри належать поточному потоку
+static void update_ts(thread_t* current) {
+    if (current && !owns_registers(current)) {
+        ts_set();
+    } else {
+        ts_clear();
+    }
+}
+
+// === #NM ===
+
+static void nm_handler(irq_frame_t* frame) {
+    (void)frame;
+    thread_t* current = sched_current();
+    if (mode == FPU_MODE_NONE || !current || this_cpu()->index != 0) {
+        asm volatile("clts");
+        ts_on = 0;
+        return;
+    }
+
+    nm_traps++;
+    ts_clear();
+    if (mode == FPU_MODE_LAZY && owner && owner != current) {
+        area_save(owner->fpu_state);
+        switch_saves++;
+    }
+    area_restore(current->fpu_state);
+    switch_restores++;
+    current->fpu_used = 1;
+    if (mode == FPU_MODE_LAZY) {
+        owner = current;
+    }
+}
+
+// === ПОТОКИ ===
+
+int fpu_thread_init(thread_t* thread) {
+    thread->fpu_used = 0;
+    thread->fpu_state = NULL;
+    if (mode == FPU_MODE_NONE) {
+        return SUCCESS;
+    }
+    thread->fpu_state = kmem_cache_alloc(area_cache);
+    if (!thread->fpu_state) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    memcpy(thread->fpu_state, init_area, area_size);
+    return SUCCESS;
+}
+
+void fpu_thread_free(thread_t* thread) {
+    if (thread == owner) {
+        owner = NULL;
+    }
+    if (thread->fpu_state) {
+        kmem_cache_free(area_cache, thread->fpu_state);
+        thread->fpu_state = NULL;
+    }
+}
+
+void fpu_switch(thread_t* prev, thread_t* next) {
+    if (mode == FPU_MODE_EAGER) {
+        if (prev->fpu_used && prev->state != THREAD_ZOMBIE) {
+            area_save(prev->fpu_state);
+            switch_saves++;
+        }
+        if (next->fpu_used) {
+            ts_clear();
+            area_restore(next->fpu_state);
+            switch_restores++;
+        } else {
+            ts_set();
+        }
+    } else if (mode == FPU_MODE_LAZY) {
+        update_ts(next);
+    }
+}
+
+// === SIMD У ЯДРІ ===
+
+// Потоки лише на BSP: на AP і до sched_init чужого стану в регістрах немає
+void kernel_fpu_begin(void) {
+    unsigned long flags = interrupts_save();
+    fpu_cpu_t* cpu = &percpu[this_cpu()->index];
+    if (cpu->depth++ > 0) {
+        return;
+    }
+    cpu->flags = flags;
+    cpu->restore = NULL;
+    cpu->regions++;
+    if (mode == FPU_MODE_NONE || cpu != &percpu[0]) {
+        return;
+    }
+
+    ts_clear();
+    thread_t* current = sched_current();
+    thread_t* live = owner;
+    if (mode == FPU_MODE_EAGER) {
+        live = current && current->fpu_used ? current : NULL;
+    }
+    if (live) {
+        area_save(live->fpu_state);
+        cpu->region_saves++;
+        if (mode == FPU_MODE_EAGER) {
+            cpu->restore = live;
+        } else {
+            owner = NULL;
+        }
+    }
+}
+
+void kernel_fpu_end(void) {
+    fpu_cpu_t* cpu = &percpu[this_cpu()->index];
+    if (--cpu->depth > 0) {
+        return;
+    }
+    if (mode != FPU_MODE_NONE && cpu == &percpu[0]) {
+        if (cpu->restore) {
+            area_restore(cpu->restore->fpu_state);
+        } else {
+            update_ts(sched_current());
+        }
+    }
+    interrupts_restore(cpu->flags);
+}
+
+// === РЕЖИМ ===
+
+int fpu_init(void) {
+    if (!(cpu_features & CPU_FEATURE_SSE2)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Розмір стандартної області для компонентів, увімкнених у XCR0
+    if (cpu_features & CPU_FEATURE_XSAVE) {
+        uint32_t a, b, c, d;
+        cpuid_count(0xD, 0, &a, &b, &c, &d);
+        area_size = b;
+        cpuid_count(0xD, 1, &a, &b, &c, &d);
+        save_kind = (a & CPUID_D1_XSAVEOPT) ? FPU_SAVE_XSAVEOPT : FPU_SAVE_XSAVE;
+    }
+    area_cache = kmem_cache_create("fpu", area_size, FPU_AREA_ALIGN, NULL);
+    if (!area_cache) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    // Початковий стан: FNINIT + MXCSR за замовчуванням; нульовий XSTATE_BV
+    // у заголовку XSAVE - решта компонентів у початковому стані
+    init_area = kmem_cache_alloc(area_cache);
+    if (!init_area) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    memset(init_area, 0, area_size);
+    *(uint16_t*)(init_area + FXSAVE_FCW) = FPU_INIT_FCW;
+    *(uint32_t*)(init_area + FXSAVE_MXCSR) = FPU_INIT_MXCSR;
+
+    char value[8];
+    mode = FPU_MODE_EAGER;
+    if (multiboot_cmdline_value("fpu", value, sizeof(value)) && strcmp(value, "lazy") == 0) {
+        mode = FPU_MODE_LAZY;
+    }
+    return irq_register(FPU_NM_VECTOR, "#NM", nm_handler, 0);
+}
+
+fpu_mode_t fpu_mode(void) {
+    return mode;
+}
+
+// Перенести стан між режимами: у lazy регістри можуть належати не поточному
+// потоку, в eager - лише поточному
+int fpu_set_mode(fpu_mode_t new_mode) {
+    if (mode == FPU_MODE_NONE || new_mode == FPU_MODE_NONE) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    unsigned long flags = interrupts_save();
+    thread_t* current = sched_current();
+    if (new_mode != mode && current) {
+        ts_clear();
+        if (new_mode == FPU_MODE_EAGER) {
+            if (owner != current) {
+                if (owner) {
+                    area_save(owner->fpu_state);
+                }
+                if (current->fpu_used) {
+                    area_restore(current->fpu_state);
+                }
+            }
+            owner = NULL;
+        } else {
+            owner = current->fpu_used ? current : NULL;
+        }
+    }
+    mode = new_mode;
+    update_ts(current);
+    interrupts_restore(flags);
+    return SUCCESS;
+}
+
+// === СТАТИСТИКА ===
+
+void fpu_print_stats(void) {
+    terminal_writestring("Режим: ");
+    terminal_writestring(mode_names[mode]);
+    if (mode == FPU_MODE_NONE) {
+        terminal_writestring(" (немає SSE2/FXSR)\n");
+        return;
+    }
+    terminal_writestring(", ");
+    terminal_writestring(save_names[save_kind]);
+    terminal_writestring(", область ");
+    terminal_writeuint(area_size);
+    terminal_writestring(" Б на потік\n");
+
+    unsigned long flags = interrupts_save();
+    uint64_t regions = 0;
+    uint64_t region_saves = 0;
+    for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+        regions += percpu[i].regions;
+        region_saves += percpu[i].region_saves;
+    }
+    terminal_writestring("Збережень: ");
+    terminal_writeuint(switch_saves);
+    terminal_writestring(", відновлень: ");
+    terminal_writeuint(switch_restores);
+    terminal_writestring(", пасток #NM: ");
+    terminal_writeuint(nm_traps);
+    terminal_writestring("\nВласник регістрів: ");
+    if (mode == FPU_MODE_LAZY && owner) {
+        terminal_writestring(owner->name);
+    } else {
+        terminal_writestring(mode == FPU_MODE_LAZY ? "немає" : "поточний потік");
+    }
+    terminal_writestring("\nСекцій kernel_fpu: ");
+    terminal_writeuint(regions);
+    terminal_writestring(", зі збереженням стану потоку: ");
+    terminal_writeuint(region_saves);
+    terminal_writestring("\n");
+    interrupts_restore(flags);
+}
+
+void fpu_reset_stats(void) {
+    unsigned long flags = interrupts_save();
+    switch_saves = 0;
+    switch_restores = 0;
+    nm_traps = 0;
+    for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+        percpu[i].regions = 0;
+        percpu[i].region_saves = 0;
+    }
+    interrupts_restore(flags);
+}
+
+// === БЕНЧМАРК ===
+
+// Потоки бенчмарку тримають шаблон у XMM7 і накопичують суму в XMM6 між
+// sched_yield. Ядро зібране з -mno-sse і XMM не виділяє, тож регістри
+// змінюються лише перемиканнями та секціями kernel_fpu - без clobber-списків
+#define BENCH_FIRST     0x1
+#define BENCH_SIMD      0x2
+
+static volatile int bench_running;
+static uint64_t bench_start;
+static uint64_t bench_end;
+static uint32_t bench_errors;
+static thread_t* bench_waiter;
+
+static inline void simd_load(uint32_t pattern) {
+    asm volatile(
+        "movd %0, %%xmm7\n\t"
+        "pshufd $0, %%xmm7, %%xmm7\n\t"
+        "pxor %%xmm6, %%xmm6"
+        : : "r"(pattern));
+}
+
+// Маска 0xFFFF - XMM7 цілий; сума в XMM6 змінює стан на кожному колі
+static inline uint32_t simd_round(uint32_t pattern) {
+    uint32_t mask;
+    asm volatile(
+        "movd %1, %%xmm0\n\t"
+        "pshufd $0, %%xmm0, %%xmm0\n\t"
+        "pcmpeqd %%xmm7, %%xmm0\n\t"
+        "pmovmskb %%xmm0, %0\n\t"
+        "paddd %%xmm7, %%xmm6"
+        : "=r"(mask) : "r"(pattern));
+    return mask;
+}
+
+static inline uint32_t simd_sum(void) {
+    uint32_t sum;
+    asm volatile("movd %%xmm6, %0" : "=r"(sum));
+    return sum;
+}
+
+static void bench_thread(void* arg) {
+    uint32_t flags = (uint32_t)(uintptr_t)arg;
+    uint32_t pattern = 0x9E3779B9u * sched_current()->tid;
+    uint32_t errors = 0;
+
+    if (flags & BENCH_SIMD) {
+        simd_load(pattern);
+    }
+    if (flags & BENCH_FIRST) {
+        bench_start = rdtsc();
+    }
+    for (uint32_t i = 0; i < FPU_BENCH_ROUNDS; i++) {
+        sched_yield();
+        if ((flags & BENCH_SIMD) && simd_round(pattern) != 0xFFFF) {
+            errors++;
+        }
+    }
+    if (flags & BENCH_FIRST) {
+        bench_end = rdtsc();
+    }
+    if ((flags & BENCH_SIMD) && simd_sum() != pattern * FPU_BENCH_ROUNDS) {
+        errors++;
+    }
+
+    unsigned long saved = interrupts_save();
+    bench_errors += errors;
+    if (--bench_running == 0) {
+        sched_wakeup(bench_waiter);
+    }
+    interrupts_restore(saved);
+}
+
+// Пінг-понг двох потоків, simd_threads з них тримають стан у XMM
+static void bench_scenario(uint32_t simd_threads) {
+    uint64_t saves = switch_saves + switch_restores;
+    uint64_t traps = nm_traps;
+
+    bench_waiter = sched_current();
+    bench_errors = 0;
+    bench_running = 2;
+
+    unsigned long flags = interrupts_save();
+    uint32_t first = BENCH_FIRST | (simd_threads >= 1 ? BENCH_SIMD : 0);
+    uint32_t second = simd_threads >= 2 ? BENCH_SIMD : 0;
+    if (!thread_create("fpubench-a", bench_thread, (void*)(uintptr_t)first, SCHED_PRIO_HIGH)) {
+        interrupts_restore(flags);
+        terminal_writestring("Не вдалося створити потік\n");
+        return;
+    }
+    if (!thread_create("fpubench-b", bench_thread, (void*)(uintptr_t)second, SCHED_PRIO_HIGH)) {
+        bench_running--;
+    }
+    while (bench_running > 0) {
+        sched_block();
+    }
+    interrupts_restore(flags);
+
+    uint64_t switches = 2ull * FPU_BENCH_ROUNDS;
+    terminal_writestring(mode_names[mode]);
+    terminal_writestring(mode == FPU_MODE_LAZY ? "   " : "  ");
+    terminal_writeuint_width(simd_threads, 6);
+    terminal_writeuint_width(div64_u32(bench_end - bench_start, (uint32_t)switches, NULL), 22);
+    terminal_writeuint_width(switch_saves + switch_restores - saves, 12);
+    terminal_writeuint_width(nm_traps - traps, 10);
+    terminal_writeuint_width(bench_errors, 9);
+    terminal_writestring("\n");
+}
+
+void fpu_benchmark(void) {
+    if (!sched_active()) {
+        terminal_writestring("Планувальник не запущено\n");
+        return;
+    }
+    if (mode == FPU_MODE_NONE) {
+        terminal_writestring("Стан FPU не керується: немає SSE2/FXSR\n");
+        return;
+    }
+
+    fpu_mode_t saved_mode = mode;
+    terminal_writestring("Режим  SIMD-потоків  тактів/перемикання  збер./відн.      #NM  помилок\n");
+    static const fpu_mode_t modes[] = { FPU_MODE_EAGER, FPU_MODE_LAZY };
+    for (uint32_t m = 0; m < 2; m++) {
+        fpu_set_mode(modes[m]);
+        for (uint32_t simd_threads = 0; simd_threads <= 2; simd_threads++) {
+            bench_scenario(simd_threads);
+        }
+    }
+    fpu_set_mode(saved_mode);
+}
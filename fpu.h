@@ -0,0 +1,54 @@
+#ifndef FPU_H
+#define FPU_H
+
+#include "kernel.h"
+#include "sched.h"
+
+// Стан x87/SSE/AVX потоків. Кожен потік має власну область XSAVE (або
+// FXSAVE без XSAVE). Потоки виконуються лише на BSP, тож власник регістрів
+// один на систему. Поки потік не торкнувся FPU поза kernel_fpu_begin/end,
+// його стан не зберігається: перше звернення ловить #NM (CR0.TS)
+//  eager - збереження/відновлення при кожному перемиканні потоків, що
+//          користуються FPU; #NM лише при першому зверненні потоку
+//  lazy  - регістри лишаються за власником, TS ставиться при перемиканні
+//          на інший потік; переносимо стан лише в обробнику #NM
+
+#define FPU_NM_VECTOR           7
+
+// Розмір FXSAVE та вирівнювання області XSAVE
+#define FPU_FXSAVE_SIZE         512
+#define FPU_AREA_ALIGN          64
+
+// Бенчмарк: перемикань на кожен сценарій
+#define FPU_BENCH_ROUNDS        20000
+
+typedef enum {
+    FPU_MODE_NONE,              // немає SSE2/FXSR: стан не керується
+    FPU_MODE_EAGER,
+    FPU_MODE_LAZY
+} fpu_mode_t;
+
+// Після heap_init і до sched_init: розмір області, кеш, образ початкового
+// стану та обробник #NM; режим - параметр ядра fpu=lazy|eager
+int fpu_init(void);
+fpu_mode_t fpu_mode(void);
+int fpu_set_mode(fpu_mode_t mode);
+
+// Область потоку (thread_alloc) та її звільнення (прибирання зомбі)
+int fpu_thread_init(thread_t* thread);
+void fpu_thread_free(thread_t* thread);
+
+// Перемикання потоків (schedule, вимкнені переривання)
+void fpu_switch(thread_t* prev, thread_t* next);
+
+// SIMD у коді ядра: зберігає живий стан потоку, вимикає переривання до
+// kernel_fpu_end. Вкладені пари дозволені, блокуватися всередині не можна
+void kernel_fpu_begin(void);
+void kernel_fpu_end(void);
+
+// Статистика та бенчмарк перемикань в обох режимах
+void fpu_print_stats(void);
+void fpu_reset_stats(void);
+void fpu_benchmark(void);
+
+#endif
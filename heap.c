@@ -0,0 +1,446 @@
+#include "heap.h"
+#include "pmm.h"
+#include "timer.h"
+
+// Заголовок на початку кожного slab та великого виділення
+#define SLAB_MAGIC          0x51AB51ABu
+#define LARGE_MAGIC         0x1A46E000u
+#define SLAB_HEADER_SIZE    64
+#define SLAB_MAX_ALIGN      SLAB_HEADER_SIZE
+
+// Скільки порожніх slab кеш тримає в запасі
+#define KMEM_EMPTY_KEEP     1
+
+enum slab_list {
+    SLAB_LIST_EMPTY,
+    SLAB_LIST_PARTIAL,
+    SLAB_LIST_FULL
+};
+
+struct slab {
+    uint32_t magic;
+    kmem_cache_t* cache;        // для великих виділень - NULL
+    struct slab* next;
+    struct slab* prev;
+    void* free;                 // вільний список об'єктів
+    uint32_t inuse;
+    uint32_t list;              // на якому списку кешу знаходиться
+    uint32_t pages;             // для великих виділень
+};
+
+static kmem_cache_t caches[KMEM_MAX_CACHES];
+static int cache_count = 0;
+
+static kmem_cache_t* kmalloc_caches[KMALLOC_CLASSES];
+
+// Статистика великих (посторінкових) виділень
+static uint64_t large_allocs = 0;
+static uint64_t large_frees = 0;
+static uint32_t large_pages = 0;
+static spinlock_t large_lock = SPINLOCK_INIT;
+
+// === СПИСКИ SLAB ===
+
+static struct slab** slab_list_head(kmem_cache_t* cache, uint32_t list) {
+    switch (list) {
+        case SLAB_LIST_PARTIAL: return &cache->partial;
+        case SLAB_LIST_FULL: return &cache->full;
+        default: return &cache->empty;
+    }
+}
+
+static void slab_unlink(kmem_cache_t* cache, struct slab* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        *slab_list_head(cache, slab->list) = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    if (slab->list == SLAB_LIST_PARTIAL) {
+        cache->partial_slabs--;
+    }
+}
+
+static void slab_link(kmem_cache_t* cache, struct slab* slab, uint32_t list) {
+    struct slab** head = slab_list_head(cache, list);
+    slab->list = list;
+    slab->prev = NULL;
+    slab->next = *head;
+    if (*head) {
+        (*head)->prev = slab;
+    }
+    *head = slab;
+    if (list == SLAB_LIST_PARTIAL) {
+        cache->partial_slabs++;
+    }
+}
+
+static void slab_move(kmem_cache_t* cache, struct slab* slab, uint32_t list) {
+    if (slab->list != list) {
+        slab_unlink(cache, slab);
+        slab_link(cache, slab, list);
+    }
+}
+
+static inline void** object_link(kmem_cache_t* cache, void* object) {
+    return (void**)((uint8_t*)object + cache->link_offset);
+}
+
+// Новий slab: конструктор викликається один раз для кожного об'єкта
+static struct slab* cache_grow(kmem_cache_t* cache) {
+    uintptr_t addr = pmm_alloc_order(SLAB_ORDER);
+    if (addr == 0) {
+        return NULL;
+    }
+
+    struct slab* slab = (struct slab*)addr;
+    slab->magic = SLAB_MAGIC;
+    slab->cache = cache;
+    slab->inuse = 0;
+    slab->pages = 1u << SLAB_ORDER;
+    slab->free = NULL;
+
+    uint8_t* base = (uint8_t*)addr + SLAB_HEADER_SIZE;
+    for (uint32_t i = cache->objects_per_slab; i > 0; i--) {
+        void* object = base + (i - 1) * cache->stride;
+        if (cache->ctor) {
+            cache->ctor(object);
+        }
+        *object_link(cache, object) = slab->free;
+        slab->free = object;
+    }
+
+    cache->slabs++;
+    slab_link(cache, slab, SLAB_LIST_EMPTY);
+    return slab;
+}
+
+static void cache_release(kmem_cache_t* cache, struct slab* slab) {
+    slab_unlink(cache, slab);
+    slab->magic = 0;
+    cache->slabs--;
+    pmm_free_order((uintptr_t)slab, SLAB_ORDER);
+}
+
+// === КЕШІ ОБ'ЄКТІВ ===
+
+kmem_cache_t* kmem_cache_create(const char* name, uint32_t size, uint32_t align, kmem_ctor_t ctor) {
+    if (cache_count >= KMEM_MAX_CACHES || size == 0 || align > SLAB_MAX_ALIGN) {
+        return NULL;
+    }
+    if (align < sizeof(void*)) {
+        align = sizeof(void*);
+    }
+    if (align & (align - 1)) {
+        return NULL;
+    }
+
+    kmem_cache_t* cache = &caches[cache_count];
+
+    // Об'єкти з конструктором зберігають стан, тож посилання кладемо за ними
+    uint32_t link_offset = 0;
+    uint32_t footprint = size;
+    if (ctor) {
+        link_offset = (size + sizeof(void*) - 1) & ~(uint32_t)(sizeof(void*) - 1);
+        footprint = link_offset + sizeof(void*);
+    }
+    uint32_t stride = (footprint + align - 1) & ~(align - 1);
+    if (stride > SLAB_SIZE - SLAB_HEADER_SIZE) {
+        return NULL;
+    }
+
+    strncpy(cache->name, name, KMEM_NAME_LEN - 1);
+    cache->name[KMEM_NAME_LEN - 1] = '\0';
+    cache->object_size = size;
+    cache->stride = stride;
+    cache->link_offset = link_offset;
+    cache->objects_per_slab = (SLAB_SIZE - SLAB_HEADER_SIZE) / stride;
+    cache->ctor = ctor;
+    cache->lock.locked = 0;
+    cache->partial = NULL;
+    cache->full = NULL;
+    cache->empty = NULL;
+    cache->allocs = 0;
+    cache->frees = 0;
+    cache->hits = 0;
+    cache->requested_bytes = 0;
+    cache->slabs = 0;
+    cache->partial_slabs = 0;
+    cache->active_objects = 0;
+
+    cache_count++;
+    return cache;
+}
+
+void* kmem_cache_alloc(kmem_cache_t* cache) {
+    unsigned long flags = spin_lock_irqsave(&cache->lock);
+
+    struct slab* slab = cache->partial;
+    if (!slab) {
+        slab = cache->empty;
+    }
+    if (slab) {
+        cache->hits++;
+    } else {
+        slab = cache_grow(cache);
+        if (!slab) {
+            spin_unlock_irqrestore(&cache->lock, flags);
+            return NULL;
+        }
+    }
+
+    void* object = slab->free;
+    slab->free = *object_link(cache, object);
+    slab->inuse++;
+
+    slab_move(cache, slab, slab->inuse == cache->objects_per_slab ? SLAB_LIST_FULL : SLAB_LIST_PARTIAL);
+
+    cache->allocs++;
+    cache->active_objects++;
+    spin_unlock_irqrestore(&cache->lock, flags);
+    return object;
+}
+
+void kmem_cache_free(kmem_cache_t* cache, void* object) {
+    struct slab* slab = (struct slab*)((uintptr_t)object & ~(uintptr_t)(SLAB_SIZE - 1));
+    if (!object || slab->magic != SLAB_MAGIC || slab->cache != cache || slab->inuse == 0) {
+        return;
+    }
+
+    unsigned long flags = spin_lock_irqsave(&cache->lock);
+
+    *object_link(cache, object) = slab->free;
+    slab->free = object;
+    slab->inuse--;
+
+    cache->frees++;
+    cache->active_objects--;
+
+    if (slab->inuse > 0) {
+        slab_move(cache, slab, SLAB_LIST_PARTIAL);
+        spin_unlock_irqrestore(&cache->lock, flags);
+        return;
+    }
+
+    // Порожній slab: тримаємо невеликий запас, решту повертаємо PMM
+    uint32_t empties = 0;
+    for (struct slab* s = cache->empty; s && empties < KMEM_EMPTY_KEEP; s = s->next) {
+        empties++;
+    }
+    if (empties >= KMEM_EMPTY_KEEP) {
+        cache_release(cache, slab);
+    } else {
+        slab_move(cache, slab, SLAB_LIST_EMPTY);
+    }
+    spin_unlock_irqrestore(&cache->lock, flags);
+}
+
+// === KMALLOC ===
+
+int heap_init(void) {
+    static const char* class_names[KMALLOC_CLASSES] = {
+        "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128", "kmalloc-256",
+        "kmalloc-512", "kmalloc-1024", "kmalloc-2048", "kmalloc-4096"
+    };
+
+    cache_count = 0;
+    for (uint32_t i = 0; i < KMALLOC_CLASSES; i++) {
+        uint32_t size = 1u << (KMALLOC_MIN_SHIFT + i);
+        uint32_t align = size < SLAB_MAX_ALIGN ? size : SLAB_MAX_ALIGN;
+        kmalloc_caches[i] = kmem_cache_create(class_names[i], size, align, NULL);
+        if (!kmalloc_caches[i]) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+    }
+    return SUCCESS;
+}
+
+static void* large_alloc(size_t size) {
+    uint32_t pages = (size + SLAB_HEADER_SIZE + PAGE_SIZE - 1) >> PAGE_SHIFT;
+
+    // Вирівнювання на SLAB_SIZE дозволяє kfree знайти заголовок маскою
+    uint32_t order = SLAB_ORDER;
+    while ((1u << order) < pages) {
+        order++;
+    }
+    uintptr_t addr = pmm_alloc_order(order);
+    if (addr == 0) {
+        return NULL;
+    }
+    if (pages < (1u << order)) {
+        pmm_free_frames(addr + ((uintptr_t)pages << PAGE_SHIFT), (1u << order) - pages);
+    }
+
+    struct slab* header = (struct slab*)addr;
+    header->magic = LARGE_MAGIC;
+    header->cache = NULL;
+    header->pages = pages;
+
+    unsigned long flags = spin_lock_irqsave(&large_lock);
+    large_allocs++;
+    large_pages += pages;
+    spin_unlock_irqrestore(&large_lock, flags);
+    return (uint8_t*)addr + SLAB_HEADER_SIZE;
+}
+
+void* kmalloc(size_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+    if (size > KMALLOC_MAX_SIZE) {
+        return large_alloc(size);
+    }
+
+    uint32_t shift = KMALLOC_MIN_SHIFT;
+    while ((1u << shift) < size) {
+        shift++;
+    }
+
+    kmem_cache_t* cache = kmalloc_caches[shift - KMALLOC_MIN_SHIFT];
+    if (!cache) {
+        return NULL;
+    }
+    void* ptr = kmem_cache_alloc(cache);
+    if (ptr) {
+        // Лише для статистики, точність під конкуренцією не критична
+        cache->requested_bytes += size;
+    }
+    return ptr;
+}
+
+void* kzalloc(size_t size) {
+    uint8_t* ptr = kmalloc(size);
+    if (ptr) {
+        for (size_t i = 0; i < size; i++) {
+            ptr[i] = 0;
+        }
+    }
+    return ptr;
+}
+
+void kfree(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    struct slab* slab = (struct slab*)((uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+    if (slab->magic == LARGE_MAGIC) {
+        unsigned long flags = spin_lock_irqsave(&large_lock);
+        large_frees++;
+        large_pages -= slab->pages;
+        spin_unlock_irqrestore(&large_lock, flags);
+        slab->magic = 0;
+        pmm_free_frames((uintptr_t)slab, slab->pages);
+    } else if (slab->magic == SLAB_MAGIC && slab->cache) {
+        kmem_cache_free(slab->cache, ptr);
+    }
+}
+
+// === СТАТИСТИКА ===
+
+static uint32_t percent(uint64_t part, uint64_t whole) {
+    while (whole > 0xFFFFFFFFull) {
+        whole >>= 1;
+        part >>= 1;
+    }
+    if (whole == 0) {
+        return 0;
+    }
+    return (uint32_t)div64_u32(part * 100, (uint32_t)whole, NULL);
+}
+
+void heap_print_stats(void) {
+    terminal_writestring("Кеш             Об'єкт Slab Частк Активні   Виділ  Влуч% Внутр% Зовн%\n");
+
+    for (int i = 0; i < cache_count; i++) {
+        kmem_cache_t* cache = &caches[i];
+        uint32_t capacity = cache->slabs * cache->objects_per_slab;
+
+        terminal_writestring(cache->name);
+        for (size_t pad = strlen(cache->name); pad < KMEM_NAME_LEN; pad++) {
+            terminal_putchar(' ');
+        }
+        terminal_writeuint_width(cache->object_size, 6);
+        terminal_writeuint_width(cache->slabs, 5);
+        terminal_writeuint_width(cache->partial_slabs, 6);
+        terminal_writeuint_width(cache->active_objects, 8);
+        terminal_writeuint_width(cache->allocs, 8);
+        terminal_writeuint_width(percent(cache->hits, cache->allocs), 7);
+
+        // Внутрішня: запитані байти проти виданих; зовнішня: незайняті місця в slab
+        uint32_t internal = 0;
+        if (cache->requested_bytes) {
+            internal = 100 - percent(cache->requested_bytes, cache->allocs * cache->object_size);
+        }
+        terminal_writeuint_width(internal, 7);
+        terminal_writeuint_width(capacity ? 100 - percent(cache->active_objects, capacity) : 0, 6);
+        terminal_writestring("\n");
+    }
+
+    terminal_writestring("Великі виділення: ");
+    terminal_writeuint(large_allocs - large_frees);
+    terminal_writestring(" активних, ");
+    terminal_writeuint(large_pages);
+    terminal_writestring(" сторінок\n");
+}
+
+// === БЕНЧМАРК ===
+
+#define HEAP_BENCH_PAIRS    10000
+#define HEAP_BENCH_LIVE     512
+#define HEAP_BENCH_STEPS    20000
+
+static void* bench_live[HEAP_BENCH_LIVE];
+
+static void report_pair(const char* label, uint64_t cycles, uint32_t pairs) {
+    terminal_writestring(label);
+    terminal_writeuint_width(div64_u32(tsc_cycles_to_ns(cycles), pairs, NULL), 6);
+    terminal_writestring(" нс/пару (");
+    terminal_writeuint(div64_u32(cycles, pairs, NULL));
+    terminal_writestring(" тактів)\n");
+}
+
+void heap_benchmark(void) {
+    // Гарячий шлях: пара kmalloc/kfree одного класу
+    for (uint32_t i = 0; i < KMALLOC_CLASSES; i++) {
+        uint32_t size = 1u << (KMALLOC_MIN_SHIFT + i);
+        uint64_t start = rdtsc();
+        for (uint32_t n = 0; n < HEAP_BENCH_PAIRS; n++) {
+            kfree(kmalloc(size));
+        }
+        uint64_t cycles = rdtsc() - start;
+
+        char label[24];
+        strcpy(label, "  ");
+        uint64toa(size, label + 2, 10);
+        strcpy(label + strlen(label), " Б:");
+        while (strlen(label) < 12) {
+            strcpy(label + strlen(label), " ");
+        }
+        report_pair(label, cycles, HEAP_BENCH_PAIRS);
+    }
+
+    // Змішане навантаження: випадкові розміри, до HEAP_BENCH_LIVE живих об'єктів
+    uint32_t seed = (uint32_t)rdtsc();
+    for (uint32_t i = 0; i < HEAP_BENCH_LIVE; i++) {
+        bench_live[i] = NULL;
+    }
+
+    uint64_t start = rdtsc();
+    for (uint32_t n = 0; n < HEAP_BENCH_STEPS; n++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t slot = (seed >> 8) % HEAP_BENCH_LIVE;
+        uint32_t size = 1 + ((seed >> 16) % KMALLOC_MAX_SIZE);
+        kfree(bench_live[slot]);
+        bench_live[slot] = kmalloc(size);
+    }
+    uint64_t cycles = rdtsc() - start;
+
+    for (uint32_t i = 0; i < HEAP_BENCH_LIVE; i++) {
+        kfree(bench_live[i]);
+        bench_live[i] = NULL;
+    }
+    report_pair("  змішане: ", cycles, HEAP_BENCH_STEPS);
+}
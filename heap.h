@@ -0,0 +1,65 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "kernel.h"
+
+// Кожен slab займає 32 КБ, вирівняних на свій розмір,
+// тож власника об'єкта знаходимо маскою адреси
+#define SLAB_ORDER          3
+#define SLAB_SIZE           (4096u << SLAB_ORDER)
+
+// Класи розмірів kmalloc: 16 Б ... 4 КБ
+#define KMALLOC_MIN_SHIFT   4
+#define KMALLOC_MAX_SHIFT   12
+#define KMALLOC_CLASSES     (KMALLOC_MAX_SHIFT - KMALLOC_MIN_SHIFT + 1)
+#define KMALLOC_MAX_SIZE    (1u << KMALLOC_MAX_SHIFT)
+
+#define KMEM_MAX_CACHES     32
+#define KMEM_NAME_LEN       16
+
+typedef void (*kmem_ctor_t)(void* object);
+
+struct slab;
+
+// Кеш однотипних об'єктів
+typedef struct kmem_cache {
+    char name[KMEM_NAME_LEN];
+    uint32_t object_size;
+    uint32_t stride;            // крок між об'єктами в slab
+    uint32_t link_offset;       // де лежить посилання вільного списку
+    uint32_t objects_per_slab;
+    kmem_ctor_t ctor;
+    spinlock_t lock;
+
+    struct slab* partial;
+    struct slab* full;
+    struct slab* empty;
+
+    // Статистика
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t hits;              // виділення без нового slab
+    uint64_t requested_bytes;   // для оцінки внутрішньої фрагментації
+    uint32_t slabs;
+    uint32_t partial_slabs;
+    uint32_t active_objects;
+} kmem_cache_t;
+
+// Ініціалізація поверх фізичного алокатора
+int heap_init(void);
+
+// Кеші об'єктів з конструктором
+kmem_cache_t* kmem_cache_create(const char* name, uint32_t size, uint32_t align, kmem_ctor_t ctor);
+void* kmem_cache_alloc(kmem_cache_t* cache);
+void kmem_cache_free(kmem_cache_t* cache, void* object);
+
+// Загальне виділення пам'яті
+void* kmalloc(size_t size);
+void* kzalloc(size_t size);
+void kfree(void* ptr);
+
+// Статистика та бенчмарк
+void heap_print_stats(void);
+void heap_benchmark(void);
+
+#endif
@@ -0,0 +1,393 @@
+#include "irq.h"
+#include "acpi.h"
+#include "apic.h"
+#include "cpu.h"
+#include "multiboot.h"
+#include "sched.h"
+#include "smp.h"
+#include "task.h"
+#include "timer.h"
+#include "trace.h"
+#include "vmm.h"
+
+// Прапорці перевизначення ISA в MADT: полярність (біти 0-1) і тригер (біти 2-3)
+#define MADT_POLARITY_MASK      0x3
+#define MADT_POLARITY_LOW       0x3
+#define MADT_TRIGGER_MASK       0xC
+#define MADT_TRIGGER_LEVEL      0xC
+
+// Каскад: slave 8259 сидить на IRQ2 master
+#define PIC_CASCADE_IRQ         2
+
+// Фальшиве IRQ7 від 8259 - без EOI
+#define PIC_SPURIOUS_VECTOR     (IRQ_VECTOR_BASE + 7)
+
+typedef struct {
+    irq_handler_t handler;
+    const char* name;
+    uint32_t flags;
+} irq_vector_t;
+
+// Лінія ISA: встановлена драйвером і процесор, що її обробляє
+typedef struct {
+    int installed;
+    uint32_t cpu;
+    uint32_t gsi;               // заповнюється при маршрутизації через IOAPIC
+    uint32_t redirection;       // полярність і тригер входу IOAPIC
+} irq_line_t;
+
+// Лічильники на процесор: без спільних рядків кешу між ядрами
+typedef struct {
+    uint64_t count;
+    uint64_t cycles;            // сума тактів від входу до EOI
+    uint32_t max_cycles;
+} irq_stat_t;
+
+static irq_vector_t vectors[IDT_VECTORS];
+static irq_line_t lines[IRQ_ISA_LINES];
+static irq_stat_t stats[SMP_MAX_CPUS][IDT_VECTORS];
+static irq_mode_t mode = IRQ_MODE_PIC;
+static int initialized = false;
+static uint16_t pic_mask = 0xFFFF;
+
+static const char* exception_names[EXCEPTION_VECTORS] = {
+    "#DE", "#DB", "NMI", "#BP", "#OF", "#BR", "#UD", "#NM",
+    "#DF", "#CSO", "#TS", "#NP", "#SS", "#GP", "#PF", "#15",
+    "#MF", "#AC", "#MC", "#XM", "#VE", "#CP", "#22", "#23",
+    "#24", "#25", "#26", "#27", "#HV", "#VC", "#SX", "#31"
+};
+
+// === ВИНЯТКИ ===
+
+static void page_fault_handler(irq_frame_t* frame) {
+    uintptr_t addr;
+    asm volatile("mov %%cr2, %0" : "=r"(addr));
+    if (vmm_page_fault(addr, frame->error_code) != SUCCESS) {
+        task_fault(frame, addr);
+    }
+}
+
+static void exception_panic(irq_frame_t* frame) {
+    char buffer[24];
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("\nВиняток ");
+    terminal_writestring(exception_names[frame->vector]);
+    terminal_writestring(" (вектор ");
+    terminal_writeuint(frame->vector);
+    terminal_writestring(") на CPU ");
+    terminal_writeuint(this_cpu()->index);
+    terminal_writestring(": код помилки 0x");
+    uint64toa(frame->error_code, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(", IP 0x");
+    uint64toa(IRQ_FRAME_IP(frame), buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(", CS 0x");
+    uint64toa(frame->cs, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(", FLAGS 0x");
+    uint64toa(IRQ_FRAME_FLAGS(frame), buffer, 16);
+    terminal_writestring(buffer);
+    kernel_panic("необроблений виняток процесора");
+}
+
+static void spurious_handler(irq_frame_t* frame) {
+    (void)frame;
+}
+
+void irq_early_init(void) {
+    for (int i = 0; i < EXCEPTION_VECTORS; i++) {
+        if (!vectors[i].handler) {
+            vectors[i].name = exception_names[i];
+        }
+    }
+    irq_register(14, "#PF", page_fault_handler, 0);
+    irq_register(APIC_SPURIOUS_VECTOR, "spurious", spurious_handler, IRQ_FLAG_NO_EOI);
+    irq_register(PIC_SPURIOUS_VECTOR, "spurious 8259", spurious_handler, IRQ_FLAG_NO_EOI);
+}
+
+// === 8259 ===
+
+static void pic_remap(void) {
+    outb(PIC1_COMMAND, 0x11); // ICW1 - ініціалізація
+    outb(PIC2_COMMAND, 0x11);
+
+    outb(PIC1_DATA, IRQ_VECTOR_BASE);       // ICW2 - IRQ 0-7 -> INT 32-39
+    outb(PIC2_DATA, IRQ_VECTOR_BASE + 8);   // ICW2 - IRQ 8-15 -> INT 40-47
+
+    outb(PIC1_DATA, 0x04); // ICW3 - master має slave на IRQ2
+    outb(PIC2_DATA, 0x02); // ICW3 - slave підключений до IRQ2 master
+
+    outb(PIC1_DATA, 0x01); // ICW4 - 8086 mode
+    outb(PIC2_DATA, 0x01);
+}
+
+static void pic_write_mask(uint16_t mask) {
+    outb(PIC1_DATA, mask & 0xFF);
+    outb(PIC2_DATA, mask >> 8);
+}
+
+// === МАРШРУТИЗАЦІЯ ===
+
+// ISA IRQ -> GSI з перевизначень MADT; без запису - фронт, активний високий
+static uint32_t isa_gsi(uint8_t irq, uint32_t* redirection) {
+    const acpi_madt_info_t* madt = acpi_madt();
+    *redirection = 0;
+    for (uint32_t i = 0; madt && i < madt->override_count; i++) {
+        if (madt->overrides[i].source != irq) continue;
+        uint16_t flags = madt->overrides[i].flags;
+        if ((flags & MADT_POLARITY_MASK) == MADT_POLARITY_LOW) {
+            *redirection |= IOAPIC_ACTIVE_LOW;
+        }
+        if ((flags & MADT_TRIGGER_MASK) == MADT_TRIGGER_LEVEL) {
+            *redirection |= IOAPIC_LEVEL;
+        }
+        return madt->overrides[i].gsi;
+    }
+    return irq;
+}
+
+static int route_line(uint8_t irq) {
+    irq_line_t* line = &lines[irq];
+    if (mode == IRQ_MODE_IOAPIC) {
+        line->gsi = isa_gsi(irq, &line->redirection);
+        return ioapic_route(line->gsi, IRQ_VECTOR_BASE + irq, cpus[line->cpu].apic_id, line->redirection);
+    }
+
+    pic_mask &= ~(1u << irq);
+    if (irq >= 8) {
+        pic_mask &= ~(1u << PIC_CASCADE_IRQ);
+    }
+    pic_write_mask(pic_mask);
+    return SUCCESS;
+}
+
+int irq_init(void) {
+    pic_remap();
+
+    // Параметр ядра "noapic" лишає 8259 (порівняння шляхів EOI)
+    if (lapic_present() && !multiboot_cmdline_has("noapic") && ioapic_init() == SUCCESS) {
+        mode = IRQ_MODE_IOAPIC;
+    }
+    pic_write_mask(mode == IRQ_MODE_IOAPIC ? 0xFFFF : pic_mask);
+    initialized = true;
+
+    for (uint8_t irq = 0; irq < IRQ_ISA_LINES; irq++) {
+        if (lines[irq].installed && route_line(irq) != SUCCESS) {
+            terminal_writestring("IRQ: не вдалося направити лінію ");
+            terminal_writeuint(irq);
+            terminal_writestring("\n");
+        }
+    }
+    return SUCCESS;
+}
+
+irq_mode_t irq_mode(void) {
+    return mode;
+}
+
+int irq_register(uint8_t vector, const char* name, irq_handler_t handler, uint32_t flags) {
+    if (!handler) {
+        return ERROR_INVALID_INPUT;
+    }
+    vectors[vector].name = name;
+    vectors[vector].flags = flags;
+    vectors[vector].handler = handler;
+    return SUCCESS;
+}
+
+int irq_alloc_vector(const char* name, irq_handler_t handler, uint32_t flags) {
+    if (!handler) {
+        return ERROR_INVALID_INPUT;
+    }
+    unsigned long saved = interrupts_save();
+    for (uint32_t vector = IRQ_DYNAMIC_BASE; vector < IRQ_DYNAMIC_LIMIT; vector++) {
+        if (!vectors[vector].handler) {
+            irq_register((uint8_t)vector, name, handler, flags);
+            interrupts_restore(saved);
+            return (int)vector;
+        }
+    }
+    interrupts_restore(saved);
+    return ERROR_BUFFER_OVERFLOW;
+}
+
+// До irq_init лінія лише запам'ятовується, маршрут ставить irq_init
+int irq_install(uint8_t irq, const char* name, irq_handler_t handler, uint32_t flags) {
+    if (irq >= IRQ_ISA_LINES || irq == PIC_CASCADE_IRQ) {
+        return ERROR_INVALID_INPUT;
+    }
+    int result = irq_register(IRQ_VECTOR_BASE + irq, name, handler, flags);
+    if (result != SUCCESS) {
+        return result;
+    }
+    lines[irq].installed = true;
+    lines[irq].cpu = 0;
+    return initialized ? route_line(irq) : SUCCESS;
+}
+
+// Обробники, що будять потоки, лишаються на BSP: планувальник однопроцесорний
+int irq_set_affinity(uint8_t irq, uint32_t cpu) {
+    if (irq >= IRQ_ISA_LINES || !lines[irq].installed) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (cpu >= smp_cpu_count() || !cpus[cpu].online) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (cpu != 0 && (mode != IRQ_MODE_IOAPIC || !(vectors[IRQ_VECTOR_BASE + irq].flags & IRQ_FLAG_MPSAFE))) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (lines[irq].cpu == cpu) {
+        return SUCCESS;
+    }
+
+    unsigned long flags = interrupts_save();
+    lines[irq].cpu = cpu;
+    int result = route_line(irq);
+    interrupts_restore(flags);
+    return result;
+}
+
+// === ДИСПЕТЧЕР ===
+
+static void send_eoi(uint32_t vector) {
+    if (mode == IRQ_MODE_PIC && vector >= IRQ_VECTOR_BASE && vector < IRQ_VECTOR_BASE + IRQ_ISA_LINES) {
+        if (vector >= IRQ_VECTOR_BASE + 8) {
+            outb(PIC2_COMMAND, PIC_EOI);
+        }
+        outb(PIC1_COMMAND, PIC_EOI);
+    } else if (lapic_present()) {
+        lapic_eoi();
+    }
+}
+
+void irq_dispatch(irq_frame_t* frame) {
+    uint64_t start = rdtsc();
+    uint32_t vector = frame->vector;
+    cpu_t* cpu = this_cpu();
+    irq_stat_t* stat = &stats[cpu->index][vector];
+    irq_vector_t* entry = &vectors[vector];
+
+    if (vector < EXCEPTION_VECTORS) {
+        stat->count++;
+        if (!entry->handler) {
+            // Виняток кільця 3 завершує лише задачу, ядро живе далі
+            if (IRQ_FRAME_USER(frame)) {
+                task_fault(frame, 0);
+            }
+            exception_panic(frame);
+        }
+        entry->handler(frame);
+        return;
+    }
+
+    trace_irq_enter(vector, frame);
+    if (entry->handler) {
+        entry->handler(frame);
+    }
+    // Невідомий вектор з IOAPIC/IPI теж чекає EOI, інакше APIC заблокує нижчі пріоритети
+    if (!(entry->flags & IRQ_FLAG_NO_EOI) && (entry->handler || mode == IRQ_MODE_IOAPIC)) {
+        send_eoi(vector);
+    }
+
+    uint32_t cycles = (uint32_t)(rdtsc() - start);
+    stat->count++;
+    stat->cycles += cycles;
+    if (cycles > stat->max_cycles) {
+        stat->max_cycles = cycles;
+    }
+    trace_irq_exit(vector);
+
+    // Можливе витіснення - вже після EOI; потоки живуть лише на BSP
+    if (cpu->index == 0) {
+        sched_irq_exit();
+    }
+}
+
+// === СТАТИСТИКА ===
+
+void irq_reset_stats(void) {
+    unsigned long flags = interrupts_save();
+    memset(stats, 0, sizeof(stats));
+    interrupts_restore(flags);
+}
+
+static void write_trigger(uint32_t redirection) {
+    terminal_writestring((redirection & IOAPIC_LEVEL) ? "рівень, " : "фронт, ");
+    terminal_writestring((redirection & IOAPIC_ACTIVE_LOW) ? "низький" : "високий");
+}
+
+void irq_print_stats(void) {
+    uint32_t cpu_count = smp_cpu_count();
+
+    terminal_writestring("Контролер: ");
+    if (mode == IRQ_MODE_IOAPIC) {
+        terminal_writestring("IOAPIC (");
+        terminal_writeuint(ioapic_gsi_count());
+        terminal_writestring(" входів) + ");
+        terminal_writestring(lapic_x2apic() ? "x2APIC (EOI через MSR)" : "xAPIC (EOI через MMIO)");
+        terminal_writestring(", 8259 замасковано\n");
+    } else {
+        terminal_writestring("8259 (EOI через порт 0x20)\n");
+    }
+
+    terminal_writestring("IRQ  GSI  Вектор  CPU  Тригер\n");
+    for (uint8_t irq = 0; irq < IRQ_ISA_LINES; irq++) {
+        irq_line_t* line = &lines[irq];
+        if (!line->installed) continue;
+        terminal_writeuint_width(irq, 3);
+        if (mode == IRQ_MODE_IOAPIC) {
+            terminal_writeuint_width(line->gsi, 5);
+        } else {
+            terminal_writestring("    -");
+        }
+        terminal_writeuint_width(IRQ_VECTOR_BASE + irq, 8);
+        terminal_writeuint_width(line->cpu, 5);
+        terminal_writestring("  ");
+        write_trigger(mode == IRQ_MODE_IOAPIC ? line->redirection : 0);
+        terminal_writestring("\n");
+    }
+
+    terminal_writestring("\nВектор  Назва            Усього  Сер.такт  Макс.такт  Макс.мкс  По CPU\n");
+    for (uint32_t vector = 0; vector < IDT_VECTORS; vector++) {
+        uint64_t count = 0, cycles = 0;
+        uint32_t max_cycles = 0;
+        for (uint32_t c = 0; c < cpu_count; c++) {
+            count += stats[c][vector].count;
+            cycles += stats[c][vector].cycles;
+            if (stats[c][vector].max_cycles > max_cycles) {
+                max_cycles = stats[c][vector].max_cycles;
+            }
+        }
+        if (count == 0) continue;
+
+        const char* name = vectors[vector].name ? vectors[vector].name : "?";
+        terminal_writeuint_width(vector, 6);
+        terminal_writestring("  ");
+        terminal_writestring(name);
+        for (size_t len = strlen(name); len < 14; len++) {
+            terminal_putchar(' ');
+        }
+        terminal_writeuint_width(count, 8);
+        if (vector < EXCEPTION_VECTORS) {
+            terminal_writestring("         -          -         -");
+        } else {
+            uint32_t ns_rem;
+            uint64_t us = div64_u32(tsc_cycles_to_ns(max_cycles), 1000, &ns_rem);
+            terminal_writeuint_width(div64_u32(cycles, (uint32_t)count, NULL), 10);
+            terminal_writeuint_width(max_cycles, 11);
+            terminal_writeuint_width(us, 8);
+            terminal_putchar('.');
+            terminal_writeuint(ns_rem / 100);
+        }
+        terminal_writestring("  ");
+        for (uint32_t c = 0; c < cpu_count; c++) {
+            if (stats[c][vector].count == 0) continue;
+            terminal_writeuint(c);
+            terminal_putchar(':');
+            terminal_writeuint(stats[c][vector].count);
+            terminal_putchar(' ');
+        }
+        terminal_writestring("\n");
+    }
+}
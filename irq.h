@@ -0,0 +1,58 @@
+#ifndef IRQ_H
+#define IRQ_H
+
+#include "kernel.h"
+
+#define IDT_VECTORS             256
+#define EXCEPTION_VECTORS       32
+
+// ISA IRQ n приходить на вектор 32+n і з 8259, і з IOAPIC
+#define IRQ_VECTOR_BASE         32
+#define IRQ_ISA_LINES           16
+
+// Вектори для MSI/MSI-X пристроїв PCI (irq_alloc_vector)
+#define IRQ_DYNAMIC_BASE        0x40
+#define IRQ_DYNAMIC_LIMIT       0xE0
+
+// Лінії ISA
+#define IRQ_TIMER               0
+#define IRQ_KEYBOARD            1
+#define IRQ_COM1                4
+
+// Прапорці обробника
+#define IRQ_FLAG_NO_EOI         0x01    // фальшиві та програмні вектори
+#define IRQ_FLAG_MPSAFE         0x02    // не чіпає планувальник - можна перенести з BSP
+
+typedef void (*irq_handler_t)(irq_frame_t* frame);
+
+typedef enum {
+    IRQ_MODE_PIC = 0,                   // 8259, EOI через порт 0x20
+    IRQ_MODE_IOAPIC                     // IOAPIC + локальний APIC, 8259 замаскований
+} irq_mode_t;
+
+// Точки входу всіх 256 векторів (kernel.asm / kernel64.asm) для idt_init
+extern uintptr_t irq_stub_table[IDT_VECTORS];
+
+// Обробники винятків; викликається з idt_init
+void irq_early_init(void);
+
+// Вибір контролера: IOAPIC з MADT, інакше 8259 (параметр ядра "noapic" - завжди 8259)
+int irq_init(void);
+irq_mode_t irq_mode(void);
+
+// Обробник вектора (IPI, програмні) та лінії ISA з маршрутизацією на процесор
+int irq_register(uint8_t vector, const char* name, irq_handler_t handler, uint32_t flags);
+int irq_install(uint8_t irq, const char* name, irq_handler_t handler, uint32_t flags);
+int irq_set_affinity(uint8_t irq, uint32_t cpu);
+
+// Вільний вектор з динамічного діапазону з обробником; від'ємне - немає вільних
+int irq_alloc_vector(const char* name, irq_handler_t handler, uint32_t flags);
+
+// Спільний вхід з kernel.asm
+void irq_dispatch(irq_frame_t* frame);
+
+// Кількість переривань на вектор і процесор, такти від входу до EOI
+void irq_print_stats(void);
+void irq_reset_stats(void);
+
+#endif
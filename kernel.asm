@@ -9,7 +9,18 @@ header_start:
     ; checksum
     dd 0x100000000 - (0xe85250d6 + 0 + (header_end - header_start))
 
+    ; framebuffer tag: лінійний буфер 1024x768x32; необов'язковий -
+    ; без нього (або з gfxpayload=text) лишається текстовий режим VGA
+    align 8, db 0
+    dw 5    ; type
+    dw 1    ; flags: optional
+    dd 20   ; size
+    dd 1024 ; width
+    dd 768  ; height
+    dd 32   ; depth
+
     ; required end tag
+    align 8, db 0
     dw 0    ; type
     dw 0    ; flags
     dd 8    ; size
@@ -24,8 +35,22 @@ stack_top:
 section .text
 global _start
 extern kernel_main
+extern boot_stub_marker
+extern boot_stub_tsc
+extern boot_entry_tsc
 
 _start:
+    ; Хронологія завантаження (boot.c): мітка stub в ECX, TSC входу stub
+    ; в EDX:ESI, потім власний TSC входу. EAX (магічне число) зберігаємо
+    mov [boot_stub_marker], ecx
+    mov [boot_stub_tsc], esi
+    mov [boot_stub_tsc + 4], edx
+    mov ecx, eax
+    rdtsc
+    mov [boot_entry_tsc], eax
+    mov [boot_entry_tsc + 4], edx
+    mov eax, ecx
+
     ; Встановлюємо стек
     mov esp, stack_top
 
@@ -33,6 +58,10 @@ _start:
     push 0
     popf
 
+    ; Передаємо kernel_main магічне число (EAX) та адресу інформації Multiboot2 (EBX)
+    push ebx
+    push eax
+
     ; Викликаємо головну функцію ядра
     call kernel_main
 
@@ -54,20 +83,137 @@ disable_interrupts:
     cli
     ret
 
-; Обробник переривання клавіатури
-global keyboard_interrupt_handler
-extern keyboard_handler
-keyboard_interrupt_handler:
-    pushad              ; Зберігаємо всі регістри
+; Точки входу всіх 256 векторів: кадр однаковий для винятків і переривань.
+; Де процесор не кладе код помилки, заглушка кладе 0
+extern irq_dispatch
+%assign i 0
+%rep 256
+irq_stub_%[i]:
+%if !(i == 8 || (i >= 10 && i <= 14) || i == 17 || i == 21 || i == 29 || i == 30)
+    push 0
+%endif
+    push i
+    jmp irq_common
+%assign i i+1
+%endrep
+
+; Селектори GDT (cpu.h)
+GDT_KERNEL_DATA equ 0x10
+GDT_USER_CODE   equ 0x18
+GDT_USER_DATA   equ 0x20
+GDT_PERCPU      equ 0x28
+RPL_USER        equ 3
+
+; Спільний пролог: pushad, irq_dispatch(кадр) - обробник, EOI, статистика,
+; витіснення на BSP; далі знімаємо вектор і код помилки. З кільця 3 приходять
+; сегменти користувача: ядру потрібні свої DS/ES і per-CPU GS, на виході - навпаки
+irq_common:
+    pushad
+    test byte [esp + 44], RPL_USER      ; CS перерваного коду
+    jz .kernel_entry
+    mov ax, GDT_KERNEL_DATA
+    mov ds, ax
+    mov es, ax
+    mov ax, GDT_PERCPU
+    mov gs, ax
+.kernel_entry:
+    cld
+    push esp            ; Вказівник на irq_frame_t
+    call irq_dispatch
+    add esp, 4
+    test byte [esp + 44], RPL_USER
+    jz .kernel_exit
+    call load_user_segments
+.kernel_exit:
+    popad
+    add esp, 8
+    iret
+
+; DS/ES/FS/GS кільця 3; EAX псується
+load_user_segments:
+    mov ax, GDT_USER_DATA | RPL_USER
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    ret
+
+; Перший вхід задачі в кільце 3
+; void enter_user(uintptr_t entry, uintptr_t user_sp)
+global enter_user
+enter_user:
+    cli
+    mov ecx, [esp + 4]
+    mov edx, [esp + 8]
+    call load_user_segments
+    push GDT_USER_DATA | RPL_USER       ; SS
+    push edx                            ; ESP
+    push 0x202                          ; EFLAGS: IF
+    push GDT_USER_CODE | RPL_USER       ; CS
+    push ecx                            ; EIP
+    xor eax, eax
+    xor ebx, ebx
+    xor ecx, ecx
+    xor edx, edx
+    xor esi, esi
+    xor edi, edi
+    xor ebp, ebp
+    iret
+
+; Швидкий системний виклик: SYSENTER_ESP вказує на TSS поточного процесора,
+; звідти береться стек ядра потоку. Заглушка vDSO кладе в ECX стек, в EDX -
+; адресу повернення для SYSEXIT; номер в EAX, аргументи в EBX, ESI, EDI
+extern syscall_fast
+global sysenter_entry
+sysenter_entry:
+    mov esp, [esp + 4]                  ; TSS.esp0
+    push ecx
+    push edx
+    mov cx, GDT_KERNEL_DATA
+    mov ds, cx
+    mov es, cx
+    mov cx, GDT_PERCPU
+    mov gs, cx
+    cld
+    sti
+    push edi
+    push esi
+    push ebx
+    push eax
+    call syscall_fast                   ; EBX, ESI, EDI, EBP зберігає cdecl
+    add esp, 16
+    cli
+    mov cx, GDT_USER_DATA | RPL_USER
+    mov ds, cx
+    mov es, cx
+    mov fs, cx
+    mov gs, cx
+    pop edx
+    pop ecx
+    sti                                 ; тінь STI: переривання лише після SYSEXIT
+    sysexit
+
+; Перемикання контексту потоків ядра
+; void switch_context(uintptr_t* old_sp, uintptr_t new_sp)
+global switch_context
+switch_context:
+    mov eax, [esp + 4]  ; Куди зберегти стек поточного потоку
+    mov edx, [esp + 8]  ; Стек наступного потоку
     
-    call keyboard_handler
+    ; Callee-saved регістри за cdecl
+    push ebp
+    push ebx
+    push esi
+    push edi
     
-    ; Відправляємо EOI до PIC
-    mov al, 0x20
-    out 0x20, al
+    mov [eax], esp
+    mov esp, edx
     
-    popad              ; Відновлюємо всі регістри
-    iret               ; Повертаємося з переривання
+    pop edi
+    pop esi
+    pop ebx
+    pop ebp
+    ret
 
 ; Функція для перезавантаження
 global reboot_system
@@ -105,7 +251,145 @@ load_idt:
     lidt [eax]
     ret
 
+; Код сторінки vDSO: syscall.c копіює його на VDSO_CODE (user/nexus.h) і
+; відображає кільцю 3 лише на читання. Точки входу на фіксованих зміщеннях;
+; без SYSENTER слот vdso_syscall заміщується копією vdso_int80
+VDSO_BASE       equ 0xA0400000
+VDSO_CODE       equ VDSO_BASE + 0x100
+
+global vdso_start
+global vdso_end
+
+vdso_start:
+; +0x00: системний виклик найшвидшим шляхом ядра (EAX - номер, EBX/ESI/EDI)
+vdso_syscall:
+    mov ecx, esp
+    mov edx, VDSO_CODE + (vdso_sysenter_return - vdso_start)
+    sysenter
+vdso_sysenter_return:
+    ret
+    times 0x40 - ($ - vdso_start) db 0xCC
+
+; +0x40: той самий виклик через шлюз int 0x80
+vdso_int80:
+    int 0x80
+    ret
+    times 0x80 - ($ - vdso_start) db 0xCC
+
+; +0x80: uint64_t time_ns(void) без входу в ядро - TSC і множник з даних
+; vDSO: ns = ((tsc - tsc_base) * mult) >> shift, добуток 96-бітний
+vdso_time_ns:
+    push ebx
+    push esi
+    push edi
+    rdtsc
+    sub eax, [VDSO_BASE + 0]            ; tsc_base
+    sbb edx, [VDSO_BASE + 4]
+    mov esi, edx
+    mul dword [VDSO_BASE + 8]           ; mult * молодша половина
+    mov edi, eax
+    mov ebx, edx
+    mov eax, esi
+    mul dword [VDSO_BASE + 8]           ; mult * старша половина
+    add eax, ebx
+    adc edx, 0
+    mov ecx, [VDSO_BASE + 12]           ; shift < 32
+    shrd edi, eax, cl
+    shrd eax, edx, cl
+    mov edx, eax
+    mov eax, edi
+    pop edi
+    pop esi
+    pop ebx
+    ret
+vdso_end:
+
+; Трамплін запуску AP: копіюється на SMP_TRAMPOLINE_BASE, стартує в real mode
+; після SIPI, вмикає захищений режим і paging та викликає ap_main(index)
+SMP_TRAMPOLINE_BASE equ 0x8000
+%define TRAMP(x) (SMP_TRAMPOLINE_BASE + (x) - trampoline_start)
+
+; Біти CR0 для AP. Після INIT у CR0 стоять CD і NW (кеші вимкнено), тому
+; трамплін завантажує повне значення, а не додає біти до наявного
+CR0_PE          equ 1 << 0
+CR0_MP          equ 1 << 1
+CR0_ET          equ 1 << 4
+CR0_NE          equ 1 << 5
+CR0_WP          equ 1 << 16
+CR0_PG          equ 1 << 31
+
+global trampoline_start
+global trampoline_end
+global trampoline_params
+
+bits 16
+trampoline_start:
+    cli
+    cld
+    xor ax, ax
+    mov ds, ax
+    
+    lgdt [TRAMP(trampoline_gdtr)]
+    mov eax, CR0_PE | CR0_ET        ; CD, NW скинуто
+    mov cr0, eax
+    jmp dword 0x08:TRAMP(trampoline_protected)
+
+bits 32
+trampoline_protected:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+    
+    ; CR4 (PSE/PGE) до CR0.PG - таблиці BSP містять великі сторінки
+    mov eax, [TRAMP(trampoline_params.cr4)]
+    mov cr4, eax
+    mov eax, [TRAMP(trampoline_params.cr3)]
+    mov cr3, eax
+    mov eax, CR0_PE | CR0_ET | CR0_MP | CR0_NE | CR0_WP | CR0_PG
+    mov cr0, eax
+    
+    mov esp, [TRAMP(trampoline_params.stack)]
+    push dword [TRAMP(trampoline_params.index)]
+    mov eax, [TRAMP(trampoline_params.entry)]
+    call eax                ; ap_main не повертається
+    
+    cli
+.hang:
+    hlt
+    jmp .hang
+
+align 8
+trampoline_gdt:
+    dq 0x0000000000000000
+    dq 0x00CF9A000000FFFF   ; код ядра
+    dq 0x00CF92000000FFFF   ; дані ядра
+trampoline_gdtr:
+    dw trampoline_gdtr - trampoline_gdt - 1
+    dd TRAMP(trampoline_gdt)
+
+; Заповнює smp_init (struct trampoline_params у smp.c)
+align 4
+trampoline_params:
+.cr3:   dd 0
+.cr4:   dd 0
+.stack: dd 0
+.entry: dd 0
+.index: dd 0
+trampoline_end:
+
 section .data
+; Адреси заглушок для idt_init
+global irq_stub_table
+irq_stub_table:
+%assign i 0
+%rep 256
+    dd irq_stub_%[i]
+%assign i i+1
+%endrep
+
 ; Неправильний GDT для triple fault
 invalid_gdt:
     dd 0x00000000
@@ -1,19 +1,47 @@
 #include "kernel.h"
+#include "multiboot.h"
+#include "timer.h"
+#include "pmm.h"
+#include "heap.h"
+#include "vmm.h"
+#include "sched.h"
+#include "fpu.h"
+#include "cpu.h"
+#include "apic.h"
+#include "irq.h"
+#include "smp.h"
+#include "keyboard.h"
+#include "serial.h"
+#include "vga.h"
+#include "fb.h"
+#include "string.h"
+#include "bench.h"
+#include "trace.h"
+#include "expr.h"
+#include "bignum.h"
+#include "ramfs.h"
+#include "command.h"
+#include "pci.h"
+#include "blk.h"
+#include "cache.h"
+#include "net.h"
+#include "syscall.h"
+#include "task.h"
+#include "boot.h"
 
 // Глобальні змінні для VGA терміналу
 size_t terminal_row;
 size_t terminal_column;
 uint8_t terminal_color;
-uint16_t* terminal_buffer;
 
 // Буфер для вводу команд
 char input_buffer[256];
 size_t input_index = 0;
 
+
 // Зовнішні функції з асемблера
 extern void enable_interrupts(void);
 extern void disable_interrupts(void);
-extern void keyboard_interrupt_handler(void);
 extern void reboot_system(void);
 extern void shutdown_system(void);
 
@@ -27,26 +55,128 @@ struct idt_entry {
     uint8_t zero;
     uint8_t type_attr;
     uint16_t offset_high;
+#ifdef __x86_64__
+    uint32_t offset_upper;          // у long mode шлюз 16-байтний
+    uint32_t reserved;
+#endif
 } __attribute__((packed));
 
 struct idt_ptr {
     uint16_t limit;
-    uint32_t base;
+    uintptr_t base;
 } __attribute__((packed));
 
 struct idt_entry idt[256];
 struct idt_ptr idtp;
 
-void kernel_main(void) {
+// Звіт і бенчмарк фізичного алокатора - у fastboot після запрошення
+static void boot_memory_report(void) {
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
+    pmm_print_stats();
+    pmm_benchmark();
+    terminal_writestring("\n");
+}
+
+// Шина PCI: диск virtio-blk з кешем блоків та мережа virtio-net, якщо QEMU їх надав
+static void boot_probe_devices(void) {
+    if (pci_init() == SUCCESS) {
+        if (blk_init() == SUCCESS) {
+            cache_init();
+        }
+        net_init();
+    }
+}
+
+void kernel_main(uint32_t multiboot_magic, uint32_t multiboot_info) {
     // Ініціалізація терміналу
     terminal_initialize();
     
-    // Показуємо логотип
-    show_logo();
+    // COM1: дзеркало терміналу та ввід shell (QEMU -serial stdio)
+    serial_init();
+    
+    // Інформація Multiboot2 лише запам'ятовується - потрібна для параметрів ядра
+    int have_multiboot = multiboot_init(multiboot_magic, multiboot_info) == SUCCESS;
+    boot_init();
+    boot_phase("термінал і COM1");
+    
+    // Показуємо логотип (fastboot - після запрошення)
+    boot_run("логотип", show_logo);
+    
+    // Калібрування TSC потрібне для звітів про продуктивність
+    tsc_calibrate();
+    timer_init();
+    vga_enable_deferred_flush();
+    random_seed = (uint32_t)rdtsc();
+    boot_phase("калібрування TSC");
     
-    // Ініціалізація IDT та PIC
+    // Власна GDT з per-CPU сегментом GS для BSP
+    cpu_init(0);
+    
+    // SSE/AVX та вибір реалізацій mem*/str* за CPUID
+    cpu_detect_features();
+    cpu_enable_simd();
+    string_init();
+    
+    // IDT до увімкнення paging, щоб page fault мав обробник
     idt_init();
-    pic_init();
+    boot_phase("GDT, IDT, SIMD");
+    
+    // Фізична пам'ять з карти Multiboot2
+    if (have_multiboot && pmm_init() == SUCCESS) {
+        boot_phase("фізична пам'ять");
+        boot_run("звіт пам'яті", boot_memory_report);
+        
+        // Таблиці сторінок: identity-відображення RAM великими сторінками
+        if (vmm_init() != SUCCESS) {
+            kernel_panic("не вдалося побудувати таблиці сторінок");
+        }
+        
+        // Купа ядра з slab-кешами поверх фізичного алокатора
+        heap_init();
+        boot_phase("сторінки та купа");
+        
+        // Initrd з модуля Multiboot2 як файлова система в RAM
+        ramfs_init();
+        
+        // Графічна консоль, якщо GRUB встановив лінійний буфер кадрів
+        if (fb_init() == SUCCESS) {
+            vga_attach_framebuffer();
+        }
+        boot_phase("initrd і буфер кадрів");
+        
+        // Стан x87/SSE/AVX потоків: області XSAVE, режим eager або lazy (fpu=)
+        fpu_init();
+        
+        // kernel_main стає потоком shell, команди більше не виконуються в IRQ
+        if (sched_init("shell", SCHED_PRIO_SHELL) == SUCCESS) {
+            keyboard_set_consumer(sched_current());
+            serial_set_consumer(sched_current());
+        }
+        
+        // Кільце 3: SYSENTER/SYSCALL, шлюз int 0x80, сторінка vDSO та задачі з ELF
+        if (syscall_init() == SUCCESS) {
+            task_init();
+        }
+        boot_phase("FPU, потоки, кільце 3");
+        
+        // Прикладні процесори з MADT: INIT-SIPI-SIPI та цикл простою
+        smp_init();
+        
+        // Кільця трасування для всіх процесорів, що піднялися
+        trace_init();
+        boot_phase("SMP і трасування");
+    } else {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Помилка: немає карти пам'яті Multiboot2\n\n");
+    }
+    
+    // Контролер переривань: IOAPIC + локальний APIC або 8259
+    irq_init();
+    keyboard_init();
+    boot_phase("контролер переривань");
+    
+    // Пристрої PCI (fastboot - після запрошення)
+    boot_run("PCI: диск і мережа", boot_probe_devices);
     
     // Ініціалізація shell
     shell_initialize();
@@ -54,6 +184,31 @@ void kernel_main(void) {
     // Включаємо переривання
     enable_interrupts();
     
+    // Параметри "trace" та "profile": збір подій і семплів з самого старту
+    if (multiboot_cmdline_has("trace")) {
+        trace_start();
+    }
+    if (multiboot_cmdline_has("profile")) {
+        profile_start(PROFILE_DEFAULT_HZ);
+    }
+    
+    // Мітка готовності; відкладені фази fastboot - у фоновому потоці
+    bench_init();
+    boot_ready();
+    
+    // Параметр "bench": прогнати набір бенчмарків і вийти з QEMU (make bench)
+    if (multiboot_cmdline_has("bench")) {
+        bench_run(NULL, BENCH_OUTPUT_MACHINE);
+        serial_flush();
+        qemu_exit(0);
+    }
+    
+    // Параметр "autorun=<шлях>": скрипт з initrd до запуску shell (make regress)
+    char autorun[RAMFS_PATH_MAX];
+    if (multiboot_cmdline_value("autorun", autorun, sizeof(autorun))) {
+        command_run_script(autorun);
+    }
+    
     // Запуск shell
     shell_run();
 }
@@ -61,28 +216,31 @@ void kernel_main(void) {
 // === IDT ФУНКЦІЇ ===
 
 void idt_init(void) {
-    // Очищуємо IDT
-    for (int i = 0; i < 256; i++) {
-        idt[i].offset_low = 0;
-        idt[i].selector = 0;
-        idt[i].zero = 0;
-        idt[i].type_attr = 0;
-        idt[i].offset_high = 0;
+    // Таблиця в .bss уже обнулена завантажувачем; усі вектори ведуть у спільні заглушки, далі - таблиця обробників irq.c
+    for (int i = 0; i < IDT_VECTORS; i++) {
+        idt_set_gate(i, irq_stub_table[i], GDT_KERNEL_CODE, IDT_GATE_KERNEL);
     }
-    
-    // Встановлюємо обробник клавіатури (IRQ1 = INT 33)
-    idt_set_gate(33, (uint32_t)keyboard_interrupt_handler, 0x08, 0x8E);
+    irq_early_init();
     
     // Встановлюємо IDT
     idtp.limit = sizeof(idt) - 1;
-    idtp.base = (uint32_t)&idt;
+    idtp.base = (uintptr_t)&idt;
     
+    idt_load();
+}
+
+// Одна IDT на всі процесори, кожен AP завантажує її сам
+void idt_load(void) {
     asm volatile("lidt %0" : : "m"(idtp));
 }
 
-void idt_set_gate(uint8_t num, uint32_t base, uint16_t sel, uint8_t flags) {
+void idt_set_gate(uint8_t num, uintptr_t base, uint16_t sel, uint8_t flags) {
     idt[num].offset_low = base & 0xFFFF;
     idt[num].offset_high = (base >> 16) & 0xFFFF;
+#ifdef __x86_64__
+    idt[num].offset_upper = (uint32_t)(base >> 32);
+    idt[num].reserved = 0;
+#endif
     idt[num].selector = sel;
     idt[num].zero = 0;
     idt[num].type_attr = flags;
@@ -99,258 +257,908 @@ uint16_t vga_entry(unsigned char uc, uint8_t color) {
 }
 
 void terminal_initialize(void) {
-    terminal_row = 0;
-    terminal_column = 0;
-    terminal_color = vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
-    terminal_buffer = (uint16_t*) 0xB8000;
-    
-    for (size_t y = 0; y < VGA_HEIGHT; y++) {
-        for (size_t x = 0; x < VGA_WIDTH; x++) {
-            const size_t index = y * VGA_WIDTH + x;
-            terminal_buffer[index] = vga_entry(' ', terminal_color);
-        }
-    }
+    // Весь вивід іде в тіньовий буфер у RAM, у відеопам'ять - лише брудні рядки
+    vga_init(vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
 }
 
 void terminal_setcolor(uint8_t color) {
     terminal_color = color;
 }
 
-void terminal_scroll(void) {
-    // Пересуваємо всі рядки на один вгору
-    for (size_t y = 1; y < VGA_HEIGHT; y++) {
-        for (size_t x = 0; x < VGA_WIDTH; x++) {
-            size_t index = y * VGA_WIDTH + x;
-            size_t prev_index = (y - 1) * VGA_WIDTH + x;
-            terminal_buffer[prev_index] = terminal_buffer[index];
-        }
-    }
-    
-    // Очищуємо останній рядок
-    for (size_t x = 0; x < VGA_WIDTH; x++) {
-        size_t index = (VGA_HEIGHT - 1) * VGA_WIDTH + x;
-        terminal_buffer[index] = vga_entry(' ', terminal_color);
-    }
-    
-    terminal_row = VGA_HEIGHT - 1;
+// Дзеркалювання на COM1 можна вимкнути (бенчмарки терміналу)
+static int terminal_mirror = true;
+
+void terminal_set_serial_mirror(int enabled) {
+    terminal_mirror = enabled;
 }
 
 void terminal_putchar(char c) {
-    if (c == '\n') {
-        terminal_column = 0;
-        if (++terminal_row == VGA_HEIGHT) {
-            terminal_scroll();
-        }
-    } else if (c == '\b') {
-        if (terminal_column > 0) {
-            terminal_column--;
-            const size_t index = terminal_row * VGA_WIDTH + terminal_column;
-            terminal_buffer[index] = vga_entry(' ', terminal_color);
-        }
-    } else {
-        const size_t index = terminal_row * VGA_WIDTH + terminal_column;
-        terminal_buffer[index] = vga_entry(c, terminal_color);
-        if (++terminal_column == VGA_WIDTH) {
-            terminal_column = 0;
-            if (++terminal_row == VGA_HEIGHT) {
-                terminal_scroll();
-            }
-        }
+    vga_putchar(c);
+    if (terminal_mirror) {
+        serial_write(&c, 1);
     }
+    command_capture(&c, 1);
 }
 
+// Рядок іде одним пакетом: одне скидання VGA та одна порція в кільце COM1
 void terminal_write(const char* data, size_t size) {
-    for (size_t i = 0; i < size; i++) {
-        terminal_putchar(data[i]);
+    vga_write(data, size);
+    if (terminal_mirror) {
+        serial_write(data, size);
     }
+    command_capture(data, size);
 }
 
 void terminal_writestring(const char* data) {
     terminal_write(data, strlen(data));
 }
 
-void terminal_clear(void) {
-    terminal_row = 0;
-    terminal_column = 0;
-    
-    for (size_t y = 0; y < VGA_HEIGHT; y++) {
-        for (size_t x = 0; x < VGA_WIDTH; x++) {
-            const size_t index = y * VGA_WIDTH + x;
-            terminal_buffer[index] = vga_entry(' ', terminal_color);
-        }
+void terminal_writeuint(uint64_t value) {
+    char buffer[24];
+    uint64toa(value, buffer, 10);
+    terminal_writestring(buffer);
+}
+
+void terminal_writeuint_width(uint64_t value, size_t width) {
+    char buffer[24];
+    uint64toa(value, buffer, 10);
+    for (size_t len = strlen(buffer); len < width; len++) {
+        terminal_putchar(' ');
     }
+    terminal_writestring(buffer);
 }
 
-// === PIC ТА ПЕРЕРИВАННЯ ===
+// Десяті частки: 123 -> "12.3"
+void terminal_writetenths(uint64_t tenths) {
+    uint32_t rem;
+    terminal_writeuint(div64_u32(tenths, 10, &rem));
+    terminal_putchar('.');
+    terminal_putchar((char)('0' + rem));
+}
 
-void pic_init(void) {
-    // Ремапінг PIC
-    outb(PIC1_COMMAND, 0x11); // ICW1 - ініціалізація
-    outb(PIC2_COMMAND, 0x11);
-    
-    outb(PIC1_DATA, 0x20); // ICW2 - vector offset для master PIC (IRQ 0-7 -> INT 32-39)
-    outb(PIC2_DATA, 0x28); // ICW2 - vector offset для slave PIC (IRQ 8-15 -> INT 40-47)
-    
-    outb(PIC1_DATA, 0x04); // ICW3 - master має slave на IRQ2
-    outb(PIC2_DATA, 0x02); // ICW3 - slave підключений до IRQ2 master
-    
-    outb(PIC1_DATA, 0x01); // ICW4 - 8086 mode
-    outb(PIC2_DATA, 0x01);
-    
-    // Дозволяємо тільки клавіатуру (IRQ1)
-    outb(PIC1_DATA, 0xFD); // 11111101 - дозволяємо IRQ1
-    outb(PIC2_DATA, 0xFF); // блокуємо всі переривання slave PIC
+// Наносекунди як мілісекунди з трьома знаками; width - поле цілої частини
+void terminal_writems(uint64_t ns, size_t width) {
+    uint32_t rem;
+    uint64_t us = div64_u32(ns, 1000, NULL);
+    terminal_writeuint_width(div64_u32(us, 1000, &rem), width);
+    terminal_putchar('.');
+    terminal_putchar((char)('0' + rem / 100));
+    terminal_putchar((char)('0' + rem / 10 % 10));
+    terminal_putchar((char)('0' + rem % 10));
 }
 
-void keyboard_handler(void) {
-    uint8_t scancode = inb(KEYBOARD_DATA_PORT);
-    
-    // Ігноруємо key release (scancode > 0x80)
-    if (scancode & 0x80) {
+void terminal_clear(void) {
+    vga_clear();
+}
+
+// === SHELL ФУНКЦІЇ ===
+
+// Нижня половина клавіатури: редагування рядка в потоці shell.
+// Поки виконується команда, натискання чекають у кільці, а не губляться.
+// Наступний символ з клавіатури або COM1
+static char console_getchar(void) {
+    key_event_t event;
+    char c = 0;
+    unsigned long flags = interrupts_save();
+    while (1) {
+        if (serial_read_char(&c)) {
+            // Термінали надсилають CR на Enter та DEL на Backspace
+            if (c == '\r') {
+                c = '\n';
+            } else if (c == 0x7F) {
+                c = '\b';
+            }
+            break;
+        }
+        if (keyboard_read_event(&event)) {
+            if (event.flags & KEY_EVENT_RELEASE) {
+                continue;
+            }
+            // PageUp/PageDown гортають історію терміналу
+            if (event.key == KEY_PAGE_UP) {
+                vga_scrollback((int)vga_rows() / 2);
+                continue;
+            }
+            if (event.key == KEY_PAGE_DOWN) {
+                vga_scrollback(-((int)vga_rows() / 2));
+                continue;
+            }
+            if (event.ascii) {
+                c = event.ascii;
+                break;
+            }
+            continue;
+        }
+        // Обидва обробники будять потік shell, перевірка з вимкненими перериваннями
+        sched_block();
+    }
+    interrupts_restore(flags);
+    return c;
+}
+
+// Tab доповнює ім'я команди: однозначний збіг - повністю з пробілом,
+// кілька - до спільного префікса, а якщо продовжити нічим - список збігів
+static void shell_complete(void) {
+    for (size_t i = 0; i < input_index; i++) {
+        if (input_buffer[i] == ' ') {
+            return;
+        }
+    }
+    char suffix[COMMAND_LINE_MAX];
+    uint32_t matches = command_complete(input_buffer, input_index, suffix, sizeof(suffix));
+    size_t length = strlen(suffix);
+    if (matches > 1 && length == 0) {
+        terminal_putchar('\n');
+        command_print_matches(input_buffer, input_index);
+        terminal_writestring("nexus> ");
+        terminal_write(input_buffer, input_index);
         return;
     }
-    
-    // Простий скан-код до ASCII конвертер
-    static char scancode_to_ascii[128] = {
-        0, 0, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
-        '\t', 'q', 'w', 'e', 'r', 't', 'y', 'u', 'i', 'o', 'p', '[', ']', '\n',
-        0, 'a', 's', 'd', 'f', 'g', 'h', 'j', 'k', 'l', ';', '\'', '`',
-        0, '\\', 'z', 'x', 'c', 'v', 'b', 'n', 'm', ',', '.', '/', 0,
-        '*', 0, ' '
-    };
-    
-    if (scancode < 128 && scancode_to_ascii[scancode] != 0) {
-        char c = scancode_to_ascii[scancode];
-        
+    if (matches == 1 && length + 1 < sizeof(suffix)) {
+        suffix[length++] = ' ';
+    }
+    if (input_index + length < sizeof(input_buffer)) {
+        memcpy(input_buffer + input_index, suffix, length);
+        input_index += length;
+        terminal_write(suffix, length);
+    }
+}
+
+// Shell чекає на ввід рядка (для виводу фонових потоків, boot.c)
+static volatile int shell_waiting = false;
+
+int shell_at_prompt(void) {
+    return shell_waiting;
+}
+
+void shell_redraw_prompt(void) {
+    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
+    terminal_writestring("nexus> ");
+    terminal_write(input_buffer, input_index);
+}
+
+static int shell_read_line(void) {
+    while (1) {
+        char c = console_getchar();
         if (c == '\n') {
             terminal_putchar('\n');
             input_buffer[input_index] = '\0';
-            process_command(input_buffer);
-            input_index = 0;
-            terminal_writestring("nexus> ");
+            return (int)input_index;
         } else if (c == '\b') {
             if (input_index > 0) {
                 input_index--;
                 terminal_putchar('\b');
             }
-        } else if (input_index < sizeof(input_buffer) - 1) {
+        } else if (c == '\t') {
+            shell_complete();
+        } else if (c == ('U' & 0x1F)) {
+            // Ctrl+U - стерти весь рядок
+            while (input_index > 0) {
+                input_index--;
+                terminal_putchar('\b');
+            }
+        } else if (c == ('L' & 0x1F)) {
+            // Ctrl+L - очистити екран, зберігши введене
+            terminal_clear();
+            terminal_writestring("nexus> ");
+            terminal_write(input_buffer, input_index);
+        } else if (c >= ' ' && c < 0x7F && input_index < sizeof(input_buffer) - 1) {
             input_buffer[input_index++] = c;
             terminal_putchar(c);
         }
     }
 }
 
-// === SHELL ФУНКЦІЇ ===
-
-void shell_initialize(void) {
-    input_index = 0;
-    
-    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
-    terminal_writestring("Nexus OS v0.1 - Готова до роботи!\n");
-    terminal_writestring("Введіть 'help' для списку команд.\n\n");
-    
-    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
-    terminal_writestring("nexus> ");
-}
-
 void shell_run(void) {
-    // Головний цикл shell - просто чекаємо переривання
+    // Головний цикл shell - рядок збирається з подій клавіатури
     while (1) {
-        asm volatile("hlt"); // Очікуємо переривання
+        terminal_writestring("nexus> ");
+        shell_waiting = true;
+        shell_read_line();
+        shell_waiting = false;
+        process_command(input_buffer);
+        input_index = 0;
     }
 }
 
 void process_command(const char* command) {
-    // Пропускаємо пробіли на початку
-    while (*command == ' ') command++;
-    
-    if (strlen(command) == 0) {
-        return;
+    command_execute(command);
+}
+
+// === КОМАНДИ SHELL ===
+
+static void set_info_color(void) {
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
+}
+
+static int usage_error(const char* usage) {
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring(usage);
+    return ERROR_INVALID_INPUT;
+}
+
+static int cmd_help(const char* args) {
+    (void)args;
+    show_help();
+    return SUCCESS;
+}
+
+static int cmd_clear(const char* args) {
+    (void)args;
+    terminal_clear();
+    show_logo();
+    return SUCCESS;
+}
+
+static int cmd_shutdown(const char* args) {
+    (void)args;
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("Вимкнення системи...\n");
+    shutdown();
+    return SUCCESS;
+}
+
+static int cmd_reboot(const char* args) {
+    (void)args;
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_BLUE, VGA_COLOR_BLACK));
+    terminal_writestring("Перезавантаження системи...\n");
+    reboot();
+    return SUCCESS;
+}
+
+static int cmd_rand(const char* args) {
+    (void)args;
+    int num = random_number();
+    char buffer[16];
+    itoa(num, buffer, 10);
+    set_info_color();
+    terminal_writestring("Випадкове число: ");
+    terminal_writestring(buffer);
+    terminal_writestring("\n");
+    return SUCCESS;
+}
+
+static int cmd_mem(const char* args) {
+    (void)args;
+    set_info_color();
+    pmm_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_heap(const char* args) {
+    (void)args;
+    set_info_color();
+    heap_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_heapbench(const char* args) {
+    (void)args;
+    set_info_color();
+    terminal_writestring("kmalloc/kfree:\n");
+    heap_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_vmm(const char* args) {
+    (void)args;
+    set_info_color();
+    vmm_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_vmbench(const char* args) {
+    (void)args;
+    set_info_color();
+    vmm_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_boot(const char* args) {
+    (void)args;
+    set_info_color();
+    boot_print_timeline();
+    return SUCCESS;
+}
+
+static int cmd_uptime(const char* args) {
+    (void)args;
+    set_info_color();
+    timer_print_uptime();
+    return SUCCESS;
+}
+
+static int cmd_sleep(const char* args) {
+    int ms = atoi(args);
+    if (ms <= 0) {
+        return usage_error("Використання: sleep <мілісекунди>\n");
     }
-    
-    if (strcmp(command, "help") == 0) {
-        show_help();
-    } else if (strcmp(command, "clear") == 0) {
-        terminal_clear();
-        show_logo();
-        terminal_writestring("nexus> ");
-        return; // Не показуємо промпт знову
-    } else if (strcmp(command, "shutdown") == 0) {
+    sched_sleep_ns((uint64_t)ms * NS_PER_MS);
+    return SUCCESS;
+}
+
+static int cmd_timers(const char* args) {
+    (void)args;
+    set_info_color();
+    timer_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_jitter(const char* args) {
+    (void)args;
+    set_info_color();
+    timer_jitter_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_ps(const char* args) {
+    (void)args;
+    set_info_color();
+    sched_print_threads();
+    return SUCCESS;
+}
+
+static int cmd_schedbench(const char* args) {
+    (void)args;
+    set_info_color();
+    sched_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_fpu(const char* args) {
+    if (strcmp(args, "lazy") == 0 || strcmp(args, "eager") == 0) {
+        if (fpu_set_mode(args[0] == 'l' ? FPU_MODE_LAZY : FPU_MODE_EAGER) != SUCCESS) {
+            return usage_error("Стан FPU не керується: немає SSE2/FXSR\n");
+        }
+    } else if (strcmp(args, "reset") == 0) {
+        fpu_reset_stats();
+        return SUCCESS;
+    } else if (*args) {
+        return usage_error("Використання: fpu [lazy|eager|reset]\n");
+    }
+    set_info_color();
+    fpu_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_fpubench(const char* args) {
+    (void)args;
+    set_info_color();
+    fpu_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_cpus(const char* args) {
+    (void)args;
+    set_info_color();
+    smp_print_cpus();
+    return SUCCESS;
+}
+
+static int cmd_smpbench(const char* args) {
+    (void)args;
+    set_info_color();
+    smp_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_kbd(const char* args) {
+    (void)args;
+    set_info_color();
+    keyboard_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_serial(const char* args) {
+    (void)args;
+    set_info_color();
+    serial_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_irq(const char* args) {
+    if (!*args) {
+        set_info_color();
+        irq_print_stats();
+        return SUCCESS;
+    }
+    if (strcmp(args, "reset") == 0) {
+        irq_reset_stats();
+        return SUCCESS;
+    }
+    if (strncmp(args, "affinity ", 9) != 0) {
+        return usage_error("Використання: irq [reset|affinity <IRQ> <CPU>]\n");
+    }
+    const char* cpu = strchr(args + 9, ' ');
+    int irq = atoi(args + 9);
+    if (!cpu || irq < 0 || irq >= IRQ_ISA_LINES || atoi(cpu + 1) < 0) {
+        return usage_error("Використання: irq affinity <IRQ> <CPU>\n");
+    }
+    if (irq_set_affinity((uint8_t)irq, (uint32_t)atoi(cpu + 1)) != SUCCESS) {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Не вдалося: лінія не встановлена, процесор не онлайн\n");
+        terminal_writestring("або обробник будить потоки і лишається на BSP\n");
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+static int cmd_serialbench(const char* args) {
+    int kilobytes = *args ? atoi(args) : 256;
+    set_info_color();
+    if (kilobytes <= 0 || kilobytes > 65536) {
+        terminal_writestring("Використання: serialbench [кілобайти, 1-65536]\n");
+        return ERROR_INVALID_INPUT;
+    }
+    serial_benchmark((uint32_t)kilobytes);
+    return SUCCESS;
+}
+
+static int cmd_console(const char* args) {
+    (void)args;
+    set_info_color();
+    vga_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_vgabench(const char* args) {
+    (void)args;
+    set_info_color();
+    vga_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_bench(const char* args) {
+    set_info_color();
+    if (bench_run(*args ? args : NULL, BENCH_OUTPUT_TABLE) == 0) {
+        terminal_writestring("Немає бенчмарків з таким префіксом\n");
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+static int cmd_strbench(const char* args) {
+    (void)args;
+    set_info_color();
+    string_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_strfuzz(const char* args) {
+    int iterations = *args ? atoi(args) : 10000;
+    set_info_color();
+    if (iterations <= 0) {
+        terminal_writestring("Використання: strfuzz [ітерації]\n");
+        return ERROR_INVALID_INPUT;
+    }
+    if (string_fuzz((uint32_t)iterations) != 0) {
         terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
-        terminal_writestring("Вимкнення системи...\n");
-        shutdown();
-    } else if (strcmp(command, "reboot") == 0) {
-        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_BLUE, VGA_COLOR_BLACK));
-        terminal_writestring("Перезавантаження системи...\n");
-        reboot();
-    } else if (strcmp(command, "rand") == 0) {
-        int num = random_number();
-        char buffer[16];
-        itoa(num, buffer, 10);
-        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
-        terminal_writestring("Випадкове число: ");
-        terminal_writestring(buffer);
+        terminal_writestring("Знайдено розбіжності з еталоном!\n");
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+static int cmd_trace(const char* args) {
+    if (!*args) {
+        set_info_color();
+        trace_print_stats();
+    } else if (strcmp(args, "on") == 0) {
+        trace_start();
+    } else if (strcmp(args, "off") == 0) {
+        trace_stop();
+    } else if (strcmp(args, "clear") == 0) {
+        trace_clear();
+    } else if (strcmp(args, "dump") == 0) {
+        set_info_color();
+        if (!serial_present()) {
+            terminal_writestring("COM1 відсутній - дамп нікуди писати\n");
+            return ERROR_INVALID_INPUT;
+        }
+        trace_dump();
+        terminal_writestring("Події записано в COM1 (tools/symbolize.py)\n");
+    } else {
+        return usage_error("Використання: trace [on|off|clear|dump]\n");
+    }
+    return SUCCESS;
+}
+
+static int cmd_profile(const char* args) {
+    if (!*args) {
+        set_info_color();
+        profile_print_stats();
+    } else if (strcmp(args, "start") == 0 || strncmp(args, "start ", 6) == 0) {
+        int hz = args[5] ? atoi(args + 6) : PROFILE_DEFAULT_HZ;
+        if (hz <= 0 || profile_start((uint32_t)hz) != SUCCESS) {
+            set_info_color();
+            terminal_writestring("Використання: profile start [Гц, 1-10000]\n");
+            return ERROR_INVALID_INPUT;
+        }
+    } else if (strcmp(args, "stop") == 0) {
+        profile_stop();
+    } else if (strcmp(args, "dump") == 0) {
+        set_info_color();
+        if (!serial_present()) {
+            terminal_writestring("COM1 відсутній - дамп нікуди писати\n");
+            return ERROR_INVALID_INPUT;
+        }
+        profile_dump();
+        terminal_writestring("Семпли записано в COM1 (tools/symbolize.py)\n");
+    } else {
+        return usage_error("Використання: profile [start [Гц]|stop|dump]\n");
+    }
+    return SUCCESS;
+}
+
+static int cmd_calc(const char* args) {
+    set_info_color();
+    if (!*args) {
+        terminal_writestring("Використання: calc <вираз> [x=A..B]\n");
+        expr_print_stats();
+        return SUCCESS;
+    }
+    expr_calc(args);
+    return SUCCESS;
+}
+
+static int cmd_bigbench(const char* args) {
+    (void)args;
+    set_info_color();
+    bignum_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_ls(const char* args) {
+    set_info_color();
+    return ramfs_ls(*args ? args : "/");
+}
+
+static int cmd_cat(const char* args) {
+    if (!*args) {
+        return usage_error("Використання: cat <файл>\n");
+    }
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
+    return ramfs_cat(args);
+}
+
+static int cmd_stat(const char* args) {
+    if (!*args) {
+        return usage_error("Використання: stat <шлях>\n");
+    }
+    set_info_color();
+    return ramfs_stat(args);
+}
+
+static int cmd_fsbench(const char* args) {
+    (void)args;
+    set_info_color();
+    ramfs_benchmark();
+    return SUCCESS;
+}
+
+static int cmd_lspci(const char* args) {
+    (void)args;
+    set_info_color();
+    pci_print_devices();
+    return SUCCESS;
+}
+
+static int cmd_blk(const char* args) {
+    (void)args;
+    set_info_color();
+    blk_print_stats();
+    return blk_present() ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+static int cmd_blkbench(const char* args) {
+    int kilobytes = *args ? atoi(args) : 4;
+    set_info_color();
+    if (kilobytes <= 0 || kilobytes > 128) {
+        terminal_writestring("Використання: blkbench [КБ на запит, 1-128]\n");
+        return ERROR_INVALID_INPUT;
+    }
+    blk_benchmark((uint32_t)kilobytes);
+    return blk_present() ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+static int cmd_cache(const char* args) {
+    set_info_color();
+    if (!*args) {
+        cache_print_stats();
+        return SUCCESS;
+    }
+    if (strcmp(args, "sync") == 0) {
+        return cache_sync();
+    }
+    if (strcmp(args, "drop") == 0) {
+        return cache_drop();
+    }
+    if (strcmp(args, "reset") == 0) {
+        cache_reset_stats();
+        return SUCCESS;
+    }
+    if (strncmp(args, "read ", 5) == 0) {
+        // Один блок через кеш - влучання чи промах видно в статистиці
+        cache_page_t* page = cache_get(CACHE_DEV_BLK, (uint64_t)atoi(args + 5));
+        if (!page) {
+            terminal_writestring("Блок не прочитано\n");
+            return ERROR_IO;
+        }
+        cache_put(page);
+        return SUCCESS;
+    }
+    if (strcmp(args, "readahead on") == 0 || strcmp(args, "readahead off") == 0) {
+        cache_set_readahead(args[11] == 'n');
+        return SUCCESS;
+    }
+    return usage_error("Використання: cache [sync|drop|reset|read БЛОК|readahead on|off]\n");
+}
+
+static int cmd_cachebench(const char* args) {
+    (void)args;
+    set_info_color();
+    cache_benchmark();
+    return blk_present() ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+static int cmd_net(const char* args) {
+    (void)args;
+    set_info_color();
+    net_print_stats();
+    return net_present() ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+static int cmd_udpsend(const char* args) {
+    const char* rest;
+    uint32_t ip = net_parse_ip(args, &rest);
+    int port = ip && *rest == ' ' ? atoi(rest + 1) : 0;
+    while (*rest == ' ') {
+        rest++;
+    }
+    while (*rest >= '0' && *rest <= '9') {
+        rest++;
+    }
+    while (*rest == ' ') {
+        rest++;
+    }
+    if (port <= 0 || port > 65535) {
+        return usage_error("Використання: udpsend IP ПОРТ [текст]\n");
+    }
+    set_info_color();
+    int result = net_udp_send(ip, NET_SHELL_PORT, (uint16_t)port, rest, strlen(rest));
+    if (result != SUCCESS) {
+        terminal_writestring("Датаграму не надіслано\n");
+    }
+    return result;
+}
+
+static int cmd_netbench(const char* args) {
+    uint32_t ip = net_parse_ip(args, NULL);
+    if (!ip) {
+        return usage_error("Використання: netbench IP\n");
+    }
+    set_info_color();
+    net_benchmark(ip);
+    return net_present() ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+// Задача кільця 3 з initrd; ненульовий код виходу - невдала команда
+static int cmd_exec(const char* args) {
+    char path[RAMFS_PATH_MAX];
+    size_t length = 0;
+    while (args[length] && args[length] != ' ' && length < sizeof(path) - 1) {
+        path[length] = args[length];
+        length++;
+    }
+    path[length] = '\0';
+    if (!length) {
+        return usage_error("Використання: exec ФАЙЛ [аргументи]\n");
+    }
+    const char* rest = args + length;
+    while (*rest == ' ') {
+        rest++;
+    }
+
+    int code = task_run(path, rest);
+    if (code != SUCCESS) {
+        set_info_color();
+        terminal_writestring("Код виходу: ");
+        if (code < 0) {
+            terminal_putchar('-');
+        }
+        terminal_writeuint((uint32_t)(code < 0 ? -code : code));
         terminal_writestring("\n");
-    } else if (strncmp(command, "echo ", 5) == 0) {
-        const char* text = command + 5;
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+static int cmd_syscalls(const char* args) {
+    if (strcmp(args, "reset") == 0) {
+        syscall_reset_stats();
+        return SUCCESS;
+    }
+    set_info_color();
+    syscall_print_stats();
+    task_print_stats();
+    return SUCCESS;
+}
+
+static int cmd_sysbench(const char* args) {
+    syscall_reset_stats();
+    int code = task_run("/bin/sysbench", args);
+    set_info_color();
+    syscall_print_stats();
+    return code == SUCCESS ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+static int cmd_run(const char* args) {
+    if (!*args) {
+        return usage_error("Використання: run <скрипт>\n");
+    }
+    int failed = command_run_script(args);
+    return failed == 0 ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+static int cmd_expect(const char* args) {
+    if (!*args) {
+        return usage_error("Використання: expect <текст>\n");
+    }
+    return command_expect(args);
+}
+
+// Вихід з QEMU через isa-debug-exit; без коду - 1, якщо у скрипті були невдалі команди
+static int cmd_exit(const char* args) {
+    int status = *args ? atoi(args) : command_script_failed();
+    if (status < 0 || status > 127) {
+        return usage_error("Використання: exit [код, 0-127]\n");
+    }
+    vga_flush();
+    serial_flush();
+    qemu_exit((uint8_t)status);
+    return SUCCESS;
+}
+
+static int cmd_echo(const char* text) {
+    // Перевіряємо чи це математичний вираз
+    if (strlen(text) > 2 && text[0] == '"' && text[strlen(text)-1] == '"') {
+        // Видаляємо лапки
+        size_t expr_len = strlen(text) - 2;
+        char* expr = kmalloc(expr_len + 1);
+        if (!expr) {
+            terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+            terminal_writestring("Помилка: недостатньо пам'яті\n");
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        strncpy(expr, text + 1, expr_len);
+        expr[expr_len] = '\0';
         
-        // Перевіряємо чи це математичний вираз
-        if (strlen(text) > 2 && text[0] == '"' && text[strlen(text)-1] == '"') {
-            // Видаляємо лапки
-            char expr[256];
-            strncpy(expr, text + 1, strlen(text) - 2);
-            expr[strlen(text) - 2] = '\0';
-            
-            // Перевіряємо на математичний вираз
-            int result = parse_math_expression(expr);
-            if (result != -999999) { // -999999 = помилка парсингу
-                char buffer[32];
-                itoa(result, buffer, 10);
-                terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
-                terminal_writestring("Результат: ");
-                terminal_writestring(buffer);
-                terminal_writestring("\n");
-            } else {
-                // Просто виводимо текст
-                terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_YELLOW, VGA_COLOR_BLACK));
-                terminal_writestring(expr);
-                terminal_writestring("\n");
-            }
+        // Перевіряємо на математичний вираз
+        math_calculation_t calc = parse_math_expression_safe(expr);
+        bignum_t big;
+        bignum_init(&big);
+        int status = SUCCESS;
+        if (calc.error == MATH_SUCCESS) {
+            char buffer[32];
+            itoa(calc.value, buffer, 10);
+            terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+            terminal_writestring("Результат: ");
+            terminal_writestring(buffer);
+            terminal_writestring("\n");
+        } else if (calc.error == MATH_ERROR_OVERFLOW && (calc.error = expr_eval_big(expr, &big)) == MATH_SUCCESS) {
+            // Не влізло в int32 - виводимо результат довгої арифметики
+            terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+            terminal_writestring("Результат: ");
+            bignum_write(&big);
+            terminal_writestring("\n");
+        } else if (calc.error == MATH_ERROR_DIV_BY_ZERO || calc.error == MATH_ERROR_OVERFLOW) {
+            terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+            terminal_writestring("Помилка: ");
+            terminal_writestring(expr_error_string(calc.error));
+            terminal_writestring("\n");
+            status = ERROR_INVALID_EXPRESSION;
         } else {
+            // Просто виводимо текст
             terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_YELLOW, VGA_COLOR_BLACK));
-            terminal_writestring(text);
+            terminal_writestring(expr);
             terminal_writestring("\n");
         }
-    } else {
-        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
-        terminal_writestring("Невідома команда: ");
-        terminal_writestring(command);
-        terminal_writestring("\n");
-        terminal_writestring("Введіть 'help' для списку команд.\n");
+        bignum_free(&big);
+        kfree(expr);
+        return status;
     }
-    
-    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_YELLOW, VGA_COLOR_BLACK));
+    terminal_writestring(text);
+    terminal_writestring("\n");
+    return SUCCESS;
 }
 
+// Порядок таблиці - порядок у довідці
+static const command_t shell_commands[] = {
+    { "help",        NULL,                      "показати цю довідку", cmd_help },
+    { "clear",       NULL,                      "очистити екран", cmd_clear },
+    { "shutdown",    NULL,                      "вимкнути систему", cmd_shutdown },
+    { "reboot",      NULL,                      "перезавантажити систему", cmd_reboot },
+    { "rand",        NULL,                      "згенерувати випадкове число (0-99)", cmd_rand },
+    { "mem",         NULL,                      "статистика фізичної пам'яті", cmd_mem },
+    { "heap",        NULL,                      "статистика slab-кешів купи", cmd_heap },
+    { "heapbench",   NULL,                      "бенчмарк kmalloc/kfree", cmd_heapbench },
+    { "vmm",         NULL,                      "статистика таблиць сторінок", cmd_vmm },
+    { "vmbench",     NULL,                      "великі проти 4 КБ сторінок", cmd_vmbench },
+    { "boot",        NULL,                      "хронологія завантаження: фази від скидання до запрошення", cmd_boot },
+    { "uptime",      NULL,                      "час роботи системи", cmd_uptime },
+    { "sleep",       "N",                       "пауза на N мілісекунд", cmd_sleep },
+    { "timers",      NULL,                      "статистика таймерів", cmd_timers },
+    { "jitter",      NULL,                      "джитер пробудження таймера", cmd_jitter },
+    { "ps",          NULL,                      "список потоків ядра", cmd_ps },
+    { "schedbench",  NULL,                      "бенчмарк перемикання контексту", cmd_schedbench },
+    { "fpu",         "[lazy|eager|reset]",      "режим і статистика стану FPU/SSE потоків", cmd_fpu },
+    { "fpubench",    NULL,                      "перемикання зі станом FPU: eager проти lazy, 0-2 SIMD-потоки", cmd_fpubench },
+    { "cpus",        NULL,                      "процесори та статистика простою", cmd_cpus },
+    { "smpbench",    NULL,                      "паралельна сума на 1..N процесорах", cmd_smpbench },
+    { "kbd",         NULL,                      "статистика клавіатури (втрати, час ISR)", cmd_kbd },
+    { "serial",      NULL,                      "статистика COM1", cmd_serial },
+    { "irq",         "[reset|affinity N CPU]",  "переривання на вектор/CPU, такти до EOI", cmd_irq },
+    { "serialbench", "[КБ]",                    "пропускна здатність COM1, байт/с", cmd_serialbench },
+    { "console",     NULL,                      "екран, тіньовий буфер, кеш гліфів графічної консолі", cmd_console },
+    { "vgabench",    NULL,                      "рядків/с і символів/с: прямий вивід проти тіньового буфера", cmd_vgabench },
+    { "bench",       "[ім'я]",                  "набір бенчмарків: мін./медіана/p99 у тактах", cmd_bench },
+    { "strbench",    NULL,                      "байт/такт mem*/strlen за розмірами 1 Б - 1 МБ", cmd_strbench },
+    { "strfuzz",     "[N]",                     "перевірка mem*/str* проти еталону", cmd_strfuzz },
+    { "trace",       "[on|off|clear|dump]",     "кільця подій IRQ/команд/VGA", cmd_trace },
+    { "profile",     "[start [Гц]|stop|dump]",  "семплювання EIP", cmd_profile },
+    { "calc",        "E [x=A..B]",              "вираз або сума E для x від A до B (інтерпретатор/JIT)", cmd_calc },
+    { "bigbench",    NULL,                      "довга арифметика: шкільне множення проти Карацуби, 10000!", cmd_bigbench },
+    { "ls",          "[шлях]",                  "вміст каталогу initrd", cmd_ls },
+    { "cat",         "ФАЙЛ",                    "вивести файл з initrd", cmd_cat },
+    { "stat",        "ШЛЯХ",                    "розмір, права, екстент і кошик хеш-таблиці", cmd_stat },
+    { "fsbench",     NULL,                      "пошук нс та читання ГБ/с по всіх файлах initrd", cmd_fsbench },
+    { "lspci",       NULL,                      "пристрої PCI: BDF, ідентифікатори, клас, BAR", cmd_lspci },
+    { "blk",         NULL,                      "диск virtio-blk: черга, переривання, затримка", cmd_blk },
+    { "blkbench",    "[КБ]",                    "IOPS і МБ/с на глибинах черги 1-64", cmd_blkbench },
+    { "cache",       "[sync|drop|reset|readahead on|off]", "кеш блоків: влучання, промахи, витіснення, read-ahead, запис", cmd_cache },
+    { "cachebench",  NULL,                      "траса випадкових і послідовних звернень: без кешу, з кешем, з read-ahead", cmd_cachebench },
+    { "net",         NULL,                      "мережа virtio-net: адреса, ARP, прийом/передача, відкинуті", cmd_net },
+    { "udpsend",     "IP ПОРТ [текст]",         "надіслати датаграму UDP", cmd_udpsend },
+    { "netbench",    "IP",                      "відлуння UDP: пак./с і RTT на розмірах пакета 1-64", cmd_netbench },
+    { "exec",        "ФАЙЛ [аргументи]",        "запустити програму кільця 3 з initrd (ELF)", cmd_exec },
+    { "syscalls",    "[reset]",                 "системні виклики за шляхами і номерами, задачі", cmd_syscalls },
+    { "sysbench",    "[N]",                     "порожній виклик: int 0x80 проти SYSENTER/SYSCALL, годинник vDSO", cmd_sysbench },
+    { "run",         "СКРИПТ",                  "виконати команди з файлу initrd, вивід пакетом", cmd_run },
+    { "expect",      "ТЕКСТ",                   "у скрипті: вивід попередньої команди містить ТЕКСТ", cmd_expect },
+    { "exit",        "[код]",                   "вийти з QEMU (isa-debug-exit) з кодом", cmd_exit },
+    { "echo",        "\"текст\"",               "вивести текст", cmd_echo },
+};
+
 void show_help(void) {
     terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
     terminal_writestring("=== NEXUS OS v0.1 - ДОВІДКА ===\n\n");
     
     terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
-    terminal_writestring("Доступні команди:\n");
-    terminal_writestring("  help        - показати цю довідку\n");
-    terminal_writestring("  clear       - очистити екран\n");
-    terminal_writestring("  shutdown    - вимкнути систему\n");
-    terminal_writestring("  reboot      - перезавантажити систему\n");
-    terminal_writestring("  rand        - згенерувати випадкове число (0-99)\n");
-    terminal_writestring("  echo \"текст\" - вивести текст\n");
+    terminal_writestring("Доступні команди (Tab доповнює ім'я):\n");
+    command_print_help();
     
     terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     terminal_writestring("\nМатематичні операції в echo:\n");
     terminal_writestring("  echo \"5+3\"   - додавання\n");
     terminal_writestring("  echo \"10-4\"  - віднімання\n");
     terminal_writestring("  echo \"6*7\"   - множення\n");
-    terminal_writestring("  echo \"20/4\"  - ділення\n\n");
+    terminal_writestring("  echo \"20/4\"  - ділення\n");
+    terminal_writestring("  echo \"-(2+3)*4^2 % 7\" - пріоритети, дужки, степінь\n");
+    terminal_writestring("  echo \"2^100 + 50!\" - поза int32 - довга арифметика\n\n");
+}
+
+void shell_initialize(void) {
+    input_index = 0;
+    if (command_register(shell_commands, sizeof(shell_commands) / sizeof(shell_commands[0])) != SUCCESS) {
+        kernel_panic("Не вдалося зареєструвати команди shell");
+    }
+    
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+    terminal_writestring("Nexus OS v0.1 (" KERNEL_ARCH ") - Готова до роботи!\n");
+    terminal_writestring("Введіть 'help' для списку команд.\n\n");
+    
+    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK));
 }
 
 void show_logo(void) {
@@ -396,44 +1204,27 @@ int random_number(void) {
     return (random_seed / 65536) % 100;
 }
 
-int parse_math_expression(const char* expr) {
-    int num1 = 0, num2 = 0;
-    char op = 0;
-    int i = 0;
-    
-    // Парсимо перше число
-    while (expr[i] && expr[i] >= '0' && expr[i] <= '9') {
-        num1 = num1 * 10 + (expr[i] - '0');
-        i++;
-    }
+// Вираз без змінних через кеш скомпільованих виразів (expr.c)
+math_calculation_t parse_math_expression_safe(const char* expr) {
+    math_calculation_t calc = { 0, MATH_SUCCESS };
+    expr_t* compiled;
     
-    // Парсимо оператор
-    if (expr[i] && (expr[i] == '+' || expr[i] == '-' || expr[i] == '*' || expr[i] == '/')) {
-        op = expr[i];
-        i++;
-    } else {
-        return -999999; // Помилка - не математичний вираз
+    calc.error = expr_lookup(expr, &compiled);
+    if (calc.error == MATH_SUCCESS && compiled->uses_x) {
+        calc.error = MATH_ERROR_INVALID_EXPR;
     }
-    
-    // Парсимо друге число
-    while (expr[i] && expr[i] >= '0' && expr[i] <= '9') {
-        num2 = num2 * 10 + (expr[i] - '0');
-        i++;
-    }
-    
-    // Перевіряємо чи дійшли до кінця
-    if (expr[i] != '\0') {
-        return -999999; // Помилка - зайві символи
-    }
-    
-    // Виконуємо операцію
-    switch (op) {
-        case '+': return add(num1, num2);
-        case '-': return subtract(num1, num2);
-        case '*': return multiply(num1, num2);
-        case '/': return divide(num1, num2);
-        default: return -999999;
+    if (calc.error == MATH_SUCCESS) {
+        int32_t value;
+        calc.error = expr_eval(compiled, 0, &value);
+        calc.value = value;
     }
+    return calc;
+}
+
+// Стара обгортка: -999999 замість коду помилки
+int parse_math_expression(const char* expr) {
+    math_calculation_t calc = parse_math_expression_safe(expr);
+    return calc.error == MATH_SUCCESS ? calc.value : -999999;
 }
 
 // === СИСТЕМНІ ФУНКЦІЇ ===
@@ -448,14 +1239,27 @@ void reboot(void) {
     reboot_system();
 }
 
-// === УТИЛІТАРНІ ФУНКЦІЇ ===
+void qemu_exit(uint8_t status) {
+    outb(QEMU_DEBUG_EXIT_PORT, status);
+    // Без isa-debug-exit просто вимикаємося
+    shutdown();
+}
 
-size_t strlen(const char* str) {
-    size_t len = 0;
-    while (str[len]) len++;
-    return len;
+void kernel_panic(const char* message) {
+    disable_interrupts();
+    terminal_setcolor(vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_RED));
+    terminal_writestring("\nKERNEL PANIC: ");
+    terminal_writestring(message);
+    terminal_writestring("\n");
+    vga_flush();
+    serial_flush();
+    while (1) {
+        asm volatile("hlt");
+    }
 }
 
+// === УТИЛІТАРНІ ФУНКЦІЇ ===
+
 int strcmp(const char* str1, const char* str2) {
     while (*str1 && (*str1 == *str2)) {
         str1++;
@@ -528,4 +1332,20 @@ void itoa(int value, char* str, int base) {
         *ptr-- = *ptr1;
         *ptr1++ = tmp_char;
     }
-}
\ No newline at end of file
+}
+
+void uint64toa(uint64_t value, char* str, int base) {
+    char tmp[65];
+    int i = 0;
+    
+    do {
+        uint32_t digit;
+        value = div64_u32(value, (uint32_t)base, &digit);
+        tmp[i++] = "0123456789abcdef"[digit];
+    } while (value);
+    
+    while (i > 0) {
+        *str++ = tmp[--i];
+    }
+    *str = '\0';
+}
@@ -11,6 +11,7 @@ typedef signed short int16_t;
 typedef signed int int32_t;
 typedef signed long long int64_t;
 typedef unsigned long size_t;
+typedef unsigned long uintptr_t;
 
 #define NULL ((void*)0)
 #define true 1
@@ -62,12 +63,16 @@ typedef unsigned long size_t;
 #define KEYBOARD_STATUS_PORT    0x64
 #define KEYBOARD_SCANCODE_MAX   57
 
+// Пристрій isa-debug-exit у QEMU: код виходу = (status << 1) | 1
+#define QEMU_DEBUG_EXIT_PORT    0xF4
+
 // Коди помилок
 #define SUCCESS                 0
 #define ERROR_INVALID_INPUT     -1
 #define ERROR_BUFFER_OVERFLOW   -2
 #define ERROR_DIVISION_BY_ZERO  -3
 #define ERROR_INVALID_EXPRESSION -4
+#define ERROR_IO                -5
 
 // Математичні операції - результати
 typedef enum {
@@ -90,8 +95,12 @@ void terminal_setcolor(uint8_t color);
 void terminal_putchar(char c);
 void terminal_write(const char* data, size_t size);
 void terminal_writestring(const char* data);
+void terminal_writeuint(uint64_t value);
+void terminal_writeuint_width(uint64_t value, size_t width);
+void terminal_writetenths(uint64_t tenths);
+void terminal_writems(uint64_t ns, size_t width);
 void terminal_clear(void);
-void terminal_scroll(void);
+void terminal_set_serial_mirror(int enabled);
 uint8_t vga_entry_color(uint8_t fg, uint8_t bg);
 uint16_t vga_entry(unsigned char uc, uint8_t color);
 
@@ -106,19 +115,175 @@ static inline uint8_t inb(uint16_t port) {
     return ret;
 }
 
+static inline void outw(uint16_t port, uint16_t val) {
+    asm volatile ( "outw %0, %1" : : "a"(val), "Nd"(port) );
+}
+
+static inline uint16_t inw(uint16_t port) {
+    uint16_t ret;
+    asm volatile ( "inw %1, %0" : "=a"(ret) : "Nd"(port) );
+    return ret;
+}
+
+static inline void outl(uint16_t port, uint32_t val) {
+    asm volatile ( "outl %0, %1" : : "a"(val), "Nd"(port) );
+}
+
+static inline uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    asm volatile ( "inl %1, %0" : "=a"(ret) : "Nd"(port) );
+    return ret;
+}
+
+// Лічильник тактів процесора
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile ( "rdtsc" : "=a"(lo), "=d"(hi) );
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Збереження стану переривань для критичних секцій
+static inline unsigned long interrupts_save(void) {
+    unsigned long flags;
+    asm volatile ( "pushf; pop %0; cli" : "=r"(flags) : : "memory" );
+    return flags;
+}
+
+static inline void interrupts_restore(unsigned long flags) {
+    if (flags & 0x200) {
+        asm volatile ( "sti" : : : "memory" );
+    }
+}
+
+// Спін-блокування для даних, спільних між процесорами
+typedef struct {
+    volatile uint32_t locked;
+} spinlock_t;
+
+#define SPINLOCK_INIT { 0 }
+
+static inline void spin_lock(spinlock_t* lock) {
+    while (__sync_lock_test_and_set(&lock->locked, 1)) {
+        while (lock->locked) {
+            asm volatile ( "pause" );
+        }
+    }
+}
+
+static inline void spin_unlock(spinlock_t* lock) {
+    __sync_lock_release(&lock->locked);
+}
+
+static inline unsigned long spin_lock_irqsave(spinlock_t* lock) {
+    unsigned long flags = interrupts_save();
+    spin_lock(lock);
+    return flags;
+}
+
+static inline void spin_unlock_irqrestore(spinlock_t* lock, unsigned long flags) {
+    spin_unlock(lock);
+    interrupts_restore(flags);
+}
+
+// Ідентифікація процесора
+static inline void cpuid(uint32_t leaf, uint32_t* a, uint32_t* b, uint32_t* c, uint32_t* d) {
+    asm volatile ( "cpuid" : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d) : "a"(leaf), "c"(0) );
+}
+
+// Листи з підлистами (0xD - компоненти XSAVE)
+static inline void cpuid_count(uint32_t leaf, uint32_t subleaf, uint32_t* a, uint32_t* b, uint32_t* c, uint32_t* d) {
+    asm volatile ( "cpuid" : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d) : "a"(leaf), "c"(subleaf) );
+}
+
+// Model-specific регістри
+static inline uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    asm volatile ( "rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr) );
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t value) {
+    asm volatile ( "wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)) );
+}
+
+// Ділення 64-бітного числа на 32-бітне без libgcc (__udivdi3)
+static inline uint64_t div64_u32(uint64_t n, uint32_t d, uint32_t* rem) {
+#ifdef __x86_64__
+    if (rem) *rem = (uint32_t)(n % d);
+    return n / d;
+#else
+    uint32_t hi = (uint32_t)(n >> 32);
+    uint32_t lo = (uint32_t)n;
+    uint32_t q_hi = hi / d;
+    uint32_t q_lo, r;
+    hi %= d;
+    asm ( "divl %4" : "=a"(q_lo), "=d"(r) : "a"(lo), "d"(hi), "rm"(d) );
+    if (rem) *rem = r;
+    return ((uint64_t)q_hi << 32) | q_lo;
+#endif
+}
+
+// Архітектура збірки (make ARCH=...)
+#ifdef __x86_64__
+#define KERNEL_ARCH "x86_64"
+#else
+#define KERNEL_ARCH "i386"
+#endif
+
+#ifdef __x86_64__
+// Кадр стеку спільного входу irq_common у kernel64.asm: регістри загального
+// призначення, номер вектора, код помилки (0, якщо процесор його не клав), кадр
+// iretq - у long mode процесор завжди кладе RSP і SS
+typedef struct {
+    uint64_t r15, r14, r13, r12, r11, r10, r9, r8;
+    uint64_t rdi, rsi, rbp, rbx, rdx, rcx, rax;
+    uint64_t vector, error_code;
+    uint64_t rip, cs, rflags, rsp, ss;
+} irq_frame_t;
+
+#define IRQ_FRAME_IP(f)     ((uintptr_t)(f)->rip)
+#define IRQ_FRAME_FP(f)     ((uintptr_t)(f)->rbp)
+#define IRQ_FRAME_FLAGS(f)  ((uintptr_t)(f)->rflags)
+#define IRQ_FRAME_SP(f)     ((uintptr_t)(f)->rsp)
+#else
+// Кадр стеку спільного входу irq_common у kernel.asm: pushad, номер вектора,
+// код помилки (0, якщо процесор його не клав), кадр iret; user_esp/user_ss
+// процесор кладе лише при перериванні кільця 3
+typedef struct {
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax;
+    uint32_t vector, error_code;
+    uint32_t eip, cs, eflags;
+    uint32_t user_esp, user_ss;
+} irq_frame_t;
+
+// Без зміни кільця ESP/SS не кладуться - перерваний стек одразу за EFLAGS
+#define IRQ_FRAME_IP(f)     ((uintptr_t)(f)->eip)
+#define IRQ_FRAME_FP(f)     ((uintptr_t)(f)->ebp)
+#define IRQ_FRAME_FLAGS(f)  ((uintptr_t)(f)->eflags)
+#define IRQ_FRAME_SP(f)     (IRQ_FRAME_USER(f) ? (uintptr_t)(f)->user_esp : (uintptr_t)&(f)->eflags + 4)
+#endif
+
+// Перервано код кільця 3 (RPL селектора CS)
+#define IRQ_FRAME_USER(f)   (((f)->cs & 3) == 3)
+
+// Шлюзи переривань: лише з кільця 0 або й з кільця 3 (int 0x80)
+#define IDT_GATE_KERNEL     0x8E
+#define IDT_GATE_USER       0xEE
+
 // Функції IDT
 void idt_init(void);
-void idt_set_gate(uint8_t num, uint32_t base, uint16_t sel, uint8_t flags);
+void idt_load(void);
+void idt_set_gate(uint8_t num, uintptr_t base, uint16_t sel, uint8_t flags);
 
 // Функції переривань
-void pic_init(void);
-void keyboard_handler(void);
 void enable_interrupts(void);
 void disable_interrupts(void);
 
 // Функції shell
 void shell_initialize(void);
 void shell_run(void);
+int shell_at_prompt(void);
+void shell_redraw_prompt(void);
 void process_command(const char* command);
 void show_help(void);
 void show_logo(void);
@@ -134,15 +299,23 @@ math_calculation_t parse_math_expression_safe(const char* expr);
 // Системні функції
 void shutdown(void);
 void reboot(void);
+void kernel_panic(const char* message);
+void qemu_exit(uint8_t status);
 
-// Утилітарні функції
+// Утилітарні функції (mem*, strlen та strchr обираються за CPUID у string.c)
+void* memcpy(void* dest, const void* src, size_t n);
+void* memmove(void* dest, const void* src, size_t n);
+void* memset(void* dest, int c, size_t n);
+int memcmp(const void* a, const void* b, size_t n);
 size_t strlen(const char* str);
+char* strchr(const char* str, int c);
 int strcmp(const char* str1, const char* str2);
 int strncmp(const char* str1, const char* str2, size_t n);
 char* strcpy(char* dest, const char* src);
 char* strncpy(char* dest, const char* src, size_t n);
 int atoi(const char* str);
 void itoa(int value, char* str, int base);
+void uint64toa(uint64_t value, char* str, int base);
 int parse_math_expression(const char* expr);
 
 // Функції валідації
@@ -155,6 +328,5 @@ extern size_t input_index;
 extern size_t terminal_row;
 extern size_t terminal_column;
 extern uint8_t terminal_color;
-extern uint16_t* terminal_buffer;
 
 #endif 
\ No newline at end of file
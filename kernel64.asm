@@ -0,0 +1,536 @@
+; Ядро x86_64: GRUB передає керування в 32-бітному захищеному режимі,
+; _start будує таблиці сторінок, вмикає PAE/LME/PG і переходить у long mode
+section .multiboot_header
+header_start:
+    ; magic number
+    dd 0xe85250d6                ; multiboot2
+    ; architecture
+    dd 0                         ; protected mode i386 - точка входу 32-бітна
+    ; header length
+    dd header_end - header_start
+    ; checksum
+    dd 0x100000000 - (0xe85250d6 + 0 + (header_end - header_start))
+
+    ; framebuffer tag: лінійний буфер 1024x768x32; необов'язковий -
+    ; без нього (або з gfxpayload=text) лишається текстовий режим VGA
+    align 8, db 0
+    dw 5    ; type
+    dw 1    ; flags: optional
+    dd 20   ; size
+    dd 1024 ; width
+    dd 768  ; height
+    dd 32   ; depth
+
+    ; required end tag
+    align 8, db 0
+    dw 0    ; type
+    dw 0    ; flags
+    dd 8    ; size
+header_end:
+
+; Біти керуючих регістрів та EFER
+CR0_PE          equ 1 << 0
+CR0_MP          equ 1 << 1
+CR0_EM          equ 1 << 2
+CR0_ET          equ 1 << 4
+CR0_NE          equ 1 << 5
+CR0_WP          equ 1 << 16
+CR0_PG          equ 1 << 31
+CR4_PAE         equ 1 << 5
+CR4_OSFXSR      equ 1 << 9
+CR4_OSXMMEXCPT  equ 1 << 10
+MSR_EFER        equ 0xC0000080
+EFER_LME        equ 1 << 8
+
+; Запис таблиці: присутній, запис; PS - сторінка 2 МБ
+PAGE_PRESENT_RW equ 0x003
+PAGE_LARGE      equ 0x080
+
+section .bss
+; Початкове identity-відображення перших 4 ГБ сторінками по 2 МБ;
+; vmm_init потім будує власні таблиці
+align 4096
+boot_pml4:
+resb 4096
+boot_pdpt:
+resb 4096
+boot_pd:
+resb 4096 * 4
+
+align 16
+stack_bottom:
+resb 16384 ; 16 KB stack
+stack_top:
+
+section .text
+bits 32
+global _start
+extern kernel_main
+extern boot_stub_marker
+extern boot_stub_tsc
+extern boot_entry_tsc
+
+_start:
+    cli
+    ; Хронологія завантаження (boot.c): мітка stub в ECX, TSC входу stub
+    ; в EDX:ESI, потім власний TSC входу. EAX (магічне число) зберігаємо
+    mov [boot_stub_marker], ecx
+    mov [boot_stub_tsc], esi
+    mov [boot_stub_tsc + 4], edx
+    mov ecx, eax
+    rdtsc
+    mov [boot_entry_tsc], eax
+    mov [boot_entry_tsc + 4], edx
+    mov eax, ecx
+
+    mov esp, stack_top
+
+    ; Магічне число та адреса Multiboot2 - аргументи kernel_main за System V
+    mov edi, eax
+    mov esi, ebx
+
+    ; Без long mode 64-бітне ядро не запуститься - повідомляємо у VGA
+    mov eax, 0x80000000
+    cpuid
+    cmp eax, 0x80000001
+    jb .no_long_mode
+    mov eax, 0x80000001
+    cpuid
+    test edx, 1 << 29
+    jz .no_long_mode
+
+    ; PML4[0] -> PDPT, PDPT[0..3] -> чотири каталоги поспіль
+    mov eax, boot_pdpt
+    or eax, PAGE_PRESENT_RW
+    mov [boot_pml4], eax
+    xor ecx, ecx
+.fill_pdpt:
+    mov eax, ecx
+    shl eax, 12
+    add eax, boot_pd
+    or eax, PAGE_PRESENT_RW
+    mov [boot_pdpt + ecx * 8], eax
+    inc ecx
+    cmp ecx, 4
+    jne .fill_pdpt
+
+    ; 2048 записів по 2 МБ: фізична адреса = віртуальна
+    xor ecx, ecx
+.fill_pd:
+    mov eax, ecx
+    shl eax, 21
+    or eax, PAGE_PRESENT_RW | PAGE_LARGE
+    mov [boot_pd + ecx * 8], eax
+    inc ecx
+    cmp ecx, 2048
+    jne .fill_pd
+
+    mov eax, boot_pml4
+    mov cr3, eax
+
+    ; PAE обов'язковий для long mode; SSE дозволено з самого старту
+    mov eax, cr4
+    or eax, CR4_PAE | CR4_OSFXSR | CR4_OSXMMEXCPT
+    mov cr4, eax
+
+    mov ecx, MSR_EFER
+    rdmsr
+    or eax, EFER_LME
+    wrmsr
+
+    mov eax, cr0
+    and eax, ~CR0_EM
+    or eax, CR0_PG | CR0_MP
+    mov cr0, eax
+
+    ; Процесор у режимі сумісності, далеким переходом - у 64-бітний код
+    lgdt [boot_gdtr]
+    jmp 0x08:long_mode_start
+
+.no_long_mode:
+    mov esi, no_long_mode_message
+    mov edi, 0xB8000
+.print:
+    lodsb
+    test al, al
+    jz .hang
+    mov ah, 0x4F            ; білий на червоному
+    stosw
+    jmp .print
+.hang:
+    cli
+    hlt
+    jmp .hang
+
+bits 64
+long_mode_start:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+    mov rsp, stack_top
+
+    ; Очищуємо RFLAGS
+    push 0
+    popfq
+
+    ; Старші половини регістрів після переходу не визначені
+    mov edi, edi
+    mov esi, esi
+
+    ; Викликаємо головну функцію ядра
+    call kernel_main
+
+    ; Якщо kernel_main повертається, зупиняємо CPU
+    cli
+.hang:
+    hlt
+    jmp .hang
+
+; Функція для включення переривань
+global enable_interrupts
+enable_interrupts:
+    sti
+    ret
+
+; Функція для вимкнення переривань
+global disable_interrupts
+disable_interrupts:
+    cli
+    ret
+
+; Точки входу всіх 256 векторів: кадр однаковий для винятків і переривань.
+; Де процесор не кладе код помилки, заглушка кладе 0
+extern irq_dispatch
+%assign i 0
+%rep 256
+irq_stub_%[i]:
+%if !(i == 8 || (i >= 10 && i <= 14) || i == 17 || i == 21 || i == 29 || i == 30)
+    push 0
+%endif
+    push i
+    jmp irq_common
+%assign i i+1
+%endrep
+
+; Селектори GDT (cpu.h) та поля cpu_t, до яких вхід SYSCALL звертається через GS
+GDT_USER_DATA   equ 0x18
+GDT_USER_CODE   equ 0x20
+RPL_USER        equ 3
+CPU_SYSCALL_STACK   equ 8
+CPU_SYSCALL_USER_SP equ 16
+
+; Спільний пролог: усі регістри загального призначення, irq_dispatch(кадр)
+; зі стеком, вирівняним на 16; далі знімаємо вектор і код помилки.
+; З кільця 3 база GS належить користувачу - swapgs на вході й виході
+irq_common:
+    test byte [rsp + 24], RPL_USER      ; CS перерваного коду
+    jz .kernel_entry
+    swapgs
+.kernel_entry:
+    push rax
+    push rcx
+    push rdx
+    push rbx
+    push rbp
+    push rsi
+    push rdi
+    push r8
+    push r9
+    push r10
+    push r11
+    push r12
+    push r13
+    push r14
+    push r15
+    cld
+    mov rdi, rsp            ; Вказівник на irq_frame_t
+    mov rbx, rsp            ; RBX зберігає викликана функція
+    and rsp, -16
+    call irq_dispatch
+    mov rsp, rbx
+    pop r15
+    pop r14
+    pop r13
+    pop r12
+    pop r11
+    pop r10
+    pop r9
+    pop r8
+    pop rdi
+    pop rsi
+    pop rbp
+    pop rbx
+    pop rdx
+    pop rcx
+    pop rax
+    add rsp, 16
+    test byte [rsp + 8], RPL_USER
+    jz .kernel_exit
+    swapgs
+.kernel_exit:
+    iretq
+
+; Перший вхід задачі в кільце 3; arg - у RDI для _start
+; void enter_user(uintptr_t entry, uintptr_t user_sp, uintptr_t arg)
+global enter_user
+enter_user:
+    cli
+    push GDT_USER_DATA | RPL_USER       ; SS
+    push rsi                            ; RSP
+    push 0x202                          ; RFLAGS: IF
+    push GDT_USER_CODE | RPL_USER       ; CS
+    push rdi                            ; RIP
+    mov rdi, rdx
+    xor eax, eax
+    xor ebx, ebx
+    xor ecx, ecx
+    xor edx, edx
+    xor esi, esi
+    xor ebp, ebp
+    xor r8d, r8d
+    xor r9d, r9d
+    xor r10d, r10d
+    xor r11d, r11d
+    xor r12d, r12d
+    xor r13d, r13d
+    xor r14d, r14d
+    xor r15d, r15d
+    swapgs
+    iretq
+
+; Швидкий системний виклик: SYSCALL кладе RIP у RCX, RFLAGS у R11 і не міняє
+; стек - його бере з cpu_t через GS. Номер у RAX, аргументи в RDI, RSI, RDX;
+; FMASK скидає IF/DF/TF, переривання вмикаємо вже на стеку ядра
+extern syscall_fast
+global syscall_entry
+syscall_entry:
+    swapgs
+    mov [gs:CPU_SYSCALL_USER_SP], rsp
+    mov rsp, [gs:CPU_SYSCALL_STACK]
+    push qword [gs:CPU_SYSCALL_USER_SP]
+    push rcx
+    push r11
+    sti
+    mov rcx, rdx
+    mov rdx, rsi
+    mov rsi, rdi
+    mov rdi, rax
+    sub rsp, 8                          ; три push - вирівнюємо на 16
+    call syscall_fast                   ; (номер, a1, a2, a3)
+    add rsp, 8
+    cli
+    xor edi, edi                        ; значення ядра не витікають у кільце 3
+    xor esi, esi
+    xor edx, edx
+    xor r8d, r8d
+    xor r9d, r9d
+    xor r10d, r10d
+    pop r11
+    pop rcx
+    pop rsp
+    swapgs
+    o64 sysret
+
+; Перемикання контексту потоків ядра
+; void switch_context(uintptr_t* old_sp, uintptr_t new_sp)
+global switch_context
+switch_context:
+    ; Callee-saved регістри за System V
+    push rbp
+    push rbx
+    push r12
+    push r13
+    push r14
+    push r15
+
+    mov [rdi], rsp
+    mov rsp, rsi
+
+    pop r15
+    pop r14
+    pop r13
+    pop r12
+    pop rbx
+    pop rbp
+    ret
+
+; Функція для перезавантаження
+global reboot_system
+reboot_system:
+    ; Перезавантаження через клавіатурний контролер
+    mov al, 0xFE
+    out 0x64, al
+    ; Якщо не спрацювало - IDT нульової довжини і triple fault
+    lidt [invalid_idt]
+    int3
+    ret
+
+; Функція для вимкнення системи
+global shutdown_system
+shutdown_system:
+    ; Спробуємо ACPI shutdown
+    mov dx, 0x604  ; QEMU ACPI shutdown port
+    mov ax, 0x2000
+    out dx, ax
+
+    ; Якщо ACPI не працює, просто зупиняємо CPU
+    cli
+.loop:
+    hlt
+    jmp .loop
+
+; Завантаження IDT
+global load_idt
+load_idt:
+    lidt [rdi]              ; Адреса IDT descriptor - перший аргумент
+    ret
+
+; Код сторінки vDSO: syscall.c копіює його на VDSO_CODE (user/nexus.h) і
+; відображає кільцю 3 лише на читання. Точки входу на фіксованих зміщеннях,
+; дані vDSO - за 0x100 байт до коду, адресуються відносно RIP
+global vdso_start
+global vdso_end
+
+vdso_start:
+; +0x00: системний виклик найшвидшим шляхом ядра (RAX - номер, RDI/RSI/RDX)
+vdso_syscall:
+    syscall
+    ret
+    times 0x40 - ($ - vdso_start) db 0xCC
+
+; +0x40: той самий виклик через шлюз int 0x80
+vdso_int80:
+    int 0x80
+    ret
+    times 0x80 - ($ - vdso_start) db 0xCC
+
+; +0x80: uint64_t time_ns(void) без входу в ядро - TSC і множник з даних
+; vDSO: ns = ((tsc - tsc_base) * mult) >> shift, добуток 128-бітний
+vdso_time_ns:
+    rdtsc
+    shl rdx, 32
+    or rax, rdx
+    sub rax, [rel vdso_start - 0x100]   ; tsc_base
+    mov r8d, [rel vdso_start - 0x100 + 8]
+    mul r8                              ; mult
+    mov ecx, [rel vdso_start - 0x100 + 12]
+    shrd rax, rdx, cl                   ; shift < 32
+    ret
+vdso_end:
+
+; Трамплін запуску AP: копіюється на SMP_TRAMPOLINE_BASE, стартує в real mode
+; після SIPI, проходить захищений режим, вмикає long mode з таблицями BSP
+; та викликає ap_main(index)
+SMP_TRAMPOLINE_BASE equ 0x8000
+%define TRAMP(x) (SMP_TRAMPOLINE_BASE + (x) - trampoline_start)
+
+global trampoline_start
+global trampoline_end
+global trampoline_params
+
+bits 16
+trampoline_start:
+    cli
+    cld
+    xor ax, ax
+    mov ds, ax
+
+    ; Після INIT у CR0 стоять CD і NW (кеші вимкнено): повне значення
+    ; замість додавання бітів до наявного
+    lgdt [TRAMP(trampoline_gdtr)]
+    mov eax, CR0_PE | CR0_ET
+    mov cr0, eax
+    jmp dword 0x08:TRAMP(trampoline_protected)
+
+bits 32
+trampoline_protected:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    ; CR4 BSP (PAE, PGE, OSFXSR) до CR0.PG, CR3 - PML4 ядра
+    mov eax, [TRAMP(trampoline_params.cr4)]
+    mov cr4, eax
+    mov eax, [TRAMP(trampoline_params.cr3)]
+    mov cr3, eax
+
+    mov ecx, MSR_EFER
+    rdmsr
+    or eax, EFER_LME
+    wrmsr
+
+    mov eax, CR0_PE | CR0_ET | CR0_MP | CR0_NE | CR0_WP | CR0_PG
+    mov cr0, eax
+    jmp 0x18:TRAMP(trampoline_long)
+
+bits 64
+trampoline_long:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov ss, ax
+
+    ; Стек, індекс та точка входу лежать нижче 4 ГБ - 32-бітні завантаження
+    mov esp, [TRAMP(trampoline_params.stack)]
+    mov edi, [TRAMP(trampoline_params.index)]
+    mov eax, [TRAMP(trampoline_params.entry)]
+    call rax                ; ap_main не повертається
+
+    cli
+.hang:
+    hlt
+    jmp .hang
+
+align 8
+trampoline_gdt:
+    dq 0x0000000000000000
+    dq 0x00CF9A000000FFFF   ; 32-бітний код для переходу в захищений режим
+    dq 0x00CF92000000FFFF   ; дані ядра
+    dq 0x00AF9A000000FFFF   ; 64-бітний код
+trampoline_gdtr:
+    dw trampoline_gdtr - trampoline_gdt - 1
+    dd TRAMP(trampoline_gdt)
+
+; Заповнює smp_init (struct trampoline_params у smp.c)
+align 4
+trampoline_params:
+.cr3:   dd 0
+.cr4:   dd 0
+.stack: dd 0
+.entry: dd 0
+.index: dd 0
+trampoline_end:
+
+section .data
+; Адреси заглушок для idt_init
+global irq_stub_table
+irq_stub_table:
+%assign i 0
+%rep 256
+    dq irq_stub_%[i]
+%assign i i+1
+%endrep
+
+; GDT переходу в long mode; cpu_init замінює її власною на кожному процесорі
+align 8
+boot_gdt:
+    dq 0x0000000000000000
+    dq 0x00AF9A000000FFFF   ; 64-бітний код ядра
+    dq 0x00CF92000000FFFF   ; дані ядра
+boot_gdtr:
+    dw boot_gdtr - boot_gdt - 1
+    dq boot_gdt
+
+; IDT нульової довжини для triple fault
+invalid_idt:
+    dw 0
+    dq 0
+
+no_long_mode_message:
+    db "Nexus OS: processor has no long mode, boot nexus32.bin (make ARCH=i386)", 0
@@ -0,0 +1,215 @@
+#include "keyboard.h"
+#include "timer.h"
+#include "irq.h"
+
+// Кільце SPSC: head пише лише IRQ1, tail - лише споживач, тож замок не потрібен.
+// На x86 записи не переупорядковуються між собою, достатньо бар'єра компілятора.
+static uint8_t ring[KEYBOARD_RING_SIZE];
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+
+static thread_t* consumer = NULL;
+
+// Стан декодера (лише контекст споживача)
+static int extended = false;
+static uint8_t modifiers = 0;
+static uint32_t keys_down[8];       // 256 кодів клавіш
+
+// Статистика
+static uint64_t isr_count = 0;
+static uint64_t isr_max_cycles = 0;
+static uint64_t isr_total_cycles = 0;
+static uint64_t dropped_events = 0;
+static uint32_t ring_high_water = 0;
+static uint64_t events_decoded = 0;
+static uint64_t repeats_seen = 0;
+
+#define barrier() asm volatile("" : : : "memory")
+
+static const char keymap[128] = {
+    0, 27, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
+    '\t', 'q', 'w', 'e', 'r', 't', 'y', 'u', 'i', 'o', 'p', '[', ']', '\n',
+    0, 'a', 's', 'd', 'f', 'g', 'h', 'j', 'k', 'l', ';', '\'', '`',
+    0, '\\', 'z', 'x', 'c', 'v', 'b', 'n', 'm', ',', '.', '/', 0,
+    '*', 0, ' '
+};
+
+static const char keymap_shift[128] = {
+    0, 27, '!', '@', '#', '$', '%', '^', '&', '*', '(', ')', '_', '+', '\b',
+    '\t', 'Q', 'W', 'E', 'R', 'T', 'Y', 'U', 'I', 'O', 'P', '{', '}', '\n',
+    0, 'A', 'S', 'D', 'F', 'G', 'H', 'J', 'K', 'L', ':', '"', '~',
+    0, '|', 'Z', 'X', 'C', 'V', 'B', 'N', 'M', '<', '>', '?', 0,
+    '*', 0, ' '
+};
+
+void keyboard_init(void) {
+    // Скидаємо те, що контролер накопичив до ремапінгу PIC
+    while (inb(KEYBOARD_STATUS_PORT) & 0x01) {
+        inb(KEYBOARD_DATA_PORT);
+    }
+    irq_install(IRQ_KEYBOARD, "keyboard", keyboard_handler, 0);
+}
+
+void keyboard_set_consumer(thread_t* thread) {
+    consumer = thread;
+}
+
+// === ОБРОБНИК IRQ1 ===
+
+// Лише зчитування порту та запис у кільце - вся логіка поза перериванням
+void keyboard_handler(irq_frame_t* frame) {
+    (void)frame;
+    uint64_t start = rdtsc();
+    uint8_t scancode = inb(KEYBOARD_DATA_PORT);
+
+    uint32_t head = ring_head;
+    uint32_t used = head - ring_tail;
+    if (used < KEYBOARD_RING_SIZE) {
+        ring[head & (KEYBOARD_RING_SIZE - 1)] = scancode;
+        barrier();
+        ring_head = head + 1;
+        if (used + 1 > ring_high_water) {
+            ring_high_water = used + 1;
+        }
+        sched_wakeup(consumer);
+    } else {
+        dropped_events++;
+    }
+
+    uint64_t cycles = rdtsc() - start;
+    isr_count++;
+    isr_total_cycles += cycles;
+    if (cycles > isr_max_cycles) {
+        isr_max_cycles = cycles;
+    }
+}
+
+// === ДЕКОДЕР ===
+
+static int ring_pop(uint8_t* scancode) {
+    uint32_t tail = ring_tail;
+    if (tail == ring_head) {
+        return false;
+    }
+    barrier();
+    *scancode = ring[tail & (KEYBOARD_RING_SIZE - 1)];
+    barrier();
+    ring_tail = tail + 1;
+    return true;
+}
+
+static uint8_t modifier_for(uint8_t key) {
+    switch (key) {
+        case KEY_LSHIFT:
+        case KEY_RSHIFT:
+            return KEY_MOD_SHIFT;
+        case KEY_LCTRL:
+        case KEY_RCTRL:
+            return KEY_MOD_CTRL;
+        case KEY_LALT:
+        case KEY_RALT:
+            return KEY_MOD_ALT;
+        default:
+            return 0;
+    }
+}
+
+static char translate(uint8_t key) {
+    if (key >= 128) {
+        return key == KEY_KP_ENTER ? '\n' : 0;
+    }
+    char c = (modifiers & KEY_MOD_SHIFT) ? keymap_shift[key] : keymap[key];
+    // Caps Lock інвертує регістр лише для літер
+    if ((modifiers & KEY_MOD_CAPS) && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) {
+        c ^= 0x20;
+    }
+    if ((modifiers & KEY_MOD_CTRL) && c >= 'a' - 0x20 && c <= 'z') {
+        c &= 0x1F;
+    }
+    return c;
+}
+
+int keyboard_read_event(key_event_t* event) {
+    uint8_t scancode;
+    while (ring_pop(&scancode)) {
+        if (scancode == SCANCODE_EXTENDED) {
+            extended = true;
+            continue;
+        }
+
+        uint8_t key = (scancode & ~SCANCODE_RELEASE) | (extended ? 0x80 : 0);
+        int released = (scancode & SCANCODE_RELEASE) != 0;
+        extended = false;
+
+        // Фальшиві shift навколо розширених кодів (0xE0 0x2A / 0xE0 0xAA)
+        if (key == (0x80 | KEY_LSHIFT) || key == (0x80 | KEY_RSHIFT)) {
+            continue;
+        }
+
+        uint32_t bit = 1u << (key & 31);
+        int was_down = (keys_down[key >> 5] & bit) != 0;
+        uint8_t modifier = modifier_for(key);
+
+        event->key = key;
+        event->flags = 0;
+        if (released) {
+            keys_down[key >> 5] &= ~bit;
+            modifiers &= ~modifier;
+            event->flags |= KEY_EVENT_RELEASE;
+        } else {
+            keys_down[key >> 5] |= bit;
+            modifiers |= modifier;
+            // Typematic повторює make-код без break - це автоповтор
+            if (was_down) {
+                event->flags |= KEY_EVENT_REPEAT;
+                repeats_seen++;
+            } else if (key == KEY_CAPSLOCK) {
+                modifiers ^= KEY_MOD_CAPS;
+            }
+        }
+        event->modifiers = modifiers;
+        event->ascii = released ? 0 : translate(key);
+        events_decoded++;
+        return true;
+    }
+    return false;
+}
+
+void keyboard_wait_event(key_event_t* event) {
+    while (1) {
+        unsigned long flags = interrupts_save();
+        if (keyboard_read_event(event)) {
+            interrupts_restore(flags);
+            return;
+        }
+        // Перевірка і блокування з вимкненими перериваннями - пробудження не загубиться
+        sched_block();
+        interrupts_restore(flags);
+    }
+}
+
+// === СТАТИСТИКА ===
+
+void keyboard_print_stats(void) {
+    terminal_writestring("Переривань IRQ1:   ");
+    terminal_writeuint(isr_count);
+    terminal_writestring("\nПодій розібрано:   ");
+    terminal_writeuint(events_decoded);
+    terminal_writestring(" (автоповторів: ");
+    terminal_writeuint(repeats_seen);
+    terminal_writestring(")\nВтрачено подій:    ");
+    terminal_writeuint(dropped_events);
+    terminal_writestring("\nЗаповнення кільця: макс. ");
+    terminal_writeuint(ring_high_water);
+    terminal_writestring(" з ");
+    terminal_writeuint(KEYBOARD_RING_SIZE);
+    terminal_writestring("\nISR, тактів:       макс. ");
+    terminal_writeuint(isr_max_cycles);
+    if (isr_count) {
+        terminal_writestring(", сер. ");
+        terminal_writeuint(div64_u32(isr_total_cycles, (uint32_t)isr_count, NULL));
+    }
+    terminal_writestring(" (макс. ");
+    terminal_writeuint(tsc_cycles_to_ns(isr_max_cycles));
+    terminal_writestring(" нс)\n");
+}
@@ -0,0 +1,68 @@
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+#include "kernel.h"
+#include "sched.h"
+
+// Кільце скан-кодів між IRQ1 і потоком-споживачем (степінь двійки)
+#define KEYBOARD_RING_SIZE      256
+
+// Скан-коди set 1 з особливою обробкою
+#define SCANCODE_EXTENDED       0xE0
+#define SCANCODE_RELEASE        0x80
+
+// Коди клавіш: скан-код без біта відпускання, розширені - з бітом 0x80
+#define KEY_ESCAPE              0x01
+#define KEY_BACKSPACE           0x0E
+#define KEY_TAB                 0x0F
+#define KEY_ENTER               0x1C
+#define KEY_LCTRL               0x1D
+#define KEY_LSHIFT              0x2A
+#define KEY_RSHIFT              0x36
+#define KEY_LALT                0x38
+#define KEY_CAPSLOCK            0x3A
+#define KEY_KP_ENTER            (0x80 | 0x1C)
+#define KEY_RCTRL               (0x80 | 0x1D)
+#define KEY_RALT                (0x80 | 0x38)
+#define KEY_HOME                (0x80 | 0x47)
+#define KEY_UP                  (0x80 | 0x48)
+#define KEY_PAGE_UP             (0x80 | 0x49)
+#define KEY_LEFT                (0x80 | 0x4B)
+#define KEY_RIGHT               (0x80 | 0x4D)
+#define KEY_END                 (0x80 | 0x4F)
+#define KEY_DOWN                (0x80 | 0x50)
+#define KEY_PAGE_DOWN           (0x80 | 0x51)
+#define KEY_DELETE              (0x80 | 0x53)
+
+// Стан модифікаторів
+#define KEY_MOD_SHIFT           0x01
+#define KEY_MOD_CTRL            0x02
+#define KEY_MOD_ALT             0x04
+#define KEY_MOD_CAPS            0x08
+
+// Прапори події
+#define KEY_EVENT_RELEASE       0x01
+#define KEY_EVENT_REPEAT        0x02    // автоповтор утримуваної клавіші
+
+typedef struct {
+    uint8_t key;
+    uint8_t flags;
+    uint8_t modifiers;
+    char ascii;                 // 0 для клавіш без символу
+} key_event_t;
+
+// Ініціалізація та потік, який будить IRQ1
+void keyboard_init(void);
+void keyboard_set_consumer(thread_t* thread);
+
+// Розбір кільця поза перериванням
+int keyboard_read_event(key_event_t* event);
+void keyboard_wait_event(key_event_t* event);
+
+// Обробник IRQ1 (irq_dispatch)
+void keyboard_handler(irq_frame_t* frame);
+
+// Статистика
+void keyboard_print_stats(void);
+
+#endif
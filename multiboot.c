@@ -0,0 +1,104 @@
+#include "multiboot.h"
+
+// Адреса та розмір інформаційної структури від завантажувача
+static uintptr_t mbi_addr = 0;
+static uint32_t mbi_size = 0;
+
+int multiboot_init(uint32_t magic, uint32_t info_addr) {
+    if (magic != MULTIBOOT2_BOOTLOADER_MAGIC || info_addr == 0) {
+        mbi_addr = 0;
+        mbi_size = 0;
+        return ERROR_INVALID_INPUT;
+    }
+    
+    // Перше слово структури - її загальний розмір
+    mbi_addr = info_addr;
+    mbi_size = *(uint32_t*)mbi_addr;
+    return SUCCESS;
+}
+
+struct multiboot_tag* multiboot_next_tag(struct multiboot_tag* previous, uint32_t type) {
+    if (mbi_addr == 0) {
+        return NULL;
+    }
+    
+    // Теги йдуть одразу після 8-байтного заголовка, кожен вирівняний на 8
+    uintptr_t ptr = mbi_addr + 8;
+    uintptr_t end = mbi_addr + mbi_size;
+    if (previous) {
+        ptr = (uintptr_t)previous + ((previous->size + 7) & ~7u);
+    }
+    
+    while (ptr + sizeof(struct multiboot_tag) <= end) {
+        struct multiboot_tag* tag = (struct multiboot_tag*)ptr;
+        if (tag->type == MULTIBOOT_TAG_TYPE_END) {
+            break;
+        }
+        if (tag->type == type) {
+            return tag;
+        }
+        ptr += (tag->size + 7) & ~7u;
+    }
+    
+    return NULL;
+}
+
+struct multiboot_tag* multiboot_find_tag(uint32_t type) {
+    return multiboot_next_tag(NULL, type);
+}
+
+uintptr_t multiboot_info_start(void) {
+    return mbi_addr;
+}
+
+uintptr_t multiboot_info_end(void) {
+    return mbi_addr + mbi_size;
+}
+
+const char* multiboot_cmdline(void) {
+    struct multiboot_tag_string* tag = (struct multiboot_tag_string*)multiboot_find_tag(MULTIBOOT_TAG_TYPE_CMDLINE);
+    return tag ? tag->string : "";
+}
+
+// Параметри розділені пробілами; шукаємо точний збіг слова
+int multiboot_cmdline_has(const char* option) {
+    const char* p = multiboot_cmdline();
+    size_t len = strlen(option);
+    while (*p) {
+        while (*p == ' ') {
+            p++;
+        }
+        if (strncmp(p, option, len) == 0 && (p[len] == ' ' || p[len] == '\0')) {
+            return true;
+        }
+        while (*p && *p != ' ') {
+            p++;
+        }
+    }
+    return false;
+}
+
+// Параметр "option=значення": копіює значення в buffer, false - немає такого
+int multiboot_cmdline_value(const char* option, char* buffer, size_t size) {
+    const char* p = multiboot_cmdline();
+    size_t len = strlen(option);
+    while (*p) {
+        while (*p == ' ') {
+            p++;
+        }
+        if (strncmp(p, option, len) == 0 && p[len] == '=') {
+            p += len + 1;
+            size_t i = 0;
+            while (p[i] && p[i] != ' ' && i + 1 < size) {
+                buffer[i] = p[i];
+                i++;
+            }
+            buffer[i] = '\0';
+            return true;
+        }
+        while (*p && *p != ' ') {
+            p++;
+        }
+    }
+    return false;
+}
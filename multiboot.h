@@ -0,0 +1,99 @@
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+
+#include "kernel.h"
+
+// Магічне значення, яке завантажувач передає в EAX
+#define MULTIBOOT2_BOOTLOADER_MAGIC 0x36d76289
+
+// Типи тегів інформаційної структури Multiboot2
+#define MULTIBOOT_TAG_TYPE_END              0
+#define MULTIBOOT_TAG_TYPE_CMDLINE          1
+#define MULTIBOOT_TAG_TYPE_BOOT_LOADER_NAME 2
+#define MULTIBOOT_TAG_TYPE_MODULE           3
+#define MULTIBOOT_TAG_TYPE_BASIC_MEMINFO    4
+#define MULTIBOOT_TAG_TYPE_MMAP             6
+#define MULTIBOOT_TAG_TYPE_FRAMEBUFFER      8
+#define MULTIBOOT_TAG_TYPE_ACPI_OLD         14
+#define MULTIBOOT_TAG_TYPE_ACPI_NEW         15
+
+// Типи регіонів карти пам'яті
+#define MULTIBOOT_MEMORY_AVAILABLE          1
+#define MULTIBOOT_MEMORY_RESERVED           2
+#define MULTIBOOT_MEMORY_ACPI_RECLAIMABLE   3
+#define MULTIBOOT_MEMORY_NVS                4
+#define MULTIBOOT_MEMORY_BADRAM             5
+
+struct multiboot_tag {
+    uint32_t type;
+    uint32_t size;
+} __attribute__((packed));
+
+struct multiboot_tag_string {
+    uint32_t type;
+    uint32_t size;
+    char string[];
+} __attribute__((packed));
+
+struct multiboot_mmap_entry {
+    uint64_t addr;
+    uint64_t len;
+    uint32_t type;
+    uint32_t zero;
+} __attribute__((packed));
+
+struct multiboot_tag_mmap {
+    uint32_t type;
+    uint32_t size;
+    uint32_t entry_size;
+    uint32_t entry_version;
+    struct multiboot_mmap_entry entries[];
+} __attribute__((packed));
+
+// Модуль, завантажений GRUB (module2): фізичні межі та рядок параметрів
+struct multiboot_tag_module {
+    uint32_t type;
+    uint32_t size;
+    uint32_t mod_start;
+    uint32_t mod_end;
+    char cmdline[];
+} __attribute__((packed));
+
+// Типи буфера кадрів у тезі FRAMEBUFFER
+#define MULTIBOOT_FRAMEBUFFER_TYPE_INDEXED  0
+#define MULTIBOOT_FRAMEBUFFER_TYPE_RGB      1
+#define MULTIBOOT_FRAMEBUFFER_TYPE_EGA_TEXT 2
+
+struct multiboot_tag_framebuffer {
+    uint32_t type;
+    uint32_t size;
+    uint64_t framebuffer_addr;
+    uint32_t framebuffer_pitch;
+    uint32_t framebuffer_width;
+    uint32_t framebuffer_height;
+    uint8_t framebuffer_bpp;
+    uint8_t framebuffer_type;
+    uint16_t reserved;
+    // Лише для TYPE_RGB: положення та ширина полів кольору в пікселі
+    uint8_t red_field_position;
+    uint8_t red_mask_size;
+    uint8_t green_field_position;
+    uint8_t green_mask_size;
+    uint8_t blue_field_position;
+    uint8_t blue_mask_size;
+} __attribute__((packed));
+
+// Функції Multiboot2
+int multiboot_init(uint32_t magic, uint32_t info_addr);
+struct multiboot_tag* multiboot_find_tag(uint32_t type);
+// Наступний тег типу type після previous (NULL - з початку): модулів кілька
+struct multiboot_tag* multiboot_next_tag(struct multiboot_tag* previous, uint32_t type);
+uintptr_t multiboot_info_start(void);
+uintptr_t multiboot_info_end(void);
+
+// Командний рядок ядра (параметри після імені файлу в GRUB)
+const char* multiboot_cmdline(void);
+int multiboot_cmdline_has(const char* option);
+int multiboot_cmdline_value(const char* option, char* buffer, size_t size);
+
+#endif
@@ -0,0 +1,695 @@
+#include "net.h"
+#include "nic.h"
+#include "multiboot.h"
+#include "sched.h"
+#include "timer.h"
+#include "string.h"
+
+typedef struct {
+    uint32_t ip;
+    uint8_t mac[6];
+    int valid;
+} arp_entry_t;
+
+static int present = false;
+static uint32_t local_ip = NET_DEFAULT_IP;
+static uint32_t gateway = 0;
+static uint32_t netmask = NET_DEFAULT_NETMASK;
+static uint8_t local_mac[6];
+static uint16_t ip_id = 0;
+
+static arp_entry_t arp_table[NET_ARP_ENTRIES];
+static uint32_t arp_next = 0;
+static spinlock_t arp_lock = SPINLOCK_INIT;
+
+static uint16_t udp_ports[NET_UDP_PORTS];
+static net_udp_handler_t udp_handlers[NET_UDP_PORTS];
+
+static const uint8_t broadcast_mac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+// Статистика
+static uint64_t arp_received = 0;
+static uint64_t arp_requests_sent = 0;
+static uint64_t arp_replies_sent = 0;
+static uint64_t ip_received = 0;
+static uint64_t udp_received = 0;
+static uint64_t udp_sent = 0;
+static uint64_t echo_replies = 0;
+static uint64_t drop_malformed = 0;
+static uint64_t drop_checksum = 0;
+static uint64_t drop_not_local = 0;
+static uint64_t drop_no_port = 0;
+static uint64_t drop_no_route = 0;
+static uint64_t drop_no_buffer = 0;
+
+// === КОНТРОЛЬНА СУМА ===
+
+static uint32_t checksum_add(uint32_t sum, const void* data, uint32_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    while (length > 1) {
+        sum += (uint32_t)(bytes[0] << 8 | bytes[1]);
+        bytes += 2;
+        length -= 2;
+    }
+    if (length) {
+        sum += (uint32_t)bytes[0] << 8;
+    }
+    return sum;
+}
+
+static uint16_t checksum_fold(uint32_t sum) {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)sum;
+}
+
+static uint32_t pseudo_header_sum(uint32_t src, uint32_t dst, uint16_t length) {
+    return (src >> 16) + (src & 0xFFFF) + (dst >> 16) + (dst & 0xFFFF) + NET_PROTO_UDP + length;
+}
+
+// === ARP ===
+
+static int arp_lookup(uint32_t ip, uint8_t mac[6]) {
+    int found = false;
+    unsigned long flags = spin_lock_irqsave(&arp_lock);
+    for (uint32_t i = 0; i < NET_ARP_ENTRIES; i++) {
+        if (arp_table[i].valid && arp_table[i].ip == ip) {
+            memcpy(mac, arp_table[i].mac, 6);
+            found = true;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&arp_lock, flags);
+    return found;
+}
+
+static void arp_learn(uint32_t ip, const uint8_t mac[6]) {
+    unsigned long flags = spin_lock_irqsave(&arp_lock);
+    arp_entry_t* entry = NULL;
+    for (uint32_t i = 0; i < NET_ARP_ENTRIES; i++) {
+        if (arp_table[i].valid && arp_table[i].ip == ip) {
+            entry = &arp_table[i];
+            break;
+        }
+    }
+    // Нова адреса заміщує записи по колу
+    if (!entry) {
+        entry = &arp_table[arp_next];
+        arp_next = (arp_next + 1) % NET_ARP_ENTRIES;
+    }
+    entry->ip = ip;
+    memcpy(entry->mac, mac, 6);
+    entry->valid = true;
+    spin_unlock_irqrestore(&arp_lock, flags);
+}
+
+static int arp_send(uint16_t oper, const uint8_t dst_mac[6], uint32_t target_ip) {
+    uint8_t* frame = nic_tx_buffer();
+    if (!frame) {
+        drop_no_buffer++;
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    eth_header_t* eth = (eth_header_t*)frame;
+    arp_packet_t* arp = (arp_packet_t*)(frame + NET_ETH_HEADER_SIZE);
+    memcpy(eth->dst, dst_mac, 6);
+    memcpy(eth->src, local_mac, 6);
+    eth->type = htons(NET_ETHERTYPE_ARP);
+    arp->htype = htons(1);
+    arp->ptype = htons(NET_ETHERTYPE_IPV4);
+    arp->hlen = 6;
+    arp->plen = 4;
+    arp->oper = htons(oper);
+    memcpy(arp->sha, local_mac, 6);
+    arp->spa = htonl(local_ip);
+    memcpy(arp->tha, oper == 1 ? (const uint8_t*)"\0\0\0\0\0\0" : dst_mac, 6);
+    arp->tpa = htonl(target_ip);
+    nic_tx_queue(frame, NET_ETH_HEADER_SIZE + sizeof(arp_packet_t), 0, 0);
+    return SUCCESS;
+}
+
+static void arp_receive(const uint8_t* data, uint32_t length) {
+    const arp_packet_t* arp = (const arp_packet_t*)data;
+    if (length < sizeof(arp_packet_t) || ntohs(arp->htype) != 1 || ntohs(arp->ptype) != NET_ETHERTYPE_IPV4 ||
+        arp->hlen != 6 || arp->plen != 4) {
+        drop_malformed++;
+        return;
+    }
+    arp_received++;
+    if (ntohl(arp->tpa) != local_ip) {
+        return;
+    }
+    uint32_t sender = ntohl(arp->spa);
+    arp_learn(sender, arp->sha);
+    if (ntohs(arp->oper) == 1 && arp_send(2, arp->sha, sender) == SUCCESS) {
+        arp_replies_sent++;
+    }
+}
+
+int net_arp_resolve(uint32_t ip, uint8_t mac[6]) {
+    if (!present) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint64_t start = time_now_ns();
+    uint64_t deadline = start + NET_ARP_TIMEOUT_MS * 1000000ull;
+    uint64_t next_request = start;
+    while (!arp_lookup(ip, mac)) {
+        uint64_t now = time_now_ns();
+        if (now >= deadline) {
+            return ERROR_IO;
+        }
+        // Повтор запиту кожні 200 мс; відповідь обробить потік прийому
+        if (now >= next_request) {
+            if (arp_send(1, broadcast_mac, ip) == SUCCESS) {
+                arp_requests_sent++;
+            }
+            nic_tx_flush();
+            next_request = now + 200000000ull;
+        }
+        if (nic_polling()) {
+            net_poll();
+        } else {
+            sched_sleep_ns(1000000ull);
+        }
+    }
+    return SUCCESS;
+}
+
+// === IPv4 ТА UDP ===
+
+static void udp_receive(uint32_t src_ip, uint32_t dst_ip, const uint8_t* data, uint32_t length, int csum_valid) {
+    const udp_header_t* udp = (const udp_header_t*)data;
+    uint16_t udp_length = length >= NET_UDP_HEADER_SIZE ? ntohs(udp->length) : 0;
+    if (udp_length < NET_UDP_HEADER_SIZE || udp_length > length) {
+        drop_malformed++;
+        return;
+    }
+    // Нульова сума - відправник її не рахував
+    if (!csum_valid && udp->checksum != 0) {
+        uint32_t sum = pseudo_header_sum(src_ip, dst_ip, udp_length);
+        if (checksum_fold(checksum_add(sum, data, udp_length)) != 0xFFFF) {
+            drop_checksum++;
+            return;
+        }
+    }
+    udp_received++;
+
+    uint16_t port = ntohs(udp->dst_port);
+    for (uint32_t i = 0; i < NET_UDP_PORTS; i++) {
+        if (udp_handlers[i] && udp_ports[i] == port) {
+            net_udp_packet_t packet;
+            packet.src_ip = src_ip;
+            packet.src_port = ntohs(udp->src_port);
+            packet.dst_port = port;
+            packet.data = data + NET_UDP_HEADER_SIZE;
+            packet.length = udp_length - NET_UDP_HEADER_SIZE;
+            udp_handlers[i](&packet);
+            return;
+        }
+    }
+    drop_no_port++;
+}
+
+static void ip_receive(const eth_header_t* eth, const uint8_t* data, uint32_t length, int csum_valid) {
+    const ipv4_header_t* ip = (const ipv4_header_t*)data;
+    uint32_t header_length = length >= NET_IP_HEADER_SIZE ? (uint32_t)(ip->version_ihl & 0x0F) * 4 : 0;
+    uint32_t total = header_length ? ntohs(ip->total_length) : 0;
+    if ((ip->version_ihl >> 4) != 4 || header_length < NET_IP_HEADER_SIZE || total < header_length || total > length) {
+        drop_malformed++;
+        return;
+    }
+    if (checksum_fold(checksum_add(0, data, header_length)) != 0xFFFF) {
+        drop_checksum++;
+        return;
+    }
+    uint32_t src = ntohl(ip->src);
+    uint32_t dst = ntohl(ip->dst);
+    if (dst != local_ip && dst != 0xFFFFFFFF && dst != (local_ip | ~netmask)) {
+        drop_not_local++;
+        return;
+    }
+    // Фрагменти не збираються
+    if (ntohs(ip->fragment) & 0x3FFF) {
+        drop_malformed++;
+        return;
+    }
+    ip_received++;
+
+    // Сусід з тієї ж мережі: відповідь піде без ARP-запиту
+    if ((src & netmask) == (local_ip & netmask)) {
+        arp_learn(src, eth->src);
+    }
+    if (ip->protocol == NET_PROTO_UDP) {
+        udp_receive(src, dst, data + header_length, total - header_length, csum_valid);
+    }
+}
+
+static void net_receive(uint8_t* frame, uint32_t length, int csum_valid) {
+    if (length < NET_ETH_HEADER_SIZE) {
+        drop_malformed++;
+        return;
+    }
+    const eth_header_t* eth = (const eth_header_t*)frame;
+    uint16_t type = ntohs(eth->type);
+    if (type == NET_ETHERTYPE_ARP) {
+        arp_receive(frame + NET_ETH_HEADER_SIZE, length - NET_ETH_HEADER_SIZE);
+    } else if (type == NET_ETHERTYPE_IPV4) {
+        ip_receive(eth, frame + NET_ETH_HEADER_SIZE, length - NET_ETH_HEADER_SIZE, csum_valid);
+    }
+}
+
+int net_udp_queue(uint32_t dst_ip, uint16_t src_port, uint16_t dst_port, const void* data, uint32_t length) {
+    if (!present || length > NET_UDP_PAYLOAD_MAX) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint8_t dst_mac[6];
+    uint32_t next_hop = (dst_ip & netmask) == (local_ip & netmask) ? dst_ip : gateway;
+    if (dst_ip == 0xFFFFFFFF || dst_ip == (local_ip | ~netmask)) {
+        memcpy(dst_mac, broadcast_mac, 6);
+    } else if (!next_hop || !arp_lookup(next_hop, dst_mac)) {
+        drop_no_route++;
+        return ERROR_INVALID_INPUT;
+    }
+    uint8_t* frame = nic_tx_buffer();
+    if (!frame) {
+        drop_no_buffer++;
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    eth_header_t* eth = (eth_header_t*)frame;
+    ipv4_header_t* ip = (ipv4_header_t*)(frame + NET_ETH_HEADER_SIZE);
+    udp_header_t* udp = (udp_header_t*)(frame + NET_ETH_HEADER_SIZE + NET_IP_HEADER_SIZE);
+    uint16_t udp_length = (uint16_t)(NET_UDP_HEADER_SIZE + length);
+    memcpy(eth->dst, dst_mac, 6);
+    memcpy(eth->src, local_mac, 6);
+    eth->type = htons(NET_ETHERTYPE_IPV4);
+
+    ip->version_ihl = 0x45;
+    ip->tos = 0;
+    ip->total_length = htons((uint16_t)(NET_IP_HEADER_SIZE + udp_length));
+    ip->id = htons(ip_id++);
+    ip->fragment = 0;
+    ip->ttl = NET_TTL;
+    ip->protocol = NET_PROTO_UDP;
+    ip->checksum = 0;
+    ip->src = htonl(local_ip);
+    ip->dst = htonl(dst_ip);
+    ip->checksum = htons((uint16_t)~checksum_fold(checksum_add(0, ip, NET_IP_HEADER_SIZE)));
+
+    udp->src_port = htons(src_port);
+    udp->dst_port = htons(dst_port);
+    udp->length = htons(udp_length);
+    memcpy(udp + 1, data, length);
+
+    // З делегуванням у полі суми лише псевдозаголовок, решту дорахує пристрій
+    uint32_t sum = pseudo_header_sum(local_ip, dst_ip, udp_length);
+    uint32_t frame_length = NET_ETH_HEADER_SIZE + NET_IP_HEADER_SIZE + udp_length;
+    if (nic_tx_csum_offload()) {
+        udp->checksum = htons(checksum_fold(sum));
+        nic_tx_queue(frame, frame_length, NET_ETH_HEADER_SIZE + NET_IP_HEADER_SIZE, 6);
+    } else {
+        udp->checksum = 0;
+        uint16_t checksum = (uint16_t)~checksum_fold(checksum_add(sum, udp, udp_length));
+        udp->checksum = htons(checksum ? checksum : 0xFFFF);
+        nic_tx_queue(frame, frame_length, 0, 0);
+    }
+    udp_sent++;
+    return SUCCESS;
+}
+
+int net_udp_send(uint32_t dst_ip, uint16_t src_port, uint16_t dst_port, const void* data, uint32_t length) {
+    uint8_t mac[6];
+    uint32_t next_hop = (dst_ip & netmask) == (local_ip & netmask) ? dst_ip : gateway;
+    if (next_hop && dst_ip != 0xFFFFFFFF) {
+        net_arp_resolve(next_hop, mac);
+    }
+    int result = net_udp_queue(dst_ip, src_port, dst_port, data, length);
+    nic_tx_flush();
+    return result;
+}
+
+int net_udp_bind(uint16_t port, net_udp_handler_t handler) {
+    int free_slot = -1;
+    for (uint32_t i = 0; i < NET_UDP_PORTS; i++) {
+        if (udp_handlers[i] && udp_ports[i] == port) {
+            udp_handlers[i] = handler;
+            return SUCCESS;
+        }
+        if (!udp_handlers[i] && free_slot < 0) {
+            free_slot = (int)i;
+        }
+    }
+    if (!handler) {
+        return SUCCESS;
+    }
+    if (free_slot < 0) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    udp_ports[free_slot] = port;
+    udp_handlers[free_slot] = handler;
+    return SUCCESS;
+}
+
+// Відповіді збираються в чергу передачі й ідуть одним пакетом після проходу.
+// Датаграми з порту відлуння не повертаються: два сервіси не зациклюються
+static void echo_handler(const net_udp_packet_t* packet) {
+    if (packet->src_port == NET_ECHO_PORT) {
+        return;
+    }
+    if (net_udp_queue(packet->src_ip, packet->dst_port, packet->src_port, packet->data, packet->length) == SUCCESS) {
+        echo_replies++;
+    }
+}
+
+uint32_t net_poll(void) {
+    uint32_t count = nic_poll(NIC_POLL_BUDGET);
+    nic_tx_flush();
+    return count;
+}
+
+static void rx_thread(void* arg) {
+    (void)arg;
+    for (;;) {
+        if (!net_poll()) {
+            nic_wait();
+        }
+    }
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+uint32_t net_parse_ip(const char* text, const char** end) {
+    uint32_t ip = 0;
+    for (uint32_t part = 0; part < 4; part++) {
+        if (part && *text++ != '.') {
+            return 0;
+        }
+        if (*text < '0' || *text > '9') {
+            return 0;
+        }
+        uint32_t value = 0;
+        while (*text >= '0' && *text <= '9') {
+            value = value * 10 + (uint32_t)(*text++ - '0');
+            if (value > 255) {
+                return 0;
+            }
+        }
+        ip = ip << 8 | value;
+    }
+    if (end) {
+        *end = text;
+    }
+    return ip;
+}
+
+void net_print_ip(uint32_t ip) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        terminal_writeuint((ip >> shift) & 0xFF);
+        if (shift) {
+            terminal_putchar('.');
+        }
+    }
+}
+
+static void print_mac(const uint8_t mac[6]) {
+    static const char digits[] = "0123456789abcdef";
+    for (uint32_t i = 0; i < 6; i++) {
+        terminal_putchar(digits[mac[i] >> 4]);
+        terminal_putchar(digits[mac[i] & 0x0F]);
+        if (i < 5) {
+            terminal_putchar(':');
+        }
+    }
+}
+
+int net_init(void) {
+    if (nic_init() != SUCCESS) {
+        return ERROR_INVALID_INPUT;
+    }
+    nic_get_mac(local_mac);
+
+    // Адреса: параметр ip=, MAC виду 02:00:A.B.C.D або адреса QEMU user-mode
+    char value[24];
+    if (multiboot_cmdline_value("ip", value, sizeof(value)) && net_parse_ip(value, NULL)) {
+        local_ip = net_parse_ip(value, NULL);
+    } else if (local_mac[0] == 0x02 && local_mac[1] == 0x00) {
+        local_ip = (uint32_t)local_mac[2] << 24 | (uint32_t)local_mac[3] << 16 |
+                   (uint32_t)local_mac[4] << 8 | local_mac[5];
+    }
+    if (multiboot_cmdline_value("gw", value, sizeof(value))) {
+        gateway = net_parse_ip(value, NULL);
+    } else if (local_ip == NET_DEFAULT_IP) {
+        gateway = NET_DEFAULT_GATEWAY;
+    }
+
+    nic_set_receiver(net_receive);
+    net_udp_bind(NET_ECHO_PORT, echo_handler);
+    present = true;
+    if (sched_active()) {
+        thread_create("net-rx", rx_thread, NULL, SCHED_PRIO_HIGH);
+    }
+    return SUCCESS;
+}
+
+int net_present(void) {
+    return present;
+}
+
+uint32_t net_local_ip(void) {
+    return local_ip;
+}
+
+// === СТАТИСТИКА ===
+
+void net_print_stats(void) {
+    if (!present) {
+        nic_print_stats();
+        return;
+    }
+    terminal_writestring("MAC ");
+    print_mac(local_mac);
+    terminal_writestring(", IPv4 ");
+    net_print_ip(local_ip);
+    terminal_writestring("/24, шлюз ");
+    if (gateway) {
+        net_print_ip(gateway);
+    } else {
+        terminal_writestring("немає");
+    }
+    terminal_writestring(", відлуння UDP на порту ");
+    terminal_writeuint(NET_ECHO_PORT);
+    terminal_writestring("\n");
+    nic_print_stats();
+
+    terminal_writestring("ARP: отримано ");
+    terminal_writeuint(arp_received);
+    terminal_writestring(", запитів ");
+    terminal_writeuint(arp_requests_sent);
+    terminal_writestring(", відповідей ");
+    terminal_writeuint(arp_replies_sent);
+    terminal_writestring("\n");
+    for (uint32_t i = 0; i < NET_ARP_ENTRIES; i++) {
+        if (arp_table[i].valid) {
+            terminal_writestring("  ");
+            net_print_ip(arp_table[i].ip);
+            terminal_writestring(" -> ");
+            print_mac(arp_table[i].mac);
+            terminal_writestring("\n");
+        }
+    }
+    terminal_writestring("IPv4: прийнято ");
+    terminal_writeuint(ip_received);
+    terminal_writestring(", UDP: прийнято ");
+    terminal_writeuint(udp_received);
+    terminal_writestring(", надіслано ");
+    terminal_writeuint(udp_sent);
+    terminal_writestring(", відлунь ");
+    terminal_writeuint(echo_replies);
+    terminal_writestring("\nВідкинуто: формат ");
+    terminal_writeuint(drop_malformed);
+    terminal_writestring(", сума ");
+    terminal_writeuint(drop_checksum);
+    terminal_writestring(", не нам ");
+    terminal_writeuint(drop_not_local);
+    terminal_writestring(", закритий порт ");
+    terminal_writeuint(drop_no_port);
+    terminal_writestring(", немає маршруту ");
+    terminal_writeuint(drop_no_route);
+    terminal_writestring(", немає буфера ");
+    terminal_writeuint(drop_no_buffer);
+    terminal_writestring("\n");
+}
+
+// === БЕНЧМАРК ===
+
+#define NET_BENCH_MAGIC 0x4E584543      // "NXEC"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t round;
+    uint64_t tsc;
+} bench_payload_t;
+
+static volatile uint32_t bench_received = 0;
+static volatile uint32_t bench_target = 0;
+static uint32_t bench_round = 0;
+static uint64_t bench_rtt_sum = 0;
+static uint64_t bench_rtt_min = 0;
+static uint64_t bench_rtt_max = 0;
+static thread_t* volatile bench_waiter = NULL;
+static timer_event_t bench_timer;
+
+static void bench_wake(void) {
+    thread_t* waiter = bench_waiter;
+    bench_waiter = NULL;
+    sched_wakeup(waiter);
+}
+
+static void bench_timeout(void* arg) {
+    (void)arg;
+    bench_wake();
+}
+
+// Відлуння поточного раунду; запізнілі з минулих раундів не рахуються
+static void bench_handler(const net_udp_packet_t* packet) {
+    bench_payload_t payload;
+    if (packet->length < sizeof(payload)) {
+        return;
+    }
+    memcpy(&payload, packet->data, sizeof(payload));
+    if (payload.magic != NET_BENCH_MAGIC || payload.round != bench_round || bench_received >= bench_target) {
+        return;
+    }
+    uint64_t rtt = rdtsc() - payload.tsc;
+    bench_rtt_sum += rtt;
+    if (rtt < bench_rtt_min) {
+        bench_rtt_min = rtt;
+    }
+    if (rtt > bench_rtt_max) {
+        bench_rtt_max = rtt;
+    }
+    if (++bench_received >= bench_target) {
+        bench_wake();
+    }
+}
+
+static void bench_wait(uint64_t deadline) {
+    while (bench_received < bench_target && time_now_ns() < deadline) {
+        if (nic_polling()) {
+            net_poll();
+            continue;
+        }
+        unsigned long flags = interrupts_save();
+        if (bench_received < bench_target) {
+            bench_waiter = sched_current();
+            timer_cancel(&bench_timer);
+            if (timer_arm(&bench_timer, deadline) == SUCCESS) {
+                sched_block();
+            }
+            bench_waiter = NULL;
+        }
+        interrupts_restore(flags);
+    }
+    timer_cancel(&bench_timer);
+}
+
+// Раунд: batch датаграм одним дзвінком, очікування всіх відлунь
+static int bench_run(uint32_t ip, uint32_t batch, uint64_t* cycles, uint32_t* lost) {
+    uint8_t data[NET_BENCH_PAYLOAD];
+    bench_payload_t payload;
+    memset(data, 0, sizeof(data));
+    payload.magic = NET_BENCH_MAGIC;
+    bench_received = 0;
+    bench_rtt_sum = 0;
+    bench_rtt_min = ~0ull;
+    bench_rtt_max = 0;
+    *lost = 0;
+
+    uint64_t start = rdtsc();
+    for (uint32_t sent = 0; sent < NET_BENCH_PACKETS; ) {
+        uint32_t count = NET_BENCH_PACKETS - sent < batch ? NET_BENCH_PACKETS - sent : batch;
+        uint32_t base = bench_received;
+        bench_round++;
+        bench_target = base + count;
+        payload.round = bench_round;
+        for (uint32_t i = 0; i < count; i++) {
+            payload.tsc = rdtsc();
+            memcpy(data, &payload, sizeof(payload));
+            if (net_udp_queue(ip, NET_BENCH_PORT, NET_ECHO_PORT, data, sizeof(data)) != SUCCESS) {
+                bench_target--;
+                (*lost)++;
+            }
+        }
+        nic_tx_flush();
+        bench_wait(time_now_ns() + NET_BENCH_TIMEOUT_MS * 1000000ull);
+        if (bench_received == base) {
+            return ERROR_IO;
+        }
+        *lost += bench_target - bench_received;
+        // Раунд закрито: відлуння, що запізнились, відкинуться за номером раунду
+        bench_target = bench_received;
+        sent += count;
+    }
+    *cycles = rdtsc() - start;
+    return SUCCESS;
+}
+
+static void bench_mode(uint32_t ip) {
+    static const uint32_t batches[] = { 1, 4, 16, 64 };
+    terminal_writestring(" Пакет     пак./с   RTT сер., мкс   мін.     макс.  втрачено\n");
+    for (uint32_t i = 0; i < sizeof(batches) / sizeof(batches[0]); i++) {
+        uint64_t cycles;
+        uint32_t lost;
+        if (bench_run(ip, batches[i], &cycles, &lost) != SUCCESS) {
+            terminal_writestring("Вузол не відповідає\n");
+            return;
+        }
+        uint32_t received = NET_BENCH_PACKETS - lost;
+        terminal_writeuint_width(batches[i], 6);
+        terminal_writeuint_width(tsc_per_second(received, cycles), 11);
+        terminal_writestring("    ");
+        terminal_writetenths(div64_u32(tsc_cycles_to_ns(bench_rtt_sum), received * 100, NULL));
+        terminal_writestring("    ");
+        terminal_writetenths(div64_u32(tsc_cycles_to_ns(bench_rtt_min), 100, NULL));
+        terminal_writestring("    ");
+        terminal_writetenths(div64_u32(tsc_cycles_to_ns(bench_rtt_max), 100, NULL));
+        terminal_writeuint_width(lost, 10);
+        terminal_writestring("\n");
+    }
+}
+
+void net_benchmark(uint32_t ip) {
+    uint8_t mac[6];
+    if (!present) {
+        nic_print_stats();
+        return;
+    }
+    if (net_arp_resolve(ip, mac) != SUCCESS) {
+        terminal_writestring("Вузол ");
+        net_print_ip(ip);
+        terminal_writestring(" не відповідає на ARP\n");
+        return;
+    }
+    timer_event_init(&bench_timer, bench_timeout, NULL);
+    if (net_udp_bind(NET_BENCH_PORT, bench_handler) != SUCCESS) {
+        terminal_writestring("Немає вільного порту UDP\n");
+        return;
+    }
+    int was_polling = nic_polling();
+    terminal_writestring("Відлуння UDP з ");
+    net_print_ip(ip);
+    terminal_writestring(": ");
+    terminal_writeuint(NET_BENCH_PACKETS);
+    terminal_writestring(" датаграм по ");
+    terminal_writeuint(NET_BENCH_PAYLOAD);
+    terminal_writestring(" Б на розмір пакета передачі\n");
+    if (!was_polling) {
+        terminal_writestring("\nПереривання MSI-X, потік прийому:\n");
+        bench_mode(ip);
+    }
+    terminal_writestring("\nОпитування у потоці бенчмарку:\n");
+    nic_set_polling(true);
+    bench_mode(ip);
+    nic_set_polling(was_polling);
+    net_udp_bind(NET_BENCH_PORT, NULL);
+}
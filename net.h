@@ -0,0 +1,127 @@
+#ifndef NET_H
+#define NET_H
+
+#include "kernel.h"
+
+// Мінімальний стек поверх nic.c: Ethernet, ARP, IPv4 без фрагментації, UDP.
+// Прийом - у потоці "net-rx", дані UDP віддаються обробнику прямо з буфера
+// кільця прийому. Адреси IPv4 в API - у порядку байтів хоста
+
+#define NET_ETHERTYPE_IPV4      0x0800
+#define NET_ETHERTYPE_ARP       0x0806
+#define NET_PROTO_UDP           17
+
+#define NET_ETH_HEADER_SIZE     14
+#define NET_IP_HEADER_SIZE      20
+#define NET_UDP_HEADER_SIZE     8
+#define NET_UDP_PAYLOAD_MAX     (1500 - NET_IP_HEADER_SIZE - NET_UDP_HEADER_SIZE)
+
+#define NET_ARP_ENTRIES         16
+#define NET_UDP_PORTS           8
+#define NET_TTL                 64
+
+// Типова адреса - гість QEMU user-mode (-netdev user); MAC виду 02:00:A.B.C.D
+// задає адресу A.B.C.D (два QEMU через -netdev socket)
+#define NET_DEFAULT_IP          0x0A00020F      // 10.0.2.15
+#define NET_DEFAULT_GATEWAY     0x0A000202      // 10.0.2.2
+#define NET_DEFAULT_NETMASK     0xFFFFFF00
+
+// Сервіс відлуння UDP та порт відправника команди udpsend
+#define NET_ECHO_PORT           7
+#define NET_SHELL_PORT          40001
+
+// Бенчмарк: пакетів на кожен розмір пакета передачі, корисне навантаження
+#define NET_BENCH_PACKETS       20000
+#define NET_BENCH_PAYLOAD       64
+#define NET_BENCH_PORT          40000
+#define NET_BENCH_TIMEOUT_MS    200
+#define NET_ARP_TIMEOUT_MS      1000
+
+typedef struct {
+    uint8_t dst[6];
+    uint8_t src[6];
+    uint16_t type;
+} __attribute__((packed)) eth_header_t;
+
+typedef struct {
+    uint16_t htype;
+    uint16_t ptype;
+    uint8_t hlen;
+    uint8_t plen;
+    uint16_t oper;
+    uint8_t sha[6];
+    uint32_t spa;
+    uint8_t tha[6];
+    uint32_t tpa;
+} __attribute__((packed)) arp_packet_t;
+
+typedef struct {
+    uint8_t version_ihl;
+    uint8_t tos;
+    uint16_t total_length;
+    uint16_t id;
+    uint16_t fragment;
+    uint8_t ttl;
+    uint8_t protocol;
+    uint16_t checksum;
+    uint32_t src;
+    uint32_t dst;
+} __attribute__((packed)) ipv4_header_t;
+
+typedef struct {
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint16_t length;
+    uint16_t checksum;
+} __attribute__((packed)) udp_header_t;
+
+// Дані вказують у буфер прийому: дійсні лише до повернення з обробника
+typedef struct {
+    uint32_t src_ip;
+    uint16_t src_port;
+    uint16_t dst_port;
+    const uint8_t* data;
+    uint32_t length;
+} net_udp_packet_t;
+
+typedef void (*net_udp_handler_t)(const net_udp_packet_t* packet);
+
+static inline uint16_t htons(uint16_t value) {
+    return __builtin_bswap16(value);
+}
+
+static inline uint32_t htonl(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+#define ntohs htons
+#define ntohl htonl
+
+// Адаптер, адреса (параметри ядра ip=, gw=), потік прийому, сервіс відлуння
+int net_init(void);
+int net_present(void);
+uint32_t net_local_ip(void);
+
+// "a.b.c.d" -> адреса; 0 - рядок не є адресою
+uint32_t net_parse_ip(const char* text, const char** end);
+void net_print_ip(uint32_t ip);
+
+// MAC сусіда: з таблиці або ARP-запитом з очікуванням
+int net_arp_resolve(uint32_t ip, uint8_t mac[6]);
+
+// Обробник порту UDP; NULL знімає прив'язку
+int net_udp_bind(uint16_t port, net_udp_handler_t handler);
+
+// Датаграма в чергу передачі без дзвінка (з обробника - відповідь піде
+// одним пакетом з іншими після проходу прийому) або з дзвінком
+int net_udp_queue(uint32_t dst_ip, uint16_t src_port, uint16_t dst_port, const void* data, uint32_t length);
+int net_udp_send(uint32_t dst_ip, uint16_t src_port, uint16_t dst_port, const void* data, uint32_t length);
+
+// Один прохід прийому та дзвінок для накопиченої передачі
+uint32_t net_poll(void);
+
+// Статистика та бенчмарк відлуння з вузлом ip
+void net_print_stats(void);
+void net_benchmark(uint32_t ip);
+
+#endif
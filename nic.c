@@ -0,0 +1,343 @@
+#include "nic.h"
+#include "virtio.h"
+#include "apic.h"
+#include "cpu.h"
+#include "irq.h"
+#include "pmm.h"
+#include "sched.h"
+#include "string.h"
+
+static virtio_device_t device;
+static virtq_t rx_queue;
+static virtq_t tx_queue;
+static spinlock_t rx_lock = SPINLOCK_INIT;
+static spinlock_t tx_lock = SPINLOCK_INIT;
+
+static int present = false;
+static int use_interrupts = false;
+static int polling = false;
+static int vector = -1;
+static uint8_t mac[6] = { 0x52, 0x54, 0x00, 0x12, 0x34, 0x56 };
+static nic_receive_t receiver = NULL;
+static thread_t* rx_waiter = NULL;
+
+// Вільні буфери передачі (на virtio-заголовок, не на кадр)
+static uint8_t* tx_free[NIC_QUEUE_SIZE];
+static uint32_t tx_free_count = 0;
+static uint32_t tx_queued = 0;
+
+// Статистика
+static uint64_t rx_packets = 0;
+static uint64_t rx_bytes = 0;
+static uint64_t rx_csum_valid = 0;
+static uint64_t rx_interrupts = 0;
+static uint64_t rx_polls = 0;
+static uint64_t tx_packets = 0;
+static uint64_t tx_bytes = 0;
+static uint64_t tx_batches = 0;
+static uint64_t tx_offloaded = 0;
+static uint64_t tx_no_buffer = 0;
+
+// === ПРИЙОМ ===
+
+// NAPI: переривання лише будить потік прийому, далі - опитування до порожнього кільця
+static void nic_irq(irq_frame_t* frame) {
+    (void)frame;
+    spin_lock(&rx_lock);
+    rx_interrupts++;
+    virtq_disable_interrupts(&rx_queue);
+    spin_unlock(&rx_lock);
+    thread_t* waiter = rx_waiter;
+    rx_waiter = NULL;
+    sched_wakeup(waiter);
+}
+
+static void rx_post_locked(uint8_t* buffer) {
+    virtq_buf_t buf = { (uintptr_t)buffer, NIC_BUFFER_SIZE };
+    virtq_add(&rx_queue, &buf, 0, 1, buffer);
+}
+
+uint32_t nic_poll(uint32_t budget) {
+    if (!present) {
+        return 0;
+    }
+    uint32_t count = 0;
+    while (count < budget) {
+        uint32_t length;
+        unsigned long flags = spin_lock_irqsave(&rx_lock);
+        uint8_t* buffer = (uint8_t*)virtq_get(&rx_queue, &length);
+        spin_unlock_irqrestore(&rx_lock, flags);
+        if (!buffer) {
+            break;
+        }
+
+        // Кадр обробляється прямо в буфері кільця, без копіювання
+        virtio_net_hdr_t* header = (virtio_net_hdr_t*)buffer;
+        if (length > NIC_HEADER_SIZE) {
+            int csum_valid = header->flags & (VIRTIO_NET_HDR_F_DATA_VALID | VIRTIO_NET_HDR_F_NEEDS_CSUM);
+            rx_packets++;
+            rx_bytes += length - NIC_HEADER_SIZE;
+            rx_csum_valid += csum_valid != 0;
+            if (receiver) {
+                receiver(buffer + NIC_HEADER_SIZE, length - NIC_HEADER_SIZE, csum_valid);
+            }
+        }
+
+        flags = spin_lock_irqsave(&rx_lock);
+        rx_post_locked(buffer);
+        spin_unlock_irqrestore(&rx_lock, flags);
+        count++;
+    }
+    if (count) {
+        unsigned long flags = spin_lock_irqsave(&rx_lock);
+        rx_polls++;
+        virtq_kick(&rx_queue);
+        spin_unlock_irqrestore(&rx_lock, flags);
+    }
+    return count;
+}
+
+void nic_wait(void) {
+    if (!present || polling || !use_interrupts) {
+        sched_sleep_ns(NIC_POLL_INTERVAL_NS);
+        return;
+    }
+    // Взвести переривання і заснути, лише якщо кільце досі порожнє
+    unsigned long flags = interrupts_save();
+    spin_lock(&rx_lock);
+    int pending = virtq_enable_interrupts(&rx_queue, 1);
+    spin_unlock(&rx_lock);
+    if (!pending) {
+        rx_waiter = sched_current();
+        sched_block();
+    }
+    interrupts_restore(flags);
+}
+
+void nic_set_polling(int enabled) {
+    if (!present) {
+        return;
+    }
+    unsigned long flags = spin_lock_irqsave(&rx_lock);
+    polling = enabled;
+    if (enabled) {
+        virtq_disable_interrupts(&rx_queue);
+    }
+    spin_unlock_irqrestore(&rx_lock, flags);
+    // Потік прийому сам взведе переривання при наступному nic_wait
+    if (!enabled) {
+        thread_t* waiter = rx_waiter;
+        rx_waiter = NULL;
+        sched_wakeup(waiter);
+    }
+}
+
+int nic_polling(void) {
+    return polling || !use_interrupts;
+}
+
+// === ПЕРЕДАЧА ===
+
+static void tx_reclaim_locked(void) {
+    uint8_t* buffer;
+    while ((buffer = (uint8_t*)virtq_get(&tx_queue, NULL)) != NULL) {
+        tx_free[tx_free_count++] = buffer;
+    }
+}
+
+uint8_t* nic_tx_buffer(void) {
+    if (!present) {
+        return NULL;
+    }
+    unsigned long flags = spin_lock_irqsave(&tx_lock);
+    // Завершені передачі забираються тут: черга передачі без переривань
+    if (tx_free_count == 0) {
+        tx_reclaim_locked();
+    }
+    uint8_t* buffer = NULL;
+    if (tx_free_count) {
+        buffer = tx_free[--tx_free_count];
+    } else {
+        tx_no_buffer++;
+    }
+    spin_unlock_irqrestore(&tx_lock, flags);
+    return buffer ? buffer + NIC_HEADER_SIZE : NULL;
+}
+
+void nic_tx_release(uint8_t* frame) {
+    unsigned long flags = spin_lock_irqsave(&tx_lock);
+    tx_free[tx_free_count++] = frame - NIC_HEADER_SIZE;
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+void nic_tx_queue(uint8_t* frame, uint32_t length, uint16_t csum_start, uint16_t csum_offset) {
+    uint8_t* buffer = frame - NIC_HEADER_SIZE;
+    virtio_net_hdr_t* header = (virtio_net_hdr_t*)buffer;
+    memset(header, 0, sizeof(*header));
+    if (csum_start) {
+        header->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+        header->csum_start = csum_start;
+        header->csum_offset = csum_offset;
+    }
+    // Заголовок і кадр - один дескриптор (VERSION_1 дозволяє довільне розбиття)
+    virtq_buf_t buf = { (uintptr_t)buffer, NIC_HEADER_SIZE + length };
+
+    unsigned long flags = spin_lock_irqsave(&tx_lock);
+    virtq_add(&tx_queue, &buf, 1, 0, buffer);
+    tx_queued++;
+    tx_packets++;
+    tx_bytes += length;
+    tx_offloaded += csum_start != 0;
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+void nic_tx_flush(void) {
+    if (!present) {
+        return;
+    }
+    unsigned long flags = spin_lock_irqsave(&tx_lock);
+    if (tx_queued) {
+        virtq_kick(&tx_queue);
+        tx_batches++;
+        tx_queued = 0;
+    }
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+int nic_tx_csum_offload(void) {
+    return present && virtio_has_feature(&device, VIRTIO_NET_F_CSUM);
+}
+
+int nic_rx_csum_offload(void) {
+    return present && virtio_has_feature(&device, VIRTIO_NET_F_GUEST_CSUM);
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int nic_init(void) {
+    pci_device_t* pci = virtio_find(VIRTIO_ID_NET, 0);
+    if (!pci) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint64_t wanted = (1ull << VIRTIO_F_EVENT_IDX) | (1ull << VIRTIO_NET_F_MAC) |
+                      (1ull << VIRTIO_NET_F_CSUM) | (1ull << VIRTIO_NET_F_GUEST_CSUM);
+    if (virtio_init(&device, pci, wanted) != SUCCESS) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Переривання лише для прийому; завершення передачі забираються при наступній
+    uint16_t entry = VIRTIO_MSI_NO_VECTOR;
+    if (lapic_present() && virtio_enable_msix(&device) == SUCCESS) {
+        vector = irq_alloc_vector("virtio-net", nic_irq, 0);
+        if (vector >= 0 && pci_msix_route(&device.msix, 0, (uint8_t)vector, cpus[0].apic_id) == SUCCESS) {
+            entry = 0;
+        }
+    }
+    if (virtio_queue_setup(&device, &rx_queue, 0, NIC_QUEUE_SIZE, entry) != SUCCESS ||
+        virtio_queue_setup(&device, &tx_queue, 1, NIC_QUEUE_SIZE, VIRTIO_MSI_NO_VECTOR) != SUCCESS) {
+        return ERROR_INVALID_INPUT;
+    }
+    use_interrupts = entry != VIRTIO_MSI_NO_VECTOR;
+    virtq_disable_interrupts(&tx_queue);
+    if (!use_interrupts) {
+        virtq_disable_interrupts(&rx_queue);
+    }
+
+    if (virtio_has_feature(&device, VIRTIO_NET_F_MAC) && device.config) {
+        for (uint32_t i = 0; i < 6; i++) {
+            mac[i] = virtio_config_read8(&device, VIRTIO_NET_CFG_MAC + i);
+        }
+    }
+
+    // Буфери прийому та передачі: по два на сторінку
+    uint32_t rx_count = rx_queue.size;
+    uint32_t tx_count = tx_queue.size;
+    uint32_t per_page = PAGE_SIZE / NIC_BUFFER_SIZE;
+    uintptr_t rx_memory = pmm_alloc_frames((rx_count + per_page - 1) / per_page);
+    uintptr_t tx_memory = pmm_alloc_frames((tx_count + per_page - 1) / per_page);
+    if (!rx_memory || !tx_memory) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    for (uint32_t i = 0; i < rx_count; i++) {
+        rx_post_locked((uint8_t*)(rx_memory + i * NIC_BUFFER_SIZE));
+    }
+    for (uint32_t i = 0; i < tx_count; i++) {
+        tx_free[tx_free_count++] = (uint8_t*)(tx_memory + i * NIC_BUFFER_SIZE);
+    }
+
+    virtio_ready(&device);
+    virtq_kick(&rx_queue);
+    present = true;
+    return SUCCESS;
+}
+
+int nic_present(void) {
+    return present;
+}
+
+void nic_get_mac(uint8_t out[6]) {
+    memcpy(out, mac, 6);
+}
+
+void nic_set_receiver(nic_receive_t callback) {
+    receiver = callback;
+}
+
+// === СТАТИСТИКА ===
+
+void nic_print_stats(void) {
+    if (!present) {
+        terminal_writestring("virtio-net не знайдено (QEMU -device virtio-net-pci)\n");
+        return;
+    }
+    char buffer[24];
+    terminal_writestring("virtio-net ");
+    uint64toa(device.pci->bus, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_putchar(':');
+    uint64toa(device.pci->slot, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_putchar('.');
+    terminal_writeuint(device.pci->function);
+    terminal_writestring(", черги ");
+    terminal_writeuint(rx_queue.size);
+    terminal_writestring("/");
+    terminal_writeuint(tx_queue.size);
+    terminal_writestring(nic_tx_csum_offload() ? ", сума передачі на пристрої" : ", сума передачі програмно");
+    terminal_writestring(nic_rx_csum_offload() ? ", перевірка прийому на пристрої\n" : "\n");
+    terminal_writestring("Прийом: ");
+    if (!use_interrupts) {
+        terminal_writestring("опитування раз на 1 мс (немає MSI-X/APIC)\n");
+    } else {
+        terminal_writestring(polling ? "опитування" : "переривання");
+        terminal_writestring(", MSI-X вектор ");
+        terminal_writeuint((uint32_t)vector);
+        terminal_writestring("\n");
+    }
+
+    terminal_writestring("Прийнято: ");
+    terminal_writeuint(rx_packets);
+    terminal_writestring(" кадрів, ");
+    terminal_writeuint(rx_bytes);
+    terminal_writestring(" Б, перевірено пристроєм ");
+    terminal_writeuint(rx_csum_valid);
+    terminal_writestring("\nПереривань: ");
+    terminal_writeuint(rx_interrupts);
+    terminal_writestring(", проходів опитування: ");
+    terminal_writeuint(rx_polls);
+    terminal_writestring("\nПередано: ");
+    terminal_writeuint(tx_packets);
+    terminal_writestring(" кадрів, ");
+    terminal_writeuint(tx_bytes);
+    terminal_writestring(" Б, пакетів ");
+    terminal_writeuint(tx_batches);
+    terminal_writestring(", дзвінків ");
+    terminal_writeuint(tx_queue.kicks);
+    terminal_writestring(" (пропущено ");
+    terminal_writeuint(tx_queue.kicks_suppressed);
+    terminal_writestring(")\nСума на пристрої: ");
+    terminal_writeuint(tx_offloaded);
+    terminal_writestring(", без вільного буфера: ");
+    terminal_writeuint(tx_no_buffer);
+    terminal_writestring("\n");
+}
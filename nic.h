@@ -0,0 +1,76 @@
+#ifndef NIC_H
+#define NIC_H
+
+#include "kernel.h"
+
+// Мережевий адаптер virtio-net (QEMU -device virtio-net-pci): кільце
+// заздалегідь виставлених буферів прийому, кадри віддаються нагору прямо
+// з них, передача пакетами з одним дзвінком і делегуванням контрольної суми
+
+#define NIC_QUEUE_SIZE          256
+#define NIC_BUFFER_SIZE         2048
+#define NIC_MTU                 1500
+#define NIC_FRAME_MAX           1514
+
+// Прийом за один виклик nic_poll
+#define NIC_POLL_BUDGET         64
+
+// Без переривань потік прийому перевіряє кільце з цим періодом
+#define NIC_POLL_INTERVAL_NS    1000000ull
+
+// Можливості virtio-net (номери бітів)
+#define VIRTIO_NET_F_CSUM       0       // пристрій дораховує суму передачі
+#define VIRTIO_NET_F_GUEST_CSUM 1       // пристрій позначає перевірені кадри
+#define VIRTIO_NET_F_MAC        5
+
+// Конфігурація пристрою
+#define VIRTIO_NET_CFG_MAC      0x00
+
+// Заголовок virtio_net_hdr перед кожним кадром (VERSION_1 - з num_buffers)
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
+
+typedef struct {
+    uint8_t flags;
+    uint8_t gso_type;
+    uint16_t hdr_len;
+    uint16_t gso_size;
+    uint16_t csum_start;
+    uint16_t csum_offset;
+    uint16_t num_buffers;
+} __attribute__((packed)) virtio_net_hdr_t;
+
+#define NIC_HEADER_SIZE         sizeof(virtio_net_hdr_t)
+
+// Кадр у буфері прийому дійсний лише до повернення з обробника: буфер
+// одразу повертається в кільце. csum_valid - пристрій перевірив суму
+typedef void (*nic_receive_t)(uint8_t* frame, uint32_t length, int csum_valid);
+
+// Пошук пристрою, черги, буфери прийому, MSI-X для черги прийому
+int nic_init(void);
+int nic_present(void);
+void nic_get_mac(uint8_t mac[6]);
+void nic_set_receiver(nic_receive_t receiver);
+
+// Прийняти до budget кадрів і повернути буфери в кільце одним дзвінком
+uint32_t nic_poll(uint32_t budget);
+
+// Потік прийому: сон до переривання (або NIC_POLL_INTERVAL_NS без нього)
+void nic_wait(void);
+
+// Опитування: переривання прийому вимкнені, кільце читає викликач nic_poll
+void nic_set_polling(int enabled);
+int nic_polling(void);
+
+// Передача: буфер під кадр, постановка в чергу, один дзвінок на пакет кадрів.
+// csum_start = 0 - контрольна сума вже готова
+uint8_t* nic_tx_buffer(void);
+void nic_tx_release(uint8_t* frame);
+void nic_tx_queue(uint8_t* frame, uint32_t length, uint16_t csum_start, uint16_t csum_offset);
+void nic_tx_flush(void);
+int nic_tx_csum_offload(void);
+int nic_rx_csum_offload(void);
+
+void nic_print_stats(void);
+
+#endif
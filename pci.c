@@ -0,0 +1,372 @@
+#include "pci.h"
+#include "vmm.h"
+
+#define PCI_MAX_BUSES           256
+#define PCI_SLOTS               32
+#define PCI_FUNCTIONS           8
+
+static pci_device_t devices[PCI_MAX_DEVICES];
+static uint32_t device_count = 0;
+static uint32_t buses_scanned = 0;
+static uint8_t bus_seen[PCI_MAX_BUSES / 8];
+
+// === КОНФІГУРАЦІЙНИЙ ПРОСТІР ===
+
+static uint32_t config_address(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset) {
+    return 0x80000000u | ((uint32_t)bus << 16) | ((uint32_t)slot << 11) |
+           ((uint32_t)function << 8) | (offset & 0xFC);
+}
+
+// Адреса і дані - пара портів, тож доступ атомарний відносно переривань
+static uint32_t config_read(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset) {
+    unsigned long flags = interrupts_save();
+    outl(PCI_CONFIG_ADDRESS, config_address(bus, slot, function, offset));
+    uint32_t value = inl(PCI_CONFIG_DATA);
+    interrupts_restore(flags);
+    return value;
+}
+
+static void config_write(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset, uint32_t value) {
+    unsigned long flags = interrupts_save();
+    outl(PCI_CONFIG_ADDRESS, config_address(bus, slot, function, offset));
+    outl(PCI_CONFIG_DATA, value);
+    interrupts_restore(flags);
+}
+
+uint32_t pci_read32(const pci_device_t* device, uint8_t offset) {
+    return config_read(device->bus, device->slot, device->function, offset);
+}
+
+uint16_t pci_read16(const pci_device_t* device, uint8_t offset) {
+    return (uint16_t)(pci_read32(device, offset) >> ((offset & 2) * 8));
+}
+
+uint8_t pci_read8(const pci_device_t* device, uint8_t offset) {
+    return (uint8_t)(pci_read32(device, offset) >> ((offset & 3) * 8));
+}
+
+void pci_write32(const pci_device_t* device, uint8_t offset, uint32_t value) {
+    config_write(device->bus, device->slot, device->function, offset, value);
+}
+
+// Сусіднє 16-бітне поле зберігається (статус поруч з командою скидається записом 1)
+void pci_write16(const pci_device_t* device, uint8_t offset, uint16_t value) {
+    uint32_t shift = (offset & 2) * 8;
+    uint32_t word = pci_read32(device, offset);
+    if (offset == PCI_COMMAND) {
+        word &= 0x0000FFFF;
+    }
+    word = (word & ~(0xFFFFu << shift)) | ((uint32_t)value << shift);
+    pci_write32(device, offset, word);
+}
+
+void pci_enable(pci_device_t* device, uint16_t command) {
+    pci_write16(device, PCI_COMMAND, pci_read16(device, PCI_COMMAND) | command);
+}
+
+uint8_t pci_find_capability(const pci_device_t* device, uint8_t id, uint8_t start) {
+    if (!(pci_read16(device, PCI_STATUS) & PCI_STATUS_CAPABILITIES)) {
+        return 0;
+    }
+    uint8_t offset = start ? pci_read8(device, start + 1) : pci_read8(device, PCI_CAPABILITIES);
+    // Обмеження на випадок зацикленого списку
+    for (int guard = 0; offset >= 0x40 && guard < 48; guard++) {
+        offset &= 0xFC;
+        if (pci_read8(device, offset) == id) {
+            return offset;
+        }
+        offset = pci_read8(device, offset + 1);
+    }
+    return 0;
+}
+
+// === ПЕРЕЛІК ПРИСТРОЇВ ===
+
+// Розмір BAR: записуємо одиниці й читаємо маску при вимкненому декодуванні
+static uint32_t probe_bars(pci_device_t* device) {
+    uint32_t count = (device->header_type & 0x7F) == PCI_HEADER_BRIDGE ? 2 : PCI_BAR_COUNT;
+    uint16_t command = pci_read16(device, PCI_COMMAND);
+    pci_write16(device, PCI_COMMAND, command & ~(PCI_COMMAND_IO | PCI_COMMAND_MEMORY));
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t offset = PCI_BAR0 + i * 4;
+        uint32_t original = pci_read32(device, offset);
+        pci_write32(device, offset, 0xFFFFFFFF);
+        uint32_t mask = pci_read32(device, offset);
+        pci_write32(device, offset, original);
+        pci_bar_t* bar = &device->bar[i];
+
+        if (original & 1) {
+            bar->flags = PCI_BAR_IO;
+            bar->base = original & ~3u;
+            mask &= ~3u;
+            bar->size = mask ? (uint16_t)(~mask + 1) : 0;
+            continue;
+        }
+        bar->base = original & ~0xFu;
+        bar->flags = (original & 0x8) ? PCI_BAR_PREFETCH : 0;
+        uint64_t size_mask = mask & ~0xFu;
+        if ((original & 0x6) == 0x4 && i + 1 < count) {
+            // 64-бітний BAR займає й наступний слот
+            uint32_t high = pci_read32(device, offset + 4);
+            pci_write32(device, offset + 4, 0xFFFFFFFF);
+            uint32_t high_mask = pci_read32(device, offset + 4);
+            pci_write32(device, offset + 4, high);
+            bar->base |= (uint64_t)high << 32;
+            size_mask |= (uint64_t)high_mask << 32;
+            bar->flags |= PCI_BAR_MEM64;
+            bar->size = size_mask ? ~size_mask + 1 : 0;
+            i++;
+            continue;
+        }
+        bar->size = size_mask ? (uint32_t)(~(uint32_t)size_mask + 1) : 0;
+    }
+
+    pci_write16(device, PCI_COMMAND, command);
+    return count;
+}
+
+static void scan_bus(uint8_t bus);
+
+static void scan_function(uint8_t bus, uint8_t slot, uint8_t function) {
+    uint32_t id = config_read(bus, slot, function, PCI_VENDOR_ID);
+    if ((id & 0xFFFF) == 0xFFFF || device_count >= PCI_MAX_DEVICES) {
+        return;
+    }
+    pci_device_t* device = &devices[device_count++];
+    memset(device, 0, sizeof(*device));
+    device->bus = bus;
+    device->slot = slot;
+    device->function = function;
+    device->vendor = (uint16_t)id;
+    device->device = (uint16_t)(id >> 16);
+
+    uint32_t class_word = pci_read32(device, PCI_REVISION);
+    device->revision = (uint8_t)class_word;
+    device->prog_if = (uint8_t)(class_word >> 8);
+    device->subclass = (uint8_t)(class_word >> 16);
+    device->class_code = (uint8_t)(class_word >> 24);
+    device->header_type = pci_read8(device, PCI_HEADER_TYPE);
+    device->irq_line = pci_read8(device, PCI_INTERRUPT_LINE);
+    device->irq_pin = pci_read8(device, PCI_INTERRUPT_PIN);
+    if ((device->header_type & 0x7F) == 0) {
+        device->subsystem = pci_read16(device, PCI_SUBSYSTEM_ID);
+    }
+    probe_bars(device);
+
+    if (device->class_code == PCI_CLASS_BRIDGE && device->subclass == PCI_SUBCLASS_PCI_BRIDGE) {
+        scan_bus(pci_read8(device, PCI_SECONDARY_BUS));
+    }
+}
+
+// Рекурсивно від шини 0 через мости - без перебору всіх 256 шин
+static void scan_bus(uint8_t bus) {
+    if (bus_seen[bus / 8] & (1 << (bus % 8))) {
+        return;
+    }
+    bus_seen[bus / 8] |= (uint8_t)(1 << (bus % 8));
+    buses_scanned++;
+
+    for (uint8_t slot = 0; slot < PCI_SLOTS; slot++) {
+        if ((config_read(bus, slot, 0, PCI_VENDOR_ID) & 0xFFFF) == 0xFFFF) {
+            continue;
+        }
+        scan_function(bus, slot, 0);
+        uint8_t header = (uint8_t)(config_read(bus, slot, 0, PCI_HEADER_TYPE & 0xFC) >> 16);
+        if (header & PCI_HEADER_MULTIFUNCTION) {
+            for (uint8_t function = 1; function < PCI_FUNCTIONS; function++) {
+                scan_function(bus, slot, function);
+            }
+        }
+    }
+}
+
+int pci_init(void) {
+    // Механізм #1: регістр адреси зберігає записане значення
+    outl(PCI_CONFIG_ADDRESS, 0x80000000u);
+    if (inl(PCI_CONFIG_ADDRESS) != 0x80000000u) {
+        return ERROR_INVALID_INPUT;
+    }
+    device_count = 0;
+    buses_scanned = 0;
+    memset(bus_seen, 0, sizeof(bus_seen));
+    scan_bus(0);
+    return device_count ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+uint32_t pci_device_count(void) {
+    return device_count;
+}
+
+pci_device_t* pci_get(uint32_t index) {
+    return index < device_count ? &devices[index] : NULL;
+}
+
+pci_device_t* pci_find(uint16_t vendor, uint16_t device, uint32_t index) {
+    for (uint32_t i = 0; i < device_count; i++) {
+        if (devices[i].vendor == vendor && devices[i].device == device && index-- == 0) {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+void* pci_map_bar(pci_device_t* device, uint32_t bar) {
+    if (bar >= PCI_BAR_COUNT) {
+        return NULL;
+    }
+    pci_bar_t* entry = &device->bar[bar];
+    if (!entry->size || (entry->flags & PCI_BAR_IO)) {
+        return NULL;
+    }
+    // Відображаємо лише identity-простір нижніх 4 ГБ
+    if (entry->base + entry->size > 0x100000000ull) {
+        return NULL;
+    }
+    return vmm_map_mmio((uintptr_t)entry->base, (size_t)entry->size, VMM_UC);
+}
+
+// === MSI-X ===
+
+int pci_msix_init(pci_device_t* device, pci_msix_t* msix) {
+    uint8_t cap = pci_find_capability(device, PCI_CAP_MSIX, 0);
+    if (!cap) {
+        return ERROR_INVALID_INPUT;
+    }
+    uint32_t table = pci_read32(device, cap + PCI_MSIX_TABLE);
+    uint32_t bir = table & 7;
+    uint16_t entries = (pci_read16(device, cap + PCI_MSIX_CONTROL) & PCI_MSIX_SIZE_MASK) + 1;
+    uint8_t* base = pci_map_bar(device, bir);
+    if (!base) {
+        return ERROR_INVALID_INPUT;
+    }
+    msix->device = device;
+    msix->cap = cap;
+    msix->entries = entries;
+    msix->table = (volatile uint32_t*)(base + (table & ~7u));
+
+    // Усі записи замасковані, доки драйвер їх не налаштує
+    for (uint16_t i = 0; i < entries; i++) {
+        msix->table[i * 4 + 3] = PCI_MSIX_VECTOR_MASKED;
+    }
+    return SUCCESS;
+}
+
+int pci_msix_route(pci_msix_t* msix, uint16_t entry, uint8_t vector, uint32_t apic_id) {
+    if (entry >= msix->entries || apic_id > 0xFF) {
+        return ERROR_INVALID_INPUT;
+    }
+    volatile uint32_t* slot = msix->table + entry * 4;
+    slot[0] = PCI_MSI_ADDRESS_BASE | (apic_id << 12);
+    slot[1] = 0;
+    slot[2] = vector;
+    slot[3] = 0;
+    return SUCCESS;
+}
+
+// MSI-X замінює INTx: лінію вимикаємо, щоб не було подвійних переривань
+void pci_msix_enable(pci_msix_t* msix) {
+    uint16_t control = pci_read16(msix->device, msix->cap + PCI_MSIX_CONTROL);
+    control = (control | PCI_MSIX_ENABLE) & ~PCI_MSIX_FUNCTION_MASK;
+    pci_write16(msix->device, msix->cap + PCI_MSIX_CONTROL, control);
+    pci_enable(msix->device, PCI_COMMAND_INTX_OFF);
+}
+
+// === ЗВІТ ===
+
+static void write_hex(uint64_t value, uint32_t digits) {
+    char buffer[24];
+    uint64toa(value, buffer, 16);
+    for (size_t len = strlen(buffer); len < digits; len++) {
+        terminal_putchar('0');
+    }
+    terminal_writestring(buffer);
+}
+
+static const char* class_name(uint8_t class_code) {
+    switch (class_code) {
+        case 0x01: return "накопичувач";
+        case 0x02: return "мережа";
+        case 0x03: return "дисплей";
+        case 0x04: return "мультимедіа";
+        case 0x06: return "міст";
+        case 0x07: return "зв'язок";
+        case 0x08: return "системний";
+        case 0x0C: return "послідовна шина";
+        default:   return "інший";
+    }
+}
+
+static void write_size(uint64_t size) {
+    if (size >= 1024 * 1024) {
+        terminal_writeuint(size >> 20);
+        terminal_writestring(" МБ");
+    } else if (size >= 1024) {
+        terminal_writeuint(size >> 10);
+        terminal_writestring(" КБ");
+    } else {
+        terminal_writeuint(size);
+        terminal_writestring(" Б");
+    }
+}
+
+void pci_print_devices(void) {
+    if (!device_count) {
+        terminal_writestring("PCI: пристроїв не знайдено\n");
+        return;
+    }
+    terminal_writestring("PCI: ");
+    terminal_writeuint(device_count);
+    terminal_writestring(" функцій на ");
+    terminal_writeuint(buses_scanned);
+    terminal_writestring(" шинах\n");
+
+    for (uint32_t i = 0; i < device_count; i++) {
+        pci_device_t* device = &devices[i];
+        write_hex(device->bus, 2);
+        terminal_putchar(':');
+        write_hex(device->slot, 2);
+        terminal_putchar('.');
+        terminal_writeuint(device->function);
+        terminal_writestring("  ");
+        write_hex(device->vendor, 4);
+        terminal_putchar(':');
+        write_hex(device->device, 4);
+        terminal_writestring("  ");
+        write_hex(device->class_code, 2);
+        terminal_putchar('.');
+        write_hex(device->subclass, 2);
+        terminal_putchar(' ');
+        terminal_writestring(class_name(device->class_code));
+        if (device->irq_pin) {
+            terminal_writestring(", INT");
+            terminal_putchar((char)('A' + device->irq_pin - 1));
+            terminal_writestring(" IRQ ");
+            terminal_writeuint(device->irq_line);
+        }
+        if (pci_find_capability(device, PCI_CAP_MSIX, 0)) {
+            terminal_writestring(", MSI-X");
+        }
+        terminal_writestring("\n");
+
+        for (uint32_t b = 0; b < PCI_BAR_COUNT; b++) {
+            pci_bar_t* bar = &device->bar[b];
+            if (!bar->size) {
+                continue;
+            }
+            terminal_writestring("      BAR");
+            terminal_writeuint(b);
+            terminal_writestring((bar->flags & PCI_BAR_IO) ? " порти 0x" : " пам'ять 0x");
+            write_hex(bar->base, 0);
+            terminal_writestring(", ");
+            write_size(bar->size);
+            if (bar->flags & PCI_BAR_MEM64) {
+                terminal_writestring(", 64 біти");
+            }
+            if (bar->flags & PCI_BAR_PREFETCH) {
+                terminal_writestring(", prefetch");
+            }
+            terminal_writestring("\n");
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef PCI_H
+#define PCI_H
+
+#include "kernel.h"
+
+// Конфігураційний простір PCI через порти 0xCF8/0xCFC (механізм #1)
+#define PCI_CONFIG_ADDRESS      0xCF8
+#define PCI_CONFIG_DATA         0xCFC
+
+#define PCI_MAX_DEVICES         32
+#define PCI_BAR_COUNT           6
+
+// Зміщення в заголовку конфігураційного простору
+#define PCI_VENDOR_ID           0x00
+#define PCI_DEVICE_ID           0x02
+#define PCI_COMMAND             0x04
+#define PCI_STATUS              0x06
+#define PCI_REVISION            0x08
+#define PCI_PROG_IF             0x09
+#define PCI_SUBCLASS            0x0A
+#define PCI_CLASS               0x0B
+#define PCI_HEADER_TYPE         0x0E
+#define PCI_BAR0                0x10
+#define PCI_SECONDARY_BUS       0x19
+#define PCI_SUBSYSTEM_ID        0x2E
+#define PCI_CAPABILITIES        0x34
+#define PCI_INTERRUPT_LINE      0x3C
+#define PCI_INTERRUPT_PIN       0x3D
+
+#define PCI_COMMAND_IO          0x0001
+#define PCI_COMMAND_MEMORY      0x0002
+#define PCI_COMMAND_BUS_MASTER  0x0004
+#define PCI_COMMAND_INTX_OFF    0x0400
+
+#define PCI_STATUS_CAPABILITIES 0x0010
+#define PCI_HEADER_MULTIFUNCTION 0x80
+#define PCI_HEADER_BRIDGE       0x01
+
+// Клас мосту PCI-PCI
+#define PCI_CLASS_BRIDGE        0x06
+#define PCI_SUBCLASS_PCI_BRIDGE 0x04
+
+// Ідентифікатори можливостей
+#define PCI_CAP_MSI             0x05
+#define PCI_CAP_VENDOR          0x09
+#define PCI_CAP_MSIX            0x11
+
+// MSI-X: регістр керування та записи таблиці (по 16 байт)
+#define PCI_MSIX_CONTROL        0x02
+#define PCI_MSIX_TABLE          0x04
+#define PCI_MSIX_ENABLE         0x8000
+#define PCI_MSIX_FUNCTION_MASK  0x4000
+#define PCI_MSIX_SIZE_MASK      0x07FF
+#define PCI_MSIX_ENTRY_SIZE     16
+#define PCI_MSIX_VECTOR_MASKED  0x1
+
+// Повідомлення MSI адресується локальному APIC
+#define PCI_MSI_ADDRESS_BASE    0xFEE00000
+
+// Типи BAR
+#define PCI_BAR_IO              0x01
+#define PCI_BAR_MEM64           0x02
+#define PCI_BAR_PREFETCH        0x04
+
+typedef struct {
+    uint64_t base;                  // фізична адреса або порт
+    uint64_t size;                  // 0 - BAR не реалізований
+    uint32_t flags;
+} pci_bar_t;
+
+typedef struct {
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t function;
+    uint8_t header_type;
+    uint16_t vendor;
+    uint16_t device;
+    uint16_t subsystem;
+    uint8_t class_code;
+    uint8_t subclass;
+    uint8_t prog_if;
+    uint8_t revision;
+    uint8_t irq_line;
+    uint8_t irq_pin;
+    pci_bar_t bar[PCI_BAR_COUNT];
+} pci_device_t;
+
+// Таблиця MSI-X пристрою, відображена як некешована пам'ять
+typedef struct {
+    pci_device_t* device;
+    uint8_t cap;
+    uint16_t entries;
+    volatile uint32_t* table;
+} pci_msix_t;
+
+// Обхід шини 0 і шин за мостами PCI-PCI; розміри BAR
+int pci_init(void);
+uint32_t pci_device_count(void);
+pci_device_t* pci_get(uint32_t index);
+
+// index-й пристрій з vendor:device (0 - перший)
+pci_device_t* pci_find(uint16_t vendor, uint16_t device, uint32_t index);
+
+// Доступ до конфігураційного простору (зміщення вирівняні за розміром)
+uint32_t pci_read32(const pci_device_t* device, uint8_t offset);
+uint16_t pci_read16(const pci_device_t* device, uint8_t offset);
+uint8_t pci_read8(const pci_device_t* device, uint8_t offset);
+void pci_write32(const pci_device_t* device, uint8_t offset, uint32_t value);
+void pci_write16(const pci_device_t* device, uint8_t offset, uint16_t value);
+
+// Увімкнення декодування пам'яті/портів та bus mastering
+void pci_enable(pci_device_t* device, uint16_t command);
+
+// Зміщення можливості id після start (0 - з початку списку); 0 - немає
+uint8_t pci_find_capability(const pci_device_t* device, uint8_t id, uint8_t start);
+
+// Відображення BAR пам'яті як некешованої MMIO; NULL - порти або поза 4 ГБ
+void* pci_map_bar(pci_device_t* device, uint32_t bar);
+
+// MSI-X: запис entry надсилає vector процесору apic_id
+int pci_msix_init(pci_device_t* device, pci_msix_t* msix);
+int pci_msix_route(pci_msix_t* msix, uint16_t entry, uint8_t vector, uint32_t apic_id);
+void pci_msix_enable(pci_msix_t* msix);
+
+// Команда lspci
+void pci_print_devices(void);
+
+#endif
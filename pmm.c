@@ -0,0 +1,483 @@
+#include "pmm.h"
+#include "multiboot.h"
+#include "timer.h"
+
+// Кінець образу ядра з linker.ld
+extern char end[];
+
+// Стан кожного фізичного кадру (1 байт на сторінку)
+#define PMM_FRAME_FREE      0x80    // голова вільного блоку, молодші біти - порядок
+#define PMM_FRAME_RESERVED  0x40    // кадр не керується алокатором
+#define PMM_ORDER_MASK      0x0F
+
+// Вузол вільного списку зберігається прямо у вільній сторінці
+struct pmm_block {
+    struct pmm_block* next;
+    struct pmm_block* prev;
+};
+
+// Зарезервовані ділянки, які не можна віддавати
+#define PMM_MAX_RESERVED    12
+
+struct pmm_range {
+    uintptr_t start;
+    uintptr_t end;
+};
+
+static uint8_t* frame_state = NULL;
+static uint32_t frame_count = 0;
+static uint32_t frames_total = 0;
+static uint32_t frames_free = 0;
+
+static struct pmm_block* free_lists[PMM_MAX_ORDER + 1];
+static uint32_t free_blocks[PMM_MAX_ORDER + 1];
+
+static struct pmm_range reserved[PMM_MAX_RESERVED];
+static int reserved_count = 0;
+
+// Алокатор спільний для всіх процесорів
+static spinlock_t pmm_lock = SPINLOCK_INIT;
+
+// === ВНУТРІШНІ ФУНКЦІЇ ===
+
+static inline uintptr_t align_up(uintptr_t value, uintptr_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+static inline struct pmm_block* frame_block(uint32_t index) {
+    return (struct pmm_block*)((uintptr_t)index << PAGE_SHIFT);
+}
+
+static inline uint32_t block_frame(struct pmm_block* block) {
+    return (uint32_t)((uintptr_t)block >> PAGE_SHIFT);
+}
+
+static void list_push(uint32_t index, uint32_t order) {
+    struct pmm_block* block = frame_block(index);
+    block->prev = NULL;
+    block->next = free_lists[order];
+    if (free_lists[order]) {
+        free_lists[order]->prev = block;
+    }
+    free_lists[order] = block;
+    free_blocks[order]++;
+    frame_state[index] = PMM_FRAME_FREE | order;
+}
+
+static void list_remove(uint32_t index, uint32_t order) {
+    struct pmm_block* block = frame_block(index);
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        free_lists[order] = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+    free_blocks[order]--;
+    frame_state[index] = 0;
+}
+
+// Звільнення блоку з об'єднанням із сусідами-"близнюками"
+static void free_block(uint32_t index, uint32_t order) {
+    frames_free += 1u << order;
+
+    while (order < PMM_MAX_ORDER) {
+        uint32_t buddy = index ^ (1u << order);
+        if (buddy >= frame_count || frame_state[buddy] != (PMM_FRAME_FREE | order)) {
+            break;
+        }
+        list_remove(buddy, order);
+        index &= ~(1u << order);
+        order++;
+    }
+
+    list_push(index, order);
+}
+
+// Розбиває [start, end) кадрів на максимальні вирівняні блоки
+static void free_range(uint32_t start, uint32_t end) {
+    while (start < end) {
+        uint32_t order = 0;
+        while (order < PMM_MAX_ORDER &&
+               (start & ((2u << order) - 1)) == 0 &&
+               start + (2u << order) <= end) {
+            order++;
+        }
+        free_block(start, order);
+        start += 1u << order;
+    }
+}
+
+// Додає доступні кадри, оминаючи зарезервовані ділянки
+static void add_available(uint32_t start, uint32_t end, int first_reserved) {
+    for (int i = first_reserved; i < reserved_count; i++) {
+        uint32_t rs = reserved[i].start >> PAGE_SHIFT;
+        uint32_t re = align_up(reserved[i].end, PAGE_SIZE) >> PAGE_SHIFT;
+        if (rs < end && re > start) {
+            if (start < rs) {
+                add_available(start, rs, i + 1);
+            }
+            if (re < end) {
+                add_available(re, end, i + 1);
+            }
+            return;
+        }
+    }
+
+    // Кадри під керуванням алокатора - не RESERVED, включно з внутрішніми
+    // кадрами блоків: інакше pmm_free_frames відкидав би виділені ділянки
+    for (uint32_t i = start; i < end; i++) {
+        frame_state[i] = 0;
+    }
+    frames_total += end - start;
+    free_range(start, end);
+}
+
+static void reserve_range(uintptr_t start, uintptr_t end) {
+    if (end <= start) {
+        return;
+    }
+    // Загублений резерв віддав би алокатору кадри ядра чи initrd
+    if (reserved_count >= PMM_MAX_RESERVED) {
+        kernel_panic("pmm: забагато зарезервованих діапазонів (модулі Multiboot2)");
+    }
+    reserved[reserved_count].start = start;
+    reserved[reserved_count].end = end;
+    reserved_count++;
+}
+
+static int overlaps_reserved(uintptr_t start, uintptr_t end) {
+    for (int i = 0; i < reserved_count; i++) {
+        if (start < reserved[i].end && end > reserved[i].start) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Обрізає регіон до меж, які адресуються вказівником ядра
+static int clip_region(const struct multiboot_mmap_entry* entry, uintptr_t* start, uintptr_t* end) {
+    uint64_t region_start = entry->addr;
+    uint64_t region_end = entry->addr + entry->len;
+    uint64_t limit = PMM_PHYS_LIMIT;
+
+    if (entry->type != MULTIBOOT_MEMORY_AVAILABLE || region_start >= limit) {
+        return false;
+    }
+    if (region_end > limit) {
+        region_end = limit;
+    }
+
+    *start = align_up((uintptr_t)region_start, PAGE_SIZE);
+    *end = (uintptr_t)region_end & ~(uintptr_t)(PAGE_SIZE - 1);
+    return *end > *start;
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int pmm_init(void) {
+    struct multiboot_tag_mmap* mmap = (struct multiboot_tag_mmap*)multiboot_find_tag(MULTIBOOT_TAG_TYPE_MMAP);
+    if (!mmap) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    uintptr_t entries = (uintptr_t)mmap->entries;
+    uintptr_t entries_end = (uintptr_t)mmap + mmap->size;
+    uintptr_t start, stop;
+
+    // Нижня пам'ять, ядро та структура Multiboot2 недоторкані
+    reserved_count = 0;
+    reserve_range(0, (uintptr_t)end);
+    reserve_range(multiboot_info_start(), multiboot_info_end());
+    // Модулі GRUB (initrd) читаються прямо з місця завантаження
+    struct multiboot_tag* tag = NULL;
+    while ((tag = multiboot_next_tag(tag, MULTIBOOT_TAG_TYPE_MODULE))) {
+        struct multiboot_tag_module* module = (struct multiboot_tag_module*)tag;
+        reserve_range(module->mod_start, module->mod_end);
+    }
+
+    // Найвища доступна адреса визначає розмір масиву станів
+    uintptr_t highest = 0;
+    for (uintptr_t p = entries; p + mmap->entry_size <= entries_end; p += mmap->entry_size) {
+        if (clip_region((struct multiboot_mmap_entry*)p, &start, &stop) && stop > highest) {
+            highest = stop;
+        }
+    }
+    if (highest <= PMM_LOW_MEMORY_END) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    frame_count = highest >> PAGE_SHIFT;
+    uintptr_t state_size = align_up(frame_count, PAGE_SIZE);
+
+    // Масив станів кладемо в першу доступну ділянку, що не перетинає резерв
+    frame_state = NULL;
+    for (uintptr_t p = entries; p + mmap->entry_size <= entries_end && !frame_state; p += mmap->entry_size) {
+        if (!clip_region((struct multiboot_mmap_entry*)p, &start, &stop)) {
+            continue;
+        }
+        for (uintptr_t candidate = start; candidate + state_size <= stop; candidate += PAGE_SIZE) {
+            if (!overlaps_reserved(candidate, candidate + state_size)) {
+                frame_state = (uint8_t*)candidate;
+                break;
+            }
+        }
+    }
+    if (!frame_state) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    reserve_range((uintptr_t)frame_state, (uintptr_t)frame_state + state_size);
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        frame_state[i] = PMM_FRAME_RESERVED;
+    }
+    for (uint32_t i = 0; i <= PMM_MAX_ORDER; i++) {
+        free_lists[i] = NULL;
+        free_blocks[i] = 0;
+    }
+    frames_total = 0;
+    frames_free = 0;
+
+    for (uintptr_t p = entries; p + mmap->entry_size <= entries_end; p += mmap->entry_size) {
+        if (clip_region((struct multiboot_mmap_entry*)p, &start, &stop)) {
+            add_available(start >> PAGE_SHIFT, stop >> PAGE_SHIFT, 0);
+        }
+    }
+
+    return SUCCESS;
+}
+
+// === ВИДІЛЕННЯ ТА ЗВІЛЬНЕННЯ ===
+
+// Викликається під pmm_lock
+static uintptr_t alloc_order_locked(uint32_t order) {
+    uint32_t current = order;
+    while (current <= PMM_MAX_ORDER && !free_lists[current]) {
+        current++;
+    }
+    if (current > PMM_MAX_ORDER) {
+        return 0;
+    }
+
+    uint32_t index = block_frame(free_lists[current]);
+    list_remove(index, current);
+
+    // Розщеплюємо більший блок, повертаючи верхні половини у списки
+    while (current > order) {
+        current--;
+        list_push(index + (1u << current), current);
+    }
+
+    frames_free -= 1u << order;
+    return (uintptr_t)index << PAGE_SHIFT;
+}
+
+uintptr_t pmm_alloc_order(uint32_t order) {
+    if (order > PMM_MAX_ORDER) {
+        return 0;
+    }
+    unsigned long flags = spin_lock_irqsave(&pmm_lock);
+    uintptr_t addr = alloc_order_locked(order);
+    spin_unlock_irqrestore(&pmm_lock, flags);
+    return addr;
+}
+
+void pmm_free_order(uintptr_t addr, uint32_t order) {
+    uint32_t index = addr >> PAGE_SHIFT;
+    unsigned long flags = spin_lock_irqsave(&pmm_lock);
+    if (order <= PMM_MAX_ORDER && index < frame_count && (index & ((1u << order) - 1)) == 0 &&
+        !(frame_state[index] & (PMM_FRAME_FREE | PMM_FRAME_RESERVED))) {
+        free_block(index, order);
+    }
+    spin_unlock_irqrestore(&pmm_lock, flags);
+}
+
+uintptr_t pmm_alloc_frame(void) {
+    unsigned long flags = spin_lock_irqsave(&pmm_lock);
+
+    // Швидкий шлях: готовий блок порядку 0
+    uintptr_t addr;
+    struct pmm_block* block = free_lists[0];
+    if (block) {
+        list_remove(block_frame(block), 0);
+        frames_free--;
+        addr = (uintptr_t)block;
+    } else {
+        addr = alloc_order_locked(0);
+    }
+
+    spin_unlock_irqrestore(&pmm_lock, flags);
+    return addr;
+}
+
+void pmm_free_frame(uintptr_t addr) {
+    pmm_free_order(addr, 0);
+}
+
+// Викликається під pmm_lock
+static uintptr_t alloc_frames_locked(size_t count) {
+    uint32_t order = 0;
+    while ((1u << order) < count) {
+        order++;
+    }
+    if (order > PMM_MAX_ORDER) {
+        return 0;
+    }
+
+    uintptr_t addr = alloc_order_locked(order);
+
+    // Хвіст понад запитану кількість одразу повертаємо
+    if (addr && count < (1u << order)) {
+        uint32_t index = addr >> PAGE_SHIFT;
+        free_range(index + count, index + (1u << order));
+    }
+    return addr;
+}
+
+// Викликається під pmm_lock
+static void free_frames_locked(uint32_t index, size_t count) {
+    for (uint32_t i = index; i < index + count; i++) {
+        if (frame_state[i] & (PMM_FRAME_FREE | PMM_FRAME_RESERVED)) {
+            return;
+        }
+    }
+    free_range(index, index + count);
+}
+
+uintptr_t pmm_alloc_frames(size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    unsigned long flags = spin_lock_irqsave(&pmm_lock);
+    uintptr_t addr = alloc_frames_locked(count);
+    spin_unlock_irqrestore(&pmm_lock, flags);
+    return addr;
+}
+
+void pmm_free_frames(uintptr_t addr, size_t count) {
+    uint32_t index = addr >> PAGE_SHIFT;
+    if (count == 0 || index + count > frame_count) {
+        return;
+    }
+
+    unsigned long flags = spin_lock_irqsave(&pmm_lock);
+    free_frames_locked(index, count);
+    spin_unlock_irqrestore(&pmm_lock, flags);
+}
+
+// === СТАТИСТИКА ===
+
+uintptr_t pmm_memory_end(void) {
+    return (uintptr_t)frame_count << PAGE_SHIFT;
+}
+
+void pmm_get_stats(pmm_stats_t* stats) {
+    stats->total_frames = frames_total;
+    stats->free_frames = frames_free;
+    for (uint32_t i = 0; i <= PMM_MAX_ORDER; i++) {
+        stats->free_blocks[i] = free_blocks[i];
+    }
+}
+
+void pmm_print_stats(void) {
+    terminal_writestring("Фізична пам'ять: ");
+    terminal_writeuint(frames_free);
+    terminal_writestring(" вільних сторінок з ");
+    terminal_writeuint(frames_total);
+    terminal_writestring(" (");
+    terminal_writeuint(((uint64_t)frames_free * PAGE_SIZE) >> 20);
+    terminal_writestring(" МБ вільно)\n");
+
+    terminal_writestring("Вільні блоки за порядками:");
+    for (uint32_t i = 0; i <= PMM_MAX_ORDER; i++) {
+        terminal_writestring(" ");
+        terminal_writeuint(free_blocks[i]);
+    }
+    terminal_writestring("\n");
+}
+
+// === САМОПЕРЕВІРКА ===
+
+// Ділянки зі степенями двійки, хвостами та неповними блоками
+static const uint8_t selftest_counts[] = { 1, 2, 3, 5, 16, 33 };
+#define PMM_SELFTEST_RUNS   (sizeof(selftest_counts) / sizeof(selftest_counts[0]))
+
+// Виділення та звільнення під одним захопленням pmm_lock: frames_free має
+// повернутися до початкового значення, інакше звільнення загубило кадри
+static int pmm_selftest(uint32_t* lost) {
+    uintptr_t frames[PMM_SELFTEST_RUNS];
+    unsigned long flags = spin_lock_irqsave(&pmm_lock);
+    uint32_t before = frames_free;
+    for (uint32_t i = 0; i < PMM_SELFTEST_RUNS; i++) {
+        frames[i] = alloc_frames_locked(selftest_counts[i]);
+    }
+    for (uint32_t i = 0; i < PMM_SELFTEST_RUNS; i++) {
+        if (frames[i]) {
+            free_frames_locked(frames[i] >> PAGE_SHIFT, selftest_counts[i]);
+        }
+    }
+    *lost = before - frames_free;
+    spin_unlock_irqrestore(&pmm_lock, flags);
+    return *lost == 0 ? SUCCESS : ERROR_BUFFER_OVERFLOW;
+}
+
+// === БЕНЧМАРК ===
+
+#define PMM_BENCH_FRAMES    4096
+#define PMM_BENCH_RUN       16
+
+static uintptr_t bench_frames[PMM_BENCH_FRAMES];
+
+static void report_rate(const char* label, uint64_t count, uint64_t cycles) {
+    terminal_writestring(label);
+    terminal_writeuint(tsc_per_second(count, cycles));
+    terminal_writestring(" кадрів/с (");
+    terminal_writeuint(div64_u32(cycles, count ? (uint32_t)count : 1, NULL));
+    terminal_writestring(" тактів/кадр)\n");
+}
+
+void pmm_benchmark(void) {
+    uint32_t count = PMM_BENCH_FRAMES;
+    if (count > frames_free / 2) {
+        count = frames_free / 2;
+    }
+    if (count < PMM_BENCH_RUN) {
+        return;
+    }
+
+    // Одиночні сторінки: виділяємо пачку, потім звільняємо
+    uint64_t start = rdtsc();
+    for (uint32_t i = 0; i < count; i++) {
+        bench_frames[i] = pmm_alloc_frame();
+    }
+    uint64_t alloc_cycles = rdtsc() - start;
+
+    start = rdtsc();
+    for (uint32_t i = 0; i < count; i++) {
+        pmm_free_frame(bench_frames[i]);
+    }
+    uint64_t free_cycles = rdtsc() - start;
+
+    // Неперервні ділянки по PMM_BENCH_RUN сторінок
+    uint32_t runs = count / PMM_BENCH_RUN;
+    start = rdtsc();
+    for (uint32_t i = 0; i < runs; i++) {
+        bench_frames[i] = pmm_alloc_frames(PMM_BENCH_RUN);
+    }
+    for (uint32_t i = 0; i < runs; i++) {
+        pmm_free_frames(bench_frames[i], PMM_BENCH_RUN);
+    }
+    uint64_t run_cycles = rdtsc() - start;
+
+    report_rate("PMM alloc 1 стор.:  ", count, alloc_cycles);
+    report_rate("PMM free 1 стор.:   ", count, free_cycles);
+    report_rate("PMM ділянки 16 стор.: ", (uint64_t)runs * PMM_BENCH_RUN, run_cycles);
+
+    uint32_t lost;
+    if (pmm_selftest(&lost) != SUCCESS) {
+        terminal_writestring("PMM: після alloc/free не повернуто кадрів: ");
+        terminal_writeuint(lost);
+        terminal_writestring("\n");
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef PMM_H
+#define PMM_H
+
+#include "kernel.h"
+
+// Розмір фізичної сторінки
+#define PAGE_SIZE           4096
+#define PAGE_SHIFT          12
+
+// Buddy-алокатор: блоки від 1 сторінки (порядок 0) до 4 МБ (порядок 10)
+#define PMM_MAX_ORDER       10
+
+// Вище цієї адреси - віртуальні області VMM та MMIO, RAM там не керуємо
+#define PMM_PHYS_LIMIT      0xC0000000
+
+// Нижній 1 МБ не віддаємо: BIOS, VGA, майбутній трамплін для AP
+#define PMM_LOW_MEMORY_END  0x100000
+
+// Статистика фізичної пам'яті
+typedef struct {
+    uint32_t total_frames;
+    uint32_t free_frames;
+    uint32_t free_blocks[PMM_MAX_ORDER + 1];
+} pmm_stats_t;
+
+// Ініціалізація з карти пам'яті Multiboot2
+int pmm_init(void);
+
+// Виділення та звільнення однієї сторінки
+uintptr_t pmm_alloc_frame(void);
+void pmm_free_frame(uintptr_t addr);
+
+// Блоки розміром 2^order сторінок, вирівняні на свій розмір
+uintptr_t pmm_alloc_order(uint32_t order);
+void pmm_free_order(uintptr_t addr, uint32_t order);
+
+// Неперервні ділянки довільної кількості сторінок
+uintptr_t pmm_alloc_frames(size_t count);
+void pmm_free_frames(uintptr_t addr, size_t count);
+
+// Кінець найвищого доступного регіону RAM
+uintptr_t pmm_memory_end(void);
+
+// Статистика та звіти
+void pmm_get_stats(pmm_stats_t* stats);
+void pmm_print_stats(void);
+void pmm_benchmark(void);
+
+#endif
@@ -0,0 +1,726 @@
+#include "ramfs.h"
+#include "multiboot.h"
+#include "heap.h"
+#include "pmm.h"
+#include "string.h"
+#include "timer.h"
+
+// Заголовок ustar: 512-байтний блок перед даними кожного запису
+#define TAR_BLOCK           512
+
+struct tar_header {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char padding[12];
+} __attribute__((packed));
+
+#define TAR_TYPE_FILE       '0'
+#define TAR_TYPE_FILE_OLD   '\0'
+#define TAR_TYPE_DIR        '5'
+
+static int mounted = false;
+static const uint8_t* image_start;
+static size_t image_size;
+
+static kmem_cache_t* node_cache;
+static ramfs_node_t* root;
+
+// Хеш-таблиця повних шляхів, кількість кошиків - степінь двійки
+static ramfs_node_t** buckets;
+static uint32_t bucket_count;
+static uint32_t bucket_pages;
+
+// Статистика
+static uint32_t files = 0;
+static uint32_t directories = 0;
+static uint64_t file_bytes = 0;
+static uint32_t skipped_entries = 0;
+
+// === ШЛЯХИ ===
+
+// FNV-1a
+static uint32_t path_hash(const char* path, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)path[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Канонічний шлях без '/' на початку та в кінці, без "." і ".."; довжина
+// або -1, якщо шлях не вміщується
+static int normalize_path(const char* path, size_t path_length, char* out) {
+    uint32_t length = 0;
+    size_t i = 0;
+    while (i < path_length) {
+        while (i < path_length && path[i] == '/') {
+            i++;
+        }
+        size_t start = i;
+        while (i < path_length && path[i] != '/') {
+            i++;
+        }
+        size_t component = i - start;
+        if (component == 0 || (component == 1 && path[start] == '.')) {
+            continue;
+        }
+        if (component == 2 && path[start] == '.' && path[start + 1] == '.') {
+            // Батьківський каталог; вище кореня піти не можна
+            while (length > 0 && out[length - 1] != '/') {
+                length--;
+            }
+            if (length > 0) {
+                length--;
+            }
+            continue;
+        }
+        if (length + (length > 0) + component >= RAMFS_PATH_MAX) {
+            return -1;
+        }
+        if (length > 0) {
+            out[length++] = '/';
+        }
+        memcpy(out + length, path + start, component);
+        length += component;
+    }
+    out[length] = '\0';
+    return (int)length;
+}
+
+static ramfs_node_t* find_node(const char* path, uint32_t length, uint32_t hash) {
+    for (ramfs_node_t* node = buckets[hash & (bucket_count - 1)]; node; node = node->hash_next) {
+        if (node->hash == hash && node->path_length == length && memcmp(node->path, path, length) == 0) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+// === ПОБУДОВА ДЕРЕВА ===
+
+static ramfs_node_t* create_node(const char* path, uint32_t length, uint32_t hash, ramfs_node_t* parent, uint32_t type) {
+    ramfs_node_t* node = kmem_cache_alloc(node_cache);
+    char* copy = kmalloc(length + 1);
+    if (!node || !copy) {
+        if (node) {
+            kmem_cache_free(node_cache, node);
+        }
+        if (copy) {
+            kfree(copy);
+        }
+        return NULL;
+    }
+    memcpy(copy, path, length);
+    copy[length] = '\0';
+
+    memset(node, 0, sizeof(*node));
+    node->path = copy;
+    node->name = copy;
+    for (uint32_t i = length; i > 0; i--) {
+        if (copy[i - 1] == '/') {
+            node->name = copy + i;
+            break;
+        }
+    }
+    node->path_length = length;
+    node->hash = hash;
+    node->type = type;
+    node->mode = type == RAMFS_DIR ? 0755 : 0644;
+    node->parent = parent;
+
+    uint32_t index = hash & (bucket_count - 1);
+    node->hash_next = buckets[index];
+    buckets[index] = node;
+
+    if (parent) {
+        if (parent->last_child) {
+            parent->last_child->next_sibling = node;
+        } else {
+            parent->first_child = node;
+        }
+        parent->last_child = node;
+        parent->children++;
+    }
+    if (type == RAMFS_DIR) {
+        directories++;
+    } else {
+        files++;
+    }
+    return node;
+}
+
+// Вузол для канонічного шляху; відсутні батьківські каталоги створюються
+static ramfs_node_t* get_node(const char* path, uint32_t length, uint32_t type) {
+    uint32_t hash = path_hash(path, length);
+    ramfs_node_t* node = find_node(path, length, hash);
+    if (node) {
+        return node->type == type ? node : NULL;
+    }
+
+    uint32_t parent_length = length;
+    while (parent_length > 0 && path[parent_length - 1] != '/') {
+        parent_length--;
+    }
+    if (parent_length > 0) {
+        parent_length--;
+    }
+    ramfs_node_t* parent = get_node(path, parent_length, RAMFS_DIR);
+    if (!parent) {
+        return NULL;
+    }
+    return create_node(path, length, hash, parent, type);
+}
+
+// Числові поля ustar - вісімкові ASCII, іноді з пробілами попереду
+static uint64_t parse_octal(const char* field, size_t size) {
+    uint64_t value = 0;
+    size_t i = 0;
+    while (i < size && field[i] == ' ') {
+        i++;
+    }
+    for (; i < size && field[i] >= '0' && field[i] <= '7'; i++) {
+        value = value * 8 + (uint64_t)(field[i] - '0');
+    }
+    return value;
+}
+
+static int header_valid(const struct tar_header* header) {
+    const uint8_t* bytes = (const uint8_t*)header;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < TAR_BLOCK; i++) {
+        // Поле контрольної суми рахується як пробіли
+        if (i >= 148 && i < 156) {
+            sum += ' ';
+        } else {
+            sum += bytes[i];
+        }
+    }
+    return sum == parse_octal(header->checksum, sizeof(header->checksum));
+}
+
+static size_t field_length(const char* field, size_t size) {
+    size_t length = 0;
+    while (length < size && field[length]) {
+        length++;
+    }
+    return length;
+}
+
+// Кількість заголовків - для розміру хеш-таблиці до побудови дерева
+static uint32_t count_entries(void) {
+    uint32_t count = 0;
+    size_t offset = 0;
+    while (offset + TAR_BLOCK <= image_size) {
+        const struct tar_header* header = (const struct tar_header*)(image_start + offset);
+        if (!header->name[0] || !header_valid(header)) {
+            break;
+        }
+        uint64_t size = parse_octal(header->size, sizeof(header->size));
+        offset += TAR_BLOCK + (size_t)((size + TAR_BLOCK - 1) & ~(uint64_t)(TAR_BLOCK - 1));
+        count++;
+    }
+    return count;
+}
+
+static int build_tree(void) {
+    char raw[RAMFS_PATH_MAX + 1];
+    char path[RAMFS_PATH_MAX];
+    size_t offset = 0;
+
+    while (offset + TAR_BLOCK <= image_size) {
+        const struct tar_header* header = (const struct tar_header*)(image_start + offset);
+        // Кінець архіву - нульовий блок
+        if (!header->name[0]) {
+            break;
+        }
+        if (!header_valid(header)) {
+            return ERROR_INVALID_INPUT;
+        }
+        uint64_t size = parse_octal(header->size, sizeof(header->size));
+        size_t data = offset + TAR_BLOCK;
+        if (size > image_size - data) {
+            return ERROR_INVALID_INPUT;
+        }
+        offset = data + (size_t)((size + TAR_BLOCK - 1) & ~(uint64_t)(TAR_BLOCK - 1));
+
+        int type = 0;
+        if (header->typeflag == TAR_TYPE_FILE || header->typeflag == TAR_TYPE_FILE_OLD) {
+            type = RAMFS_FILE;
+        } else if (header->typeflag == TAR_TYPE_DIR) {
+            type = RAMFS_DIR;
+        } else {
+            // Посилання, пристрої та розширені заголовки не підтримуються
+            skipped_entries++;
+            continue;
+        }
+
+        // Повне ім'я ustar: prefix/name
+        size_t prefix_length = field_length(header->prefix, sizeof(header->prefix));
+        size_t name_length = field_length(header->name, sizeof(header->name));
+        size_t raw_length = 0;
+        if (prefix_length) {
+            memcpy(raw, header->prefix, prefix_length);
+            raw[prefix_length] = '/';
+            raw_length = prefix_length + 1;
+        }
+        memcpy(raw + raw_length, header->name, name_length);
+        raw_length += name_length;
+
+        int length = normalize_path(raw, raw_length, path);
+        if (length <= 0) {
+            skipped_entries++;
+            continue;
+        }
+        ramfs_node_t* node = get_node(path, (uint32_t)length, (uint32_t)type);
+        if (!node) {
+            skipped_entries++;
+            continue;
+        }
+        node->mode = (uint32_t)parse_octal(header->mode, sizeof(header->mode)) & 07777;
+        node->mtime = parse_octal(header->mtime, sizeof(header->mtime));
+        if (type == RAMFS_FILE) {
+            file_bytes += size - node->extent.length;
+            node->extent.start = image_start + data;
+            node->extent.length = (size_t)size;
+        }
+    }
+    return SUCCESS;
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+// Усі вузли є в ланцюжках кошиків: звільняємо їх, потім самі кошики
+static void free_tree(void) {
+    for (uint32_t i = 0; i < bucket_count; i++) {
+        ramfs_node_t* node = buckets[i];
+        while (node) {
+            ramfs_node_t* next = node->hash_next;
+            kfree((void*)node->path);
+            kmem_cache_free(node_cache, node);
+            node = next;
+        }
+    }
+    pmm_free_frames((uintptr_t)buckets, bucket_pages);
+    buckets = NULL;
+    root = NULL;
+    files = 0;
+    directories = 0;
+    file_bytes = 0;
+    skipped_entries = 0;
+}
+
+static struct multiboot_tag_module* find_initrd(void) {
+    struct multiboot_tag_module* first = NULL;
+    struct multiboot_tag* tag = NULL;
+    while ((tag = multiboot_next_tag(tag, MULTIBOOT_TAG_TYPE_MODULE))) {
+        struct multiboot_tag_module* module = (struct multiboot_tag_module*)tag;
+        if (strcmp(module->cmdline, RAMFS_MODULE_NAME) == 0) {
+            return module;
+        }
+        if (!first) {
+            first = module;
+        }
+    }
+    return first;
+}
+
+int ramfs_init(void) {
+    struct multiboot_tag_module* module = find_initrd();
+    if (!module || module->mod_end <= module->mod_start) {
+        return ERROR_INVALID_INPUT;
+    }
+    image_start = (const uint8_t*)(uintptr_t)module->mod_start;
+    image_size = module->mod_end - module->mod_start;
+
+    // Кошиків удвічі більше за записи: ланцюжки в середньому коротші за 1
+    uint32_t entries = count_entries();
+    if (entries == 0) {
+        return ERROR_INVALID_INPUT;
+    }
+    bucket_count = RAMFS_MIN_BUCKETS;
+    while (bucket_count < entries * 2) {
+        bucket_count <<= 1;
+    }
+    bucket_pages = (bucket_count * sizeof(ramfs_node_t*) + PAGE_SIZE - 1) / PAGE_SIZE;
+    buckets = (ramfs_node_t**)pmm_alloc_frames(bucket_pages);
+    if (!buckets) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    memset(buckets, 0, bucket_pages * PAGE_SIZE);
+
+    if (!node_cache) {
+        node_cache = kmem_cache_create("ramfs_node", sizeof(ramfs_node_t), 8, NULL);
+    }
+    root = node_cache ? create_node("", 0, path_hash("", 0), NULL, RAMFS_DIR) : NULL;
+    if (!root) {
+        pmm_free_frames((uintptr_t)buckets, bucket_pages);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    int result = build_tree();
+    if (result != SUCCESS) {
+        free_tree();
+        return result;
+    }
+    mounted = true;
+    return SUCCESS;
+}
+
+int ramfs_mounted(void) {
+    return mounted;
+}
+
+// === ПОШУК ТА ЧИТАННЯ ===
+
+ramfs_node_t* ramfs_lookup(const char* path) {
+    if (!mounted) {
+        return NULL;
+    }
+    char canonical[RAMFS_PATH_MAX];
+    int length = normalize_path(path, strlen(path), canonical);
+    if (length < 0) {
+        return NULL;
+    }
+    return find_node(canonical, (uint32_t)length, path_hash(canonical, (uint32_t)length));
+}
+
+size_t ramfs_read(const ramfs_node_t* node, size_t offset, size_t length, const void** data) {
+    if (!node || node->type != RAMFS_FILE || offset >= node->extent.length) {
+        *data = NULL;
+        return 0;
+    }
+    size_t available = node->extent.length - offset;
+    *data = node->extent.start + offset;
+    return length < available ? length : available;
+}
+
+size_t ramfs_read_copy(const ramfs_node_t* node, size_t offset, void* buffer, size_t length) {
+    const void* data;
+    size_t count = ramfs_read(node, offset, length, &data);
+    if (count) {
+        memcpy(buffer, data, count);
+    }
+    return count;
+}
+
+// === КОМАНДИ SHELL ===
+
+static ramfs_node_t* lookup_or_report(const char* path) {
+    if (!mounted) {
+        terminal_writestring("Initrd не змонтовано\n");
+        return NULL;
+    }
+    ramfs_node_t* node = ramfs_lookup(path);
+    if (!node) {
+        terminal_writestring("Немає такого файлу або каталогу: ");
+        terminal_writestring(path);
+        terminal_writestring("\n");
+    }
+    return node;
+}
+
+int ramfs_ls(const char* path) {
+    ramfs_node_t* node = lookup_or_report(path);
+    if (!node) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (node->type == RAMFS_FILE) {
+        terminal_writeuint_width(node->extent.length, 10);
+        terminal_writestring("  ");
+        terminal_writestring(node->name);
+        terminal_writestring("\n");
+        return SUCCESS;
+    }
+    for (ramfs_node_t* child = node->first_child; child; child = child->next_sibling) {
+        if (child->type == RAMFS_DIR) {
+            terminal_writestring("     <DIR>  ");
+            terminal_writestring(child->name);
+            terminal_writestring("/\n");
+        } else {
+            terminal_writeuint_width(child->extent.length, 10);
+            terminal_writestring("  ");
+            terminal_writestring(child->name);
+            terminal_writestring("\n");
+        }
+    }
+    return SUCCESS;
+}
+
+int ramfs_cat(const char* path) {
+    ramfs_node_t* node = lookup_or_report(path);
+    if (!node) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (node->type != RAMFS_FILE) {
+        terminal_writestring("Це каталог: ");
+        terminal_writestring(path);
+        terminal_writestring("\n");
+        return ERROR_INVALID_INPUT;
+    }
+    const void* data;
+    size_t length = ramfs_read(node, 0, node->extent.length, &data);
+    terminal_write(data, length);
+    if (length && ((const char*)data)[length - 1] != '\n') {
+        terminal_writestring("\n");
+    }
+    return SUCCESS;
+}
+
+static void write_octal(uint32_t value) {
+    char buffer[12];
+    int i = sizeof(buffer) - 1;
+    buffer[i] = '\0';
+    do {
+        buffer[--i] = (char)('0' + (value & 7));
+        value >>= 3;
+    } while (value && i > 0);
+    terminal_writestring("0");
+    terminal_writestring(buffer + i);
+}
+
+int ramfs_stat(const char* path) {
+    ramfs_node_t* node = lookup_or_report(path);
+    if (!node) {
+        return ERROR_INVALID_INPUT;
+    }
+    terminal_writestring("Шлях: /");
+    terminal_writestring(node->path);
+    terminal_writestring(node->type == RAMFS_DIR ? "\nТип: каталог" : "\nТип: файл");
+    terminal_writestring("\nПрава: ");
+    write_octal(node->mode);
+    terminal_writestring("\nЗмінено (Unix): ");
+    terminal_writeuint(node->mtime);
+    if (node->type == RAMFS_DIR) {
+        terminal_writestring("\nЕлементів: ");
+        terminal_writeuint(node->children);
+    } else {
+        terminal_writestring("\nРозмір: ");
+        terminal_writeuint(node->extent.length);
+        terminal_writestring(" байт\nЕкстент: 0x");
+        char buffer[24];
+        uint64toa((uintptr_t)node->extent.start, buffer, 16);
+        terminal_writestring(buffer);
+        terminal_writestring(" (зсув у initrd ");
+        terminal_writeuint((uintptr_t)(node->extent.start - image_start));
+        terminal_writestring(")");
+    }
+    uint32_t chain = 0;
+    for (ramfs_node_t* other = buckets[node->hash & (bucket_count - 1)]; other; other = other->hash_next) {
+        chain++;
+    }
+    terminal_writestring("\nХеш: 0x");
+    char buffer[24];
+    uint64toa(node->hash, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(", записів у кошику: ");
+    terminal_writeuint(chain);
+    terminal_writestring("\n");
+    return SUCCESS;
+}
+
+// === СТАТИСТИКА ===
+
+void ramfs_print_stats(void) {
+    if (!mounted) {
+        terminal_writestring("Initrd не змонтовано\n");
+        return;
+    }
+    uint32_t used = 0;
+    uint32_t longest = 0;
+    for (uint32_t i = 0; i < bucket_count; i++) {
+        uint32_t chain = 0;
+        for (ramfs_node_t* node = buckets[i]; node; node = node->hash_next) {
+            chain++;
+        }
+        if (chain) {
+            used++;
+        }
+        if (chain > longest) {
+            longest = chain;
+        }
+    }
+    terminal_writestring("Initrd: ");
+    terminal_writeuint(image_size / 1024);
+    terminal_writestring(" КБ за адресою 0x");
+    char buffer[24];
+    uint64toa((uintptr_t)image_start, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring("\nФайлів: ");
+    terminal_writeuint(files);
+    terminal_writestring(" (");
+    terminal_writeuint(file_bytes / 1024);
+    terminal_writestring(" КБ), каталогів: ");
+    terminal_writeuint(directories);
+    terminal_writestring(", пропущено записів: ");
+    terminal_writeuint(skipped_entries);
+    terminal_writestring("\nХеш-таблиця: ");
+    terminal_writeuint(bucket_count);
+    terminal_writestring(" кошиків, зайнято ");
+    terminal_writeuint(used);
+    terminal_writestring(", найдовший ланцюжок ");
+    terminal_writeuint(longest);
+    terminal_writestring("\n");
+}
+
+// === БЕНЧМАРК ===
+
+#define RAMFS_BENCH_ROUNDS  4
+
+// Базовий варіант для порівняння: покомпонентний обхід списків дітей
+static ramfs_node_t* walk_lookup(const char* path) {
+    ramfs_node_t* node = root;
+    while (*path && node) {
+        while (*path == '/') {
+            path++;
+        }
+        const char* end = path;
+        while (*end && *end != '/') {
+            end++;
+        }
+        if (end == path) {
+            break;
+        }
+        size_t length = end - path;
+        ramfs_node_t* child = node->first_child;
+        while (child && (strncmp(child->name, path, length) != 0 || child->name[length])) {
+            child = child->next_sibling;
+        }
+        node = child;
+        path = end;
+    }
+    return node;
+}
+
+// Сума слів - кожен байт файлу справді прочитано
+static uintptr_t sum_words(const void* data, size_t length) {
+    const uintptr_t* words = data;
+    uintptr_t sum = 0;
+    for (size_t i = 0; i < length / sizeof(uintptr_t); i++) {
+        sum += words[i];
+    }
+    return sum;
+}
+
+// ГБ/с з двома знаками після коми
+static void write_gbps(uint64_t bytes, uint64_t cycles) {
+    uint32_t hundredths;
+    uint64_t whole = div64_u32(div64_u32(tsc_per_second(bytes, cycles), 10000000, NULL), 100, &hundredths);
+    terminal_writeuint(whole);
+    terminal_writestring(hundredths < 10 ? ".0" : ".");
+    terminal_writeuint(hundredths);
+    terminal_writestring(" ГБ/с\n");
+}
+
+static void report_ns(const char* label, uint32_t count, uint64_t cycles) {
+    terminal_writestring(label);
+    terminal_writeuint(count ? div64_u32(tsc_cycles_to_ns(cycles), count, NULL) : 0);
+    terminal_writestring(" нс\n");
+}
+
+void ramfs_benchmark(void) {
+    if (!mounted) {
+        terminal_writestring("Initrd не змонтовано\n");
+        return;
+    }
+    ramfs_print_stats();
+
+    // Усі вузли у порядку хеш-таблиці; шляхи з '/' на початку, як у shell
+    uint32_t count = files + directories;
+    uint32_t pages = (count * sizeof(ramfs_node_t*) + PAGE_SIZE - 1) / PAGE_SIZE;
+    ramfs_node_t** nodes = (ramfs_node_t**)pmm_alloc_frames(pages);
+    if (!nodes) {
+        terminal_writestring("Недостатньо пам'яті\n");
+        return;
+    }
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < bucket_count; i++) {
+        for (ramfs_node_t* node = buckets[i]; node && n < count; node = node->hash_next) {
+            nodes[n++] = node;
+        }
+    }
+
+    uint32_t misses = 0;
+    uint64_t start = rdtsc();
+    for (int round = 0; round < RAMFS_BENCH_ROUNDS; round++) {
+        for (uint32_t i = 0; i < n; i++) {
+            misses += ramfs_lookup(nodes[i]->path) != nodes[i];
+        }
+    }
+    uint64_t hash_cycles = rdtsc() - start;
+
+    start = rdtsc();
+    for (uint32_t i = 0; i < n; i++) {
+        misses += walk_lookup(nodes[i]->path) != nodes[i];
+    }
+    uint64_t walk_cycles = rdtsc() - start;
+
+    // Читання всіх файлів: вказівник у модуль проти копії в буфер
+    uint8_t* buffer = (uint8_t*)pmm_alloc_frames(1);
+    uint64_t bytes = 0;
+    uintptr_t sum = 0;
+    start = rdtsc();
+    for (uint32_t i = 0; i < n; i++) {
+        const void* data;
+        for (size_t offset = 0;; offset += PAGE_SIZE) {
+            size_t length = ramfs_read(nodes[i], offset, PAGE_SIZE, &data);
+            if (!length) {
+                break;
+            }
+            sum += sum_words(data, length);
+            bytes += length;
+        }
+    }
+    uint64_t zero_copy_cycles = rdtsc() - start;
+
+    uint64_t copied = 0;
+    start = rdtsc();
+    for (uint32_t i = 0; buffer && i < n; i++) {
+        for (size_t offset = 0;; offset += PAGE_SIZE) {
+            size_t length = ramfs_read_copy(nodes[i], offset, buffer, PAGE_SIZE);
+            if (!length) {
+                break;
+            }
+            sum -= sum_words(buffer, length);
+            copied += length;
+        }
+    }
+    uint64_t copy_cycles = rdtsc() - start;
+
+    terminal_writestring("Пошук (");
+    terminal_writeuint(n);
+    terminal_writestring(" шляхів)\n");
+    report_ns("  хеш-таблиця:      ", n * RAMFS_BENCH_ROUNDS, hash_cycles);
+    report_ns("  обхід каталогів:  ", n, walk_cycles);
+    terminal_writestring("Читання ");
+    terminal_writeuint(bytes / 1024);
+    terminal_writestring(" КБ\n  без копіювання:   ");
+    write_gbps(bytes, zero_copy_cycles);
+    if (buffer) {
+        terminal_writestring("  з копіюванням:    ");
+        write_gbps(copied, copy_cycles);
+    }
+    if (misses || (buffer && sum)) {
+        terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+        terminal_writestring("Помилка: пошук або читання дали різні результати\n");
+    }
+
+    if (buffer) {
+        pmm_free_frames((uintptr_t)buffer, 1);
+    }
+    pmm_free_frames((uintptr_t)nodes, pages);
+}
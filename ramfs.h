@@ -0,0 +1,63 @@
+#ifndef RAMFS_H
+#define RAMFS_H
+
+#include "kernel.h"
+
+// Файлова система в RAM поверх initrd (ustar-архів у модулі Multiboot2).
+// Дані файлів не копіюються: екстент вказує прямо в пам'ять модуля
+
+#define RAMFS_MODULE_NAME       "initrd"
+#define RAMFS_PATH_MAX          256
+#define RAMFS_MIN_BUCKETS       64
+
+#define RAMFS_FILE              1
+#define RAMFS_DIR               2
+
+// Неперервна ділянка даних файлу в пам'яті модуля
+typedef struct {
+    const uint8_t* start;
+    size_t length;
+} ramfs_extent_t;
+
+typedef struct ramfs_node {
+    const char* path;               // повний шлях без початкового '/', корінь - ""
+    const char* name;               // останній компонент усередині path
+    uint32_t path_length;
+    uint32_t hash;
+    uint32_t type;
+    uint32_t mode;
+    uint64_t mtime;
+    ramfs_extent_t extent;
+    uint32_t children;
+
+    struct ramfs_node* parent;
+    struct ramfs_node* first_child;
+    struct ramfs_node* last_child;
+    struct ramfs_node* next_sibling;
+    struct ramfs_node* hash_next;   // ланцюжок кошика хеш-таблиці
+} ramfs_node_t;
+
+// Розбір initrd з модуля "initrd" (або першого модуля); потрібна купа
+int ramfs_init(void);
+int ramfs_mounted(void);
+
+// Пошук за шляхом ("/a/b", "a/b", з "." та ".."); NULL - немає такого
+ramfs_node_t* ramfs_lookup(const char* path);
+
+// Читання без копіювання: *data вказує в пам'ять модуля, повертає кількість
+// доступних байтів від offset (не більше length)
+size_t ramfs_read(const ramfs_node_t* node, size_t offset, size_t length, const void** data);
+
+// Звичайне читання з копіюванням у буфер (для порівняння)
+size_t ramfs_read_copy(const ramfs_node_t* node, size_t offset, void* buffer, size_t length);
+
+// Команди shell
+int ramfs_ls(const char* path);
+int ramfs_cat(const char* path);
+int ramfs_stat(const char* path);
+
+// Статистика та бенчмарк
+void ramfs_print_stats(void);
+void ramfs_benchmark(void);
+
+#endif
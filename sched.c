@@ -0,0 +1,458 @@
+#include "sched.h"
+#include "fpu.h"
+#include "heap.h"
+#include "pmm.h"
+#include "task.h"
+#include "timer.h"
+#include "trace.h"
+
+// Перемикання стеків з kernel.asm
+extern void switch_context(uintptr_t* old_sp, uintptr_t new_sp);
+
+// Черги готових потоків: FIFO на кожен пріоритет + бітова маска непорожніх
+struct run_queue {
+    thread_t* head;
+    thread_t* tail;
+};
+
+static struct run_queue run_queues[SCHED_PRIORITIES];
+static uint32_t ready_bitmap = 0;
+
+static thread_t* current = NULL;
+static thread_t* all_threads = NULL;
+static thread_t* zombie = NULL;
+static kmem_cache_t* thread_cache = NULL;
+static uint32_t next_tid = 0;
+
+static volatile int need_resched = false;
+static timer_event_t slice_timer;
+static uint64_t total_switches = 0;
+
+// === ЧЕРГИ ===
+
+static void enqueue(thread_t* thread) {
+    struct run_queue* queue = &run_queues[thread->priority];
+    thread->run_next = NULL;
+    if (queue->tail) {
+        queue->tail->run_next = thread;
+    } else {
+        queue->head = thread;
+    }
+    queue->tail = thread;
+    ready_bitmap |= 1u << thread->priority;
+}
+
+// O(1): найвищий пріоритет - наймолодший встановлений біт маски
+static thread_t* dequeue_highest(void) {
+    if (ready_bitmap == 0) {
+        return NULL;
+    }
+    uint32_t priority = __builtin_ctz(ready_bitmap);
+    struct run_queue* queue = &run_queues[priority];
+    thread_t* thread = queue->head;
+    queue->head = thread->run_next;
+    if (!queue->head) {
+        queue->tail = NULL;
+        ready_bitmap &= ~(1u << priority);
+    }
+    thread->run_next = NULL;
+    return thread;
+}
+
+// === КВАНТ ЧАСУ ===
+
+static void slice_expired(void* arg) {
+    (void)arg;
+    need_resched = true;
+}
+
+// Квант потрібен лише коли на тому ж пріоритеті хтось чекає - інакше таймер мовчить
+static void update_timeslice(void) {
+    if (ready_bitmap & (1u << current->priority)) {
+        if (slice_timer.heap_index < 0) {
+            timer_arm(&slice_timer, time_now_ns() + SCHED_TIMESLICE_NS);
+        }
+    } else {
+        timer_cancel(&slice_timer);
+    }
+}
+
+// === ПЕРЕМИКАННЯ ===
+
+static void reap_zombie(void) {
+    if (!zombie) {
+        return;
+    }
+    thread_t* dead = zombie;
+    zombie = NULL;
+
+    thread_t** link = &all_threads;
+    while (*link && *link != dead) {
+        link = &(*link)->all_next;
+    }
+    if (*link) {
+        *link = dead->all_next;
+    }
+
+    fpu_thread_free(dead);
+    pmm_free_frames(dead->stack, THREAD_STACK_PAGES);
+    kmem_cache_free(thread_cache, dead);
+}
+
+// Викликається з вимкненими перериваннями
+static void schedule(void) {
+    need_resched = false;
+
+    thread_t* prev = current;
+    if (prev->state == THREAD_RUNNING) {
+        prev->state = THREAD_READY;
+        enqueue(prev);
+    }
+
+    thread_t* next = dequeue_highest();
+    next->state = THREAD_RUNNING;
+    if (next == prev) {
+        update_timeslice();
+        return;
+    }
+
+    uint64_t now = rdtsc();
+    prev->cpu_cycles += now - prev->switched_in;
+    next->switched_in = now;
+    next->switches++;
+    total_switches++;
+
+    // Регістри FPU переходять до next разом з current: секція kernel_fpu між
+    // цими кроками зберегла б стан не того потоку
+    current = next;
+    fpu_switch(prev, next);
+    update_timeslice();
+    if (next->task) {
+        task_switch(next);
+    }
+    trace(TRACE_SCHED_SWITCH, prev->tid, next->tid);
+    switch_context(&prev->sp, next->sp);
+
+    // Сюди повертаємося, коли prev знову отримає процесор
+    reap_zombie();
+}
+
+static void thread_trampoline(void) {
+    reap_zombie();
+    asm volatile("sti");
+    current->entry(current->arg);
+    sched_exit();
+}
+
+// === ПУБЛІЧНИЙ API ===
+
+static void thread_ctor(void* object) {
+    thread_t* thread = object;
+    thread->stack = 0;
+    thread->run_next = NULL;
+    thread->all_next = NULL;
+}
+
+static thread_t* thread_alloc(const char* name, uint32_t priority) {
+    thread_t* thread = kmem_cache_alloc(thread_cache);
+    if (!thread) {
+        return NULL;
+    }
+    if (fpu_thread_init(thread) != SUCCESS) {
+        kmem_cache_free(thread_cache, thread);
+        return NULL;
+    }
+    thread->tid = next_tid++;
+    strncpy(thread->name, name, THREAD_NAME_LEN - 1);
+    thread->name[THREAD_NAME_LEN - 1] = '\0';
+    thread->priority = priority < SCHED_PRIORITIES ? priority : SCHED_PRIO_IDLE;
+    thread->cpu_cycles = 0;
+    thread->switched_in = rdtsc();
+    thread->switches = 0;
+    thread->task = NULL;
+    thread->all_next = all_threads;
+    all_threads = thread;
+    return thread;
+}
+
+static void idle_thread(void* arg) {
+    (void)arg;
+    while (1) {
+        asm volatile("hlt");
+    }
+}
+
+int sched_init(const char* name, uint32_t priority) {
+    thread_cache = kmem_cache_create("thread", sizeof(thread_t), 16, thread_ctor);
+    if (!thread_cache) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    timer_event_init(&slice_timer, slice_expired, NULL);
+
+    // Поточний контекст (kernel_main на стеку з kernel.asm) стає першим потоком
+    thread_t* boot = thread_alloc(name, priority);
+    if (!boot) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    boot->state = THREAD_RUNNING;
+    current = boot;
+
+    if (!thread_create("idle", idle_thread, NULL, SCHED_PRIO_IDLE)) {
+        current = NULL;
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    return SUCCESS;
+}
+
+int sched_active(void) {
+    return current != NULL;
+}
+
+thread_t* sched_current(void) {
+    return current;
+}
+
+thread_t* thread_create(const char* name, thread_entry_t entry, void* arg, uint32_t priority) {
+    if (!thread_cache) {
+        return NULL;
+    }
+    uintptr_t stack = pmm_alloc_frames(THREAD_STACK_PAGES);
+    if (!stack) {
+        return NULL;
+    }
+
+    unsigned long flags = interrupts_save();
+    thread_t* thread = thread_alloc(name, priority);
+    if (!thread) {
+        interrupts_restore(flags);
+        pmm_free_frames(stack, THREAD_STACK_PAGES);
+        return NULL;
+    }
+    thread->stack = stack;
+    thread->entry = entry;
+    thread->arg = arg;
+
+    // Початковий кадр у форматі switch_context: callee-saved регістри, адреса повернення
+    uintptr_t* sp = (uintptr_t*)(stack + THREAD_STACK_PAGES * PAGE_SIZE);
+    *--sp = 0;                                  // фіктивна адреса повернення трампліна
+    *--sp = (uintptr_t)thread_trampoline;
+#ifdef __x86_64__
+    *--sp = 0;                                  // rbp
+    *--sp = 0;                                  // rbx
+    *--sp = 0;                                  // r12
+    *--sp = 0;                                  // r13
+    *--sp = 0;                                  // r14
+    *--sp = 0;                                  // r15
+#else
+    *--sp = 0;                                  // ebp
+    *--sp = 0;                                  // ebx
+    *--sp = 0;                                  // esi
+    *--sp = 0;                                  // edi
+#endif
+    thread->sp = (uintptr_t)sp;
+
+    thread->state = THREAD_READY;
+    enqueue(thread);
+    if (current && thread->priority < current->priority) {
+        need_resched = true;
+    } else if (current && thread->priority == current->priority) {
+        update_timeslice();
+    }
+
+    interrupts_restore(flags);
+    return thread;
+}
+
+void sched_exit(void) {
+    asm volatile("cli");
+    current->state = THREAD_ZOMBIE;
+    zombie = current;
+    schedule();
+    while (1) {
+        asm volatile("hlt");
+    }
+}
+
+void sched_yield(void) {
+    if (!current) {
+        return;
+    }
+    unsigned long flags = interrupts_save();
+    schedule();
+    interrupts_restore(flags);
+}
+
+void sched_block(void) {
+    unsigned long flags = interrupts_save();
+    if (!current) {
+        // Без планувальника просто чекаємо наступного переривання
+        asm volatile("sti; hlt; cli" : : : "memory");
+    } else {
+        current->state = THREAD_BLOCKED;
+        schedule();
+    }
+    interrupts_restore(flags);
+}
+
+void sched_wakeup(thread_t* thread) {
+    if (!thread) {
+        return;
+    }
+    unsigned long flags = interrupts_save();
+    if (thread->state == THREAD_BLOCKED || thread->state == THREAD_SLEEPING) {
+        thread->state = THREAD_READY;
+        enqueue(thread);
+        if (thread->priority < current->priority) {
+            need_resched = true;
+        } else if (thread->priority == current->priority) {
+            update_timeslice();
+        }
+    }
+    interrupts_restore(flags);
+}
+
+static void sleep_expired(void* arg) {
+    sched_wakeup((thread_t*)arg);
+}
+
+void sched_sleep_ns(uint64_t ns) {
+    if (!current) {
+        timer_sleep_ns(ns);
+        return;
+    }
+
+    uint64_t deadline = time_now_ns() + ns;
+    timer_event_t event;
+    timer_event_init(&event, sleep_expired, current);
+
+    // sched_wakeup будить і сплячі потоки (клавіатура, COM1): після раннього
+    // пробудження подію на стеку знято з купи таймерів, спимо до дедлайну далі
+    unsigned long flags = interrupts_save();
+    while (time_now_ns() < deadline) {
+        current->state = THREAD_SLEEPING;
+        if (timer_arm(&event, deadline) != SUCCESS) {
+            current->state = THREAD_RUNNING;
+            break;
+        }
+        schedule();
+        timer_cancel(&event);
+    }
+    interrupts_restore(flags);
+}
+
+void sched_irq_exit(void) {
+    // EOI вже надіслано, переривання вимкнені до iret
+    if (current && need_resched) {
+        schedule();
+    }
+}
+
+// === СТАТИСТИКА ===
+
+int sched_thread_name(uint32_t tid, char* name) {
+    int result = ERROR_INVALID_INPUT;
+    unsigned long flags = interrupts_save();
+    for (thread_t* t = all_threads; t; t = t->all_next) {
+        if (t->tid == tid) {
+            strcpy(name, t->name);
+            result = SUCCESS;
+            break;
+        }
+    }
+    interrupts_restore(flags);
+    return result;
+}
+
+void sched_print_threads(void) {
+    static const char* state_names[] = { "працює", "готовий", "блок.", "спить", "зомбі" };
+
+    if (!current) {
+        terminal_writestring("Планувальник не запущено\n");
+        return;
+    }
+
+    unsigned long flags = interrupts_save();
+    terminal_writestring(" TID Ім'я            Пріор Стан     Перемик.    CPU мс\n");
+    uint64_t now = rdtsc();
+    for (thread_t* t = all_threads; t; t = t->all_next) {
+        uint64_t cycles = t->cpu_cycles + (t == current ? now - t->switched_in : 0);
+        terminal_writeuint_width(t->tid, 4);
+        terminal_writestring(" ");
+        terminal_writestring(t->name);
+        for (size_t pad = strlen(t->name); pad < THREAD_NAME_LEN; pad++) {
+            terminal_putchar(' ');
+        }
+        terminal_writeuint_width(t->priority, 5);
+        terminal_writestring(" ");
+        terminal_writestring(state_names[t->state]);
+        for (size_t pad = strlen(state_names[t->state]); pad < 16; pad++) {
+            terminal_putchar(' ');
+        }
+        terminal_writeuint_width(t->switches, 8);
+        terminal_writeuint_width(div64_u32(tsc_cycles_to_ns(cycles), NS_PER_MS, NULL), 10);
+        terminal_writestring("\n");
+    }
+    terminal_writestring("Всього перемикань: ");
+    terminal_writeuint(total_switches);
+    terminal_writestring("\n");
+    interrupts_restore(flags);
+}
+
+// === БЕНЧМАРК ПЕРЕМИКАННЯ КОНТЕКСТУ ===
+
+#define SCHED_BENCH_ROUNDS  100000
+
+static volatile int bench_running;
+static uint64_t bench_start;
+static uint64_t bench_end;
+static thread_t* bench_waiter;
+
+// Два потоки пінг-понгу: кожен yield віддає процесор іншому
+static void bench_thread(void* arg) {
+    int first = (int)(uintptr_t)arg;
+    if (first) {
+        bench_start = rdtsc();
+    }
+    for (int i = 0; i < SCHED_BENCH_ROUNDS; i++) {
+        sched_yield();
+    }
+    if (first) {
+        bench_end = rdtsc();
+    }
+    if (--bench_running == 0) {
+        sched_wakeup(bench_waiter);
+    }
+}
+
+void sched_benchmark(void) {
+    if (!current) {
+        terminal_writestring("Планувальник не запущено\n");
+        return;
+    }
+
+    bench_waiter = current;
+    bench_running = 2;
+
+    unsigned long flags = interrupts_save();
+    if (!thread_create("bench-a", bench_thread, (void*)1, SCHED_PRIO_HIGH)) {
+        interrupts_restore(flags);
+        terminal_writestring("Не вдалося створити потік\n");
+        return;
+    }
+    if (!thread_create("bench-b", bench_thread, (void*)0, SCHED_PRIO_HIGH)) {
+        bench_running--;
+    }
+    while (bench_running > 0) {
+        current->state = THREAD_BLOCKED;
+        schedule();
+    }
+    interrupts_restore(flags);
+
+    uint64_t switches = 2ull * SCHED_BENCH_ROUNDS;
+    uint64_t cycles = bench_end - bench_start;
+    terminal_writestring("Перемикання контексту: ");
+    terminal_writeuint(tsc_per_second(switches, cycles));
+    terminal_writestring(" перемикань/с, ");
+    terminal_writeuint(div64_u32(cycles, (uint32_t)switches, NULL));
+    terminal_writestring(" тактів/перемикання\n");
+}
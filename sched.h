@@ -0,0 +1,78 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "kernel.h"
+
+// Пріоритети: 0 - найвищий, SCHED_PRIORITIES - 1 - idle
+#define SCHED_PRIORITIES        32
+#define SCHED_PRIO_HIGH         4
+#define SCHED_PRIO_SHELL        8
+#define SCHED_PRIO_DEFAULT      16
+#define SCHED_PRIO_IDLE         (SCHED_PRIORITIES - 1)
+
+// Квант часу для потоків однакового пріоритету
+#define SCHED_TIMESLICE_NS      10000000ull
+
+// Стек потоку: 16 КБ з фізичного алокатора
+#define THREAD_STACK_PAGES      4
+#define THREAD_NAME_LEN         16
+
+typedef enum {
+    THREAD_RUNNING,
+    THREAD_READY,
+    THREAD_BLOCKED,
+    THREAD_SLEEPING,
+    THREAD_ZOMBIE
+} thread_state_t;
+
+typedef void (*thread_entry_t)(void* arg);
+
+typedef struct thread {
+    uintptr_t sp;                   // збережений стек (switch_context)
+    uint32_t tid;
+    char name[THREAD_NAME_LEN];
+    thread_state_t state;
+    uint32_t priority;
+
+    uintptr_t stack;                // 0 для початкового потоку ядра
+    thread_entry_t entry;
+    void* arg;
+
+    struct thread* run_next;        // черга свого пріоритету
+    struct thread* all_next;        // список усіх потоків для ps
+    struct task* task;              // задача кільця 3 (task.c) або NULL
+    void* fpu_state;                // область XSAVE/FXSAVE (fpu.c) або NULL
+    int fpu_used;                   // торкався FPU поза kernel_fpu_begin/end
+
+    // Облік
+    uint64_t cpu_cycles;
+    uint64_t switched_in;
+    uint32_t switches;
+} thread_t;
+
+// Ініціалізація: поточний контекст стає потоком name
+int sched_init(const char* name, uint32_t priority);
+int sched_active(void);
+
+// Керування потоками
+thread_t* thread_create(const char* name, thread_entry_t entry, void* arg, uint32_t priority);
+thread_t* sched_current(void);
+void sched_exit(void);
+
+// Добровільне перемикання, блокування та пробудження
+void sched_yield(void);
+void sched_block(void);
+void sched_wakeup(thread_t* thread);
+void sched_sleep_ns(uint64_t ns);
+
+// Виклик при виході з переривання на BSP (irq_dispatch)
+void sched_irq_exit(void);
+
+// Ім'я живого потоку за tid (для дампу профайлера)
+int sched_thread_name(uint32_t tid, char* name);
+
+// Статистика та бенчмарк
+void sched_print_threads(void);
+void sched_benchmark(void);
+
+#endif
@@ -0,0 +1,278 @@
+#include "serial.h"
+#include "timer.h"
+#include "irq.h"
+
+static int present = false;
+static thread_t* consumer = NULL;
+
+// Передача: виробники - будь-які потоки під замком, споживач - IRQ4
+static char tx_ring[SERIAL_TX_RING_SIZE];
+static uint32_t tx_head = 0;
+static uint32_t tx_tail = 0;
+static int tx_active = false;           // THRE-переривання увімкнене
+static spinlock_t tx_lock = SPINLOCK_INIT;
+
+// Прийом: виробник - IRQ4, споживач - потік shell (SPSC без замка)
+static char rx_ring[SERIAL_RX_RING_SIZE];
+static volatile uint32_t rx_head = 0;
+static volatile uint32_t rx_tail = 0;
+
+// Статистика
+static uint64_t tx_bytes = 0;
+static uint64_t rx_bytes = 0;
+static uint64_t irq_count = 0;
+static uint64_t tx_stalls = 0;          // кільце повне - опитування FIFO
+static uint64_t rx_dropped = 0;
+static uint64_t rx_overruns = 0;
+
+static inline uint8_t uart_read(uint16_t reg) {
+    return inb(SERIAL_COM1 + reg);
+}
+
+static inline void uart_write(uint16_t reg, uint8_t value) {
+    outb(SERIAL_COM1 + reg, value);
+}
+
+int serial_init(void) {
+    // Наявність UART перевіряємо регістром scratch
+    uart_write(UART_SCRATCH, 0xA5);
+    if (uart_read(UART_SCRATCH) != 0xA5) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    uart_write(UART_IER, 0x00);
+    uart_write(UART_LCR, 0x80);                     // DLAB
+    uart_write(UART_DATA, SERIAL_BAUD_DIVISOR & 0xFF);
+    uart_write(UART_IER, SERIAL_BAUD_DIVISOR >> 8);
+    uart_write(UART_LCR, 0x03);                     // 8N1
+    uart_write(UART_FCR, 0xC7);                     // FIFO, очищення, поріг RX 14 байт
+    uart_write(UART_MCR, 0x0B);                     // DTR, RTS, OUT2 (лінія IRQ)
+
+    // Без FIFO (8250/16450) бітів 6-7 в IIR немає - працюємо побайтово
+    if ((uart_read(UART_IIR) & 0xC0) != 0xC0) {
+        uart_write(UART_FCR, 0x00);
+    }
+
+    uart_read(UART_LSR);
+    uart_read(UART_DATA);
+    uart_write(UART_IER, UART_IER_RX | UART_IER_LINE);
+    present = true;
+    return irq_install(IRQ_COM1, "serial", serial_handler, 0);
+}
+
+int serial_present(void) {
+    return present;
+}
+
+void serial_set_consumer(thread_t* thread) {
+    consumer = thread;
+}
+
+// === ПЕРЕДАЧА ===
+
+// Заповнює апаратний FIFO з кільця; викликається під tx_lock
+static void tx_fill_fifo(void) {
+    uint32_t count = 0;
+    while (tx_tail != tx_head && count < UART_FIFO_SIZE) {
+        uart_write(UART_DATA, tx_ring[tx_tail & (SERIAL_TX_RING_SIZE - 1)]);
+        tx_tail++;
+        count++;
+    }
+    tx_bytes += count;
+}
+
+static void tx_push(char c) {
+    // Кільце повне: чекаємо на FIFO опитуванням, переривання тут не допоможе
+    if (tx_head - tx_tail == SERIAL_TX_RING_SIZE) {
+        tx_stalls++;
+        while (!(uart_read(UART_LSR) & UART_LSR_THRE)) {
+            asm volatile("pause");
+        }
+        tx_fill_fifo();
+    }
+    tx_ring[tx_head & (SERIAL_TX_RING_SIZE - 1)] = c;
+    tx_head++;
+}
+
+void serial_write(const char* data, size_t size) {
+    if (!present || size == 0) {
+        return;
+    }
+
+    unsigned long flags = spin_lock_irqsave(&tx_lock);
+    for (size_t i = 0; i < size; i++) {
+        char c = data[i];
+        // Термінал на тому боці чекає CRLF і стирання символу пробілом
+        if (c == '\n') {
+            tx_push('\r');
+        } else if (c == '\b') {
+            tx_push('\b');
+            tx_push(' ');
+        }
+        tx_push(c);
+    }
+
+    // Пакет пішов у кільце - запускаємо передачу, якщо вона стоїть
+    if (!tx_active && (uart_read(UART_LSR) & UART_LSR_THRE)) {
+        tx_fill_fifo();
+    }
+    if (!tx_active && tx_tail != tx_head) {
+        tx_active = true;
+        uart_write(UART_IER, UART_IER_RX | UART_IER_LINE | UART_IER_THRE);
+    }
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+// Синхронне спорожнення (паніка, кінець бенчмарку)
+void serial_flush(void) {
+    if (!present) {
+        return;
+    }
+    unsigned long flags = spin_lock_irqsave(&tx_lock);
+    while (tx_tail != tx_head) {
+        while (!(uart_read(UART_LSR) & UART_LSR_THRE)) {
+            asm volatile("pause");
+        }
+        tx_fill_fifo();
+    }
+    while (!(uart_read(UART_LSR) & UART_LSR_TEMT)) {
+        asm volatile("pause");
+    }
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+// === ПРИЙОМ ===
+
+int serial_read_char(char* c) {
+    uint32_t tail = rx_tail;
+    if (tail == rx_head) {
+        return false;
+    }
+    asm volatile("" : : : "memory");
+    *c = rx_ring[tail & (SERIAL_RX_RING_SIZE - 1)];
+    asm volatile("" : : : "memory");
+    rx_tail = tail + 1;
+    return true;
+}
+
+static void rx_drain(void) {
+    int received = false;
+    uint8_t lsr;
+    while ((lsr = uart_read(UART_LSR)) & UART_LSR_DATA_READY) {
+        if (lsr & UART_LSR_OVERRUN) {
+            rx_overruns++;
+        }
+        char c = (char)uart_read(UART_DATA);
+        uint32_t head = rx_head;
+        if (head - rx_tail < SERIAL_RX_RING_SIZE) {
+            rx_ring[head & (SERIAL_RX_RING_SIZE - 1)] = c;
+            asm volatile("" : : : "memory");
+            rx_head = head + 1;
+            received = true;
+        } else {
+            rx_dropped++;
+        }
+        rx_bytes++;
+    }
+    if (received) {
+        sched_wakeup(consumer);
+    }
+}
+
+// === ОБРОБНИК IRQ4 ===
+
+void serial_handler(irq_frame_t* frame) {
+    (void)frame;
+    irq_count++;
+
+    uint8_t iir;
+    while (!((iir = uart_read(UART_IIR)) & 0x01)) {
+        switch (iir & 0x0E) {
+            case 0x04:              // дані прийнято
+            case 0x0C:              // тайм-аут FIFO прийому
+                rx_drain();
+                break;
+            case 0x02:              // THR порожній
+                spin_lock(&tx_lock);
+                tx_fill_fifo();
+                if (tx_tail == tx_head) {
+                    tx_active = false;
+                    uart_write(UART_IER, UART_IER_RX | UART_IER_LINE);
+                }
+                spin_unlock(&tx_lock);
+                break;
+            case 0x06:              // стан лінії
+                if (uart_read(UART_LSR) & UART_LSR_OVERRUN) {
+                    rx_overruns++;
+                }
+                break;
+            default:                // стан модему
+                uart_read(UART_MSR);
+                break;
+        }
+    }
+}
+
+// === СТАТИСТИКА ===
+
+void serial_print_stats(void) {
+    if (!present) {
+        terminal_writestring("COM1 не знайдено\n");
+        return;
+    }
+    terminal_writestring("COM1: 115200 бод, FIFO ");
+    terminal_writeuint(UART_FIFO_SIZE);
+    terminal_writestring(" байт, кільце TX ");
+    terminal_writeuint(SERIAL_TX_RING_SIZE);
+    terminal_writestring(" байт\nПередано:   ");
+    terminal_writeuint(tx_bytes);
+    terminal_writestring(" байт (очікувань повного кільця: ");
+    terminal_writeuint(tx_stalls);
+    terminal_writestring(")\nПрийнято:   ");
+    terminal_writeuint(rx_bytes);
+    terminal_writestring(" байт (втрачено: ");
+    terminal_writeuint(rx_dropped);
+    terminal_writestring(", переповнень FIFO: ");
+    terminal_writeuint(rx_overruns);
+    terminal_writestring(")\nПереривань: ");
+    terminal_writeuint(irq_count);
+    terminal_writestring("\n");
+}
+
+// === БЕНЧМАРК ПРОПУСКНОЇ ЗДАТНОСТІ ===
+
+void serial_benchmark(uint32_t kilobytes) {
+    if (!present) {
+        terminal_writestring("COM1 не знайдено\n");
+        return;
+    }
+
+    // Рядок із 64 байт разом із переведенням рядка
+    static const char line[] =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\n";
+    uint32_t lines = kilobytes * 1024 / (sizeof(line) - 1);
+    uint64_t stalls_before = tx_stalls;
+
+    serial_flush();
+    uint64_t start = rdtsc();
+    for (uint32_t i = 0; i < lines; i++) {
+        serial_write(line, sizeof(line) - 1);
+    }
+    uint64_t queued = rdtsc();
+    serial_flush();
+    uint64_t end = rdtsc();
+
+    // На лінії кожен \n стає \r\n
+    uint64_t bytes = (uint64_t)lines * sizeof(line);
+    terminal_writestring("Передано ");
+    terminal_writeuint(bytes);
+    terminal_writestring(" байт за ");
+    terminal_writeuint(div64_u32(tsc_cycles_to_ns(end - start), 1000, NULL));
+    terminal_writestring(" мкс\nПропускна здатність: ");
+    terminal_writeuint(tsc_per_second(bytes, end - start));
+    terminal_writestring(" байт/с\nЧас викликача на постановку в чергу: ");
+    terminal_writeuint(div64_u32(queued - start, lines ? lines : 1, NULL));
+    terminal_writestring(" тактів/рядок (очікувань повного кільця: ");
+    terminal_writeuint(tx_stalls - stalls_before);
+    terminal_writestring(")\n");
+}
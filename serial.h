@@ -0,0 +1,57 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "kernel.h"
+#include "sched.h"
+
+// COM1 на IRQ4
+#define SERIAL_COM1             0x3F8
+#define SERIAL_BAUD_DIVISOR     1       // 115200 бод
+
+// Регістри 16550 (зміщення від бази порту)
+#define UART_DATA               0       // RBR/THR, DLL при DLAB
+#define UART_IER                1       // DLM при DLAB
+#define UART_IIR                2       // при читанні
+#define UART_FCR                2       // при записі
+#define UART_LCR                3
+#define UART_MCR                4
+#define UART_LSR                5
+#define UART_MSR                6
+#define UART_SCRATCH            7
+
+#define UART_IER_RX             0x01
+#define UART_IER_THRE           0x02
+#define UART_IER_LINE           0x04
+
+#define UART_LSR_DATA_READY     0x01
+#define UART_LSR_OVERRUN        0x02
+#define UART_LSR_THRE           0x20
+#define UART_LSR_TEMT           0x40
+
+// Глибина апаратного FIFO передавача
+#define UART_FIFO_SIZE          16
+
+// Кільця передачі та прийому (степені двійки)
+#define SERIAL_TX_RING_SIZE     16384
+#define SERIAL_RX_RING_SIZE     256
+
+// Ініціалізація та потік, який будить прийом
+int serial_init(void);
+int serial_present(void);
+void serial_set_consumer(thread_t* thread);
+
+// Передача: запис у кільце, решту доробляє переривання THRE
+void serial_write(const char* data, size_t size);
+void serial_flush(void);
+
+// Прийом поза перериванням
+int serial_read_char(char* c);
+
+// Обробник IRQ4 (irq_dispatch)
+void serial_handler(irq_frame_t* frame);
+
+// Статистика та бенчмарк
+void serial_print_stats(void);
+void serial_benchmark(uint32_t kilobytes);
+
+#endif
@@ -0,0 +1,386 @@
+#include "smp.h"
+#include "acpi.h"
+#include "apic.h"
+#include "irq.h"
+#include "pmm.h"
+#include "vmm.h"
+#include "sched.h"
+#include "timer.h"
+
+// Параметри трампліна (kernel.asm, після копіювання лежать у нижній пам'яті)
+struct trampoline_params {
+    uint32_t cr3;
+    uint32_t cr4;
+    uint32_t stack;
+    uint32_t entry;
+    uint32_t index;
+};
+
+extern uint8_t trampoline_start[];
+extern uint8_t trampoline_end[];
+extern struct trampoline_params trampoline_params;
+
+static uint32_t cpu_count = 1;
+static volatile uint32_t cpus_online = 1;
+
+// Запит shootdown: діапазон спільний, прапорці - в кожного процесора
+static spinlock_t shootdown_lock = SPINLOCK_INIT;
+static volatile uintptr_t shootdown_virt;
+static volatile size_t shootdown_size;
+static volatile uint32_t shootdown_acks;
+
+static inline unsigned long read_cr4(void) {
+    unsigned long value;
+    asm volatile("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+// === ПРОСТІЙ ТА IPI ===
+
+// Виконує очікуваний shootdown; викликається з обробника IPI та з циклів очікування
+static void tlb_poll(cpu_t* cpu) {
+    if (!cpu->tlb_pending) {
+        return;
+    }
+    vmm_flush_local(shootdown_virt, shootdown_size);
+    cpu->tlb_shootdowns++;
+    cpu->tlb_pending = 0;
+    __sync_fetch_and_sub(&shootdown_acks, 1);
+}
+
+// EOI у локальний APIC надсилає irq_dispatch
+void smp_ipi_handler(irq_frame_t* frame) {
+    (void)frame;
+    cpu_t* cpu = this_cpu();
+    cpu->ipis_received++;
+    tlb_poll(cpu);
+}
+
+// Спершу коротко крутимося (дешеве пробудження), потім засинаємо:
+// mwait будить сам запис у work_pending, hlt - лише IPI
+static void ap_idle_loop(cpu_t* cpu) {
+    while (1) {
+        for (int spin = 0; spin < SMP_IDLE_SPIN && !cpu->work_pending; spin++) {
+            asm volatile("pause");
+        }
+
+        if (!cpu->work_pending) {
+            if (cpu->use_mwait) {
+                asm volatile("monitor" : : "a"(&cpu->work_pending), "c"(0), "d"(0));
+                if (!cpu->work_pending) {
+                    asm volatile("mwait" : : "a"(0), "c"(0));
+                }
+            } else {
+                // halted публікується до повторної перевірки - відправник побачить
+                // або роботу не взятою, або прапорець і надішле IPI
+                asm volatile("cli");
+                cpu->halted = 1;
+                __sync_synchronize();
+                if (!cpu->work_pending) {
+                    asm volatile("sti; hlt" : : : "memory");
+                } else {
+                    asm volatile("sti");
+                }
+                cpu->halted = 0;
+            }
+            cpu->idle_wakeups++;
+        }
+
+        if (cpu->work_pending) {
+            cpu->work(cpu->work_arg);
+            cpu->work_done++;
+            __sync_synchronize();
+            cpu->work_pending = 0;
+        }
+    }
+}
+
+void ap_main(uint32_t index) {
+    cpu_t* cpu = &cpus[index];
+    cpu_init(index);
+    cpu_enable_simd();
+    idt_load();
+    vmm_init_cpu();
+    lapic_enable();
+
+    __sync_synchronize();
+    cpu->online = 1;
+    __sync_fetch_and_add(&cpus_online, 1);
+
+    asm volatile("sti");
+    ap_idle_loop(cpu);
+}
+
+// === ЗАПУСК AP ===
+
+static int start_ap(uint32_t index, uint32_t apic_id) {
+    cpu_t* cpu = &cpus[index];
+    uintptr_t stack = pmm_alloc_frames(THREAD_STACK_PAGES);
+    if (!stack) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    cpu->apic_id = apic_id;
+    cpu->stack = stack;
+    cpu->use_mwait = cpus[0].use_mwait;
+
+    // Параметри в копії трампліна, не в образі ядра
+    struct trampoline_params* params = (struct trampoline_params*)(SMP_TRAMPOLINE_BASE +
+        ((uintptr_t)&trampoline_params - (uintptr_t)trampoline_start));
+    params->cr3 = vmm_page_directory();
+    params->cr4 = read_cr4();
+    params->stack = (uint32_t)(stack + THREAD_STACK_PAGES * PAGE_SIZE);
+    params->entry = (uint32_t)(uintptr_t)ap_main;
+    params->index = index;
+    __sync_synchronize();
+
+    // INIT, потім двічі SIPI з вектором сторінки трампліна
+    lapic_send_ipi(apic_id, ICR_INIT | ICR_LEVEL_ASSERT);
+    tsc_delay_us(10000);
+    for (int i = 0; i < 2 && !cpu->online; i++) {
+        lapic_send_ipi(apic_id, ICR_STARTUP | (SMP_TRAMPOLINE_BASE >> PAGE_SHIFT));
+        tsc_delay_us(200);
+    }
+
+    uint64_t deadline = time_now_ns() + SMP_START_TIMEOUT_NS;
+    while (!cpu->online && time_now_ns() < deadline) {
+        asm volatile("pause");
+    }
+    if (!cpu->online) {
+        pmm_free_frames(stack, THREAD_STACK_PAGES);
+        cpu->stack = 0;
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+int smp_init(void) {
+    cpu_t* bsp = &cpus[0];
+    bsp->online = 1;
+
+    bsp->use_mwait = (cpu_features & CPU_FEATURE_MONITOR) != 0;
+
+    if (acpi_init() != SUCCESS) {
+        terminal_writestring("SMP: таблиці ACPI не знайдено, працює лише BSP\n");
+        return ERROR_INVALID_INPUT;
+    }
+    const acpi_madt_info_t* madt = acpi_madt();
+    if (lapic_init(madt->lapic_address) != SUCCESS) {
+        terminal_writestring("SMP: не вдалося відобразити локальний APIC\n");
+        return ERROR_INVALID_INPUT;
+    }
+    bsp->apic_id = lapic_id();
+    irq_register(IPI_WORK_VECTOR, "ipi", smp_ipi_handler, IRQ_FLAG_MPSAFE);
+
+    // Трамплін у нижню пам'ять, яку фізичний алокатор не видає
+    size_t tramp_size = (size_t)(trampoline_end - trampoline_start);
+    uint8_t* dest = (uint8_t*)SMP_TRAMPOLINE_BASE;
+    for (size_t i = 0; i < tramp_size; i++) {
+        dest[i] = trampoline_start[i];
+    }
+
+    // AP запускаються по черзі: у трампліна один блок параметрів
+    for (uint32_t i = 0; i < madt->cpu_count && cpu_count < SMP_MAX_CPUS; i++) {
+        uint32_t apic_id = madt->cpu_apic_ids[i];
+        if (apic_id == bsp->apic_id) {
+            continue;
+        }
+        if (start_ap(cpu_count, apic_id) == SUCCESS) {
+            cpu_count++;
+        } else {
+            terminal_writestring("SMP: процесор APIC ");
+            terminal_writeuint(apic_id);
+            terminal_writestring(" не відповів\n");
+        }
+    }
+
+    terminal_writestring("SMP: ");
+    terminal_writeuint(cpu_count);
+    terminal_writestring(" процесор(ів) онлайн\n");
+    return SUCCESS;
+}
+
+uint32_t smp_cpu_count(void) {
+    return cpu_count;
+}
+
+// === РОБОТА НА ІНШИХ ПРОЦЕСОРАХ ===
+
+int smp_call(uint32_t index, cpu_work_t work, void* arg) {
+    if (index == 0 || index >= cpu_count || !cpus[index].online) {
+        return ERROR_INVALID_INPUT;
+    }
+    cpu_t* cpu = &cpus[index];
+    smp_wait(index);
+
+    cpu->work = work;
+    cpu->work_arg = arg;
+    __sync_synchronize();
+    cpu->work_pending = 1;
+    __sync_synchronize();
+
+    // IPI лише для сплячого в hlt процесора; крутіння та mwait бачать запис самі
+    if (cpu->halted) {
+        lapic_send_ipi(cpu->apic_id, ICR_FIXED | IPI_WORK_VECTOR);
+    }
+    return SUCCESS;
+}
+
+void smp_wait(uint32_t index) {
+    cpu_t* self = this_cpu();
+    while (cpus[index].work_pending) {
+        tlb_poll(self);
+        asm volatile("pause");
+    }
+}
+
+void smp_call_all(cpu_work_t work, void* arg) {
+    for (uint32_t i = 1; i < cpu_count; i++) {
+        smp_call(i, work, arg);
+    }
+    for (uint32_t i = 1; i < cpu_count; i++) {
+        smp_wait(i);
+    }
+}
+
+void smp_tlb_shootdown(uintptr_t virt, size_t size) {
+    if (cpus_online <= 1) {
+        return;
+    }
+    cpu_t* self = this_cpu();
+
+    // Поки чекаємо на замок, обслуговуємо чужі запити - інакше взаємне блокування
+    unsigned long flags = interrupts_save();
+    while (__sync_lock_test_and_set(&shootdown_lock.locked, 1)) {
+        tlb_poll(self);
+        asm volatile("pause");
+    }
+
+    shootdown_virt = virt;
+    shootdown_size = size;
+    shootdown_acks = 0;
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        if (&cpus[i] != self && cpus[i].online) {
+            shootdown_acks++;
+        }
+    }
+    __sync_synchronize();
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        if (&cpus[i] != self && cpus[i].online) {
+            cpus[i].tlb_pending = 1;
+            lapic_send_ipi(cpus[i].apic_id, ICR_FIXED | IPI_WORK_VECTOR);
+        }
+    }
+    while (shootdown_acks) {
+        asm volatile("pause");
+    }
+
+    spin_unlock(&shootdown_lock);
+    interrupts_restore(flags);
+}
+
+// === СТАТИСТИКА ===
+
+void smp_print_cpus(void) {
+    terminal_writestring("CPU APIC Стан     Робіт     IPI  Пробудж.  TLB  Сон\n");
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        cpu_t* cpu = &cpus[i];
+        terminal_writeuint_width(i, 3);
+        terminal_writeuint_width(cpu->apic_id, 5);
+        terminal_writestring(i == 0 ? " BSP    " : (cpu->online ? " онлайн " : " офлайн "));
+        terminal_writeuint_width(cpu->work_done, 8);
+        terminal_writeuint_width(cpu->ipis_received, 8);
+        terminal_writeuint_width(cpu->idle_wakeups, 10);
+        terminal_writeuint_width(cpu->tlb_shootdowns, 5);
+        terminal_writestring(i == 0 ? "  -\n" : (cpu->use_mwait ? "  mwait\n" : "  hlt\n"));
+    }
+}
+
+// === БЕНЧМАРК ПАРАЛЕЛЬНОЇ СУМИ ===
+
+#define SMP_BENCH_ITEMS     (32u << 20)
+
+// Окрема кеш-лінія на кожну частину, щоб уникнути false sharing
+struct sum_part {
+    uint32_t begin;
+    uint32_t end;
+    uint64_t sum;
+} __attribute__((aligned(64)));
+
+static struct sum_part sum_parts[SMP_MAX_CPUS];
+
+// Обчислювально важке тіло: хеш кожного індексу, без звернень до пам'яті
+static void sum_work(void* arg) {
+    struct sum_part* part = arg;
+    uint64_t sum = 0;
+    for (uint32_t i = part->begin; i < part->end; i++) {
+        uint32_t x = i * 0x9E3779B1u;
+        x ^= x >> 15;
+        x *= 0x85EBCA77u;
+        x ^= x >> 13;
+        sum += x;
+    }
+    part->sum = sum;
+}
+
+static uint64_t parallel_sum(uint32_t workers, uint64_t* result) {
+    uint32_t chunk = SMP_BENCH_ITEMS / workers;
+    for (uint32_t i = 0; i < workers; i++) {
+        sum_parts[i].begin = i * chunk;
+        sum_parts[i].end = (i == workers - 1) ? SMP_BENCH_ITEMS : (i + 1) * chunk;
+    }
+
+    uint64_t start = rdtsc();
+    for (uint32_t i = 1; i < workers; i++) {
+        smp_call(i, sum_work, &sum_parts[i]);
+    }
+    sum_work(&sum_parts[0]);
+    uint64_t total = sum_parts[0].sum;
+    for (uint32_t i = 1; i < workers; i++) {
+        smp_wait(i);
+        total += sum_parts[i].sum;
+    }
+    uint64_t cycles = rdtsc() - start;
+
+    *result = total;
+    return cycles;
+}
+
+void smp_benchmark(void) {
+    uint64_t reference = 0;
+    uint64_t base_cycles = 0;
+
+    terminal_writestring("Паралельна сума ");
+    terminal_writeuint(SMP_BENCH_ITEMS);
+    terminal_writestring(" елементів:\n");
+    terminal_writestring("CPU     мкс   Прискорення\n");
+
+    for (uint32_t workers = 1; workers <= cpu_count; workers++) {
+        uint64_t result;
+        uint64_t cycles = parallel_sum(workers, &result);
+        if (workers == 1) {
+            reference = result;
+            base_cycles = cycles;
+        }
+
+        // Прискорення в сотих; дільник зводимо до 32 біт для div64_u32
+        uint64_t scaled = base_cycles * 100;
+        uint64_t divisor = cycles;
+        while (divisor >> 32) {
+            divisor >>= 1;
+            scaled >>= 1;
+        }
+        uint32_t speedup = (uint32_t)div64_u32(scaled, divisor ? (uint32_t)divisor : 1, NULL);
+        terminal_writeuint_width(workers, 3);
+        terminal_writeuint_width(div64_u32(tsc_cycles_to_ns(cycles), 1000, NULL), 8);
+        terminal_writestring("   ");
+        terminal_writeuint(speedup / 100);
+        terminal_writestring(".");
+        terminal_writeuint(speedup % 100 / 10);
+        terminal_writeuint(speedup % 10);
+        terminal_writestring("x");
+        if (result != reference) {
+            terminal_writestring("  ПОМИЛКА: сума відрізняється");
+        }
+        terminal_writestring("\n");
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include "kernel.h"
+#include "cpu.h"
+
+// Трамплін для AP копіюється в нижню пам'ять (має збігатися з kernel.asm)
+#define SMP_TRAMPOLINE_BASE     0x8000
+
+// Скільки ітерацій pause простоює AP перед засинанням
+#define SMP_IDLE_SPIN           2000
+
+// Скільки чекати, поки AP позначить себе онлайн
+#define SMP_START_TIMEOUT_NS    100000000ull
+
+// Запуск прикладних процесорів
+int smp_init(void);
+uint32_t smp_cpu_count(void);
+
+// Робота на інших процесорах
+int smp_call(uint32_t cpu, cpu_work_t work, void* arg);
+void smp_wait(uint32_t cpu);
+void smp_call_all(cpu_work_t work, void* arg);
+void smp_tlb_shootdown(uintptr_t virt, size_t size);
+
+// Точки входу з kernel.asm
+void ap_main(uint32_t index);
+void smp_ipi_handler(irq_frame_t* frame);
+
+// Статистика та бенчмарк
+void smp_print_cpus(void);
+void smp_benchmark(void);
+
+#endif
@@ -0,0 +1,814 @@
+#include "string.h"
+#include "cpu.h"
+#include "fpu.h"
+#include "pmm.h"
+#include "timer.h"
+
+// Базові цикли не повинні перетворюватися компілятором на виклики memcpy/memset
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// === БАЗОВІ РЕАЛІЗАЦІЇ (ПОБАЙТОВІ, ЕТАЛОН ДЛЯ ПЕРЕВІРКИ) ===
+
+static void* memcpy_generic(void* dest, const void* src, size_t n) {
+    uint8_t* d = dest;
+    const uint8_t* s = src;
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dest;
+}
+
+static void* memmove_generic(void* dest, const void* src, size_t n) {
+    uint8_t* d = dest;
+    const uint8_t* s = src;
+    if (d < s) {
+        while (n--) {
+            *d++ = *s++;
+        }
+    } else {
+        d += n;
+        s += n;
+        while (n--) {
+            *--d = *--s;
+        }
+    }
+    return dest;
+}
+
+static void* memset_generic(void* dest, int c, size_t n) {
+    uint8_t* d = dest;
+    while (n--) {
+        *d++ = (uint8_t)c;
+    }
+    return dest;
+}
+
+static int memcmp_generic(const void* a, const void* b, size_t n) {
+    const uint8_t* pa = a;
+    const uint8_t* pb = b;
+    for (size_t i = 0; i < n; i++) {
+        if (pa[i] != pb[i]) {
+            return pa[i] - pb[i];
+        }
+    }
+    return 0;
+}
+
+static size_t strlen_generic(const char* str) {
+    size_t len = 0;
+    while (str[len]) {
+        len++;
+    }
+    return len;
+}
+
+static char* strchr_generic(const char* str, int c) {
+    while (*str != (char)c) {
+        if (!*str) {
+            return NULL;
+        }
+        str++;
+    }
+    return (char*)str;
+}
+
+// === ERMS: REP MOVSB / STOSB ===
+
+static void* memcpy_erms(void* dest, const void* src, size_t n) {
+    void* d = dest;
+    asm volatile("rep movsb" : "+D"(d), "+S"(src), "+c"(n) : : "memory");
+    return dest;
+}
+
+static void* memmove_erms(void* dest, const void* src, size_t n) {
+    // Вперед безпечно, якщо dest не потрапляє всередину [src, src + n)
+    if ((uintptr_t)dest - (uintptr_t)src >= n) {
+        return memcpy_erms(dest, src, n);
+    }
+    void* d = (uint8_t*)dest + n - 1;
+    const void* s = (const uint8_t*)src + n - 1;
+    asm volatile("std; rep movsb; cld" : "+D"(d), "+S"(s), "+c"(n) : : "memory");
+    return dest;
+}
+
+static void* memset_erms(void* dest, int c, size_t n) {
+    void* d = dest;
+    asm volatile("rep stosb" : "+D"(d), "+c"(n) : "a"(c) : "memory");
+    return dest;
+}
+
+// === SSE2 ===
+
+SSE2_TARGET
+static void* memcpy_sse2(void* dest, const void* src, size_t n) {
+    uint8_t* d = dest;
+    const uint8_t* s = src;
+
+    if (n >= 64) {
+        // Вирівнюємо запис, читання лишається невирівняним
+        size_t head = (-(uintptr_t)d) & 15;
+        n -= head;
+        while (head--) {
+            *d++ = *s++;
+        }
+        while (n >= 64) {
+            size_t chunk = n < STRING_SIMD_CHUNK ? (n & ~(size_t)63) : STRING_SIMD_CHUNK;
+            n -= chunk;
+            kernel_fpu_begin();
+            asm volatile(
+                "1:\n\t"
+                "movdqu (%[s]), %%xmm0\n\t"
+                "movdqu 16(%[s]), %%xmm1\n\t"
+                "movdqu 32(%[s]), %%xmm2\n\t"
+                "movdqu 48(%[s]), %%xmm3\n\t"
+                "movdqa %%xmm0, (%[d])\n\t"
+                "movdqa %%xmm1, 16(%[d])\n\t"
+                "movdqa %%xmm2, 32(%[d])\n\t"
+                "movdqa %%xmm3, 48(%[d])\n\t"
+                "add $64, %[s]\n\t"
+                "add $64, %[d]\n\t"
+                "sub $64, %[c]\n\t"
+                "jnz 1b"
+                : [s] "+r"(s), [d] "+r"(d), [c] "+r"(chunk)
+                : : "xmm0", "xmm1", "xmm2", "xmm3", "memory", "cc");
+            kernel_fpu_end();
+        }
+    }
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dest;
+}
+
+SSE2_TARGET
+static void* memmove_sse2(void* dest, const void* src, size_t n) {
+    // Кожен блок спершу повністю читається, тож dest < src безпечно копіювати вперед
+    if ((uintptr_t)dest - (uintptr_t)src >= n) {
+        return memcpy_sse2(dest, src, n);
+    }
+
+    uint8_t* d = (uint8_t*)dest + n;
+    const uint8_t* s = (const uint8_t*)src + n;
+    while (n >= 64) {
+        size_t chunk = n < STRING_SIMD_CHUNK ? (n & ~(size_t)63) : STRING_SIMD_CHUNK;
+        n -= chunk;
+        kernel_fpu_begin();
+        asm volatile(
+            "1:\n\t"
+            "sub $64, %[s]\n\t"
+            "sub $64, %[d]\n\t"
+            "movdqu (%[s]), %%xmm0\n\t"
+            "movdqu 16(%[s]), %%xmm1\n\t"
+            "movdqu 32(%[s]), %%xmm2\n\t"
+            "movdqu 48(%[s]), %%xmm3\n\t"
+            "movdqu %%xmm0, (%[d])\n\t"
+            "movdqu %%xmm1, 16(%[d])\n\t"
+            "movdqu %%xmm2, 32(%[d])\n\t"
+            "movdqu %%xmm3, 48(%[d])\n\t"
+            "sub $64, %[c]\n\t"
+            "jnz 1b"
+            : [s] "+r"(s), [d] "+r"(d), [c] "+r"(chunk)
+            : : "xmm0", "xmm1", "xmm2", "xmm3", "memory", "cc");
+        kernel_fpu_end();
+    }
+    while (n--) {
+        *--d = *--s;
+    }
+    return dest;
+}
+
+SSE2_TARGET
+static void* memset_sse2(void* dest, int c, size_t n) {
+    uint8_t* d = dest;
+    uint32_t pattern = (uint8_t)c * 0x01010101u;
+
+    if (n >= 64) {
+        size_t head = (-(uintptr_t)d) & 15;
+        n -= head;
+        while (head--) {
+            *d++ = (uint8_t)c;
+        }
+        while (n >= 64) {
+            size_t chunk = n < STRING_SIMD_CHUNK ? (n & ~(size_t)63) : STRING_SIMD_CHUNK;
+            n -= chunk;
+            kernel_fpu_begin();
+            asm volatile(
+                "movd %[v], %%xmm0\n\t"
+                "pshufd $0, %%xmm0, %%xmm0\n\t"
+                "1:\n\t"
+                "movdqa %%xmm0, (%[d])\n\t"
+                "movdqa %%xmm0, 16(%[d])\n\t"
+                "movdqa %%xmm0, 32(%[d])\n\t"
+                "movdqa %%xmm0, 48(%[d])\n\t"
+                "add $64, %[d]\n\t"
+                "sub $64, %[c]\n\t"
+                "jnz 1b"
+                : [d] "+r"(d), [c] "+r"(chunk)
+                : [v] "r"(pattern)
+                : "xmm0", "memory", "cc");
+            kernel_fpu_end();
+        }
+    }
+    while (n--) {
+        *d++ = (uint8_t)c;
+    }
+    return dest;
+}
+
+// Маска рівних байтів двох 16-байтних блоків
+SSE2_TARGET
+static inline uint32_t equal_mask16(const uint8_t* a, const uint8_t* b) {
+    uint32_t mask;
+    asm volatile(
+        "movdqu (%1), %%xmm0\n\t"
+        "movdqu (%2), %%xmm1\n\t"
+        "pcmpeqb %%xmm1, %%xmm0\n\t"
+        "pmovmskb %%xmm0, %0"
+        : "=r"(mask) : "r"(a), "r"(b) : "xmm0", "xmm1", "memory");
+    return mask;
+}
+
+SSE2_TARGET
+static int memcmp_sse2(const void* a, const void* b, size_t n) {
+    const uint8_t* pa = a;
+    const uint8_t* pb = b;
+    while (n >= 16) {
+        size_t blocks = (n < STRING_SIMD_CHUNK ? n : STRING_SIMD_CHUNK) / 16;
+        kernel_fpu_begin();
+        for (; blocks; blocks--) {
+            uint32_t mask = equal_mask16(pa, pb);
+            if (mask != 0xFFFF) {
+                kernel_fpu_end();
+                uint32_t i = __builtin_ctz(~mask);
+                return pa[i] - pb[i];
+            }
+            pa += 16;
+            pb += 16;
+            n -= 16;
+        }
+        kernel_fpu_end();
+    }
+    return memcmp_generic(pa, pb, n);
+}
+
+// Маска нульових байтів вирівняного блоку; вирівняне читання не перетинає сторінку
+SSE2_TARGET
+static inline uint32_t zero_mask16(const char* p) {
+    uint32_t mask;
+    asm volatile(
+        "pxor %%xmm0, %%xmm0\n\t"
+        "pcmpeqb (%1), %%xmm0\n\t"
+        "pmovmskb %%xmm0, %0"
+        : "=r"(mask) : "r"(p) : "xmm0", "memory");
+    return mask;
+}
+
+// Маска байтів, рівних c або нулю
+SSE2_TARGET
+static inline uint32_t char_mask16(const char* p, uint32_t pattern) {
+    uint32_t mask;
+    asm volatile(
+        "movd %2, %%xmm1\n\t"
+        "pshufd $0, %%xmm1, %%xmm1\n\t"
+        "movdqa (%1), %%xmm0\n\t"
+        "pxor %%xmm2, %%xmm2\n\t"
+        "pcmpeqb %%xmm0, %%xmm2\n\t"
+        "pcmpeqb %%xmm1, %%xmm0\n\t"
+        "por %%xmm2, %%xmm0\n\t"
+        "pmovmskb %%xmm0, %0"
+        : "=r"(mask) : "r"(p), "r"(pattern) : "xmm0", "xmm1", "xmm2", "memory");
+    return mask;
+}
+
+SSE2_TARGET
+static size_t strlen_sse2(const char* str) {
+    const char* p = (const char*)((uintptr_t)str & ~(uintptr_t)15);
+    kernel_fpu_begin();
+    uint32_t mask = zero_mask16(p) >> ((uintptr_t)str & 15);
+    if (mask) {
+        kernel_fpu_end();
+        return __builtin_ctz(mask);
+    }
+    uint32_t blocks = 0;
+    do {
+        p += 16;
+        if (++blocks == STRING_SIMD_CHUNK / 16) {
+            kernel_fpu_end();
+            kernel_fpu_begin();
+            blocks = 0;
+        }
+    } while (!(mask = zero_mask16(p)));
+    kernel_fpu_end();
+    return (size_t)(p - str) + __builtin_ctz(mask);
+}
+
+SSE2_TARGET
+static char* strchr_sse2(const char* str, int c) {
+    uint32_t pattern = (uint8_t)c * 0x01010101u;
+    const char* p = (const char*)((uintptr_t)str & ~(uintptr_t)15);
+    kernel_fpu_begin();
+    uint32_t mask = char_mask16(p, pattern) >> ((uintptr_t)str & 15);
+    if (mask) {
+        p = str;
+    } else {
+        uint32_t blocks = 0;
+        do {
+            p += 16;
+            if (++blocks == STRING_SIMD_CHUNK / 16) {
+                kernel_fpu_end();
+                kernel_fpu_begin();
+                blocks = 0;
+            }
+        } while (!(mask = char_mask16(p, pattern)));
+    }
+    kernel_fpu_end();
+    p += __builtin_ctz(mask);
+    return *p == (char)c ? (char*)p : NULL;
+}
+
+// === AVX2 ===
+
+AVX2_TARGET
+static void* memcpy_avx2(void* dest, const void* src, size_t n) {
+    uint8_t* d = dest;
+    const uint8_t* s = src;
+
+    if (n >= 128) {
+        size_t head = (-(uintptr_t)d) & 31;
+        n -= head;
+        while (head--) {
+            *d++ = *s++;
+        }
+        while (n >= 128) {
+            size_t chunk = n < STRING_SIMD_CHUNK ? (n & ~(size_t)127) : STRING_SIMD_CHUNK;
+            n -= chunk;
+            kernel_fpu_begin();
+            asm volatile(
+                "1:\n\t"
+                "vmovdqu (%[s]), %%ymm0\n\t"
+                "vmovdqu 32(%[s]), %%ymm1\n\t"
+                "vmovdqu 64(%[s]), %%ymm2\n\t"
+                "vmovdqu 96(%[s]), %%ymm3\n\t"
+                "vmovdqa %%ymm0, (%[d])\n\t"
+                "vmovdqa %%ymm1, 32(%[d])\n\t"
+                "vmovdqa %%ymm2, 64(%[d])\n\t"
+                "vmovdqa %%ymm3, 96(%[d])\n\t"
+                "add $128, %[s]\n\t"
+                "add $128, %[d]\n\t"
+                "sub $128, %[c]\n\t"
+                "jnz 1b\n\t"
+                "vzeroupper"
+                : [s] "+r"(s), [d] "+r"(d), [c] "+r"(chunk)
+                : : "xmm0", "xmm1", "xmm2", "xmm3", "memory", "cc");
+            kernel_fpu_end();
+        }
+    }
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dest;
+}
+
+AVX2_TARGET
+static void* memmove_avx2(void* dest, const void* src, size_t n) {
+    if ((uintptr_t)dest - (uintptr_t)src >= n) {
+        return memcpy_avx2(dest, src, n);
+    }
+    return memmove_sse2(dest, src, n);
+}
+
+AVX2_TARGET
+static void* memset_avx2(void* dest, int c, size_t n) {
+    uint8_t* d = dest;
+    uint32_t pattern = (uint8_t)c * 0x01010101u;
+
+    if (n >= 128) {
+        size_t head = (-(uintptr_t)d) & 31;
+        n -= head;
+        while (head--) {
+            *d++ = (uint8_t)c;
+        }
+        while (n >= 128) {
+            size_t chunk = n < STRING_SIMD_CHUNK ? (n & ~(size_t)127) : STRING_SIMD_CHUNK;
+            n -= chunk;
+            kernel_fpu_begin();
+            asm volatile(
+                "vmovd %[v], %%xmm0\n\t"
+                "vpbroadcastd %%xmm0, %%ymm0\n\t"
+                "1:\n\t"
+                "vmovdqa %%ymm0, (%[d])\n\t"
+                "vmovdqa %%ymm0, 32(%[d])\n\t"
+                "vmovdqa %%ymm0, 64(%[d])\n\t"
+                "vmovdqa %%ymm0, 96(%[d])\n\t"
+                "add $128, %[d]\n\t"
+                "sub $128, %[c]\n\t"
+                "jnz 1b\n\t"
+                "vzeroupper"
+                : [d] "+r"(d), [c] "+r"(chunk)
+                : [v] "r"(pattern)
+                : "xmm0", "memory", "cc");
+            kernel_fpu_end();
+        }
+    }
+    while (n--) {
+        *d++ = (uint8_t)c;
+    }
+    return dest;
+}
+
+AVX2_TARGET
+static inline uint32_t equal_mask32(const uint8_t* a, const uint8_t* b) {
+    uint32_t mask;
+    asm volatile(
+        "vmovdqu (%1), %%ymm0\n\t"
+        "vpcmpeqb (%2), %%ymm0, %%ymm0\n\t"
+        "vpmovmskb %%ymm0, %0\n\t"
+        "vzeroupper"
+        : "=r"(mask) : "r"(a), "r"(b) : "xmm0", "memory");
+    return mask;
+}
+
+AVX2_TARGET
+static int memcmp_avx2(const void* a, const void* b, size_t n) {
+    const uint8_t* pa = a;
+    const uint8_t* pb = b;
+    while (n >= 32) {
+        size_t blocks = (n < STRING_SIMD_CHUNK ? n : STRING_SIMD_CHUNK) / 32;
+        kernel_fpu_begin();
+        for (; blocks; blocks--) {
+            uint32_t mask = equal_mask32(pa, pb);
+            if (mask != 0xFFFFFFFFu) {
+                kernel_fpu_end();
+                uint32_t i = __builtin_ctz(~mask);
+                return pa[i] - pb[i];
+            }
+            pa += 32;
+            pb += 32;
+            n -= 32;
+        }
+        kernel_fpu_end();
+    }
+    return memcmp_sse2(pa, pb, n);
+}
+
+AVX2_TARGET
+static inline uint32_t zero_mask32(const char* p) {
+    uint32_t mask;
+    asm volatile(
+        "vpxor %%xmm0, %%xmm0, %%xmm0\n\t"
+        "vpcmpeqb (%1), %%ymm0, %%ymm0\n\t"
+        "vpmovmskb %%ymm0, %0\n\t"
+        "vzeroupper"
+        : "=r"(mask) : "r"(p) : "xmm0", "memory");
+    return mask;
+}
+
+AVX2_TARGET
+static inline uint32_t char_mask32(const char* p, uint32_t c) {
+    uint32_t mask;
+    asm volatile(
+        "vmovd %2, %%xmm1\n\t"
+        "vpbroadcastb %%xmm1, %%ymm1\n\t"
+        "vmovdqa (%1), %%ymm0\n\t"
+        "vpxor %%xmm2, %%xmm2, %%xmm2\n\t"
+        "vpcmpeqb %%ymm0, %%ymm2, %%ymm2\n\t"
+        "vpcmpeqb %%ymm0, %%ymm1, %%ymm0\n\t"
+        "vpor %%ymm2, %%ymm0, %%ymm0\n\t"
+        "vpmovmskb %%ymm0, %0\n\t"
+        "vzeroupper"
+        : "=r"(mask) : "r"(p), "r"(c) : "xmm0", "xmm1", "xmm2", "memory");
+    return mask;
+}
+
+AVX2_TARGET
+static size_t strlen_avx2(const char* str) {
+    const char* p = (const char*)((uintptr_t)str & ~(uintptr_t)31);
+    kernel_fpu_begin();
+    uint32_t mask = zero_mask32(p) >> ((uintptr_t)str & 31);
+    if (mask) {
+        kernel_fpu_end();
+        return __builtin_ctz(mask);
+    }
+    uint32_t blocks = 0;
+    do {
+        p += 32;
+        if (++blocks == STRING_SIMD_CHUNK / 32) {
+            kernel_fpu_end();
+            kernel_fpu_begin();
+            blocks = 0;
+        }
+    } while (!(mask = zero_mask32(p)));
+    kernel_fpu_end();
+    return (size_t)(p - str) + __builtin_ctz(mask);
+}
+
+AVX2_TARGET
+static char* strchr_avx2(const char* str, int c) {
+    uint32_t byte = (uint8_t)c;
+    const char* p = (const char*)((uintptr_t)str & ~(uintptr_t)31);
+    kernel_fpu_begin();
+    uint32_t mask = char_mask32(p, byte) >> ((uintptr_t)str & 31);
+    if (mask) {
+        p = str;
+    } else {
+        uint32_t blocks = 0;
+        do {
+            p += 32;
+            if (++blocks == STRING_SIMD_CHUNK / 32) {
+                kernel_fpu_end();
+                kernel_fpu_begin();
+                blocks = 0;
+            }
+        } while (!(mask = char_mask32(p, byte)));
+    }
+    kernel_fpu_end();
+    p += __builtin_ctz(mask);
+    return *p == (char)c ? (char*)p : NULL;
+}
+
+// === ДИСПЕТЧЕРИЗАЦІЯ ===
+
+static const string_impl_t impls[STRING_IMPL_COUNT] = {
+    [STRING_IMPL_GENERIC] = { "generic", 0,
+        memcpy_generic, memmove_generic, memset_generic,
+        memcmp_generic, strlen_generic, strchr_generic },
+    // ERMS прискорює лише копіювання та заповнення
+    [STRING_IMPL_ERMS] = { "erms", CPU_FEATURE_ERMS,
+        memcpy_erms, memmove_erms, memset_erms,
+        memcmp_generic, strlen_generic, strchr_generic },
+    [STRING_IMPL_SSE2] = { "sse2", CPU_FEATURE_SSE2,
+        memcpy_sse2, memmove_sse2, memset_sse2,
+        memcmp_sse2, strlen_sse2, strchr_sse2 },
+    [STRING_IMPL_AVX2] = { "avx2", CPU_FEATURE_SSE2 | CPU_FEATURE_AVX2,
+        memcpy_avx2, memmove_avx2, memset_avx2,
+        memcmp_avx2, strlen_avx2, strchr_avx2 },
+};
+
+// До string_init працюють побайтові версії
+static const string_impl_t* copy_impl = &impls[STRING_IMPL_GENERIC];
+static const string_impl_t* scan_impl = &impls[STRING_IMPL_GENERIC];
+
+static int impl_available(const string_impl_t* impl) {
+    return (cpu_features & impl->required_features) == impl->required_features;
+}
+
+void string_init(void) {
+    // Копіювання: rep movsb при ERMS - без SIMD-стану і вимкнених переривань
+    if (impl_available(&impls[STRING_IMPL_ERMS])) {
+        copy_impl = &impls[STRING_IMPL_ERMS];
+    } else if (impl_available(&impls[STRING_IMPL_AVX2])) {
+        copy_impl = &impls[STRING_IMPL_AVX2];
+    } else if (impl_available(&impls[STRING_IMPL_SSE2])) {
+        copy_impl = &impls[STRING_IMPL_SSE2];
+    }
+
+    // Пошук і порівняння: найширші доступні вектори
+    if (impl_available(&impls[STRING_IMPL_AVX2])) {
+        scan_impl = &impls[STRING_IMPL_AVX2];
+    } else if (impl_available(&impls[STRING_IMPL_SSE2])) {
+        scan_impl = &impls[STRING_IMPL_SSE2];
+    }
+}
+
+void* memcpy(void* dest, const void* src, size_t n) {
+    return copy_impl->memcpy(dest, src, n);
+}
+
+void* memmove(void* dest, const void* src, size_t n) {
+    return copy_impl->memmove(dest, src, n);
+}
+
+void* memset(void* dest, int c, size_t n) {
+    return copy_impl->memset(dest, c, n);
+}
+
+int memcmp(const void* a, const void* b, size_t n) {
+    return scan_impl->memcmp(a, b, n);
+}
+
+size_t strlen(const char* str) {
+    return scan_impl->strlen(str);
+}
+
+char* strchr(const char* str, int c) {
+    return scan_impl->strchr(str, c);
+}
+
+void string_print_impl(void) {
+    terminal_writestring("CPU: SSE2 ");
+    terminal_writestring(cpu_features & CPU_FEATURE_SSE2 ? "так" : "ні");
+    terminal_writestring(", ERMS ");
+    terminal_writestring(cpu_features & CPU_FEATURE_ERMS ? "так" : "ні");
+    terminal_writestring(", AVX2 ");
+    terminal_writestring(cpu_features & CPU_FEATURE_AVX2 ? "так" : "ні");
+    terminal_writestring("\nmemcpy/memmove/memset: ");
+    terminal_writestring(copy_impl->name);
+    terminal_writestring("\nmemcmp/strlen/strchr:  ");
+    terminal_writestring(scan_impl->name);
+    terminal_writestring("\n");
+}
+
+// === ПЕРЕВІРКА НА ВИПАДКОВИХ ДАНИХ ===
+
+#define FUZZ_BUFFER     4096
+#define FUZZ_MAX_LEN    2048
+
+static uint8_t fuzz_a[FUZZ_BUFFER];
+static uint8_t fuzz_b[FUZZ_BUFFER];
+static uint8_t fuzz_expect[FUZZ_BUFFER];
+static uint32_t fuzz_state;
+
+static uint32_t fuzz_random(void) {
+    fuzz_state ^= fuzz_state << 13;
+    fuzz_state ^= fuzz_state >> 17;
+    fuzz_state ^= fuzz_state << 5;
+    return fuzz_state;
+}
+
+static void fuzz_fill(uint8_t* buffer, size_t size, int nonzero) {
+    for (size_t i = 0; i < size; i++) {
+        uint8_t value = (uint8_t)fuzz_random();
+        buffer[i] = (nonzero && value == 0) ? 1 : value;
+    }
+}
+
+static int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+// Одна випадкова перевірка кожної функції; повертає кількість розбіжностей
+static uint32_t fuzz_one(const string_impl_t* impl) {
+    const string_impl_t* ref = &impls[STRING_IMPL_GENERIC];
+    uint32_t failures = 0;
+    size_t len = fuzz_random() % FUZZ_MAX_LEN;
+    size_t src_off = fuzz_random() % 64;
+    size_t dst_off = fuzz_random() % 64;
+
+    // memcpy: решта буфера (охоронні байти) має лишитися незмінною
+    fuzz_fill(fuzz_a, FUZZ_BUFFER, false);
+    fuzz_fill(fuzz_b, FUZZ_BUFFER, false);
+    memcpy_generic(fuzz_expect, fuzz_b, FUZZ_BUFFER);
+    ref->memcpy(fuzz_expect + dst_off, fuzz_a + src_off, len);
+    impl->memcpy(fuzz_b + dst_off, fuzz_a + src_off, len);
+    failures += memcmp_generic(fuzz_b, fuzz_expect, FUZZ_BUFFER) != 0;
+
+    // memmove з перекриттям в обидва боки
+    size_t from = fuzz_random() % (FUZZ_BUFFER - FUZZ_MAX_LEN);
+    size_t to = fuzz_random() % (FUZZ_BUFFER - FUZZ_MAX_LEN);
+    memcpy_generic(fuzz_expect, fuzz_a, FUZZ_BUFFER);
+    ref->memmove(fuzz_expect + to, fuzz_expect + from, len);
+    impl->memmove(fuzz_a + to, fuzz_a + from, len);
+    failures += memcmp_generic(fuzz_a, fuzz_expect, FUZZ_BUFFER) != 0;
+
+    // memset
+    int value = (int)(fuzz_random() & 0x1FF);   // старші біти значення відкидаються
+    memcpy_generic(fuzz_expect, fuzz_b, FUZZ_BUFFER);
+    ref->memset(fuzz_expect + dst_off, value, len);
+    impl->memset(fuzz_b + dst_off, value, len);
+    failures += memcmp_generic(fuzz_b, fuzz_expect, FUZZ_BUFFER) != 0;
+
+    // memcmp: рівні блоки, потім з однією зміненою позицією
+    memcpy_generic(fuzz_b + dst_off, fuzz_a + src_off, len);
+    failures += impl->memcmp(fuzz_a + src_off, fuzz_b + dst_off, len) != 0;
+    if (len > 0) {
+        fuzz_b[dst_off + fuzz_random() % len] ^= (uint8_t)(1 + fuzz_random() % 255);
+        failures += sign(impl->memcmp(fuzz_a + src_off, fuzz_b + dst_off, len)) !=
+                    sign(ref->memcmp(fuzz_a + src_off, fuzz_b + dst_off, len));
+    }
+
+    // strlen/strchr: рядок без нулів із термінатором у випадковому місці
+    fuzz_fill(fuzz_a, FUZZ_BUFFER, true);
+    fuzz_a[src_off + len] = 0;
+    const char* str = (const char*)fuzz_a + src_off;
+    failures += impl->strlen(str) != len;
+    int c = (len > 0 && (fuzz_random() & 1)) ? str[fuzz_random() % len] : (int)(fuzz_random() & 0xFF);
+    failures += impl->strchr(str, c) != ref->strchr(str, c);
+    failures += impl->strchr(str, 0) != str + len;
+
+    return failures;
+}
+
+int string_fuzz(uint32_t iterations) {
+    int total = 0;
+    fuzz_state = (uint32_t)rdtsc() | 1;
+
+    for (int i = 0; i < STRING_IMPL_COUNT; i++) {
+        const string_impl_t* impl = &impls[i];
+        terminal_writestring(impl->name);
+        for (size_t pad = strlen(impl->name); pad < 8; pad++) {
+            terminal_putchar(' ');
+        }
+        if (!impl_available(impl)) {
+            terminal_writestring(" недоступно\n");
+            continue;
+        }
+        uint32_t failures = 0;
+        for (uint32_t n = 0; n < iterations; n++) {
+            failures += fuzz_one(impl);
+        }
+        terminal_writestring(failures ? " ПОМИЛОК: " : " OK, перевірок: ");
+        terminal_writeuint(failures ? failures : iterations);
+        terminal_writestring("\n");
+        total += failures;
+    }
+    return total;
+}
+
+// === БЕНЧМАРК БАЙТ/ТАКТ ===
+
+#define BENCH_MAX_SIZE      (1u << 20)
+#define BENCH_BUFFER_PAGES  ((2 * BENCH_MAX_SIZE) / PAGE_SIZE)
+#define BENCH_TARGET_BYTES  (4u << 20)
+#define BENCH_SIZES         11
+
+static const uint32_t bench_sizes[BENCH_SIZES] = {
+    1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576
+};
+
+typedef enum { BENCH_MEMCPY, BENCH_MEMSET, BENCH_STRLEN } bench_op_t;
+
+static void print_bytes_per_cycle(uint64_t bytes, uint64_t cycles) {
+    while (cycles >> 32) {
+        cycles >>= 1;
+        bytes >>= 1;
+    }
+    uint32_t hundredths = (uint32_t)div64_u32(bytes * 100, cycles ? (uint32_t)cycles : 1, NULL);
+    char buffer[16];
+    uint64toa(hundredths / 100, buffer, 10);
+    size_t len = strlen(buffer);
+    buffer[len++] = '.';
+    buffer[len++] = '0' + (hundredths % 100) / 10;
+    buffer[len++] = '0' + hundredths % 10;
+    buffer[len] = '\0';
+    for (; len < 6; len++) {
+        terminal_putchar(' ');
+    }
+    terminal_writestring(buffer);
+}
+
+static void bench_row(const char* label, const string_impl_t* impl, bench_op_t op,
+                      uint8_t* src, uint8_t* dst) {
+    terminal_writestring(label);
+    terminal_writestring(impl->name);
+    for (size_t pad = strlen(label) + strlen(impl->name); pad < 13; pad++) {
+        terminal_putchar(' ');
+    }
+
+    for (int i = 0; i < BENCH_SIZES; i++) {
+        uint32_t size = bench_sizes[i];
+        uint32_t reps = BENCH_TARGET_BYTES / size;
+        if (reps > 20000) {
+            reps = 20000;
+        }
+        if (op == BENCH_STRLEN) {
+            src[size - 1] = 0;
+        }
+
+        uint64_t start = rdtsc();
+        for (uint32_t r = 0; r < reps; r++) {
+            switch (op) {
+                case BENCH_MEMCPY: impl->memcpy(dst, src, size); break;
+                case BENCH_MEMSET: impl->memset(dst, (int)r, size); break;
+                case BENCH_STRLEN: impl->strlen((const char*)src); break;
+            }
+            asm volatile("" : : : "memory");
+        }
+        uint64_t cycles = rdtsc() - start;
+
+        if (op == BENCH_STRLEN) {
+            src[size - 1] = 'x';
+        }
+        print_bytes_per_cycle((uint64_t)size * reps, cycles);
+    }
+    terminal_writestring("\n");
+}
+
+void string_benchmark(void) {
+    uintptr_t buffer = pmm_alloc_frames(BENCH_BUFFER_PAGES);
+    if (!buffer) {
+        terminal_writestring("Недостатньо пам'яті для бенчмарку\n");
+        return;
+    }
+    uint8_t* src = (uint8_t*)buffer;
+    uint8_t* dst = src + BENCH_MAX_SIZE;
+    memset_generic(src, 'x', BENCH_MAX_SIZE);
+
+    string_print_impl();
+    terminal_writestring("Байт/такт за розміром:\n");
+    terminal_writestring("                 1B    4B   16B   64B  256B    1K    4K   16K   64K  256K    1M\n");
+    for (int op = BENCH_MEMCPY; op <= BENCH_STRLEN; op++) {
+        static const char* labels[] = { "cpy ", "set ", "len " };
+        for (int i = 0; i < STRING_IMPL_COUNT; i++) {
+            // strlen у ERMS - та сама побайтова версія
+            if (!impl_available(&impls[i]) || (op == BENCH_STRLEN && i == STRING_IMPL_ERMS)) {
+                continue;
+            }
+            bench_row(labels[op], &impls[i], (bench_op_t)op, src, dst);
+        }
+    }
+
+    pmm_free_frames(buffer, BENCH_BUFFER_PAGES);
+}
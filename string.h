@@ -0,0 +1,38 @@
+#ifndef STRING_H
+#define STRING_H
+
+#include "kernel.h"
+
+// Реалізації, між якими обираємо за CPUID
+typedef enum {
+    STRING_IMPL_GENERIC,
+    STRING_IMPL_ERMS,
+    STRING_IMPL_SSE2,
+    STRING_IMPL_AVX2,
+    STRING_IMPL_COUNT
+} string_impl_id_t;
+
+// SIMD-цикли - секції kernel_fpu_begin/end (fpu.c): стан потоку зберігається,
+// переривання вимкнені, тож довгі операції ділимо на шматки
+#define STRING_SIMD_CHUNK       65536
+
+typedef struct {
+    const char* name;
+    uint32_t required_features;
+    void* (*memcpy)(void* dest, const void* src, size_t n);
+    void* (*memmove)(void* dest, const void* src, size_t n);
+    void* (*memset)(void* dest, int c, size_t n);
+    int (*memcmp)(const void* a, const void* b, size_t n);
+    size_t (*strlen)(const char* str);
+    char* (*strchr)(const char* str, int c);
+} string_impl_t;
+
+// Вибір реалізацій один раз при завантаженні (після cpu_enable_simd)
+void string_init(void);
+
+// Звіт, перевірка та бенчмарк
+void string_print_impl(void);
+int string_fuzz(uint32_t iterations);
+void string_benchmark(void);
+
+#endif
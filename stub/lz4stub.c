@@ -0,0 +1,154 @@
+// Розпакувальник стиснутого ядра: GRUB завантажує цей ELF (32-бітний для
+// обох архітектур - Multiboot2 входить у захищений режим), stub розпаковує
+// блок LZ4 з tools/lz4pack.py за адресою ядра і передає керування його
+// _start так само, як GRUB: EAX - магічне число, EBX - інформація Multiboot2.
+// Місце під ядро з BSS резервує порожній сегмент stub.ld, тож GRUB не кладе
+// туди модулі й сам обнуляє BSS ядра
+
+#include <stdint.h>
+
+// Мітка в ECX і TSC входу stub в EDX:ESI - для хронології завантаження (boot.c)
+#define STUB_MARKER             0x345A4C4E
+
+#define MULTIBOOT2_MAGIC        0xE85250D6
+#define MULTIBOOT2_HEADER_SIZE  48
+
+#define PACK_MAGIC              0x345A584E      // "NXZ4"
+#define MIN_MATCH               4
+
+#define VGA_MEMORY              0xB8000
+
+// Заголовок Multiboot2 з тими самими тегами, що й у kernel.asm: ядро за
+// stub бачить ту саму інформацію від GRUB, зокрема буфер кадрів
+__attribute__((section(".multiboot_header"), aligned(8), used))
+static const uint32_t multiboot_header[] = {
+    MULTIBOOT2_MAGIC, 0, MULTIBOOT2_HEADER_SIZE,
+    (uint32_t)(0x100000000ull - (MULTIBOOT2_MAGIC + MULTIBOOT2_HEADER_SIZE)),
+    5 | (1u << 16), 20, 1024, 768, 32, 0,   // буфер кадрів 1024x768x32, необов'язковий
+    0, 8                                    // кінцевий тег
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t load;
+    uint32_t entry;
+    uint32_t raw_size;
+    uint32_t packed_size;
+    uint32_t mem_end;
+} pack_header_t;
+
+// Пакет ядра (build/<arch>/kernel.lz4) прямо в образі stub
+__asm__(
+    ".section .payload, \"a\"\n"
+    ".balign 4\n"
+    "payload:\n"
+    ".incbin \"" PAYLOAD_FILE "\"\n"
+    ".previous\n");
+extern const uint8_t payload[];
+
+void stub_main(uint32_t magic, uint32_t info, uint32_t tsc_lo, uint32_t tsc_hi) __attribute__((noreturn, used));
+
+// Вхід: TSC якомога раніше, далі власний стек. DF скинуто для rep movsb
+__asm__(
+    ".section .bss\n"
+    ".balign 16\n"
+    "    .skip 4096\n"
+    "stub_stack_top:\n"
+    ".text\n"
+    ".global _start\n"
+    "_start:\n"
+    "    cli\n"
+    "    cld\n"
+    "    mov %eax, %edi\n"
+    "    rdtsc\n"
+    "    mov $stub_stack_top, %esp\n"
+    "    push %edx\n"
+    "    push %eax\n"
+    "    push %ebx\n"
+    "    push %edi\n"
+    "    call stub_main\n");
+
+// === LZ4 ===
+
+static inline uint32_t read_length(const uint8_t** src, const uint8_t* end, uint32_t length) {
+    if (length == 15) {
+        uint8_t byte;
+        do {
+            if (*src >= end) {
+                return 0xFFFFFFFF;
+            }
+            byte = *(*src)++;
+            length += byte;
+        } while (byte == 255);
+    }
+    return length;
+}
+
+// Блок LZ4: послідовності "токен, літерали, зміщення, довжина збігу";
+// остання - лише літерали. Повертає розмір виходу або 0 при помилці
+static uint32_t lz4_decompress(const uint8_t* src, uint32_t size, uint8_t* dst, uint32_t capacity) {
+    const uint8_t* end = src + size;
+    uint8_t* out = dst;
+    uint8_t* out_end = dst + capacity;
+
+    while (src < end) {
+        uint8_t token = *src++;
+        uint32_t literals = read_length(&src, end, token >> 4);
+        if (literals > (uint32_t)(end - src) || literals > (uint32_t)(out_end - out)) {
+            return 0;
+        }
+        // rep movsb: на сучасних процесорах швидке копіювання без SSE
+        __asm__ volatile("rep movsb" : "+S"(src), "+D"(out), "+c"(literals) : : "memory");
+        if (src >= end) {
+            break;
+        }
+
+        if (end - src < 2) {
+            return 0;
+        }
+        uint32_t offset = src[0] | ((uint32_t)src[1] << 8);
+        src += 2;
+        uint32_t length = read_length(&src, end, token & 15);
+        if (length == 0xFFFFFFFF || offset == 0 || offset > (uint32_t)(out - dst)) {
+            return 0;
+        }
+        length += MIN_MATCH;
+        if (length > (uint32_t)(out_end - out)) {
+            return 0;
+        }
+        // Перекриття (offset < length) повторює шаблон - лише побайтово вперед
+        const uint8_t* match = out - offset;
+        __asm__ volatile("rep movsb" : "+S"(match), "+D"(out), "+c"(length) : : "memory");
+    }
+    return (uint32_t)(out - dst);
+}
+
+// === ВХІД ===
+
+static void __attribute__((noreturn)) fail(const char* message) {
+    volatile uint16_t* vga = (volatile uint16_t*)VGA_MEMORY;
+    while (*message) {
+        *vga++ = 0x4F00 | (uint8_t)*message++;      // білий на червоному
+    }
+    while (1) {
+        __asm__ volatile("cli; hlt");
+    }
+}
+
+void stub_main(uint32_t magic, uint32_t info, uint32_t tsc_lo, uint32_t tsc_hi) {
+    const pack_header_t* header = (const pack_header_t*)payload;
+    if (header->magic != PACK_MAGIC) {
+        fail("Nexus OS stub: bad kernel package");
+    }
+    uint32_t size = lz4_decompress(payload + sizeof(pack_header_t), header->packed_size,
+                                   (uint8_t*)(uintptr_t)header->load, header->raw_size);
+    if (size != header->raw_size) {
+        fail("Nexus OS stub: kernel decompression failed");
+    }
+
+    __asm__ volatile(
+        "jmp *%[entry]"
+        : : [entry] "r"(header->entry), "a"(magic), "b"(info), "c"(STUB_MARKER), "d"(tsc_hi), "S"(tsc_lo)
+        : "memory");
+    __builtin_unreachable();
+}
@@ -0,0 +1,261 @@
+#include "syscall.h"
+#include "cpu.h"
+#include "irq.h"
+#include "pmm.h"
+#include "sched.h"
+#include "task.h"
+#include "timer.h"
+#include "vmm.h"
+
+// SYSENTER (i386): селектор коду ядра, стек і точка входу
+#define MSR_SYSENTER_CS         0x174
+#define MSR_SYSENTER_ESP        0x175
+#define MSR_SYSENTER_EIP        0x176
+
+// SYSCALL (x86_64): дозвіл в EFER, селектори в STAR, вхід у LSTAR, маска RFLAGS
+#define MSR_EFER                0xC0000080
+#define MSR_STAR                0xC0000081
+#define MSR_LSTAR               0xC0000082
+#define MSR_FMASK               0xC0000084
+#define EFER_SCE                0x01
+
+// CPUID.1:EDX.SEP та CPUID.80000001h:EDX.SYSCALL
+#define CPUID_SEP               (1u << 11)
+#define CPUID_EXT_SYSCALL       (1u << 11)
+
+// На вході SYSCALL скидаються TF, IF, DF, IOPL, NT, AC
+#define SYSCALL_RFLAGS_MASK     0x47700
+
+// Код vDSO з kernel.asm / kernel64.asm та входи швидкого шляху
+extern uint8_t vdso_start[];
+extern uint8_t vdso_end[];
+#ifdef __x86_64__
+extern void syscall_entry(void);
+#else
+extern void sysenter_entry(void);
+#endif
+
+#define VDSO_SLOT_SYSCALL       (NEXUS_VDSO_SYSCALL - NEXUS_VDSO_CODE)
+#define VDSO_SLOT_INT80         (NEXUS_VDSO_INT80 - NEXUS_VDSO_CODE)
+#define VDSO_SLOT_SIZE          0x40
+
+static syscall_path_t path = SYSCALL_PATH_INT80;
+static uintptr_t vdso_page = 0;
+static uint32_t vdso_mult = 0;
+static uint32_t vdso_shift = 0;
+
+// Статистика
+static uint64_t fast_calls = 0;
+static uint64_t int80_calls = 0;
+static uint64_t calls[NEXUS_SYS_COUNT];
+static uint64_t bad_calls = 0;
+
+// === ВИКЛИКИ ===
+
+static long sys_write(uintptr_t buffer, uintptr_t length) {
+    if (length == 0) {
+        return 0;
+    }
+    if (length > SYSCALL_WRITE_MAX) {
+        length = SYSCALL_WRITE_MAX;
+    }
+    if (!vmm_user_access_ok(buffer, length, false)) {
+        return ERROR_INVALID_INPUT;
+    }
+    terminal_write((const char*)buffer, length);
+    return (long)length;
+}
+
+static long sys_time(uintptr_t result) {
+    if (!vmm_user_access_ok(result, sizeof(uint64_t), true)) {
+        return ERROR_INVALID_INPUT;
+    }
+    *(uint64_t*)result = time_now_ns();
+    return SUCCESS;
+}
+
+static long syscall_dispatch(uintptr_t number, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3) {
+    (void)arg3;
+    if (number >= NEXUS_SYS_COUNT) {
+        bad_calls++;
+        return ERROR_INVALID_INPUT;
+    }
+    calls[number]++;
+
+    switch (number) {
+    case NEXUS_SYS_EXIT:
+        task_exit((int)arg1);
+        return SUCCESS;
+    case NEXUS_SYS_WRITE:
+        return sys_write(arg1, arg2);
+    case NEXUS_SYS_NULL:
+        return SUCCESS;
+    case NEXUS_SYS_TIME:
+        return sys_time(arg1);
+    case NEXUS_SYS_YIELD:
+        sched_yield();
+        return SUCCESS;
+    }
+    return ERROR_INVALID_INPUT;
+}
+
+long syscall_fast(uintptr_t number, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3) {
+    fast_calls++;
+    return syscall_dispatch(number, arg1, arg2, arg3);
+}
+
+// Повільний шлях: повний кадр irq_common, результат - у збережений EAX/RAX
+static void syscall_int80(irq_frame_t* frame) {
+    int80_calls++;
+#ifdef __x86_64__
+    frame->rax = (uint64_t)syscall_dispatch(frame->rax, frame->rdi, frame->rsi, frame->rdx);
+#else
+    frame->eax = (uint32_t)syscall_dispatch(frame->eax, frame->ebx, frame->esi, frame->edi);
+#endif
+}
+
+// === ШВИДКИЙ ШЛЯХ ===
+
+// Задачі виконуються лише на BSP, тож MSR програмуються тільки тут
+static syscall_path_t setup_fast_path(void) {
+    uint32_t a, b, c, d;
+#ifdef __x86_64__
+    cpuid(0x80000000, &a, &b, &c, &d);
+    if (a < 0x80000001) {
+        return SYSCALL_PATH_INT80;
+    }
+    cpuid(0x80000001, &a, &b, &c, &d);
+    if (!(d & CPUID_EXT_SYSCALL)) {
+        return SYSCALL_PATH_INT80;
+    }
+    // SYSCALL: CS = STAR[47:32], SS = +8; SYSRET: SS = STAR[63:48] + 8, CS = +16
+    wrmsr(MSR_STAR, ((uint64_t)GDT_KERNEL_DATA << 48) | ((uint64_t)GDT_KERNEL_CODE << 32));
+    wrmsr(MSR_LSTAR, (uintptr_t)syscall_entry);
+    wrmsr(MSR_FMASK, SYSCALL_RFLAGS_MASK);
+    wrmsr(MSR_EFER, rdmsr(MSR_EFER) | EFER_SCE);
+    return SYSCALL_PATH_SYSCALL;
+#else
+    // Intel не підтримує SYSCALL у 32-бітному режимі, AMD - SYSENTER у long mode
+    cpuid(1, &a, &b, &c, &d);
+    if (!(d & CPUID_SEP)) {
+        return SYSCALL_PATH_INT80;
+    }
+    // ESP на вході - TSS процесора: sysenter_entry бере звідти esp0 поточного потоку
+    wrmsr(MSR_SYSENTER_CS, GDT_KERNEL_CODE);
+    wrmsr(MSR_SYSENTER_ESP, (uintptr_t)&this_cpu()->tss);
+    wrmsr(MSR_SYSENTER_EIP, (uintptr_t)sysenter_entry);
+    return SYSCALL_PATH_SYSENTER;
+#endif
+}
+
+// === vDSO ===
+
+// mult/shift для ns = (такти * mult) >> shift: найбільший shift, за якого
+// mult = 10^6 * 2^shift / кГц ще вміщається в 32 біти
+static void clock_params(uint32_t khz, uint32_t* mult, uint32_t* shift) {
+    for (uint32_t s = 31; s > 0; s--) {
+        uint64_t m = div64_u32(1000000ull << s, khz, NULL);
+        if (m <= 0xFFFFFFFFull) {
+            *mult = (uint32_t)m;
+            *shift = s;
+            return;
+        }
+    }
+    *mult = (uint32_t)div64_u32(1000000ull, khz, NULL);
+    *shift = 0;
+}
+
+static int vdso_init(void) {
+    uint32_t code_size = (uint32_t)(vdso_end - vdso_start);
+    if (code_size > PAGE_SIZE - (NEXUS_VDSO_CODE - NEXUS_VDSO_BASE)) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    vdso_page = pmm_alloc_frame();
+    if (!vdso_page) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    uint8_t* page = (uint8_t*)vdso_page;
+    memset(page, 0, PAGE_SIZE);
+    clock_params(tsc_khz(), &vdso_mult, &vdso_shift);
+    *(uint64_t*)(page + NEXUS_VDSO_TSC_BASE) = timer_base_tsc();
+    *(uint32_t*)(page + NEXUS_VDSO_MULT) = vdso_mult;
+    *(uint32_t*)(page + NEXUS_VDSO_SHIFT) = vdso_shift;
+    *(uint32_t*)(page + NEXUS_VDSO_FAST) = path != SYSCALL_PATH_INT80;
+    *(uint32_t*)(page + NEXUS_VDSO_TSC_KHZ) = tsc_khz();
+
+    uint8_t* code = page + (NEXUS_VDSO_CODE - NEXUS_VDSO_BASE);
+    memcpy(code, vdso_start, code_size);
+    if (path == SYSCALL_PATH_INT80) {
+        memcpy(code + VDSO_SLOT_SYSCALL, code + VDSO_SLOT_INT80, VDSO_SLOT_SIZE);
+    }
+
+    // Спільна для всіх задач, лише читання; глобальна - переживає зміну CR3
+    return vmm_map(VMM_VDSO_BASE, vdso_page, PAGE_SIZE, VMM_USER | VMM_GLOBAL);
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int syscall_init(void) {
+    path = setup_fast_path();
+
+    int result = vdso_init();
+    if (result != SUCCESS) {
+        terminal_writestring("Системні виклики: не вдалося створити сторінку vDSO\n");
+        return result;
+    }
+
+    // Шлюз з DPL 3, інакше int 0x80 з кільця 3 дає #GP
+    idt_set_gate(SYSCALL_VECTOR, irq_stub_table[SYSCALL_VECTOR], GDT_KERNEL_CODE, IDT_GATE_USER);
+    return irq_register(SYSCALL_VECTOR, "syscall", syscall_int80, IRQ_FLAG_NO_EOI);
+}
+
+syscall_path_t syscall_path(void) {
+    return path;
+}
+
+// === СТАТИСТИКА ===
+
+static const char* syscall_names[NEXUS_SYS_COUNT] = {
+    "exit", "write", "null", "time", "yield"
+};
+
+void syscall_print_stats(void) {
+    char buffer[24];
+    static const char* path_names[] = { "лише int 0x80", "SYSENTER/SYSEXIT", "SYSCALL/SYSRET" };
+
+    terminal_writestring("Швидкий шлях: ");
+    terminal_writestring(path_names[path]);
+    terminal_writestring("\nВикликів: швидким шляхом ");
+    terminal_writeuint(fast_calls);
+    terminal_writestring(", через int 0x80 ");
+    terminal_writeuint(int80_calls);
+    terminal_writestring(", невідомих ");
+    terminal_writeuint(bad_calls);
+    terminal_writestring("\n");
+    for (uint32_t i = 0; i < NEXUS_SYS_COUNT; i++) {
+        terminal_writestring("  ");
+        terminal_writestring(syscall_names[i]);
+        terminal_writestring(": ");
+        terminal_writeuint(calls[i]);
+        terminal_writestring("\n");
+    }
+
+    terminal_writestring("vDSO: 0x");
+    uint64toa(VMM_VDSO_BASE, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(", годинник ns = (такти * ");
+    terminal_writeuint(vdso_mult);
+    terminal_writestring(") >> ");
+    terminal_writeuint(vdso_shift);
+    terminal_writestring("\n");
+}
+
+void syscall_reset_stats(void) {
+    unsigned long flags = interrupts_save();
+    fast_calls = 0;
+    int80_calls = 0;
+    bad_calls = 0;
+    memset(calls, 0, sizeof(calls));
+    interrupts_restore(flags);
+}
@@ -0,0 +1,34 @@
+#ifndef SYSCALL_H
+#define SYSCALL_H
+
+#include "kernel.h"
+#include "user/nexus.h"
+
+// Системні виклики задач кільця 3: SYSENTER (i386) або SYSCALL (x86_64) через
+// заглушку vDSO і повільний шлях - шлюз int 0x80 через irq_dispatch.
+// Обидва шляхи сходяться в одній таблиці викликів
+
+#define SYSCALL_VECTOR          0x80
+
+// Найбільший запис SYS_WRITE за один виклик
+#define SYSCALL_WRITE_MAX       4096
+
+typedef enum {
+    SYSCALL_PATH_INT80 = 0,             // швидкого шляху немає
+    SYSCALL_PATH_SYSENTER,
+    SYSCALL_PATH_SYSCALL
+} syscall_path_t;
+
+// MSR швидкого шляху на BSP, шлюз int 0x80, сторінка vDSO. Після pmm/vmm,
+// до irq_init: вектор 0x80 лежить у динамічному діапазоні irq_alloc_vector
+int syscall_init(void);
+syscall_path_t syscall_path(void);
+
+// Вхід швидкого шляху (sysenter_entry / syscall_entry) з увімкненими перериваннями
+long syscall_fast(uintptr_t number, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3);
+
+// Лічильники викликів за шляхами та номерами
+void syscall_print_stats(void);
+void syscall_reset_stats(void);
+
+#endif
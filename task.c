@@ -0,0 +1,375 @@
+#include "task.h"
+#include "cpu.h"
+#include "heap.h"
+#include "pmm.h"
+#include "ramfs.h"
+#include "syscall.h"
+#include "vmm.h"
+
+// Перший вхід у кільце 3 (kernel.asm / kernel64.asm): на x86_64 рядок
+// аргументів іде в RDI, на i386 - на стеку задачі
+#ifdef __x86_64__
+extern void enter_user(uintptr_t entry, uintptr_t user_sp, uintptr_t arg) __attribute__((noreturn));
+#else
+extern void enter_user(uintptr_t entry, uintptr_t user_sp) __attribute__((noreturn));
+#endif
+
+// ELF: лише те, що потрібно статичному виконуваному файлу
+#define ELF_MAGIC               0x464C457F      // "\x7FELF"
+#define ELF_IDENT_CLASS         4
+#define ELF_TYPE_EXEC           2
+#define ELF_SEGMENT_LOAD        1
+#define ELF_SEGMENT_WRITE       0x2
+
+#ifdef __x86_64__
+#define ELF_CLASS               2               // ELFCLASS64
+#define ELF_MACHINE             62              // EM_X86_64
+
+typedef struct {
+    uint8_t ident[16];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    uint64_t entry;
+    uint64_t phoff;
+    uint64_t shoff;
+    uint32_t flags;
+    uint16_t ehsize;
+    uint16_t phentsize;
+    uint16_t phnum;
+    uint16_t shentsize;
+    uint16_t shnum;
+    uint16_t shstrndx;
+} elf_header_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t flags;
+    uint64_t offset;
+    uint64_t vaddr;
+    uint64_t paddr;
+    uint64_t filesz;
+    uint64_t memsz;
+    uint64_t align;
+} elf_segment_t;
+#else
+#define ELF_CLASS               1               // ELFCLASS32
+#define ELF_MACHINE             3               // EM_386
+
+typedef struct {
+    uint8_t ident[16];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    uint32_t entry;
+    uint32_t phoff;
+    uint32_t shoff;
+    uint32_t flags;
+    uint16_t ehsize;
+    uint16_t phentsize;
+    uint16_t phnum;
+    uint16_t shentsize;
+    uint16_t shnum;
+    uint16_t shstrndx;
+} elf_header_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t offset;
+    uint32_t vaddr;
+    uint32_t paddr;
+    uint32_t filesz;
+    uint32_t memsz;
+    uint32_t flags;
+    uint32_t align;
+} elf_segment_t;
+#endif
+
+// Стек - останні сторінки області, образ має закінчуватися нижче
+#define TASK_REGION_END         (VMM_USER_BASE + VMM_USER_SIZE)
+#define TASK_STACK_BASE         (TASK_REGION_END - TASK_STACK_PAGES * PAGE_SIZE)
+
+static int available = false;
+
+// Статистика
+static uint64_t tasks_started = 0;
+static uint64_t tasks_exited = 0;
+static uint64_t tasks_faulted = 0;
+static uint64_t pages_loaded = 0;
+
+// === ЗАВАНТАЖЕННЯ ===
+
+// Сторінка області: наявна (спільна з попереднім сегментом) або новий нульовий кадр
+static uintptr_t map_page(task_t* task, uintptr_t page, uint32_t flags) {
+    uintptr_t frame = vmm_user_lookup(task->table, page);
+    if (frame) {
+        if (flags & VMM_WRITE) {
+            vmm_user_map(task->table, page, frame, flags);
+        }
+        return frame;
+    }
+    frame = pmm_alloc_frame();
+    if (!frame) {
+        return 0;
+    }
+    memset((void*)frame, 0, PAGE_SIZE);
+    if (vmm_user_map(task->table, page, frame, flags) != SUCCESS) {
+        pmm_free_frame(frame);
+        return 0;
+    }
+    pages_loaded++;
+    return frame;
+}
+
+// Кадри identity-відображені, тож дані копіюються прямо в них, не чіпаючи CR3
+static int load_segment(task_t* task, const uint8_t* image, size_t size, const elf_segment_t* segment) {
+    uintptr_t start = (uintptr_t)segment->vaddr;
+    uintptr_t end = start + (uintptr_t)segment->memsz;
+    uintptr_t file_end = start + (uintptr_t)segment->filesz;
+    if (segment->filesz > segment->memsz || segment->offset > size || segment->filesz > size - segment->offset ||
+        start < VMM_USER_BASE || end < start || end > TASK_STACK_BASE) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    uint32_t flags = (segment->flags & ELF_SEGMENT_WRITE) ? VMM_WRITE : 0;
+    for (uintptr_t page = start & ~(uintptr_t)(PAGE_SIZE - 1); page < end; page += PAGE_SIZE) {
+        uintptr_t frame = map_page(task, page, flags);
+        if (!frame) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        uintptr_t copy_start = page > start ? page : start;
+        uintptr_t copy_end = page + PAGE_SIZE < file_end ? page + PAGE_SIZE : file_end;
+        if (copy_start < copy_end) {
+            memcpy((uint8_t*)frame + (copy_start - page),
+                   image + (uintptr_t)segment->offset + (copy_start - start), copy_end - copy_start);
+        }
+    }
+    return SUCCESS;
+}
+
+static int load_elf(task_t* task, const uint8_t* image, size_t size) {
+    const elf_header_t* header = (const elf_header_t*)image;
+    if (size < sizeof(elf_header_t) || *(const uint32_t*)header->ident != ELF_MAGIC ||
+        header->ident[ELF_IDENT_CLASS] != ELF_CLASS || header->type != ELF_TYPE_EXEC ||
+        header->machine != ELF_MACHINE || header->phentsize != sizeof(elf_segment_t) ||
+        header->phoff > size || (size - header->phoff) / sizeof(elf_segment_t) < header->phnum) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (header->entry < VMM_USER_BASE || header->entry >= TASK_STACK_BASE) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    const elf_segment_t* segments = (const elf_segment_t*)(image + header->phoff);
+    for (uint32_t i = 0; i < header->phnum; i++) {
+        if (segments[i].type != ELF_SEGMENT_LOAD || segments[i].memsz == 0) continue;
+        int result = load_segment(task, image, size, &segments[i]);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+    task->entry = (uintptr_t)header->entry;
+    return SUCCESS;
+}
+
+// Стек з рядком аргументів нагорі. Вхід як після call: i386 - адреса
+// повернення й аргумент на стеку, x86_64 - аргумент у RDI, RSP = 8 mod 16
+static int setup_stack(task_t* task, const char* args) {
+    for (uintptr_t page = TASK_STACK_BASE; page < TASK_REGION_END; page += PAGE_SIZE) {
+        if (!map_page(task, page, VMM_WRITE)) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+    }
+
+    uintptr_t top_page = TASK_REGION_END - PAGE_SIZE;
+    uint8_t* top = (uint8_t*)vmm_user_lookup(task->table, top_page);
+    size_t length = strlen(args) + 1;
+    task->args = (TASK_REGION_END - length) & ~(uintptr_t)15;
+    memcpy(top + (task->args - top_page), args, length);
+
+    task->user_sp = task->args - 16 - sizeof(uintptr_t);
+    *(uintptr_t*)(top + (task->user_sp - top_page)) = 0;
+#ifndef __x86_64__
+    *(uintptr_t*)(top + (task->user_sp + sizeof(uintptr_t) - top_page)) = task->args;
+#endif
+    return SUCCESS;
+}
+
+// === ЖИТТЄВИЙ ЦИКЛ ===
+
+static void task_main(void* arg) {
+    task_t* task = arg;
+    thread_t* thread = sched_current();
+
+    // Від прив'язки задачі до iret у кільце 3 - без витіснення
+    asm volatile("cli");
+    thread->task = task;
+    task_switch(thread);
+    tasks_started++;
+#ifdef __x86_64__
+    enter_user(task->entry, task->user_sp, task->args);
+#else
+    enter_user(task->entry, task->user_sp);
+#endif
+}
+
+static void spawn_error(const char* path, const char* reason) {
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("exec: ");
+    terminal_writestring(path);
+    terminal_writestring(": ");
+    terminal_writestring(reason);
+    terminal_writestring("\n");
+}
+
+task_t* task_spawn(const char* path, const char* args, int* error) {
+    if (!available) {
+        spawn_error(path, "задачі кільця 3 недоступні");
+        *error = ERROR_INVALID_INPUT;
+        return NULL;
+    }
+    ramfs_node_t* node = ramfs_lookup(path);
+    if (!node || node->type != RAMFS_FILE) {
+        spawn_error(path, "файл не знайдено");
+        *error = ERROR_INVALID_INPUT;
+        return NULL;
+    }
+    if (strlen(args) >= TASK_ARGS_MAX) {
+        spawn_error(path, "задовгий рядок аргументів");
+        *error = ERROR_BUFFER_OVERFLOW;
+        return NULL;
+    }
+
+    task_t* task = kzalloc(sizeof(task_t));
+    if (!task) {
+        spawn_error(path, "недостатньо пам'яті");
+        *error = ERROR_BUFFER_OVERFLOW;
+        return NULL;
+    }
+    task->table = vmm_user_table_create();
+    if (!task->table) {
+        kfree(task);
+        spawn_error(path, "недостатньо пам'яті");
+        *error = ERROR_BUFFER_OVERFLOW;
+        return NULL;
+    }
+
+    int result = load_elf(task, node->extent.start, node->extent.length);
+    if (result == SUCCESS) {
+        result = setup_stack(task, args);
+    }
+    if (result == SUCCESS) {
+        task->thread = thread_create(node->name, task_main, task, SCHED_PRIO_SHELL);
+        if (!task->thread) {
+            result = ERROR_BUFFER_OVERFLOW;
+        }
+    }
+    if (result != SUCCESS) {
+        vmm_user_table_free(task->table);
+        kfree(task);
+        spawn_error(path, result == ERROR_INVALID_INPUT ? "не статичний ELF цієї архітектури або не вміщається в область"
+                                                        : "недостатньо пам'яті");
+        *error = result;
+        return NULL;
+    }
+    return task;
+}
+
+int task_wait(task_t* task) {
+    unsigned long flags = interrupts_save();
+    while (!task->exited) {
+        task->waiter = sched_current();
+        sched_block();
+    }
+    interrupts_restore(flags);
+
+    int code = task->exit_code;
+    kfree(task);
+    return code;
+}
+
+int task_run(const char* path, const char* args) {
+    int error;
+    task_t* task = task_spawn(path, args, &error);
+    if (!task) {
+        return error;
+    }
+    return task_wait(task);
+}
+
+void task_switch(thread_t* next) {
+    cpu_set_kernel_stack(next->stack + THREAD_STACK_PAGES * PAGE_SIZE);
+    vmm_user_activate(next->task->table);
+}
+
+// Таблицю знімаємо з каталогу до звільнення; потік стає зомбі звичайним шляхом
+void task_exit(int code) {
+    asm volatile("cli");
+    thread_t* thread = sched_current();
+    task_t* task = thread->task;
+    if (!task) {
+        kernel_panic("task_exit поза задачею");
+    }
+    thread->task = NULL;
+    vmm_user_activate(0);
+    vmm_user_table_free(task->table);
+    task->table = 0;
+
+    task->exit_code = code;
+    task->exited = true;
+    tasks_exited++;
+    sched_wakeup(task->waiter);
+    sched_exit();
+    while (1) {
+        asm volatile("hlt");
+    }
+}
+
+void task_fault(irq_frame_t* frame, uintptr_t addr) {
+    char buffer[24];
+    thread_t* thread = sched_current();
+    tasks_faulted++;
+
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("\nЗадача ");
+    terminal_writestring(thread ? thread->name : "?");
+    terminal_writestring(": виняток (вектор ");
+    terminal_writeuint(frame->vector);
+    terminal_writestring("), код помилки 0x");
+    uint64toa(frame->error_code, buffer, 16);
+    terminal_writestring(buffer);
+    if (frame->vector == 14) {
+        terminal_writestring(", адреса 0x");
+        uint64toa(addr, buffer, 16);
+        terminal_writestring(buffer);
+    }
+    terminal_writestring(", IP 0x");
+    uint64toa(IRQ_FRAME_IP(frame), buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(" - завершено\n");
+    task_exit(TASK_EXIT_FAULT);
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+int task_init(void) {
+    if (pmm_memory_end() > VMM_USER_BASE) {
+        terminal_writestring("Задачі: RAM перекриває область задач, кільце 3 вимкнено\n");
+        return ERROR_INVALID_INPUT;
+    }
+    available = true;
+    return SUCCESS;
+}
+
+// === СТАТИСТИКА ===
+
+void task_print_stats(void) {
+    terminal_writestring("Задачі: запущено ");
+    terminal_writeuint(tasks_started);
+    terminal_writestring(", завершено ");
+    terminal_writeuint(tasks_exited);
+    terminal_writestring(" (з них винятком ");
+    terminal_writeuint(tasks_faulted);
+    terminal_writestring("), завантажено сторінок ");
+    terminal_writeuint(pages_loaded);
+    terminal_writestring("\n");
+}
@@ -0,0 +1,52 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include "kernel.h"
+#include "sched.h"
+
+// Задачі кільця 3: статичний ELF (ET_EXEC) з initrd у власній області
+// VMM_USER_BASE..+VMM_USER_SIZE. Каталог сторінок спільний, при перемиканні
+// потоку підставляється лише таблиця області задачі. Задача - звичайний потік
+// ядра, що входить у кільце 3; його стек ядра стає стеком TSS/SYSCALL
+
+#define TASK_STACK_PAGES        4
+#define TASK_ARGS_MAX           128
+
+// Код виходу задачі, яку завершив виняток процесора
+#define TASK_EXIT_FAULT         (-128)
+
+typedef struct task {
+    thread_t* thread;
+    uintptr_t table;                // таблиця сторінок області (vmm_user_*)
+    uintptr_t entry;
+    uintptr_t user_sp;
+    uintptr_t args;                 // рядок аргументів на стеку задачі
+    int exit_code;
+    volatile int exited;
+    thread_t* waiter;
+} task_t;
+
+// Перевірка, що область задач не перетинає identity-відображення RAM
+int task_init(void);
+
+// Завантажити path і запустити з рядком args; NULL - помилка в *error
+task_t* task_spawn(const char* path, const char* args, int* error);
+
+// Дочекатися завершення, звільнити задачу; повертає код виходу
+int task_wait(task_t* task);
+
+// Спавн і очікування (команда exec): код виходу або ERROR_*
+int task_run(const char* path, const char* args);
+
+// Перемикання на потік задачі (schedule, вимкнені переривання): стек ядра
+// для входу з кільця 3 та таблиця області
+void task_switch(thread_t* next);
+
+// Завершення поточної задачі (SYS_EXIT, виняток кільця 3)
+void task_exit(int code) __attribute__((noreturn));
+void task_fault(irq_frame_t* frame, uintptr_t addr) __attribute__((noreturn));
+
+// Задачі: запущено, завершено, завершено винятком
+void task_print_stats(void);
+
+#endif
@@ -0,0 +1,358 @@
+#include "timer.h"
+#include "irq.h"
+
+// Частота TSC у кілогерцах (0 - ще не відкалібровано)
+static uint32_t tsc_frequency_khz = 0;
+
+// Точка відліку монотонного годинника
+static uint64_t boot_tsc = 0;
+
+// Мін-купа взведених дедлайнів
+static timer_event_t* timer_heap[TIMER_MAX_EVENTS];
+static int timer_count = 0;
+
+// Статистика: переривання та затримка пробудження відносно дедлайну
+static uint64_t timer_interrupts = 0;
+static uint64_t events_fired = 0;
+static uint64_t latency_min = 0;
+static uint64_t latency_max = 0;
+static uint64_t latency_total = 0;
+
+// Інтервал калібрування: 10 мс на каналі 2 PIT
+#define TSC_CALIBRATE_MS    10
+
+void tsc_calibrate(void) {
+    uint32_t count = PIT_FREQUENCY / (1000 / TSC_CALIBRATE_MS);
+    
+    // Вмикаємо gate каналу 2, динамік вимкнено
+    uint8_t gate = inb(PIT_CHANNEL2_GATE);
+    outb(PIT_CHANNEL2_GATE, (gate & ~0x02) | 0x01);
+    
+    // Канал 2, lobyte/hibyte, режим 0 (interrupt on terminal count)
+    outb(PIT_COMMAND, 0xB0);
+    outb(PIT_CHANNEL2_DATA, count & 0xFF);
+    outb(PIT_CHANNEL2_DATA, (count >> 8) & 0xFF);
+    
+    uint64_t start = rdtsc();
+    // Біт 5 порту 0x61 - вихід каналу 2, стає 1 після закінчення відліку
+    while ((inb(PIT_CHANNEL2_GATE) & 0x20) == 0) {
+    }
+    uint64_t end = rdtsc();
+    
+    outb(PIT_CHANNEL2_GATE, gate);
+    
+    tsc_frequency_khz = (uint32_t)div64_u32(end - start, TSC_CALIBRATE_MS, NULL);
+    if (tsc_frequency_khz == 0) {
+        tsc_frequency_khz = 1;
+    }
+}
+
+uint32_t tsc_khz(void) {
+    return tsc_frequency_khz;
+}
+
+uint64_t tsc_cycles_to_ns(uint64_t cycles) {
+    if (tsc_frequency_khz == 0) {
+        return 0;
+    }
+    // cycles * 10^6 / khz, з розбиттям щоб уникнути переповнення
+    uint32_t rem;
+    uint64_t whole = div64_u32(cycles, tsc_frequency_khz, &rem);
+    return whole * 1000000 + div64_u32((uint64_t)rem * 1000000, tsc_frequency_khz, NULL);
+}
+
+void tsc_delay_us(uint32_t us) {
+    uint64_t end = rdtsc() + div64_u32((uint64_t)us * tsc_frequency_khz, 1000, NULL);
+    while (rdtsc() < end) {
+        asm volatile("pause");
+    }
+}
+
+uint64_t tsc_per_second(uint64_t count, uint64_t cycles) {
+    uint64_t ns = tsc_cycles_to_ns(cycles);
+    if (ns == 0) {
+        return 0;
+    }
+    // count * 10^9 / ns; ns вкладається в 32 біти для коротких вимірів
+    while (ns > 0xFFFFFFFFull) {
+        ns >>= 1;
+        count >>= 1;
+    }
+    return div64_u32(count * 1000000000ull, (uint32_t)ns, NULL);
+}
+
+// === МОНОТОННИЙ ГОДИННИК ===
+
+void timer_init(void) {
+    boot_tsc = rdtsc();
+    timer_count = 0;
+    irq_install(IRQ_TIMER, "timer", timer_handler, 0);
+}
+
+uint64_t time_now_ns(void) {
+    return tsc_cycles_to_ns(rdtsc() - boot_tsc);
+}
+
+uint64_t timer_base_tsc(void) {
+    return boot_tsc;
+}
+
+// === КУПА ДЕДЛАЙНІВ ===
+
+static void heap_swap(int a, int b) {
+    timer_event_t* tmp = timer_heap[a];
+    timer_heap[a] = timer_heap[b];
+    timer_heap[b] = tmp;
+    timer_heap[a]->heap_index = a;
+    timer_heap[b]->heap_index = b;
+}
+
+static void heap_sift_up(int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (timer_heap[parent]->deadline <= timer_heap[index]->deadline) {
+            break;
+        }
+        heap_swap(parent, index);
+        index = parent;
+    }
+}
+
+static void heap_sift_down(int index) {
+    while (1) {
+        int smallest = index;
+        int left = index * 2 + 1;
+        int right = left + 1;
+        if (left < timer_count && timer_heap[left]->deadline < timer_heap[smallest]->deadline) {
+            smallest = left;
+        }
+        if (right < timer_count && timer_heap[right]->deadline < timer_heap[smallest]->deadline) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        heap_swap(smallest, index);
+        index = smallest;
+    }
+}
+
+static void heap_remove(int index) {
+    timer_heap[index]->heap_index = -1;
+    timer_count--;
+    if (index != timer_count) {
+        timer_heap[index] = timer_heap[timer_count];
+        timer_heap[index]->heap_index = index;
+        heap_sift_up(index);
+        heap_sift_down(timer_heap[index]->heap_index);
+    }
+}
+
+// === ОДНОРАЗОВИЙ PIT ===
+
+// Програмуємо канал 0 у режимі 0 лише під найближчий дедлайн;
+// без дедлайнів PIT мовчить і не будить процесор
+static void program_next(uint64_t now) {
+    if (timer_count == 0) {
+        return;
+    }
+
+    uint64_t deadline = timer_heap[0]->deadline;
+    uint64_t delta = deadline > now ? deadline - now : 0;
+    uint32_t ticks = PIT_MAX_TICKS;
+    if (delta < 54 * NS_PER_MS) {
+        // Округлюємо вгору, щоб не прокинутися раніше дедлайну
+        ticks = (uint32_t)div64_u32(delta * PIT_FREQUENCY + NS_PER_SEC - 1, NS_PER_SEC, NULL);
+    }
+    if (ticks < 2) {
+        ticks = 2;
+    }
+
+    outb(PIT_COMMAND, 0x30);    // канал 0, lobyte/hibyte, режим 0
+    outb(PIT_CHANNEL0_DATA, ticks & 0xFF);
+    outb(PIT_CHANNEL0_DATA, (ticks >> 8) & 0xFF);
+}
+
+void timer_event_init(timer_event_t* event, timer_callback_t callback, void* arg) {
+    event->deadline = 0;
+    event->callback = callback;
+    event->arg = arg;
+    event->heap_index = -1;
+}
+
+int timer_arm(timer_event_t* event, uint64_t deadline_ns) {
+    unsigned long flags = interrupts_save();
+
+    if (event->heap_index >= 0) {
+        heap_remove(event->heap_index);
+    }
+    if (timer_count >= TIMER_MAX_EVENTS) {
+        interrupts_restore(flags);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    event->deadline = deadline_ns;
+    event->heap_index = timer_count;
+    timer_heap[timer_count++] = event;
+    heap_sift_up(event->heap_index);
+
+    // Перепрограмовуємо лише якщо новий дедлайн став найближчим
+    if (timer_heap[0] == event) {
+        program_next(time_now_ns());
+    }
+
+    interrupts_restore(flags);
+    return SUCCESS;
+}
+
+void timer_cancel(timer_event_t* event) {
+    unsigned long flags = interrupts_save();
+    if (event->heap_index >= 0) {
+        heap_remove(event->heap_index);
+    }
+    interrupts_restore(flags);
+}
+
+void timer_handler(irq_frame_t* frame) {
+    (void)frame;
+    uint64_t now = time_now_ns();
+    timer_interrupts++;
+
+    while (timer_count > 0 && timer_heap[0]->deadline <= now) {
+        timer_event_t* event = timer_heap[0];
+        heap_remove(0);
+
+        uint64_t latency = now - event->deadline;
+        if (events_fired == 0 || latency < latency_min) latency_min = latency;
+        if (latency > latency_max) latency_max = latency;
+        latency_total += latency;
+        events_fired++;
+
+        // Колбек може знову взвести цей самий дедлайн
+        event->callback(event->arg);
+        now = time_now_ns();
+    }
+
+    program_next(now);
+}
+
+static void sleep_wakeup(void* arg) {
+    *(volatile int*)arg = true;
+}
+
+void timer_sleep_ns(uint64_t ns) {
+    volatile int done = false;
+    timer_event_t event;
+    timer_event_init(&event, sleep_wakeup, (void*)&done);
+
+    unsigned long flags = interrupts_save();
+    if (timer_arm(&event, time_now_ns() + ns) != SUCCESS) {
+        interrupts_restore(flags);
+        return;
+    }
+    // sti;hlt атомарні: переривання не загубиться між перевіркою та сном
+    while (!done) {
+        asm volatile("sti; hlt; cli" : : : "memory");
+    }
+    interrupts_restore(flags);
+}
+
+// === СТАТИСТИКА ===
+
+static void write_us(uint64_t ns) {
+    uint32_t rem;
+    terminal_writeuint(div64_u32(ns, 1000, &rem));
+    terminal_writestring(".");
+    terminal_writeuint(rem / 100);
+    terminal_writestring(" мкс");
+}
+
+void timer_print_uptime(void) {
+    uint32_t rem;
+    uint64_t ms = div64_u32(time_now_ns(), NS_PER_MS, NULL);
+    uint64_t seconds = div64_u32(ms, 1000, &rem);
+
+    terminal_writestring("Час роботи: ");
+    terminal_writeuint(seconds);
+    terminal_writestring(".");
+    if (rem < 100) terminal_writestring("0");
+    if (rem < 10) terminal_writestring("0");
+    terminal_writeuint(rem);
+    terminal_writestring(" с, переривань таймера: ");
+    terminal_writeuint(timer_interrupts);
+    terminal_writestring("\n");
+}
+
+void timer_print_stats(void) {
+    terminal_writestring("TSC: ");
+    terminal_writeuint(tsc_frequency_khz / 1000);
+    terminal_writestring(" МГц, дедлайнів спрацювало: ");
+    terminal_writeuint(events_fired);
+    terminal_writestring(", переривань: ");
+    terminal_writeuint(timer_interrupts);
+    terminal_writestring("\n");
+
+    if (events_fired) {
+        terminal_writestring("Затримка пробудження: мін ");
+        write_us(latency_min);
+        terminal_writestring(", сер ");
+        write_us(div64_u32(latency_total, (uint32_t)events_fired, NULL));
+        terminal_writestring(", макс ");
+        write_us(latency_max);
+        terminal_writestring(", джитер ");
+        write_us(latency_max - latency_min);
+        terminal_writestring("\n");
+    }
+}
+
+// === БЕНЧМАРК ДЖИТЕРА ===
+
+#define JITTER_SAMPLES      100
+
+static volatile int jitter_done;
+static uint64_t jitter_woken;
+
+static void jitter_wakeup(void* arg) {
+    (void)arg;
+    jitter_woken = time_now_ns();
+    jitter_done = true;
+}
+
+void timer_jitter_benchmark(void) {
+    timer_event_t event;
+    timer_event_init(&event, jitter_wakeup, NULL);
+
+    uint64_t min = (uint64_t)-1, max = 0, total = 0;
+    uint32_t seed = (uint32_t)rdtsc();
+
+    unsigned long flags = interrupts_save();
+    for (int i = 0; i < JITTER_SAMPLES; i++) {
+        // Інтервали 0.5-2.5 мс з псевдовипадковим зсувом відносно PIT
+        seed = seed * 1103515245 + 12345;
+        uint64_t deadline = time_now_ns() + 500000 + ((seed >> 8) % 2000000);
+
+        jitter_done = false;
+        timer_arm(&event, deadline);
+        while (!jitter_done) {
+            asm volatile("sti; hlt; cli" : : : "memory");
+        }
+
+        uint64_t latency = jitter_woken - deadline;
+        if (latency < min) min = latency;
+        if (latency > max) max = latency;
+        total += latency;
+    }
+    interrupts_restore(flags);
+
+    terminal_writestring("Затримка пробудження (");
+    terminal_writeuint(JITTER_SAMPLES);
+    terminal_writestring(" дедлайнів): мін ");
+    write_us(min);
+    terminal_writestring(", сер ");
+    write_us(div64_u32(total, JITTER_SAMPLES, NULL));
+    terminal_writestring(", макс ");
+    write_us(max);
+    terminal_writestring("\nДжитер (макс - мін): ");
+    write_us(max - min);
+    terminal_writestring("\n");
+}
@@ -0,0 +1,59 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "kernel.h"
+
+// PIT константи
+#define PIT_FREQUENCY       1193182
+#define PIT_CHANNEL0_DATA   0x40
+#define PIT_CHANNEL2_DATA   0x42
+#define PIT_COMMAND         0x43
+#define PIT_CHANNEL2_GATE   0x61
+
+// Найдовший інтервал одного відліку PIT (65535 тиків ~ 54.9 мс)
+#define PIT_MAX_TICKS       0xFFFF
+
+#define NS_PER_MS           1000000ull
+#define NS_PER_SEC          1000000000ull
+
+// Кількість одночасно взведених дедлайнів
+#define TIMER_MAX_EVENTS    64
+
+typedef void (*timer_callback_t)(void* arg);
+
+// Дедлайн належить викликачу, купа зберігає лише вказівники
+typedef struct timer_event {
+    uint64_t deadline;
+    timer_callback_t callback;
+    void* arg;
+    int32_t heap_index;         // -1, якщо не взведено
+} timer_event_t;
+
+// Калібрування TSC
+void tsc_calibrate(void);
+uint32_t tsc_khz(void);
+uint64_t tsc_cycles_to_ns(uint64_t cycles);
+uint64_t tsc_per_second(uint64_t count, uint64_t cycles);
+void tsc_delay_us(uint32_t us);
+
+// Монотонний годинник
+void timer_init(void);
+uint64_t time_now_ns(void);
+// Показ TSC, від якого відлічується time_now_ns (годинник vDSO)
+uint64_t timer_base_tsc(void);
+
+// Одноразові дедлайни
+void timer_event_init(timer_event_t* event, timer_callback_t callback, void* arg);
+int timer_arm(timer_event_t* event, uint64_t deadline_ns);
+void timer_cancel(timer_event_t* event);
+void timer_sleep_ns(uint64_t ns);
+
+// Обробник IRQ0 (irq_dispatch)
+void timer_handler(irq_frame_t* frame);
+
+// Статистика та бенчмарк
+void timer_print_uptime(void);
+void timer_print_stats(void);
+void timer_jitter_benchmark(void);
+
+#endif
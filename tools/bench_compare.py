@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Порівняння результатів "make bench" двох збірок (i386 та x86_64).
+
+Читає файли результатів (рядки BENCH-BEGIN та BENCH <ім'я> ...), друкує
+медіани в наносекундах поруч і відношення другої збірки до першої: значення
+менше 1.0 означає, що друга збірка швидша.
+
+Використання:
+  python3 tools/bench_compare.py bench_i386.txt bench_x86_64.txt
+"""
+
+import argparse
+import sys
+
+
+def parse_results(path):
+    """Повертає (опис збірки, {ім'я: медіана нс}) у порядку файлу."""
+    label = path
+    medians = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            parts = line.split()
+            if not parts:
+                continue
+            if parts[0] == "BENCH-BEGIN":
+                fields = dict(p.split("=", 1) for p in parts[1:] if "=" in p)
+                label = fields.get("arch", label)
+            elif parts[0] == "BENCH" and len(parts) == 8:
+                # ім'я, min/median/p99 у тактах, min/median/p99 у нс
+                medians[parts[1]] = int(parts[6])
+    return label, medians
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base", help="результати першої збірки (база)")
+    parser.add_argument("other", help="результати другої збірки")
+    args = parser.parse_args()
+
+    base_label, base = parse_results(args.base)
+    other_label, other = parse_results(args.other)
+    if not base or not other:
+        print("Немає рядків BENCH у %s" % (args.base if not base else args.other), file=sys.stderr)
+        return 1
+
+    print("%-22s %12s %12s %8s" % ("Бенчмарк", base_label + " нс", other_label + " нс", "відн."))
+    ratios = []
+    for name, base_ns in base.items():
+        if name not in other:
+            continue
+        other_ns = other[name]
+        ratio = other_ns / base_ns if base_ns else float("inf")
+        if base_ns:
+            ratios.append(ratio)
+        print("%-22s %12d %12d %8.2f" % (name, base_ns, other_ns, ratio))
+
+    missing = sorted(set(base) ^ set(other))
+    if missing:
+        print("Лише в одній збірці: %s" % ", ".join(missing))
+    if ratios:
+        product = 1.0
+        for ratio in ratios:
+            product *= ratio
+        print("Середнє геометричне відношення: %.3f" % (product ** (1.0 / len(ratios))))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
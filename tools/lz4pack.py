@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""Пакує ядро Nexus OS для розпакувальника stub/lz4stub.c.
+
+Сегменти PT_LOAD ядра (ELF32 або ELF64) складаються в плаский образ від
+найнижчої фізичної адреси до кінця ініціалізованих даних; BSS не пакується -
+його обнуляє GRUB, бо stub резервує під ядро порожній сегмент. Образ
+стискається у блок LZ4 (формат блоку, без кадру), перед ним - заголовок
+з шести 32-бітних слів:
+
+  magic 'NXZ4', адреса завантаження, точка входу, розмір образу,
+  розмір стиснутих даних, кінець ядра разом з BSS
+
+--ld пише KERNEL_LOAD і KERNEL_END для stub/stub.ld. Після стиснення блок
+розпаковується назад і порівнюється з образом.
+
+Використання:
+  python3 tools/lz4pack.py -o build/x86_64/kernel.lz4 --ld build/x86_64/kernel-layout.ld build/x86_64/nexus.elf
+  python3 tools/lz4pack.py --report build/x86_64/kernel.lz4 nexus.bin
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"NXZ4"
+HEADER = struct.Struct("<4sIIIII")
+
+# Обмеження формату блоку LZ4
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MF_LIMIT = 12
+MAX_OFFSET = 65535
+
+PT_LOAD = 1
+
+
+def load_image(path):
+    """Плаский образ PT_LOAD-сегментів: (адреса, вхід, байти, кінець з BSS)."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        sys.exit("%s: не ELF" % path)
+    is64 = elf[4] == 2
+    if is64:
+        entry, phoff = struct.unpack_from("<QQ", elf, 24)
+        phentsize, phnum = struct.unpack_from("<HH", elf, 54)
+    else:
+        entry, phoff = struct.unpack_from("<II", elf, 24)
+        phentsize, phnum = struct.unpack_from("<HH", elf, 42)
+
+    segments = []
+    for i in range(phnum):
+        at = phoff + i * phentsize
+        if is64:
+            ptype, _, offset, _, paddr, filesz, memsz = struct.unpack_from("<IIQQQQQ", elf, at)
+        else:
+            ptype, offset, _, paddr, filesz, memsz = struct.unpack_from("<IIIIII", elf, at)
+        if ptype == PT_LOAD and memsz > 0:
+            segments.append((paddr, offset, filesz, memsz))
+    if not segments:
+        sys.exit("%s: немає сегментів PT_LOAD" % path)
+
+    base = min(s[0] for s in segments)
+    file_end = max(s[0] + s[2] for s in segments)
+    mem_end = max(s[0] + s[3] for s in segments)
+    if mem_end > 0xFFFFFFFF or entry > 0xFFFFFFFF:
+        sys.exit("%s: ядро має лежати нижче 4 ГБ" % path)
+
+    image = bytearray(file_end - base)
+    for paddr, offset, filesz, _ in segments:
+        image[paddr - base:paddr - base + filesz] = elf[offset:offset + filesz]
+    return base, entry, bytes(image), mem_end
+
+
+def write_length(out, value):
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+
+
+def emit(out, literals, offset, match_length):
+    lit = len(literals)
+    extra = match_length - MIN_MATCH
+    out.append((min(lit, 15) << 4) | min(extra, 15))
+    if lit >= 15:
+        write_length(out, lit - 15)
+    out += literals
+    out += struct.pack("<H", offset)
+    if extra >= 15:
+        write_length(out, extra - 15)
+
+
+def compress(data):
+    """Жадібний пошук: остання позиція кожних 4 байтів у словнику."""
+    n = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    limit = n - MF_LIMIT
+    while i < limit:
+        key = data[i:i + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > MAX_OFFSET:
+            i += 1
+            continue
+        length = MIN_MATCH
+        max_length = n - LAST_LITERALS - i
+        while length < max_length and data[candidate + length] == data[i + length]:
+            length += 1
+        emit(out, data[anchor:i], i - candidate, length)
+        i += length
+        anchor = i
+        # Позиція перед кінцем збігу - дешевий шанс на наступний збіг
+        if i - 2 > candidate:
+            table[data[i - 2:i + 2]] = i - 2
+
+    literals = data[anchor:]
+    out.append(min(len(literals), 15) << 4)
+    if len(literals) >= 15:
+        write_length(out, len(literals) - 15)
+    out += literals
+    return bytes(out)
+
+
+def read_length(data, pos, value):
+    if value == 15:
+        while True:
+            byte = data[pos]
+            pos += 1
+            value += byte
+            if byte != 255:
+                break
+    return value, pos
+
+
+def decompress(data, size):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        lit, pos = read_length(data, pos, token >> 4)
+        out += data[pos:pos + lit]
+        pos += lit
+        if pos >= len(data):
+            break
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        length, pos = read_length(data, pos, token & 15)
+        length += MIN_MATCH
+        start = len(out) - offset
+        if offset >= length:
+            out += out[start:start + length]
+        else:
+            for k in range(length):
+                out.append(out[start + k])
+    if len(out) != size:
+        raise ValueError("розмір після розпакування %d, очікувався %d" % (len(out), size))
+    return bytes(out)
+
+
+def pack(args):
+    base, entry, image, mem_end = load_image(args.kernel)
+    packed = compress(image)
+    if decompress(packed, len(image)) != image:
+        sys.exit("lz4pack: розпакований блок не збігається з образом")
+
+    with open(args.output, "wb") as f:
+        f.write(HEADER.pack(MAGIC, base, entry, len(image), len(packed), mem_end))
+        f.write(packed)
+    if args.ld:
+        with open(args.ld, "w") as f:
+            f.write("/* Згенеровано tools/lz4pack.py з %s */\n" % os.path.basename(args.kernel))
+            f.write("KERNEL_LOAD = 0x%x;\n" % base)
+            f.write("KERNEL_END = 0x%x;\n" % mem_end)
+    print("lz4pack: %d -> %d байт (%.1f%%), ядро 0x%x-0x%x, вхід 0x%x"
+          % (len(image), len(packed), 100.0 * len(packed) / len(image), base, mem_end, entry))
+
+
+def report(args):
+    with open(args.report, "rb") as f:
+        magic, base, entry, raw, packed, mem_end = HEADER.unpack(f.read(HEADER.size))
+    if magic != MAGIC:
+        sys.exit("%s: не пакет lz4pack" % args.report)
+    print("  образ ядра (без BSS):   %8d Б" % raw)
+    print("  BSS:                    %8d Б" % (mem_end - base - raw))
+    print("  стиснуто LZ4:           %8d Б (%.1f%%)" % (packed, 100.0 * packed / raw))
+    for path in args.files:
+        if os.path.exists(path):
+            print("  %-23s %8d Б" % (path + ":", os.path.getsize(path)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Пакування ядра Nexus OS у LZ4")
+    parser.add_argument("kernel", nargs="?", help="ELF ядра")
+    parser.add_argument("files", nargs="*", help="з --report: файли, розмір яких показати")
+    parser.add_argument("-o", "--output", help="вихідний пакет")
+    parser.add_argument("--ld", help="файл з KERNEL_LOAD/KERNEL_END для stub.ld")
+    parser.add_argument("--report", metavar="PACKAGE", help="звіт про розміри пакета")
+    args = parser.parse_args()
+
+    if args.report:
+        if args.kernel:
+            args.files.insert(0, args.kernel)
+        report(args)
+    elif args.kernel and args.output:
+        pack(args)
+    else:
+        parser.error("потрібні ELF ядра та -o, або --report")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Збирає initrd для Nexus OS - ustar-архів, який GRUB завантажує модулем.
+
+До архіву потрапляє вміст каталогу-джерела (типово initrd/), програми
+кільця 3 з --bin у /bin та згенеровані файли для "fsbench":
+bench/dNN/fNNNNN.txt у 64 каталогах і bench/big.bin.
+Вміст і дати детерміновані, тож однаковий вхід дає побайтово однаковий архів.
+
+Використання:
+  python3 tools/mkinitrd.py -o build/initrd.tar initrd
+  python3 tools/mkinitrd.py --bench-files 0 -o build/initrd.tar initrd
+  python3 tools/mkinitrd.py --bin build/x86_64/user/bin -o build/initrd.tar initrd
+"""
+
+import argparse
+import io
+import os
+import sys
+import tarfile
+
+BENCH_DIRS = 64
+BENCH_MTIME = 1700000000
+
+
+def add_bytes(tar, name, data, mode=0o644):
+    info = tarfile.TarInfo(name)
+    info.size = len(data)
+    info.mode = mode
+    info.mtime = BENCH_MTIME
+    tar.addfile(info, io.BytesIO(data))
+
+
+def add_dir(tar, name):
+    info = tarfile.TarInfo(name)
+    info.type = tarfile.DIRTYPE
+    info.mode = 0o755
+    info.mtime = BENCH_MTIME
+    tar.addfile(info)
+
+
+def bench_file(index):
+    """Текстовий файл розміром 64 Б - 4 КБ з номером у кожному рядку."""
+    size = 64 + (index * 2654435761) % 4032
+    line = ("file %05d: Nexus OS initrd benchmark data\n" % index).encode()
+    data = line * (size // len(line) + 1)
+    return data[:size]
+
+
+def normalize(info):
+    """Без власника та часу з робочої копії - архів не залежить від машини."""
+    info.uid = info.gid = 0
+    info.uname = info.gname = ""
+    info.mtime = BENCH_MTIME
+    return info
+
+
+def add_source(tar, source):
+    for top, dirs, names in os.walk(source):
+        dirs.sort()
+        rel = os.path.relpath(top, source)
+        if rel != ".":
+            tar.add(top, arcname=rel, recursive=False, filter=normalize)
+        for name in sorted(names):
+            path = os.path.join(top, name)
+            tar.add(path, arcname=os.path.normpath(os.path.join(rel, name)), recursive=False, filter=normalize)
+
+
+def add_programs(tar, directory):
+    """Виконувані файли кільця 3 у /bin з правами 0755."""
+    add_dir(tar, "bin")
+    for name in sorted(os.listdir(directory)):
+        path = os.path.join(directory, name)
+        if os.path.isfile(path):
+            with open(path, "rb") as f:
+                add_bytes(tar, "bin/" + name, f.read(), mode=0o755)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", nargs="?", help="каталог, вміст якого стає коренем initrd")
+    parser.add_argument("-o", "--output", required=True, help="вихідний tar-файл")
+    parser.add_argument("--bench-files", type=int, default=8192, help="кількість згенерованих файлів (0 - без них)")
+    parser.add_argument("--bin", help="каталог програм кільця 3 для /bin")
+    parser.add_argument("--big-size", type=int, default=4 << 20, help="розмір bench/big.bin у байтах")
+    args = parser.parse_args()
+
+    with tarfile.open(args.output, "w", format=tarfile.USTAR_FORMAT) as tar:
+        if args.source:
+            if not os.path.isdir(args.source):
+                print("Немає каталогу %s" % args.source, file=sys.stderr)
+                return 1
+            add_source(tar, args.source)
+        if args.bin:
+            if not os.path.isdir(args.bin):
+                print("Немає каталогу %s" % args.bin, file=sys.stderr)
+                return 1
+            add_programs(tar, args.bin)
+        if args.bench_files > 0:
+            add_dir(tar, "bench")
+            for d in range(BENCH_DIRS):
+                add_dir(tar, "bench/d%02d" % d)
+            for i in range(args.bench_files):
+                add_bytes(tar, "bench/d%02d/f%05d.txt" % (i % BENCH_DIRS, i), bench_file(i))
+            # Псевдовипадковий вміст: xorshift32
+            big = bytearray(args.big_size)
+            x = 2463534242
+            for i in range(0, len(big) - 3, 4):
+                x ^= (x << 13) & 0xFFFFFFFF
+                x ^= x >> 17
+                x ^= (x << 5) & 0xFFFFFFFF
+                big[i:i + 4] = x.to_bytes(4, "little")
+            add_bytes(tar, "bench/big.bin", bytes(big))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
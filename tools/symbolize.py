@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""Символізація дампів "trace dump" та "profile dump" з логу COM1 Nexus OS.
+
+Адреси семплів зіставляються з символами build/x86_64/nexus.elf (nm, за бажанням
+addr2line для рядків коду). Результат:
+  <out>.flat.txt    - плаский профіль: семпли на функцію
+  <out>.folded.txt  - folded-стеки (потік;виклики;функція N) для flamegraph.pl
+  <out>.trace.txt   - зведення трасування: IRQ, команди, скидання VGA
+
+Використання:
+  python3 tools/symbolize.py --kernel build/x86_64/nexus.elf --out profile profile_serial.log
+"""
+
+import argparse
+import bisect
+import collections
+import subprocess
+import sys
+
+IRQ_NAMES = {32: "timer", 33: "keyboard", 36: "serial", 0xF0: "ipi"}
+
+
+class Symbols:
+    def __init__(self, kernel):
+        out = subprocess.run(["nm", "-n", "--defined-only", kernel],
+                             check=True, capture_output=True, text=True).stdout
+        self.addrs = []
+        self.names = []
+        for line in out.splitlines():
+            parts = line.split()
+            if len(parts) == 3 and parts[1] in "tTwW":
+                self.addrs.append(int(parts[0], 16))
+                self.names.append(parts[2])
+        self.kernel = kernel
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return "0x%x" % addr
+        return self.names[i]
+
+    def lines(self, addrs):
+        """addr2line для списку адрес (потрібна збірка з -g)."""
+        if not addrs:
+            return {}
+        proc = subprocess.run(["addr2line", "-e", self.kernel] + ["0x%x" % a for a in addrs],
+                              check=True, capture_output=True, text=True)
+        return dict(zip(addrs, proc.stdout.splitlines()))
+
+
+def parse_log(path):
+    threads = {}
+    samples = []
+    events = []
+    tsc_khz = 0
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for raw in f:
+            line = raw.replace("\r", "").strip()
+            parts = line.split()
+            if not parts:
+                continue
+            tag = parts[0]
+            if tag == "PROFILE-THREAD" and len(parts) >= 3:
+                threads[int(parts[1])] = parts[2]
+            elif tag == "PROFILE" and len(parts) >= 4:
+                cpu, tid = int(parts[1]), int(parts[2])
+                stack = [int(x, 16) for x in parts[3:]]
+                samples.append((cpu, tid, stack))
+            elif tag == "TRACE-BEGIN":
+                # Кожен дамп містить усе кільце - беремо останній
+                events = []
+                for kv in parts[1:]:
+                    if kv.startswith("tsc_khz="):
+                        tsc_khz = int(kv.split("=", 1)[1])
+            elif tag == "TRACE" and len(parts) == 6:
+                events.append((int(parts[1]), int(parts[2]), parts[3],
+                               int(parts[4], 16), int(parts[5], 16)))
+    return threads, samples, events, tsc_khz
+
+
+def write_profiles(out, symbols, threads, samples, use_lines):
+    flat = collections.Counter()
+    folded = collections.Counter()
+    line_counts = collections.Counter()
+
+    for cpu, tid, stack in samples:
+        leaf = stack[0]
+        # Адреси повернення вказують за call - символізуємо попередній байт
+        frames = [symbols.lookup(leaf)] + [symbols.lookup(ret - 1) for ret in stack[1:]]
+        flat[frames[0]] += 1
+        if use_lines:
+            line_counts[leaf] += 1
+        thread = threads.get(tid, "tid%d" % tid)
+        folded[";".join(["%s/cpu%d" % (thread, cpu)] + frames[::-1])] += 1
+
+    total = len(samples) or 1
+    with open(out + ".flat.txt", "w") as f:
+        f.write("# %d семплів\n" % len(samples))
+        f.write("# %8s %7s  %s\n" % ("семпли", "%", "функція"))
+        for name, count in flat.most_common():
+            f.write("%10d %6.2f%%  %s\n" % (count, 100.0 * count / total, name))
+        if use_lines:
+            resolved = symbols.lines(list(line_counts))
+            f.write("\n# за рядками коду\n")
+            for addr, count in line_counts.most_common():
+                f.write("%10d %6.2f%%  %s %s\n" % (count, 100.0 * count / total,
+                                                 symbols.lookup(addr), resolved.get(addr, "??")))
+
+    with open(out + ".folded.txt", "w") as f:
+        for stack, count in sorted(folded.items()):
+            f.write("%s %d\n" % (stack, count))
+
+    return flat
+
+
+def cycles_to_us(cycles, tsc_khz):
+    return cycles * 1000.0 / tsc_khz if tsc_khz else 0.0
+
+
+def write_trace(out, events, tsc_khz):
+    irq = collections.defaultdict(list)
+    commands = []
+    flushes = []
+    switches = 0
+
+    for cpu, tsc, name, arg0, arg1 in events:
+        if name == "irq_exit":
+            irq[(cpu, arg0)].append(arg1)
+        elif name == "cmd_begin":
+            text = arg0.to_bytes(4, "little").rstrip(b"\0").decode("utf-8", "replace")
+            commands.append([text, None])
+        elif name == "cmd_end" and commands and commands[-1][1] is None:
+            commands[-1][1] = arg0
+        elif name == "vga_flush":
+            flushes.append((arg0, arg1))
+        elif name == "sched_switch":
+            switches += 1
+
+    lines = []
+    lines.append("# %d подій, TSC %d кГц" % (len(events), tsc_khz))
+    if events:
+        span = events[-1][1] - events[0][1]
+        lines.append("# проміжок %.3f мс" % (cycles_to_us(span, tsc_khz) / 1000.0))
+
+    lines.append("\nIRQ (такти в обробнику):")
+    lines.append("%4s %-10s %8s %10s %10s %10s" % ("CPU", "вектор", "к-сть", "сер.", "макс.", "макс. мкс"))
+    for (cpu, vector), values in sorted(irq.items()):
+        label = "%d/%s" % (vector, IRQ_NAMES.get(vector, "?"))
+        lines.append("%4d %-10s %8d %10d %10d %10.1f" % (cpu, label, len(values),
+                                                        sum(values) // len(values), max(values),
+                                                        cycles_to_us(max(values), tsc_khz)))
+
+    lines.append("\nКоманди shell:")
+    for text, cycles in commands:
+        if cycles is None:
+            lines.append("  %-6s (не завершилась у межах кільця)" % text)
+        else:
+            lines.append("  %-6s %12d тактів %10.1f мкс" % (text, cycles, cycles_to_us(cycles, tsc_khz)))
+
+    if flushes:
+        rows = sum(r for r, _ in flushes)
+        worst = max(c for _, c in flushes)
+        lines.append("\nСкидання VGA: %d, рядків %d, найдовше %d тактів (%.1f мкс)"
+                     % (len(flushes), rows, worst, cycles_to_us(worst, tsc_khz)))
+    lines.append("Перемикань потоків: %d" % switches)
+
+    with open(out + ".trace.txt", "w") as f:
+        f.write("\n".join(lines) + "\n")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", help="лог COM1 з рядками PROFILE/TRACE")
+    parser.add_argument("--kernel", default="build/x86_64/nexus.elf", help="ELF ядра з символами")
+    parser.add_argument("--out", default="profile", help="префікс вихідних файлів")
+    parser.add_argument("--lines", action="store_true", help="addr2line для рядків коду (збірка з -g)")
+    parser.add_argument("--top", type=int, default=20, help="скільки функцій показати")
+    args = parser.parse_args()
+
+    threads, samples, events, tsc_khz = parse_log(args.log)
+    if not samples and not events:
+        print("У %s немає дампів PROFILE/TRACE" % args.log, file=sys.stderr)
+        return 1
+
+    symbols = Symbols(args.kernel)
+    if samples:
+        flat = write_profiles(args.out, symbols, threads, samples, args.lines)
+        print("Семплів: %d -> %s.flat.txt, %s.folded.txt" % (len(samples), args.out, args.out))
+        for name, count in flat.most_common(args.top):
+            print("%8d %6.2f%%  %s" % (count, 100.0 * count / len(samples), name))
+    if events:
+        print("\n".join(write_trace(args.out, events, tsc_khz)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,412 @@
+#include "trace.h"
+#include "cpu.h"
+#include "pmm.h"
+#include "sched.h"
+#include "serial.h"
+#include "timer.h"
+
+extern char end[];
+
+// Скільки різних потоків називає дамп профайлера
+#define PROFILE_DUMP_THREADS    64
+
+volatile int trace_enabled = false;
+
+static uint32_t ring_pages = 0;
+
+// Профайлер: буфер семплів та періодичний дедлайн на BSP
+// Ядро лежить нижче 4 ГБ і в x86_64-збірці - адреси вміщаються в 32 біти
+typedef struct {
+    uint32_t ip;
+    uint16_t tid;
+    uint8_t cpu;
+    uint8_t depth;
+    uint32_t frames[PROFILE_MAX_DEPTH];
+} profile_sample_t;
+
+static profile_sample_t* samples = NULL;
+static uint32_t sample_count = 0;
+static uint32_t samples_dropped = 0;
+static uint32_t profile_hz = 0;
+static uint64_t profile_period_ns = 0;
+static timer_event_t profile_timer;
+static int profiling = false;
+
+static const char* event_names[TRACE_EVENT_COUNT] = {
+    "none", "irq_enter", "irq_exit", "cmd_begin", "cmd_end", "vga_flush", "sched_switch"
+};
+
+int trace_init(void) {
+    ring_pages = (sizeof(trace_ring_t) + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+        if (!cpus[i].online || cpus[i].trace_ring) {
+            continue;
+        }
+        uintptr_t frames = pmm_alloc_frames(ring_pages);
+        if (!frames) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        trace_ring_t* ring = (trace_ring_t*)frames;
+        ring->head = 0;
+        cpus[i].trace_ring = ring;
+    }
+
+    timer_event_init(&profile_timer, NULL, NULL);
+    return SUCCESS;
+}
+
+void trace_start(void) {
+    trace_enabled = true;
+}
+
+void trace_stop(void) {
+    trace_enabled = false;
+}
+
+void trace_clear(void) {
+    for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+        if (cpus[i].trace_ring) {
+            cpus[i].trace_ring->head = 0;
+        }
+    }
+}
+
+// === ЗАПИС ПОДІЙ ===
+
+void trace_record(uint32_t id, uint32_t arg0, uint32_t arg1) {
+    trace_ring_t* ring = this_cpu()->trace_ring;
+    if (!ring) {
+        return;
+    }
+
+    // xadd атомарний відносно переривань на цьому процесорі, а інші
+    // процесори в це кільце не пишуть - lock не потрібен
+    uint32_t slot = 1;
+    asm volatile("xaddl %0, %1" : "+r"(slot), "+m"(ring->head) : : "memory");
+
+    trace_event_t* event = &ring->events[slot & (TRACE_RING_SIZE - 1)];
+    event->id = id;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+    event->tsc = rdtsc();
+}
+
+void trace_irq_enter(uint32_t vector, irq_frame_t* frame) {
+    cpu_t* cpu = this_cpu();
+    cpu->irq_frame = frame;
+    if (trace_enabled) {
+        cpu->irq_enter_tsc = rdtsc();
+        trace_record(TRACE_IRQ_ENTER, vector, (uint32_t)IRQ_FRAME_IP(frame));
+    }
+}
+
+void trace_irq_exit(uint32_t vector) {
+    cpu_t* cpu = this_cpu();
+    cpu->irq_frame = NULL;
+    if (trace_enabled) {
+        trace_record(TRACE_IRQ_EXIT, vector, (uint32_t)(rdtsc() - cpu->irq_enter_tsc));
+    }
+}
+
+// === ПРОФАЙЛЕР ===
+
+// Ланцюжок EBP/RBP існує лише у збірці з -fno-omit-frame-pointer (PROFILE_FRAMES=1)
+static uint8_t walk_frames(const irq_frame_t* frame, uint32_t* out) {
+#ifdef PROFILE_FRAME_POINTERS
+    if (IRQ_FRAME_USER(frame)) {
+        return 0;                   // ланцюжок кільця 3 ядру не цікавий
+    }
+    uintptr_t low = IRQ_FRAME_SP(frame);
+    uintptr_t high = low + THREAD_STACK_PAGES * PAGE_SIZE;
+    uintptr_t fp = IRQ_FRAME_FP(frame);
+    uint8_t depth = 0;
+
+    while (depth < PROFILE_MAX_DEPTH && fp >= low && fp + 2 * sizeof(uintptr_t) <= high &&
+           !(fp & (sizeof(uintptr_t) - 1))) {
+        uintptr_t ret = ((uintptr_t*)fp)[1];
+        if (ret < PMM_LOW_MEMORY_END || ret >= (uintptr_t)end) {
+            break;
+        }
+        out[depth++] = (uint32_t)ret;
+        uintptr_t next = ((uintptr_t*)fp)[0];
+        if (next <= fp) {
+            break;
+        }
+        fp = next;
+    }
+    return depth;
+#else
+    (void)frame;
+    (void)out;
+    return 0;
+#endif
+}
+
+static void profile_tick(void* arg) {
+    (void)arg;
+    cpu_t* cpu = this_cpu();
+    const irq_frame_t* frame = cpu->irq_frame;
+
+    if (frame) {
+        if (sample_count < PROFILE_MAX_SAMPLES) {
+            profile_sample_t* sample = &samples[sample_count++];
+            thread_t* thread = sched_current();
+            sample->ip = (uint32_t)IRQ_FRAME_IP(frame);
+            sample->tid = thread ? (uint16_t)thread->tid : 0xFFFF;
+            sample->cpu = (uint8_t)cpu->index;
+            sample->depth = walk_frames(frame, sample->frames);
+        } else {
+            samples_dropped++;
+        }
+    }
+
+    // Період від попереднього дедлайну, щоб частота не пливла
+    uint64_t next = profile_timer.deadline + profile_period_ns;
+    uint64_t now = time_now_ns();
+    if (next <= now) {
+        next = now + profile_period_ns;
+    }
+    timer_arm(&profile_timer, next);
+}
+
+int profile_start(uint32_t hz) {
+    if (hz == 0 || hz > PROFILE_MAX_HZ) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (!samples) {
+        uint32_t pages = (PROFILE_MAX_SAMPLES * sizeof(profile_sample_t) + PAGE_SIZE - 1) / PAGE_SIZE;
+        samples = (profile_sample_t*)pmm_alloc_frames(pages);
+        if (!samples) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+    }
+
+    unsigned long flags = interrupts_save();
+    sample_count = 0;
+    samples_dropped = 0;
+    profile_hz = hz;
+    profile_period_ns = div64_u32(NS_PER_SEC, hz, NULL);
+    timer_event_init(&profile_timer, profile_tick, NULL);
+    profiling = true;
+    int result = timer_arm(&profile_timer, time_now_ns() + profile_period_ns);
+    if (result != SUCCESS) {
+        profiling = false;
+    }
+    interrupts_restore(flags);
+    return result;
+}
+
+void profile_stop(void) {
+    timer_cancel(&profile_timer);
+    profiling = false;
+}
+
+int profile_active(void) {
+    return profiling;
+}
+
+// === ВИВІД У COM1 ===
+
+static char* append_str(char* p, const char* s) {
+    while (*s) {
+        *p++ = *s++;
+    }
+    return p;
+}
+
+static char* append_num(char* p, uint64_t value, int base) {
+    uint64toa(value, p, base);
+    return p + strlen(p);
+}
+
+static void emit_line(char* line, char* p) {
+    *p++ = '\n';
+    serial_write(line, (size_t)(p - line));
+}
+
+static const char* event_name(uint32_t id) {
+    return id < TRACE_EVENT_COUNT ? event_names[id] : "unknown";
+}
+
+void trace_dump(void) {
+    char line[128];
+    uint32_t cursor[SMP_MAX_CPUS];
+    uint32_t stop[SMP_MAX_CPUS];
+    uint32_t total = 0, lost = 0, ncpus = 0;
+
+    // Зупиняємо запис, щоб читати узгоджені кільця
+    int was_enabled = trace_enabled;
+    trace_enabled = false;
+
+    for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+        cursor[i] = stop[i] = 0;
+        trace_ring_t* ring = cpus[i].trace_ring;
+        if (!ring) {
+            continue;
+        }
+        ncpus++;
+        stop[i] = ring->head;
+        if (stop[i] > TRACE_RING_SIZE) {
+            cursor[i] = stop[i] - TRACE_RING_SIZE;
+            lost += cursor[i];
+        }
+    }
+
+    char* p = append_str(line, "TRACE-BEGIN tsc_khz=");
+    p = append_num(p, tsc_khz(), 10);
+    p = append_str(p, " cpus=");
+    p = append_num(p, ncpus, 10);
+    emit_line(line, p);
+
+    // Злиття кілець за TSC (на QEMU та сучасних процесорах TSC синхронний)
+    while (1) {
+        int best = -1;
+        uint64_t best_tsc = 0;
+        for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+            if (cursor[i] == stop[i]) {
+                continue;
+            }
+            const trace_event_t* event = &cpus[i].trace_ring->events[cursor[i] & (TRACE_RING_SIZE - 1)];
+            if (best < 0 || event->tsc < best_tsc) {
+                best = (int)i;
+                best_tsc = event->tsc;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        const trace_event_t* event = &cpus[best].trace_ring->events[cursor[best] & (TRACE_RING_SIZE - 1)];
+        cursor[best]++;
+        total++;
+
+        p = append_str(line, "TRACE ");
+        p = append_num(p, (uint32_t)best, 10);
+        *p++ = ' ';
+        p = append_num(p, event->tsc, 10);
+        *p++ = ' ';
+        p = append_str(p, event_name(event->id));
+        p = append_str(p, " 0x");
+        p = append_num(p, event->arg0, 16);
+        p = append_str(p, " 0x");
+        p = append_num(p, event->arg1, 16);
+        emit_line(line, p);
+    }
+
+    p = append_str(line, "TRACE-END events=");
+    p = append_num(p, total, 10);
+    p = append_str(p, " lost=");
+    p = append_num(p, lost, 10);
+    emit_line(line, p);
+    serial_flush();
+
+    trace_enabled = was_enabled;
+}
+
+void profile_dump(void) {
+    char line[160];
+    uint16_t tids[PROFILE_DUMP_THREADS];
+    uint32_t ntids = 0;
+
+    int was_profiling = profiling;
+    profile_stop();
+
+    char* p = append_str(line, "PROFILE-BEGIN hz=");
+    p = append_num(p, profile_hz, 10);
+    p = append_str(p, " samples=");
+    p = append_num(p, sample_count, 10);
+    p = append_str(p, " dropped=");
+    p = append_num(p, samples_dropped, 10);
+    emit_line(line, p);
+
+    for (uint32_t i = 0; i < sample_count; i++) {
+        const profile_sample_t* sample = &samples[i];
+
+        // Імена потоків виводимо один раз, перед першим семплом
+        uint32_t known = 0;
+        while (known < ntids && tids[known] != sample->tid) {
+            known++;
+        }
+        if (known == ntids && ntids < PROFILE_DUMP_THREADS) {
+            char name[THREAD_NAME_LEN];
+            tids[ntids++] = sample->tid;
+            if (sched_thread_name(sample->tid, name) != SUCCESS) {
+                strcpy(name, sample->tid == 0xFFFF ? "boot" : "exited");
+            }
+            p = append_str(line, "PROFILE-THREAD ");
+            p = append_num(p, sample->tid, 10);
+            *p++ = ' ';
+            p = append_str(p, name);
+            emit_line(line, p);
+        }
+
+        p = append_str(line, "PROFILE ");
+        p = append_num(p, sample->cpu, 10);
+        *p++ = ' ';
+        p = append_num(p, sample->tid, 10);
+        p = append_str(p, " 0x");
+        p = append_num(p, sample->ip, 16);
+        for (uint32_t d = 0; d < sample->depth; d++) {
+            p = append_str(p, " 0x");
+            p = append_num(p, sample->frames[d], 16);
+        }
+        emit_line(line, p);
+    }
+
+    p = append_str(line, "PROFILE-END");
+    emit_line(line, p);
+    serial_flush();
+
+    // Продовжуємо з новим буфером
+    if (was_profiling) {
+        profile_start(profile_hz);
+    }
+}
+
+// === ЗВІТИ ===
+
+void trace_print_stats(void) {
+    terminal_writestring("Трасування: ");
+    terminal_writestring(trace_enabled ? "увімкнено" : "вимкнено");
+    terminal_writestring(", кільце ");
+    terminal_writeuint(TRACE_RING_SIZE);
+    terminal_writestring(" подій на процесор\n");
+
+    for (uint32_t i = 0; i < SMP_MAX_CPUS; i++) {
+        trace_ring_t* ring = cpus[i].trace_ring;
+        if (!ring) {
+            continue;
+        }
+        uint32_t head = ring->head;
+        terminal_writestring("  CPU ");
+        terminal_writeuint(i);
+        terminal_writestring(": записано ");
+        terminal_writeuint(head);
+        terminal_writestring(", перезаписано ");
+        terminal_writeuint(head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0);
+        terminal_writestring("\n");
+    }
+}
+
+void profile_print_stats(void) {
+    terminal_writestring("Профайлер: ");
+    terminal_writestring(profiling ? "працює" : "зупинено");
+    if (profile_hz) {
+        terminal_writestring(", ");
+        terminal_writeuint(profile_hz);
+        terminal_writestring(" Гц");
+    }
+    terminal_writestring(", семплів ");
+    terminal_writeuint(sample_count);
+    terminal_writestring("/");
+    terminal_writeuint(PROFILE_MAX_SAMPLES);
+    terminal_writestring(", відкинуто ");
+    terminal_writeuint(samples_dropped);
+#ifdef PROFILE_FRAME_POINTERS
+    terminal_writestring(", стеки до ");
+    terminal_writeuint(PROFILE_MAX_DEPTH);
+    terminal_writestring(" кадрів");
+#endif
+    terminal_writestring("\n");
+}
@@ -0,0 +1,73 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "kernel.h"
+
+// Кільце подій на кожен процесор (степінь двійки), старі події перезаписуються
+#define TRACE_RING_SIZE         8192
+
+// Семпли профайлера: буфер заповнюється до кінця, далі семпли відкидаються
+#define PROFILE_MAX_SAMPLES     8192
+#define PROFILE_MAX_DEPTH       8       // адрес повернення при PROFILE_FRAMES=1
+#define PROFILE_DEFAULT_HZ      997     // не кратна періодам інших таймерів
+#define PROFILE_MAX_HZ          10000
+
+// Ідентифікатори подій та значення аргументів
+typedef enum {
+    TRACE_IRQ_ENTER = 1,        // вектор, EIP перерваного коду
+    TRACE_IRQ_EXIT,             // вектор, такти в обробнику
+    TRACE_CMD_BEGIN,            // перші 4 байти команди
+    TRACE_CMD_END,              // такти виконання команди
+    TRACE_VGA_FLUSH,            // рядків скопійовано, тактів
+    TRACE_SCHED_SWITCH,         // tid попереднього, tid наступного потоку
+    TRACE_EVENT_COUNT
+} trace_event_id_t;
+
+typedef struct {
+    uint64_t tsc;
+    uint32_t id;
+    uint32_t arg0;
+    uint32_t arg1;
+    uint32_t reserved;
+} trace_event_t;
+
+// Кільце пише лише свій процесор: слот резервує xadd без lock
+typedef struct trace_ring {
+    volatile uint32_t head;
+    uint32_t reserved[3];
+    trace_event_t events[TRACE_RING_SIZE];
+} trace_ring_t;
+
+extern volatile int trace_enabled;
+
+// Кільця для процесорів, що вже онлайн (після smp_init)
+int trace_init(void);
+void trace_start(void);
+void trace_stop(void);
+void trace_clear(void);
+
+// Запис події у кільце поточного процесора
+void trace_record(uint32_t id, uint32_t arg0, uint32_t arg1);
+
+static inline void trace(uint32_t id, uint32_t arg0, uint32_t arg1) {
+    if (trace_enabled) {
+        trace_record(id, arg0, arg1);
+    }
+}
+
+// Виклики з irq_dispatch (кадр переривання для профайлера)
+void trace_irq_enter(uint32_t vector, irq_frame_t* frame);
+void trace_irq_exit(uint32_t vector);
+
+// Семплювання EIP з переривання PIT на BSP
+int profile_start(uint32_t hz);
+void profile_stop(void);
+int profile_active(void);
+
+// Вивід у COM1 для tools/symbolize.py та звіти на екрані
+void trace_dump(void);
+void profile_dump(void);
+void trace_print_stats(void);
+void profile_print_stats(void);
+
+#endif
@@ -0,0 +1,117 @@
+#include "lib.h"
+
+// Стан FPU/SSE задачі переживає системні виклики та перемикання потоків:
+// шаблон у XMM0-XMM7 через write/yield (SIMD-цикли mem* ядра), ряд у
+// плаваючій комі з yield між кроками проти того ж ряду без викликів
+
+#define DEFAULT_ROUNDS          1000
+#define XMM_WORDS               32
+
+static uint32_t xmm_in[XMM_WORDS];
+static uint32_t xmm_out[XMM_WORDS];
+
+// Регістри XMM оголошуються зіпсованими лише там, де компілятор їх виділяє
+#ifdef __SSE2__
+#define XMM_CLOBBERS "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+#else
+#define XMM_CLOBBERS
+#endif
+
+#define XMM_LOAD                                                \
+    "movdqu %[in], %%xmm0\n\t"                                  \
+    "movdqu 16+%[in], %%xmm1\n\t"                               \
+    "movdqu 32+%[in], %%xmm2\n\t"                               \
+    "movdqu 48+%[in], %%xmm3\n\t"                               \
+    "movdqu 64+%[in], %%xmm4\n\t"                               \
+    "movdqu 80+%[in], %%xmm5\n\t"                               \
+    "movdqu 96+%[in], %%xmm6\n\t"                               \
+    "movdqu 112+%[in], %%xmm7\n\t"
+
+#define XMM_STORE                                               \
+    "movdqu %%xmm0, %[out]\n\t"                                 \
+    "movdqu %%xmm1, 16+%[out]\n\t"                              \
+    "movdqu %%xmm2, 32+%[out]\n\t"                              \
+    "movdqu %%xmm3, 48+%[out]\n\t"                              \
+    "movdqu %%xmm4, 64+%[out]\n\t"                              \
+    "movdqu %%xmm5, 80+%[out]\n\t"                              \
+    "movdqu %%xmm6, 96+%[out]\n\t"                              \
+    "movdqu %%xmm7, 112+%[out]"
+
+// Завантаження, виклик і вивантаження - одна вставка, між ними компілятор
+// регістрів не торкається
+static long xmm_syscall(long number, uintptr_t a1, uintptr_t a2) {
+    long ret = number;
+#ifdef __x86_64__
+    register uintptr_t _a1 __asm__("rdi") = a1;
+    register uintptr_t _a2 __asm__("rsi") = a2;
+    register uintptr_t _a3 __asm__("rdx") = 0;
+    __asm__ volatile(XMM_LOAD "call nexus_vdso_syscall\n\t" XMM_STORE
+                     : "+a"(ret), "+r"(_a1), "+r"(_a2), "+r"(_a3), [out] "=m"(xmm_out)
+                     : [in] "m"(xmm_in)
+                     : XMM_CLOBBERS "rcx", "r8", "r9", "r10", "r11", "memory", "cc");
+#else
+    __asm__ volatile(XMM_LOAD "call nexus_vdso_syscall\n\t" XMM_STORE
+                     : "+a"(ret), [out] "=m"(xmm_out)
+                     : [in] "m"(xmm_in), "b"(a1), "S"(a2), "D"(0)
+                     : XMM_CLOBBERS "ecx", "edx", "memory", "cc");
+#endif
+    return ret;
+}
+
+static uint32_t check_xmm(uint32_t round) {
+    for (uint32_t i = 0; i < XMM_WORDS; i++) {
+        xmm_in[i] = 0x9E3779B9u * (round * XMM_WORDS + i + 1);
+    }
+    if (round & 1) {
+        xmm_syscall(NEXUS_SYS_YIELD, 0, 0);
+    } else {
+        xmm_syscall(NEXUS_SYS_WRITE, (uintptr_t)".", (round & 63) == 0 ? 1 : 0);
+    }
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < XMM_WORDS; i++) {
+        errors += xmm_out[i] != xmm_in[i];
+    }
+    return errors;
+}
+
+// Той самий ряд двічі: з yield між кроками і без; результати мають збігтися.
+// volatile - округлення до double на кожному кроці й для 80-бітного x87
+static volatile double series_factor = 1.0001;
+
+static double series(uint32_t steps, int yielding) {
+    volatile double x = 1.0;
+    for (uint32_t i = 0; i < steps; i++) {
+        x = x * series_factor + 0.5;
+        if (yielding) {
+            yield();
+        }
+    }
+    return x;
+}
+
+int main(const char* args) {
+    uint32_t rounds = atou(args);
+    if (rounds == 0) {
+        rounds = DEFAULT_ROUNDS;
+    }
+
+    uint32_t errors = 0;
+    for (uint32_t round = 0; round < rounds; round++) {
+        errors += check_xmm(round);
+    }
+    print("\nXMM0-XMM7 через ");
+    print_uint(rounds);
+    print(" викликів write/yield: розбіжностей ");
+    print_uint(errors);
+    print("\n");
+
+    double expected = series(rounds, 0);
+    double result = series(rounds, 1);
+    print("Ряд з плаваючою комою: ");
+    print_uint((uint32_t)result);
+    print(result == expected ? ", збігається\n" : ", НЕ збігається\n");
+    if (result != expected) {
+        errors++;
+    }
+    return errors == 0 ? 0 : 1;
+}
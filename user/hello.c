@@ -0,0 +1,24 @@
+#include "lib.h"
+
+// Перша програма кільця 3: аргументи, годинник vDSO проти SYS_TIME,
+// "fault" - звернення до пам'яті ядра (задачу завершує виняток, не ядро)
+int main(const char* args) {
+    print("Привіт з кільця 3! Аргументи: \"");
+    print(args);
+    print("\"\n");
+
+    uint64_t vdso = time_ns();
+    uint64_t kernel = sys_time();
+    print("Час (vDSO): ");
+    print_uint(udiv64(vdso, 1000000));
+    print(" мс, через SYS_TIME: ");
+    print_uint(udiv64(kernel, 1000000));
+    print(" мс\n");
+
+    if (args[0] == 'f') {
+        print("Читаю пам'ять ядра за адресою 0x100000...\n");
+        volatile uint32_t* kernel_memory = (volatile uint32_t*)0x100000;
+        return (int)*kernel_memory;
+    }
+    return 0;
+}
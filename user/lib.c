@@ -0,0 +1,88 @@
+#include "lib.h"
+
+// === ВХІД ===
+
+// Ядро входить сюди як після call: аргумент - рядок на вершині стеку задачі
+void _start(const char* args) __attribute__((noreturn));
+
+void _start(const char* args) {
+    exit(main(args));
+}
+
+// === СИСТЕМНІ ВИКЛИКИ ===
+
+void exit(int code) {
+    syscall(NEXUS_SYS_EXIT, code, 0, 0);
+    __builtin_unreachable();
+}
+
+long write(const void* buffer, size_t length) {
+    return syscall(NEXUS_SYS_WRITE, buffer, length, 0);
+}
+
+uint64_t sys_time(void) {
+    uint64_t ns = 0;
+    syscall(NEXUS_SYS_TIME, &ns, 0, 0);
+    return ns;
+}
+
+void yield(void) {
+    syscall(NEXUS_SYS_YIELD, 0, 0, 0);
+}
+
+// === РЯДКИ ТА ЧИСЛА ===
+
+size_t strlen(const char* s) {
+    size_t length = 0;
+    while (s[length]) {
+        length++;
+    }
+    return length;
+}
+
+// На i386 gcc кличе __udivdi3 з libgcc - ділимо двома divl
+uint64_t udiv64(uint64_t n, uint32_t d) {
+#ifdef __x86_64__
+    return n / d;
+#else
+    uint32_t high = (uint32_t)(n >> 32);
+    uint32_t low = (uint32_t)n;
+    uint32_t quotient_high = high / d;
+    uint32_t quotient_low, remainder = high % d;
+    __asm__("divl %[d]" : "=a"(quotient_low), "=d"(remainder) : "a"(low), "d"(remainder), [d] "rm"(d));
+    return ((uint64_t)quotient_high << 32) | quotient_low;
+#endif
+}
+
+uint32_t atou(const char* s) {
+    uint32_t value = 0;
+    while (*s == ' ') {
+        s++;
+    }
+    while (*s >= '0' && *s <= '9') {
+        value = value * 10 + (uint32_t)(*s++ - '0');
+    }
+    return value;
+}
+
+void print(const char* s) {
+    write(s, strlen(s));
+}
+
+void print_uint_width(uint64_t value, size_t width) {
+    char buffer[24];
+    size_t i = sizeof(buffer);
+    do {
+        uint64_t quotient = udiv64(value, 10);
+        buffer[--i] = (char)('0' + (value - quotient * 10));
+        value = quotient;
+    } while (value);
+    while (sizeof(buffer) - i < width && i > 0) {
+        buffer[--i] = ' ';
+    }
+    write(buffer + i, sizeof(buffer) - i);
+}
+
+void print_uint(uint64_t value) {
+    print_uint_width(value, 0);
+}
@@ -0,0 +1,77 @@
+#ifndef USER_LIB_H
+#define USER_LIB_H
+
+// Мінімальне середовище програм кільця 3: системні виклики через vDSO,
+// годинник без входу в ядро, вивід чисел. Без libc і без SSE
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nexus.h"
+
+// Виклик через слот vDSO entry - символ з user.ld: call на фіксовану адресу
+// як rel32 (0xA04xxxxx не вміщається в знакове 32-бітне). Номер і результат
+// в EAX/RAX. Швидкий шлях псує ECX/EDX (SYSEXIT) або RCX/R11 (SYSRET), ядро
+// на виході з SYSCALL обнуляє ще й регістри аргументів
+#ifdef __x86_64__
+#define NEXUS_SYSCALL(entry, number, a1, a2, a3) ({                                    \
+    register uintptr_t _a1 __asm__("rdi") = (uintptr_t)(a1);                           \
+    register uintptr_t _a2 __asm__("rsi") = (uintptr_t)(a2);                           \
+    register uintptr_t _a3 __asm__("rdx") = (uintptr_t)(a3);                           \
+    long _ret = (long)(number);                                                         \
+    __asm__ volatile("call " #entry                                                    \
+                     : "+a"(_ret), "+r"(_a1), "+r"(_a2), "+r"(_a3)                      \
+                     :                                                                  \
+                     : "rcx", "r8", "r9", "r10", "r11", "memory", "cc");                \
+    _ret;                                                                               \
+})
+#else
+#define NEXUS_SYSCALL(entry, number, a1, a2, a3) ({                                    \
+    long _ret = (long)(number);                                                         \
+    __asm__ volatile("call " #entry                                                    \
+                     : "+a"(_ret)                                                       \
+                     : "b"((uintptr_t)(a1)), "S"((uintptr_t)(a2)), "D"((uintptr_t)(a3)) \
+                     : "ecx", "edx", "memory", "cc");                                   \
+    _ret;                                                                               \
+})
+#endif
+
+#define syscall(number, a1, a2, a3)         NEXUS_SYSCALL(nexus_vdso_syscall, number, a1, a2, a3)
+#define syscall_int80(number, a1, a2, a3)   NEXUS_SYSCALL(nexus_vdso_int80, number, a1, a2, a3)
+
+// Дані сторінки vDSO
+#define VDSO_U32(offset)    (*(volatile const uint32_t*)(NEXUS_VDSO_BASE + (offset)))
+
+static inline uint64_t time_ns(void) {
+    return ((uint64_t (*)(void))NEXUS_VDSO_TIME_NS)();
+}
+
+static inline int fast_syscall_available(void) {
+    return VDSO_U32(NEXUS_VDSO_FAST) != 0;
+}
+
+static inline uint32_t tsc_khz(void) {
+    return VDSO_U32(NEXUS_VDSO_TSC_KHZ);
+}
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Точка входу програми; повернення - SYS_EXIT з результатом
+int main(const char* args);
+
+void exit(int code) __attribute__((noreturn));
+long write(const void* buffer, size_t length);
+uint64_t sys_time(void);
+void yield(void);
+
+size_t strlen(const char* s);
+uint64_t udiv64(uint64_t n, uint32_t d);
+uint32_t atou(const char* s);
+void print(const char* s);
+void print_uint(uint64_t value);
+void print_uint_width(uint64_t value, size_t width);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef NEXUS_H
+#define NEXUS_H
+
+// ABI задач кільця 3: номери системних викликів і розкладка сторінки vDSO.
+// Спільний для ядра (syscall.h) і програм user/, тож лише #define без типів
+
+// Номер - в EAX/RAX, аргументи - EBX, ESI, EDI (i386) або RDI, RSI, RDX
+// (x86_64), результат - в EAX/RAX; від'ємний результат - код ERROR_* ядра
+#define NEXUS_SYS_EXIT          0       // (код) - не повертається
+#define NEXUS_SYS_WRITE         1       // (буфер, довжина) -> записано байтів
+#define NEXUS_SYS_NULL          2       // порожній виклик для вимірювань
+#define NEXUS_SYS_TIME          3       // (uint64_t* ns) - монотонний час ядра
+#define NEXUS_SYS_YIELD         4       // віддати процесор
+#define NEXUS_SYS_COUNT         5
+
+// Область задачі: код і дані з адреси ELF, стек - у кінці області
+#define NEXUS_USER_BASE         0xA0000000
+
+// Сторінка vDSO: дані ядра на початку, код з фіксованими точками входу з 0x100.
+// Годинник: ns = ((TSC - tsc_base) * mult) >> shift
+#define NEXUS_VDSO_BASE         0xA0400000
+#define NEXUS_VDSO_TSC_BASE     0x00    // uint64_t
+#define NEXUS_VDSO_MULT         0x08    // uint32_t
+#define NEXUS_VDSO_SHIFT        0x0C    // uint32_t, < 32
+#define NEXUS_VDSO_FAST         0x10    // uint32_t: 1 - слот SYSCALL веде на SYSENTER/SYSCALL
+#define NEXUS_VDSO_TSC_KHZ      0x14    // uint32_t
+
+#define NEXUS_VDSO_CODE         (NEXUS_VDSO_BASE + 0x100)
+#define NEXUS_VDSO_SYSCALL      (NEXUS_VDSO_CODE + 0x00)    // найшвидший шлях ядра
+#define NEXUS_VDSO_INT80        (NEXUS_VDSO_CODE + 0x40)    // завжди через int 0x80
+#define NEXUS_VDSO_TIME_NS      (NEXUS_VDSO_CODE + 0x80)    // uint64_t time_ns(void)
+
+#endif
@@ -0,0 +1,79 @@
+#include "lib.h"
+
+// Затримка порожнього системного виклику: шлюз int 0x80 проти SYSENTER/SYSCALL,
+// і годинник: SYS_TIME проти vDSO. Кожен виклик між парою rdtsc, тож
+// мінімум містить і сам замір (рядок "rdtsc" - для віднімання)
+
+#define DEFAULT_ITERATIONS      100000
+
+typedef struct {
+    uint64_t total;
+    uint64_t min;
+} result_t;
+
+#define MEASURE(result, iterations, call) do {                  \
+    (result)->total = 0;                                        \
+    (result)->min = ~0ull;                                      \
+    for (uint32_t _i = 0; _i < (iterations); _i++) {            \
+        uint64_t _start = rdtsc();                              \
+        call;                                                   \
+        uint64_t _cycles = rdtsc() - _start;                    \
+        (result)->total += _cycles;                             \
+        if (_cycles < (result)->min) (result)->min = _cycles;   \
+    }                                                           \
+} while (0)
+
+static uint64_t cycles_to_ns(uint64_t cycles) {
+    uint32_t khz = tsc_khz();
+    return khz ? udiv64(cycles * 1000000, khz) : 0;
+}
+
+static void report(const char* name, const result_t* result, uint32_t iterations) {
+    uint64_t average = udiv64(result->total, iterations);
+    print(name);
+    print_uint_width(result->min, 10);
+    print_uint_width(average, 10);
+    print_uint_width(cycles_to_ns(average), 10);
+    print("\n");
+}
+
+int main(const char* args) {
+    uint32_t iterations = atou(args);
+    if (iterations == 0) {
+        iterations = DEFAULT_ITERATIONS;
+    }
+    volatile uint64_t sink = 0;
+    result_t baseline, int80, fast, kernel_time, vdso_time;
+
+    MEASURE(&baseline, iterations, (void)0);
+    MEASURE(&int80, iterations, syscall_int80(NEXUS_SYS_NULL, 0, 0, 0));
+    MEASURE(&fast, iterations, syscall(NEXUS_SYS_NULL, 0, 0, 0));
+    MEASURE(&kernel_time, iterations, sink += sys_time());
+    MEASURE(&vdso_time, iterations, sink += time_ns());
+
+    print("Викликів на тест: ");
+    print_uint(iterations);
+    print(fast_syscall_available() ? "\n" : " (швидкого шляху немає - слот vDSO веде на int 0x80)\n");
+    print("Тест                     мін.тактів сер.тактів   сер.нс\n");
+    report("rdtsc (замір)           ", &baseline, iterations);
+    report("null через int 0x80     ", &int80, iterations);
+#ifdef __x86_64__
+    report("null через SYSCALL      ", &fast, iterations);
+#else
+    report("null через SYSENTER     ", &fast, iterations);
+#endif
+    report("час через SYS_TIME      ", &kernel_time, iterations);
+    report("час через vDSO          ", &vdso_time, iterations);
+
+    uint64_t fast_average = udiv64(fast.total, iterations);
+    if (fast_average) {
+        uint64_t ratio = udiv64(udiv64(int80.total, iterations) * 100, (uint32_t)fast_average);
+        print("int 0x80 / швидкий шлях: ");
+        uint32_t fraction = (uint32_t)(ratio - udiv64(ratio, 100) * 100);
+        char digits[3] = { '.', (char)('0' + fraction / 10), (char)('0' + fraction % 10) };
+        print_uint(udiv64(ratio, 100));
+        write(digits, sizeof(digits));
+        print("x\n");
+    }
+    return 0;
+}
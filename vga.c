@@ -0,0 +1,500 @@
+#include "vga.h"
+#include "timer.h"
+#include "trace.h"
+
+// Рядок line (абсолютний номер) живе в shadow[line % VGA_SHADOW_ROWS],
+// тож прокрутка - це зсув top_line і очищення одного рядка, без копіювання
+static uint16_t shadow[VGA_SHADOW_ROWS][VGA_SHADOW_COLUMNS];
+static uint32_t top_line = 0;           // абсолютний рядок у верху екрана
+static uint32_t view_back = 0;          // на скільки рядків переглядаємо історію назад
+static uint64_t dirty_rows = 0;         // біт на кожен рядок екрана
+static uint32_t cursor_shown = ~0u;     // позиція курсора, записана в CRTC або fb
+
+// Розмір екрана: текстовий режим або сітка графічної консолі
+static uint32_t screen_columns = VGA_WIDTH;
+static uint32_t screen_rows = VGA_HEIGHT;
+static int framebuffer_console = false;
+static uint32_t scroll_pending = 0;     // прокрутки, ще не застосовані до fb
+
+// Незавершена послідовність UTF-8 (лише графічна консоль)
+static uint32_t utf8_codepoint = 0;
+static uint32_t utf8_remaining = 0;
+
+static volatile uint16_t* const vga_memory = (volatile uint16_t*)VGA_BUFFER_ADDRESS;
+static spinlock_t vga_lock = SPINLOCK_INIT;
+
+static timer_event_t flush_timer;
+static int deferred_flush = false;
+static int batch_output = false;
+
+// Статистика
+static uint64_t flushes = 0;
+static uint64_t rows_flushed = 0;
+static uint64_t cursor_updates = 0;
+static uint64_t scrolls = 0;
+
+#define ALL_ROWS_DIRTY      ((1ull << screen_rows) - 1)
+
+static inline uint16_t* shadow_line(uint32_t line) {
+    return shadow[line & (VGA_SHADOW_ROWS - 1)];
+}
+
+// Номер найнижчого брудного рядка; i386 не має 64-бітного bsf без libgcc
+static inline uint32_t lowest_row(uint64_t rows) {
+    uint32_t low = (uint32_t)rows;
+    return low ? (uint32_t)__builtin_ctz(low) : 32 + (uint32_t)__builtin_ctz((uint32_t)(rows >> 32));
+}
+
+static void clear_line(uint32_t line) {
+    uint16_t blank = vga_entry(' ', terminal_color);
+    uint16_t* row = shadow_line(line);
+    for (size_t x = 0; x < VGA_SHADOW_COLUMNS; x++) {
+        row[x] = blank;
+    }
+}
+
+// Байт UTF-8 -> код гліфа шрифту; false, поки послідовність не завершена
+static int utf8_decode(uint8_t byte, uint8_t* glyph) {
+    if (byte < 0x80) {
+        utf8_remaining = 0;
+        *glyph = byte;
+        return true;
+    }
+    if ((byte & 0xC0) == 0x80) {
+        if (!utf8_remaining) {
+            *glyph = FONT_REPLACEMENT;
+            return true;
+        }
+        utf8_codepoint = (utf8_codepoint << 6) | (byte & 0x3F);
+        if (--utf8_remaining) {
+            return false;
+        }
+        *glyph = font_glyph(utf8_codepoint);
+        return true;
+    }
+    if ((byte & 0xE0) == 0xC0) {
+        utf8_codepoint = byte & 0x1F;
+        utf8_remaining = 1;
+    } else if ((byte & 0xF0) == 0xE0) {
+        utf8_codepoint = byte & 0x0F;
+        utf8_remaining = 2;
+    } else if ((byte & 0xF8) == 0xF0) {
+        utf8_codepoint = byte & 0x07;
+        utf8_remaining = 3;
+    } else {
+        utf8_remaining = 0;
+        *glyph = FONT_REPLACEMENT;
+        return true;
+    }
+    return false;
+}
+
+// === СКИДАННЯ У ВІДЕОПАМ'ЯТЬ ===
+
+// 0xB8000 відображено як write-combining: rep movsd збирається в пакети
+static inline void copy_row(volatile uint16_t* dest, const uint16_t* src) {
+    size_t count = VGA_WIDTH / 2;
+    asm volatile("rep movsl"
+                 : "+D"(dest), "+S"(src), "+c"(count)
+                 : : "memory");
+}
+
+static void update_text_cursor(void) {
+    // Під час перегляду історії курсор ховаємо за межі екрана
+    uint32_t position = view_back ? VGA_WIDTH * VGA_HEIGHT : terminal_row * VGA_WIDTH + terminal_column;
+    if (position == cursor_shown) {
+        return;
+    }
+    cursor_shown = position;
+    outb(VGA_CRTC_INDEX, 0x0F);
+    outb(VGA_CRTC_DATA, (uint8_t)(position & 0xFF));
+    outb(VGA_CRTC_INDEX, 0x0E);
+    outb(VGA_CRTC_DATA, (uint8_t)((position >> 8) & 0xFF));
+    cursor_updates++;
+}
+
+// Графічна консоль: відкладена прокрутка зсуває задній буфер, брудні рядки
+// порівнюються з намальованим, у відеопам'ять ідуть лише пошкоджені ділянки
+static void flush_framebuffer(void) {
+    uint64_t start = rdtsc();
+    uint32_t drawn = 0;
+    if (scroll_pending) {
+        fb_scroll(scroll_pending);
+        scroll_pending = 0;
+        // Курсор fb поїхав разом із вмістом - ставимо заново
+        cursor_shown = ~0u;
+    }
+
+    uint32_t first = top_line - view_back;
+    uint64_t rows = dirty_rows;
+    while (rows) {
+        uint32_t y = lowest_row(rows);
+        rows &= rows - 1;
+        fb_draw_row(y, shadow_line(first + y), screen_columns);
+        drawn++;
+    }
+    if (drawn) {
+        rows_flushed += drawn;
+        dirty_rows = 0;
+        flushes++;
+    }
+
+    uint32_t position = view_back ? ~1u : terminal_row * screen_columns + terminal_column;
+    if (position != cursor_shown) {
+        cursor_shown = position;
+        fb_set_cursor(terminal_column, terminal_row, !view_back);
+        cursor_updates++;
+    }
+    fb_present();
+    if (drawn) {
+        trace(TRACE_VGA_FLUSH, drawn, (uint32_t)(rdtsc() - start));
+    }
+}
+
+// Викликається під vga_lock
+static void flush_locked(void) {
+    if (framebuffer_console) {
+        flush_framebuffer();
+        return;
+    }
+    if (dirty_rows) {
+        uint64_t start = rdtsc();
+        uint32_t first = top_line - view_back;
+        uint64_t rows = dirty_rows;
+        uint32_t copied = 0;
+        while (rows) {
+            uint32_t y = lowest_row(rows);
+            rows &= rows - 1;
+            copy_row(vga_memory + y * VGA_WIDTH, shadow_line(first + y));
+            copied++;
+        }
+        rows_flushed += copied;
+        dirty_rows = 0;
+        flushes++;
+        // Блокована операція виштовхує буфери write-combining
+        __sync_synchronize();
+        trace(TRACE_VGA_FLUSH, copied, (uint32_t)(rdtsc() - start));
+    }
+    update_text_cursor();
+}
+
+static void flush_expired(void* arg) {
+    (void)arg;
+    vga_flush();
+}
+
+void vga_flush(void) {
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    flush_locked();
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+// === ВІДОБРАЖЕННЯ СИМВОЛІВ ===
+
+static void newline(void) {
+    terminal_column = 0;
+    if (terminal_row < screen_rows - 1) {
+        terminal_row++;
+        return;
+    }
+    top_line++;
+    clear_line(top_line + screen_rows - 1);
+    if (framebuffer_console) {
+        // Вміст зсувається в задньому буфері - брудні рядки їдуть угору разом з ним
+        scroll_pending++;
+        dirty_rows = (dirty_rows >> 1) | 1ull << (screen_rows - 1);
+    } else {
+        dirty_rows = ALL_ROWS_DIRTY;
+    }
+    scrolls++;
+}
+
+static void put_locked(char c) {
+    // Новий вивід повертає перегляд історії до живого екрана
+    if (view_back) {
+        view_back = 0;
+        dirty_rows = ALL_ROWS_DIRTY;
+    }
+
+    // Текстовий режим показує байти як є, графічна консоль - символи UTF-8
+    uint8_t glyph = (uint8_t)c;
+    if (framebuffer_console && !utf8_decode((uint8_t)c, &glyph)) {
+        return;
+    }
+
+    uint16_t* row = shadow_line(top_line + terminal_row);
+    if (c == '\n') {
+        newline();
+    } else if (c == '\b') {
+        if (terminal_column > 0) {
+            terminal_column--;
+            row[terminal_column] = vga_entry(' ', terminal_color);
+            dirty_rows |= 1ull << terminal_row;
+        }
+    } else {
+        row[terminal_column] = vga_entry(glyph, terminal_color);
+        dirty_rows |= 1ull << terminal_row;
+        if (++terminal_column == screen_columns) {
+            newline();
+        }
+    }
+}
+
+void vga_init(uint8_t color) {
+    terminal_row = 0;
+    terminal_column = 0;
+    terminal_color = color;
+    top_line = 0;
+    view_back = 0;
+    for (uint32_t line = 0; line < VGA_SHADOW_ROWS; line++) {
+        clear_line(line);
+    }
+    dirty_rows = ALL_ROWS_DIRTY;
+    timer_event_init(&flush_timer, flush_expired, NULL);
+    vga_flush();
+}
+
+void vga_enable_deferred_flush(void) {
+    deferred_flush = true;
+}
+
+// Перекодовує рядок тіні, виведений байтами UTF-8, у коди гліфів; column
+// (позиція курсора в цьому рядку) зсувається разом із символами
+static void transcode_line(uint16_t* row, uint32_t width, size_t* column) {
+    uint32_t out = 0;
+    size_t new_column = 0;
+    utf8_remaining = 0;
+    for (uint32_t x = 0; x < width; x++) {
+        uint16_t cell = row[x];
+        uint8_t glyph;
+        if (column && x == *column) {
+            new_column = out;
+        }
+        if (utf8_decode(cell & 0xFF, &glyph)) {
+            row[out++] = (cell & 0xFF00) | glyph;
+        }
+    }
+    for (uint32_t x = out; x < width; x++) {
+        row[x] = vga_entry(' ', terminal_color);
+    }
+    if (column) {
+        *column = new_column;
+    }
+    utf8_remaining = 0;
+}
+
+void vga_attach_framebuffer(void) {
+    if (!fb_active()) {
+        return;
+    }
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    uint32_t current = top_line + terminal_row;
+    uint32_t oldest = top_line > VGA_SCROLLBACK_ROWS ? top_line - VGA_SCROLLBACK_ROWS : 0;
+    for (uint32_t line = oldest; line <= current; line++) {
+        transcode_line(shadow_line(line), screen_columns, line == current ? &terminal_column : NULL);
+    }
+
+    // Нижче курсора на більшому екрані - порожні рядки
+    screen_columns = fb_columns();
+    screen_rows = fb_rows();
+    for (uint32_t y = terminal_row + 1; y < screen_rows; y++) {
+        clear_line(top_line + y);
+    }
+    framebuffer_console = true;
+    view_back = 0;
+    scroll_pending = 0;
+    cursor_shown = ~0u;
+    dirty_rows = ALL_ROWS_DIRTY;
+    flush_locked();
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+uint32_t vga_rows(void) {
+    return screen_rows;
+}
+
+// Відкладене скидання: не пізніше ніж за VGA_FLUSH_DELAY_NS (під vga_lock)
+static void defer_flush_locked(void) {
+    if (!deferred_flush) {
+        flush_locked();
+    } else if (flush_timer.heap_index < 0) {
+        timer_arm(&flush_timer, time_now_ns() + VGA_FLUSH_DELAY_NS);
+    }
+}
+
+// Пакет символів: одне скидання та одне оновлення курсора в кінці
+void vga_write(const char* data, size_t size) {
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    for (size_t i = 0; i < size; i++) {
+        put_locked(data[i]);
+    }
+    if (batch_output) {
+        defer_flush_locked();
+    } else {
+        flush_locked();
+    }
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+// Одиночний символ: скидання в кінці рядка, інакше - за таймером
+void vga_putchar(char c) {
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    put_locked(c);
+    if (c == '\n' && !batch_output) {
+        flush_locked();
+    } else {
+        defer_flush_locked();
+    }
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+// Пакетний режим: екран оновлюється лише за таймером, вимкнення скидає все
+void vga_set_batch(int enabled) {
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    batch_output = enabled;
+    if (!enabled) {
+        flush_locked();
+    }
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+// Екран очищується новою сторінкою - попередній вміст лишається в історії
+void vga_clear(void) {
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    top_line += terminal_row + 1;
+    for (uint32_t y = 0; y < screen_rows; y++) {
+        clear_line(top_line + y);
+    }
+    terminal_row = 0;
+    terminal_column = 0;
+    view_back = 0;
+    dirty_rows = ALL_ROWS_DIRTY;
+    flush_locked();
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+void vga_scrollback(int lines) {
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    uint32_t limit = top_line < VGA_SCROLLBACK_ROWS ? top_line : VGA_SCROLLBACK_ROWS;
+    int32_t target = (int32_t)view_back + lines;
+    if (target < 0) {
+        target = 0;
+    } else if ((uint32_t)target > limit) {
+        target = (int32_t)limit;
+    }
+    if ((uint32_t)target != view_back) {
+        view_back = (uint32_t)target;
+        dirty_rows = ALL_ROWS_DIRTY;
+    }
+    flush_locked();
+    spin_unlock_irqrestore(&vga_lock, flags);
+}
+
+// === СТАТИСТИКА ===
+
+void vga_print_stats(void) {
+    terminal_writestring("Екран: ");
+    terminal_writeuint(screen_columns);
+    terminal_writestring("x");
+    terminal_writeuint(screen_rows);
+    terminal_writestring(framebuffer_console ? " (графічна консоль)\n" : " (текстовий режим)\n");
+    terminal_writestring("Тіньовий буфер: ");
+    terminal_writeuint(VGA_SHADOW_ROWS);
+    terminal_writestring(" рядків (історія ");
+    terminal_writeuint(VGA_SCROLLBACK_ROWS);
+    terminal_writestring(")\nПрокруток: ");
+    terminal_writeuint(scrolls);
+    terminal_writestring(", скидань: ");
+    terminal_writeuint(flushes);
+    terminal_writestring(", рядків скинуто: ");
+    terminal_writeuint(rows_flushed);
+    terminal_writestring(", оновлень курсора: ");
+    terminal_writeuint(cursor_updates);
+    terminal_writestring("\n");
+    if (framebuffer_console) {
+        fb_print_stats();
+    }
+}
+
+// === БЕНЧМАРК ===
+
+#define VGA_BENCH_LINES     2000
+
+static const char bench_line[] = "Nexus OS terminal throughput test: 0123456789 abcdefghij\n";
+
+// Старий шлях для порівняння: символ за символом у MMIO і посімвольна прокрутка
+static void direct_write(const char* data, size_t* row, size_t* column) {
+    uint16_t blank = vga_entry(' ', terminal_color);
+    for (; *data; data++) {
+        if (*data != '\n') {
+            vga_memory[*row * VGA_WIDTH + *column] = vga_entry(*data, terminal_color);
+            if (++*column < VGA_WIDTH) {
+                continue;
+            }
+        }
+        *column = 0;
+        if (++*row == VGA_HEIGHT) {
+            for (size_t i = 0; i < (VGA_HEIGHT - 1) * VGA_WIDTH; i++) {
+                vga_memory[i] = vga_memory[i + VGA_WIDTH];
+            }
+            for (size_t x = 0; x < VGA_WIDTH; x++) {
+                vga_memory[(VGA_HEIGHT - 1) * VGA_WIDTH + x] = blank;
+            }
+            *row = VGA_HEIGHT - 1;
+        }
+    }
+}
+
+void vga_benchmark(void) {
+    size_t length = strlen(bench_line);
+    uint64_t glyphs = (uint64_t)VGA_BENCH_LINES * length;
+
+    unsigned long flags = spin_lock_irqsave(&vga_lock);
+    uint64_t direct_cycles = 0;
+    uint64_t cached_cycles = 0;
+    if (framebuffer_console) {
+        fb_benchmark((uint32_t)glyphs, &direct_cycles, &cached_cycles);
+    } else {
+        size_t row = 0;
+        size_t column = 0;
+        uint64_t start = rdtsc();
+        for (int i = 0; i < VGA_BENCH_LINES; i++) {
+            direct_write(bench_line, &row, &column);
+        }
+        direct_cycles = rdtsc() - start;
+    }
+    // Екран відновлюємо з тіні
+    dirty_rows = ALL_ROWS_DIRTY;
+    flush_locked();
+    spin_unlock_irqrestore(&vga_lock, flags);
+
+    uint64_t start = rdtsc();
+    for (int i = 0; i < VGA_BENCH_LINES; i++) {
+        vga_write(bench_line, length);
+    }
+    uint64_t shadow_cycles = rdtsc() - start;
+
+    terminal_writestring("Рядків: ");
+    terminal_writeuint(VGA_BENCH_LINES);
+    terminal_writestring(", символів: ");
+    terminal_writeuint(glyphs);
+    if (framebuffer_console) {
+        terminal_writestring("\nГліфи попіксельно у відеопам'ять: ");
+        terminal_writeuint(tsc_per_second(glyphs, direct_cycles));
+        terminal_writestring(" символів/с\nКеш гліфів + SSE2 + показ:       ");
+        terminal_writeuint(tsc_per_second(glyphs, cached_cycles));
+        terminal_writestring(" символів/с");
+    } else {
+        terminal_writestring("\nПряме MMIO:     ");
+        terminal_writeuint(tsc_per_second(VGA_BENCH_LINES, direct_cycles));
+        terminal_writestring(" рядків/с, ");
+        terminal_writeuint(tsc_per_second(glyphs, direct_cycles));
+        terminal_writestring(" символів/с");
+    }
+    terminal_writestring("\nТіньовий буфер: ");
+    terminal_writeuint(tsc_per_second(VGA_BENCH_LINES, shadow_cycles));
+    terminal_writestring(" рядків/с, ");
+    terminal_writeuint(tsc_per_second(glyphs, shadow_cycles));
+    terminal_writestring(" символів/с\n");
+    vga_print_stats();
+}
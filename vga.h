@@ -0,0 +1,50 @@
+#ifndef VGA_H
+#define VGA_H
+
+#include "kernel.h"
+#include "fb.h"
+
+// Тіньове кільце рядків у RAM: екран плюс історія прокрутки (степінь двійки).
+// Рядок тіні вміщує найширшу сітку графічної консолі
+#define VGA_SHADOW_ROWS         256
+#define VGA_SHADOW_COLUMNS      FB_MAX_COLUMNS
+#define VGA_SCROLLBACK_ROWS     (VGA_SHADOW_ROWS - FB_MAX_ROWS)
+
+// Незавершений рядок потрапляє на екран не пізніше ніж за цей час
+#define VGA_FLUSH_DELAY_NS      10000000ull
+
+// Порти CRTC для апаратного курсора
+#define VGA_CRTC_INDEX          0x3D4
+#define VGA_CRTC_DATA           0x3D5
+
+// Ініціалізація; відкладене скидання вмикається, коли готовий таймер
+void vga_init(uint8_t color);
+void vga_enable_deferred_flush(void);
+
+// Перемикання виводу на графічну консоль після успішного fb_init: вже
+// виведене перекодовується з UTF-8, екран розширюється до сітки fb
+void vga_attach_framebuffer(void);
+
+// Висота екрана в рядках тексту (25 або сітка буфера кадрів)
+uint32_t vga_rows(void);
+
+// Вивід у тіньовий буфер
+void vga_write(const char* data, size_t size);
+void vga_putchar(char c);
+void vga_clear(void);
+
+// Пакетний режим (скрипти shell): вивід не скидається після кожного рядка,
+// екран оновлюється за таймером раз на VGA_FLUSH_DELAY_NS
+void vga_set_batch(int enabled);
+
+// Перенесення брудних рядків у відеопам'ять та оновлення курсора
+void vga_flush(void);
+
+// Перегляд історії: lines > 0 - назад, < 0 - вперед
+void vga_scrollback(int lines);
+
+// Статистика та бенчмарк
+void vga_print_stats(void);
+void vga_benchmark(void);
+
+#endif
@@ -0,0 +1,349 @@
+#include "virtio.h"
+#include "heap.h"
+#include "pmm.h"
+
+// Поля vendor-можливості virtio_pci_cap
+#define CAP_CFG_TYPE        3
+#define CAP_BAR             4
+#define CAP_OFFSET          8
+#define CAP_NOTIFY_MULT     16
+
+// Скидання пристрою - очікування нульового статусу
+#define RESET_SPINS         1000000
+
+static inline void mmio_write8(volatile uint8_t* base, uint32_t offset, uint8_t value) {
+    *(volatile uint8_t*)(base + offset) = value;
+}
+
+static inline void mmio_write16(volatile uint8_t* base, uint32_t offset, uint16_t value) {
+    *(volatile uint16_t*)(base + offset) = value;
+}
+
+static inline void mmio_write32(volatile uint8_t* base, uint32_t offset, uint32_t value) {
+    *(volatile uint32_t*)(base + offset) = value;
+}
+
+static inline uint8_t mmio_read8(volatile uint8_t* base, uint32_t offset) {
+    return *(volatile uint8_t*)(base + offset);
+}
+
+static inline uint16_t mmio_read16(volatile uint8_t* base, uint32_t offset) {
+    return *(volatile uint16_t*)(base + offset);
+}
+
+static inline uint32_t mmio_read32(volatile uint8_t* base, uint32_t offset) {
+    return *(volatile uint32_t*)(base + offset);
+}
+
+// 64-бітні поля загальної конфігурації пишуться двома половинами
+static inline void mmio_write64(volatile uint8_t* base, uint32_t offset, uint64_t value) {
+    mmio_write32(base, offset, (uint32_t)value);
+    mmio_write32(base, offset + 4, (uint32_t)(value >> 32));
+}
+
+// === ПОШУК ТА ІНІЦІАЛІЗАЦІЯ ===
+
+pci_device_t* virtio_find(uint16_t type, uint32_t index) {
+    for (uint32_t i = 0; i < pci_device_count(); i++) {
+        pci_device_t* pci = pci_get(i);
+        if (pci->vendor != VIRTIO_PCI_VENDOR) {
+            continue;
+        }
+        int match = pci->device == VIRTIO_PCI_MODERN_BASE + type ||
+                    (pci->device >= VIRTIO_PCI_TRANSITIONAL_MIN &&
+                     pci->device <= VIRTIO_PCI_TRANSITIONAL_MAX && pci->subsystem == type);
+        if (match && index-- == 0) {
+            return pci;
+        }
+    }
+    return NULL;
+}
+
+// Структури virtio лежать у BAR за vendor-можливостями PCI; беремо першу кожного типу
+static int map_structures(virtio_device_t* device) {
+    void* bars[PCI_BAR_COUNT] = { 0 };
+    uint8_t cap = 0;
+    while ((cap = pci_find_capability(device->pci, PCI_CAP_VENDOR, cap)) != 0) {
+        uint8_t type = pci_read8(device->pci, cap + CAP_CFG_TYPE);
+        uint8_t bar = pci_read8(device->pci, cap + CAP_BAR);
+        uint32_t offset = pci_read32(device->pci, cap + CAP_OFFSET);
+        if (bar >= PCI_BAR_COUNT || type < VIRTIO_PCI_CAP_COMMON || type > VIRTIO_PCI_CAP_DEVICE) {
+            continue;
+        }
+        if (!bars[bar]) {
+            bars[bar] = pci_map_bar(device->pci, bar);
+            if (!bars[bar]) {
+                continue;
+            }
+        }
+        volatile uint8_t* base = (volatile uint8_t*)bars[bar] + offset;
+        if (type == VIRTIO_PCI_CAP_COMMON && !device->common) {
+            device->common = base;
+        } else if (type == VIRTIO_PCI_CAP_NOTIFY && !device->notify_base) {
+            device->notify_base = base;
+            device->notify_multiplier = pci_read32(device->pci, cap + CAP_NOTIFY_MULT);
+        } else if (type == VIRTIO_PCI_CAP_ISR && !device->isr) {
+            device->isr = base;
+        } else if (type == VIRTIO_PCI_CAP_DEVICE && !device->config) {
+            device->config = base;
+        }
+    }
+    return device->common && device->notify_base && device->isr ? SUCCESS : ERROR_INVALID_INPUT;
+}
+
+int virtio_init(virtio_device_t* device, pci_device_t* pci, uint64_t wanted) {
+    memset(device, 0, sizeof(*device));
+    device->pci = pci;
+    pci_enable(pci, PCI_COMMAND_MEMORY | PCI_COMMAND_BUS_MASTER);
+    if (map_structures(device) != SUCCESS) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    volatile uint8_t* common = device->common;
+    mmio_write8(common, VIRTIO_COMMON_STATUS, 0);
+    for (int spins = 0; mmio_read8(common, VIRTIO_COMMON_STATUS) != 0; spins++) {
+        if (spins >= RESET_SPINS) {
+            return ERROR_INVALID_INPUT;
+        }
+        asm volatile("pause");
+    }
+    uint8_t status = VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER;
+    mmio_write8(common, VIRTIO_COMMON_STATUS, status);
+
+    mmio_write32(common, VIRTIO_COMMON_DFSELECT, 0);
+    uint64_t offered = mmio_read32(common, VIRTIO_COMMON_DF);
+    mmio_write32(common, VIRTIO_COMMON_DFSELECT, 1);
+    offered |= (uint64_t)mmio_read32(common, VIRTIO_COMMON_DF) << 32;
+    if (!(offered & (1ull << VIRTIO_F_VERSION_1))) {
+        mmio_write8(common, VIRTIO_COMMON_STATUS, status | VIRTIO_STATUS_FAILED);
+        return ERROR_INVALID_INPUT;
+    }
+
+    device->features = offered & (wanted | (1ull << VIRTIO_F_VERSION_1));
+    mmio_write32(common, VIRTIO_COMMON_GFSELECT, 0);
+    mmio_write32(common, VIRTIO_COMMON_GF, (uint32_t)device->features);
+    mmio_write32(common, VIRTIO_COMMON_GFSELECT, 1);
+    mmio_write32(common, VIRTIO_COMMON_GF, (uint32_t)(device->features >> 32));
+
+    status |= VIRTIO_STATUS_FEATURES_OK;
+    mmio_write8(common, VIRTIO_COMMON_STATUS, status);
+    if (!(mmio_read8(common, VIRTIO_COMMON_STATUS) & VIRTIO_STATUS_FEATURES_OK)) {
+        mmio_write8(common, VIRTIO_COMMON_STATUS, status | VIRTIO_STATUS_FAILED);
+        return ERROR_INVALID_INPUT;
+    }
+    return SUCCESS;
+}
+
+int virtio_has_feature(const virtio_device_t* device, uint32_t bit) {
+    return (device->features >> bit) & 1;
+}
+
+int virtio_enable_msix(virtio_device_t* device) {
+    if (pci_msix_init(device->pci, &device->msix) != SUCCESS) {
+        return ERROR_INVALID_INPUT;
+    }
+    // Зміни конфігурації не цікавлять - лише черги
+    mmio_write16(device->common, VIRTIO_COMMON_MSIX, VIRTIO_MSI_NO_VECTOR);
+    device->msix_ready = true;
+    return SUCCESS;
+}
+
+int virtio_queue_setup(virtio_device_t* device, virtq_t* queue, uint16_t index, uint16_t max_size, uint16_t msix_entry) {
+    volatile uint8_t* common = device->common;
+    mmio_write16(common, VIRTIO_COMMON_Q_SELECT, index);
+    uint16_t size = mmio_read16(common, VIRTIO_COMMON_Q_SIZE);
+    if (size == 0) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (size > max_size) {
+        size = max_size;
+    }
+    // Степінь двійки: індекси кілець беруться маскою
+    while (size & (size - 1)) {
+        size &= size - 1;
+    }
+
+    // Дескриптори, avail та used - кожне з власної сторінки
+    size_t desc_bytes = (size_t)size * sizeof(virtq_desc_t);
+    size_t avail_bytes = sizeof(virtq_avail_t) + (size_t)size * 2 + 2;
+    size_t used_bytes = sizeof(virtq_used_t) + (size_t)size * sizeof(virtq_used_elem_t) + 2;
+    size_t desc_pages = (desc_bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t avail_pages = (avail_bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t used_pages = (used_bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    uintptr_t memory = pmm_alloc_frames(desc_pages + avail_pages + used_pages);
+    void** cookies = kmalloc((size_t)size * sizeof(void*));
+    if (!memory || !cookies) {
+        if (memory) {
+            pmm_free_frames(memory, desc_pages + avail_pages + used_pages);
+        }
+        kfree(cookies);
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    memset((void*)memory, 0, (desc_pages + avail_pages + used_pages) * PAGE_SIZE);
+
+    memset(queue, 0, sizeof(*queue));
+    queue->index = index;
+    queue->size = size;
+    queue->desc = (virtq_desc_t*)memory;
+    queue->avail = (volatile virtq_avail_t*)(memory + desc_pages * PAGE_SIZE);
+    queue->used = (volatile virtq_used_t*)(memory + (desc_pages + avail_pages) * PAGE_SIZE);
+    queue->used_event = (volatile uint16_t*)((uintptr_t)queue->avail + sizeof(virtq_avail_t) + size * sizeof(uint16_t));
+    queue->avail_event = (volatile uint16_t*)&queue->used->ring[size];
+    queue->cookies = cookies;
+    queue->event_idx = virtio_has_feature(device, VIRTIO_F_EVENT_IDX);
+    for (uint16_t i = 0; i < size; i++) {
+        queue->desc[i].next = (uint16_t)(i + 1);
+    }
+    queue->free_head = 0;
+    queue->num_free = size;
+
+    mmio_write16(common, VIRTIO_COMMON_Q_SIZE, size);
+    mmio_write16(common, VIRTIO_COMMON_Q_MSIX, msix_entry);
+    if (mmio_read16(common, VIRTIO_COMMON_Q_MSIX) != msix_entry) {
+        pmm_free_frames(memory, desc_pages + avail_pages + used_pages);
+        kfree(cookies);
+        memset(queue, 0, sizeof(*queue));
+        return ERROR_INVALID_INPUT;
+    }
+    mmio_write64(common, VIRTIO_COMMON_Q_DESC, (uintptr_t)queue->desc);
+    mmio_write64(common, VIRTIO_COMMON_Q_AVAIL, (uintptr_t)queue->avail);
+    mmio_write64(common, VIRTIO_COMMON_Q_USED, (uintptr_t)queue->used);
+    uint16_t notify_off = mmio_read16(common, VIRTIO_COMMON_Q_NOFF);
+    queue->notify = (volatile uint16_t*)(device->notify_base + (uint32_t)notify_off * device->notify_multiplier);
+    mmio_write16(common, VIRTIO_COMMON_Q_ENABLE, 1);
+    return SUCCESS;
+}
+
+void virtio_ready(virtio_device_t* device) {
+    if (device->msix_ready) {
+        pci_msix_enable(&device->msix);
+    }
+    uint8_t status = mmio_read8(device->common, VIRTIO_COMMON_STATUS);
+    mmio_write8(device->common, VIRTIO_COMMON_STATUS, status | VIRTIO_STATUS_DRIVER_OK);
+}
+
+uint8_t virtio_config_read8(const virtio_device_t* device, uint32_t offset) {
+    return mmio_read8(device->config, offset);
+}
+
+uint32_t virtio_config_read32(const virtio_device_t* device, uint32_t offset) {
+    return mmio_read32(device->config, offset);
+}
+
+// Поле більше за 32 біти читається повторно, доки лічильник поколінь не сталий
+uint64_t virtio_config_read64(const virtio_device_t* device, uint32_t offset) {
+    uint8_t generation;
+    uint64_t value;
+    do {
+        generation = mmio_read8(device->common, VIRTIO_COMMON_CFGGEN);
+        value = mmio_read32(device->config, offset);
+        value |= (uint64_t)mmio_read32(device->config, offset + 4) << 32;
+    } while (generation != mmio_read8(device->common, VIRTIO_COMMON_CFGGEN));
+    return value;
+}
+
+// === ЧЕРГИ ===
+
+int virtq_add(virtq_t* queue, const virtq_buf_t* bufs, uint32_t out, uint32_t in, void* cookie) {
+    uint32_t total = out + in;
+    if (total == 0 || total > queue->num_free) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    // Вільні дескриптори зв'язані через next - ланцюжок бере їх підряд
+    uint16_t head = queue->free_head;
+    uint16_t index = head;
+    for (uint32_t i = 0; i < total; i++) {
+        virtq_desc_t* desc = &queue->desc[index];
+        desc->addr = bufs[i].addr;
+        desc->len = bufs[i].len;
+        desc->flags = (uint16_t)((i >= out ? VIRTQ_DESC_F_WRITE : 0) | (i + 1 < total ? VIRTQ_DESC_F_NEXT : 0));
+        index = desc->next;
+    }
+    queue->free_head = index;
+    queue->num_free -= (uint16_t)total;
+    queue->cookies[head] = cookie;
+    queue->avail->ring[queue->avail_next & (queue->size - 1)] = head;
+    queue->avail_next++;
+    return SUCCESS;
+}
+
+// Пристрій просить дзвінок, якщо його avail_event потрапив у щойно опубліковане
+static int need_event(uint16_t event, uint16_t new_idx, uint16_t old_idx) {
+    return (uint16_t)(new_idx - event - 1) < (uint16_t)(new_idx - old_idx);
+}
+
+void virtq_kick(virtq_t* queue) {
+    uint16_t old_idx = queue->avail_published;
+    uint16_t new_idx = queue->avail_next;
+    if (old_idx == new_idx) {
+        return;
+    }
+    // На x86 записи не переставляються: дескриптори видно раніше за idx
+    asm volatile("" : : : "memory");
+    queue->avail->idx = new_idx;
+    queue->avail_published = new_idx;
+    // Запис idx має стати видимим до читання avail_event/flags
+    __sync_synchronize();
+
+    int notify = queue->event_idx ? need_event(*queue->avail_event, new_idx, old_idx)
+                                  : !(queue->used->flags & VIRTQ_USED_F_NO_NOTIFY);
+    if (notify) {
+        *queue->notify = queue->index;
+        queue->kicks++;
+    } else {
+        queue->kicks_suppressed++;
+    }
+}
+
+void* virtq_get(virtq_t* queue, uint32_t* length) {
+    if (queue->last_used == queue->used->idx) {
+        return NULL;
+    }
+    asm volatile("" : : : "memory");
+    volatile virtq_used_elem_t* elem = &queue->used->ring[queue->last_used & (queue->size - 1)];
+    uint16_t head = (uint16_t)elem->id;
+    if (length) {
+        *length = elem->len;
+    }
+    queue->last_used++;
+
+    // Ланцюжок повертається на початок списку вільних
+    uint16_t index = head;
+    uint16_t count = 1;
+    while (queue->desc[index].flags & VIRTQ_DESC_F_NEXT) {
+        index = queue->desc[index].next;
+        count++;
+    }
+    queue->desc[index].next = queue->free_head;
+    queue->free_head = head;
+    queue->num_free += count;
+    return queue->cookies[head];
+}
+
+int virtq_pending(const virtq_t* queue) {
+    return queue->last_used != queue->used->idx;
+}
+
+int virtq_enable_interrupts(virtq_t* queue, uint16_t after) {
+    if (after == 0) {
+        after = 1;
+    }
+    if (queue->event_idx) {
+        *queue->used_event = (uint16_t)(queue->last_used + after - 1);
+    } else {
+        queue->avail->flags = 0;
+        after = 1;
+    }
+    // Запис порогу - до перевірки used->idx, інакше завершення проскочить без переривання
+    __sync_synchronize();
+    return (uint16_t)(queue->used->idx - queue->last_used) >= after;
+}
+
+void virtq_disable_interrupts(virtq_t* queue) {
+    if (queue->event_idx) {
+        // Поріг на півкола вперед - до нього черга не дійде
+        *queue->used_event = (uint16_t)(queue->last_used + 0x8000);
+    } else {
+        queue->avail->flags = VIRTQ_AVAIL_F_NO_INTERRUPT;
+    }
+}
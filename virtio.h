@@ -0,0 +1,162 @@
+#ifndef VIRTIO_H
+#define VIRTIO_H
+
+#include "kernel.h"
+#include "pci.h"
+
+// Транспорт virtio 1.0 поверх PCI (структури в BAR за vendor-можливостями)
+// і розділені (split) черги віртуальних дескрипторів
+
+#define VIRTIO_PCI_VENDOR           0x1AF4
+#define VIRTIO_PCI_MODERN_BASE      0x1040      // + тип пристрою
+#define VIRTIO_PCI_TRANSITIONAL_MIN 0x1000      // тип - у subsystem id
+#define VIRTIO_PCI_TRANSITIONAL_MAX 0x103F
+
+// Типи пристроїв
+#define VIRTIO_ID_NET               1
+#define VIRTIO_ID_BLOCK             2
+
+// Біти статусу пристрою
+#define VIRTIO_STATUS_ACKNOWLEDGE   0x01
+#define VIRTIO_STATUS_DRIVER        0x02
+#define VIRTIO_STATUS_DRIVER_OK     0x04
+#define VIRTIO_STATUS_FEATURES_OK   0x08
+#define VIRTIO_STATUS_FAILED        0x80
+
+// Загальні можливості (номери бітів)
+#define VIRTIO_F_INDIRECT_DESC      28
+#define VIRTIO_F_EVENT_IDX          29
+#define VIRTIO_F_VERSION_1          32
+
+// Типи vendor-можливостей PCI
+#define VIRTIO_PCI_CAP_COMMON       1
+#define VIRTIO_PCI_CAP_NOTIFY       2
+#define VIRTIO_PCI_CAP_ISR          3
+#define VIRTIO_PCI_CAP_DEVICE       4
+
+// Поля загальної конфігурації (зміщення)
+#define VIRTIO_COMMON_DFSELECT      0x00
+#define VIRTIO_COMMON_DF            0x04
+#define VIRTIO_COMMON_GFSELECT      0x08
+#define VIRTIO_COMMON_GF            0x0C
+#define VIRTIO_COMMON_MSIX          0x10
+#define VIRTIO_COMMON_NUMQ          0x12
+#define VIRTIO_COMMON_STATUS        0x14
+#define VIRTIO_COMMON_CFGGEN        0x15
+#define VIRTIO_COMMON_Q_SELECT      0x16
+#define VIRTIO_COMMON_Q_SIZE        0x18
+#define VIRTIO_COMMON_Q_MSIX        0x1A
+#define VIRTIO_COMMON_Q_ENABLE      0x1C
+#define VIRTIO_COMMON_Q_NOFF        0x1E
+#define VIRTIO_COMMON_Q_DESC        0x20
+#define VIRTIO_COMMON_Q_AVAIL       0x28
+#define VIRTIO_COMMON_Q_USED        0x30
+
+#define VIRTIO_MSI_NO_VECTOR        0xFFFF
+
+// Прапорці дескрипторів та кілець
+#define VIRTQ_DESC_F_NEXT           1
+#define VIRTQ_DESC_F_WRITE          2
+#define VIRTQ_AVAIL_F_NO_INTERRUPT  1
+#define VIRTQ_USED_F_NO_NOTIFY      1
+
+typedef struct {
+    uint64_t addr;
+    uint32_t len;
+    uint16_t flags;
+    uint16_t next;
+} __attribute__((packed)) virtq_desc_t;
+
+typedef struct {
+    uint16_t flags;
+    uint16_t idx;
+    uint16_t ring[];                // за кільцем - used_event
+} __attribute__((packed)) virtq_avail_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t len;
+} __attribute__((packed)) virtq_used_elem_t;
+
+typedef struct {
+    uint16_t flags;
+    uint16_t idx;
+    virtq_used_elem_t ring[];       // за кільцем - avail_event
+} __attribute__((packed)) virtq_used_t;
+
+// Буфер ланцюжка: спершу ті, що пристрій читає, далі ті, куди він пише
+typedef struct {
+    uintptr_t addr;                 // identity-пам'ять: фізична = віртуальна
+    uint32_t len;
+} virtq_buf_t;
+
+typedef struct {
+    uint16_t index;
+    uint16_t size;
+    int event_idx;
+    virtq_desc_t* desc;
+    volatile virtq_avail_t* avail;
+    volatile virtq_used_t* used;
+    volatile uint16_t* used_event;
+    volatile uint16_t* avail_event;
+    volatile uint16_t* notify;
+    void** cookies;                 // на голову ланцюжка
+
+    uint16_t free_head;
+    uint16_t num_free;
+    uint16_t avail_next;            // наступний індекс avail, ще не опублікований
+    uint16_t avail_published;       // avail->idx на момент останнього дзвінка
+    uint16_t last_used;
+
+    // Статистика
+    uint64_t kicks;
+    uint64_t kicks_suppressed;
+} virtq_t;
+
+typedef struct {
+    pci_device_t* pci;
+    volatile uint8_t* common;
+    volatile uint8_t* notify_base;
+    uint32_t notify_multiplier;
+    volatile uint8_t* isr;
+    volatile uint8_t* config;
+    uint64_t features;
+    pci_msix_t msix;
+    int msix_ready;
+} virtio_device_t;
+
+// index-й пристрій virtio типу type на шині PCI
+pci_device_t* virtio_find(uint16_t type, uint32_t index);
+
+// Скидання, узгодження можливостей (VERSION_1 обов'язкова), FEATURES_OK
+int virtio_init(virtio_device_t* device, pci_device_t* pci, uint64_t wanted);
+int virtio_has_feature(const virtio_device_t* device, uint32_t bit);
+
+// MSI-X з одним записом на чергу; без MSI-X пристрій працює опитуванням
+int virtio_enable_msix(virtio_device_t* device);
+
+// Черга index розміром не більше max_size; msix_entry - VIRTIO_MSI_NO_VECTOR без переривань
+int virtio_queue_setup(virtio_device_t* device, virtq_t* queue, uint16_t index, uint16_t max_size, uint16_t msix_entry);
+void virtio_ready(virtio_device_t* device);
+
+// Конфігурація пристрою
+uint8_t virtio_config_read8(const virtio_device_t* device, uint32_t offset);
+uint32_t virtio_config_read32(const virtio_device_t* device, uint32_t offset);
+uint64_t virtio_config_read64(const virtio_device_t* device, uint32_t offset);
+
+// Додати ланцюжок out+in буферів; опублікується при virtq_kick
+int virtq_add(virtq_t* queue, const virtq_buf_t* bufs, uint32_t out, uint32_t in, void* cookie);
+
+// Опублікувати додане одним записом avail->idx; дзвінок - лише якщо пристрій чекає
+void virtq_kick(virtq_t* queue);
+
+// Наступний завершений ланцюжок (його дескриптори звільняються); NULL - немає
+void* virtq_get(virtq_t* queue, uint32_t* length);
+int virtq_pending(const virtq_t* queue);
+
+// Переривання після ще after завершень (EVENT_IDX) або після кожного;
+// true - стільки вже завершилось, треба обробити ще раз
+int virtq_enable_interrupts(virtq_t* queue, uint16_t after);
+void virtq_disable_interrupts(virtq_t* queue);
+
+#endif
@@ -0,0 +1,758 @@
+#include "vmm.h"
+#include "pmm.h"
+#include "timer.h"
+#include "smp.h"
+
+// Біти елементів PDE/PTE
+#define PTE_PRESENT         0x001
+#define PTE_WRITE           0x002
+#define PTE_USER            0x004
+#define PTE_PWT             0x008
+#define PTE_PCD             0x010
+#define PTE_LARGE           0x080
+#define PTE_GLOBAL          0x100
+#define PTE_DEMAND_ZERO     0x200   // AVL: сторінка з'явиться при першому доступі
+#define PTE_OWNED           0x400   // AVL: кадр виділив VMM, звільняємо при unmap
+#define PTE_FLAGS_MASK      0xFFF
+
+#ifdef __x86_64__
+// PAE-формат: 64-бітні записи по 512 на таблицю. Відображаємо лише нижні 4 ГБ
+// (identity, як і на i386): PML4[0] -> PDPT[0..3] -> чотири каталоги, що лежать
+// поспіль і працюють як один каталог на 2048 записів
+typedef uint64_t pte_t;
+#define PT_ENTRIES          512
+#define PD_PAGES            4
+#define PTE_ADDR_MASK       0x000FFFFFFFFFF000ull
+#define PDE_LARGE_ADDR_MASK 0x000FFFFFFFE00000ull
+#define VMM_SPACE_END       0x100000000ull
+#else
+typedef uint32_t pte_t;
+#define PT_ENTRIES          1024
+#define PD_PAGES            1
+#define PTE_ADDR_MASK       0xFFFFF000
+#define PDE_LARGE_ADDR_MASK 0xFFC00000
+#define VMM_SPACE_END       0x100000000ull
+#endif
+
+#define PDE_INDEX(v)        ((uint32_t)((v) >> LARGE_PAGE_SHIFT))
+#define PTE_INDEX(v)        ((uint32_t)((v) >> PAGE_SHIFT) & (PT_ENTRIES - 1))
+
+// CPUID.1:EDX
+#define CPUID_EDX_PSE       (1u << 3)
+#define CPUID_EDX_PGE       (1u << 13)
+#define CPUID_EDX_PAT       (1u << 16)
+
+// PAT: PA1 (тільки PWT) перепрограмовано з WT на WC, решта за замовчуванням
+#define MSR_IA32_PAT        0x277
+#define PAT_VALUE           0x0007040600070106ull
+
+#define CR0_WP              (1u << 16)
+#define CR0_PG              (1u << 31)
+#define CR4_PSE             (1u << 4)
+#define CR4_PGE             (1u << 7)
+
+// Понад цю кількість сторінок дешевше скинути весь TLB
+#define VMM_FLUSH_THRESHOLD 32
+
+static pte_t* page_directory = NULL;
+static uintptr_t page_root = 0;     // CR3
+static int has_pse = false;
+static int has_pge = false;
+static int has_pat = false;
+static int paging_enabled = false;
+
+static uintptr_t heap_end = VMM_HEAP_BASE;
+
+// Статистика
+static uint32_t large_mapped = 0;
+static uint32_t small_mapped = 0;
+static uint32_t page_tables = 0;
+static uint32_t demand_faults = 0;
+static uint64_t invlpg_count = 0;
+static uint64_t full_flushes = 0;
+
+// === РЕГІСТРИ КЕРУВАННЯ ===
+
+static inline unsigned long read_cr0(void) {
+    unsigned long value;
+    asm volatile("mov %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr0(unsigned long value) {
+    asm volatile("mov %0, %%cr0" : : "r"(value) : "memory");
+}
+
+static inline unsigned long read_cr4(void) {
+    unsigned long value;
+    asm volatile("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr4(unsigned long value) {
+    asm volatile("mov %0, %%cr4" : : "r"(value) : "memory");
+}
+
+static inline void write_cr3(unsigned long value) {
+    asm volatile("mov %0, %%cr3" : : "r"(value) : "memory");
+}
+
+static inline void invlpg(uintptr_t virt) {
+    asm volatile("invlpg (%0)" : : "r"(virt) : "memory");
+}
+
+// === ІНВАЛІДАЦІЯ TLB ===
+
+void vmm_flush_all(void) {
+    if (!paging_enabled) {
+        return;
+    }
+    full_flushes++;
+    if (has_pge) {
+        // Глобальні записи скидаються лише перемиканням CR4.PGE
+        unsigned long cr4 = read_cr4();
+        write_cr4(cr4 & ~CR4_PGE);
+        write_cr4(cr4);
+    } else {
+        write_cr3(page_root);
+    }
+}
+
+void vmm_flush_range(uintptr_t virt, size_t size) {
+    if (!paging_enabled) {
+        return;
+    }
+
+    // Єдина точка інвалідації: локально, а потім shootdown на інших CPU
+    size_t pages = (size + PAGE_SIZE - 1) >> PAGE_SHIFT;
+    if (pages > VMM_FLUSH_THRESHOLD) {
+        vmm_flush_all();
+    } else {
+        for (size_t i = 0; i < pages; i++) {
+            invlpg(virt + (i << PAGE_SHIFT));
+        }
+        invlpg_count += pages;
+    }
+    smp_tlb_shootdown(virt, size);
+}
+
+void vmm_flush_local(uintptr_t virt, size_t size) {
+    size_t pages = (size + PAGE_SIZE - 1) >> PAGE_SHIFT;
+    if (pages > VMM_FLUSH_THRESHOLD) {
+        unsigned long cr4 = read_cr4();
+        if (has_pge) {
+            write_cr4(cr4 & ~CR4_PGE);
+            write_cr4(cr4);
+        } else {
+            write_cr3(page_root);
+        }
+        return;
+    }
+    for (size_t i = 0; i < pages; i++) {
+        invlpg(virt + (i << PAGE_SHIFT));
+    }
+}
+
+// === ТАБЛИЦІ СТОРІНОК ===
+
+static uint32_t hw_flags(uint32_t flags) {
+    uint32_t hw = PTE_PRESENT;
+    if (flags & VMM_WRITE) hw |= PTE_WRITE;
+    if (flags & VMM_USER) hw |= PTE_USER;
+    if ((flags & VMM_GLOBAL) && has_pge) hw |= PTE_GLOBAL;
+    if (flags & VMM_UC) {
+        hw |= PTE_PCD | PTE_PWT;
+    } else if ((flags & VMM_WC) && has_pat) {
+        hw |= PTE_PWT;
+    } else if (flags & VMM_WC) {
+        // Без PAT найближчий безпечний тип - некешований
+        hw |= PTE_PCD | PTE_PWT;
+    }
+    return hw;
+}
+
+static pte_t* alloc_page_table(void) {
+    pte_t* table = (pte_t*)pmm_alloc_frame();
+    if (table) {
+        for (int i = 0; i < PT_ENTRIES; i++) {
+            table[i] = 0;
+        }
+        page_tables++;
+    }
+    return table;
+}
+
+// Розбиває велику сторінку на таблицю дрібних з тими ж атрибутами
+static pte_t* split_large(uint32_t pde_index) {
+    pte_t pde = page_directory[pde_index];
+    pte_t* table = alloc_page_table();
+    if (!table) {
+        return NULL;
+    }
+
+    pte_t base = pde & PDE_LARGE_ADDR_MASK;
+    pte_t flags = pde & (PTE_FLAGS_MASK & ~PTE_LARGE);
+    for (uint32_t i = 0; i < PT_ENTRIES; i++) {
+        table[i] = (base + ((pte_t)i << PAGE_SHIFT)) | flags;
+    }
+
+    page_directory[pde_index] = (uintptr_t)table | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    large_mapped--;
+    small_mapped += PT_ENTRIES;
+    vmm_flush_range((uintptr_t)pde_index << LARGE_PAGE_SHIFT, LARGE_PAGE_SIZE);
+    return table;
+}
+
+// Таблиця сторінок для адреси; create - створити, якщо її немає
+static pte_t* get_page_table(uintptr_t virt, int create) {
+    uint32_t index = PDE_INDEX(virt);
+    pte_t pde = page_directory[index];
+
+    if (pde & PTE_PRESENT) {
+        if (pde & PTE_LARGE) {
+            return create ? split_large(index) : NULL;
+        }
+        return (pte_t*)(uintptr_t)(pde & PTE_ADDR_MASK);
+    }
+    if (!create) {
+        return NULL;
+    }
+
+    pte_t* table = alloc_page_table();
+    if (table) {
+        page_directory[index] = (uintptr_t)table | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    }
+    return table;
+}
+
+// Діапазон усередині відображеного простору (нижні 4 ГБ)
+static int in_space(uintptr_t virt, size_t size) {
+    return (uint64_t)virt + size <= VMM_SPACE_END;
+}
+
+static void free_pte(pte_t* pte) {
+    if ((*pte & (PTE_PRESENT | PTE_OWNED)) == (PTE_PRESENT | PTE_OWNED)) {
+        pmm_free_frame(*pte & PTE_ADDR_MASK);
+    }
+    if (*pte & PTE_PRESENT) {
+        small_mapped--;
+    }
+    *pte = 0;
+}
+
+// === ПУБЛІЧНИЙ API ===
+
+int vmm_map(uintptr_t virt, uintptr_t phys, size_t size, uint32_t flags) {
+    if (!page_directory || (virt | phys) & (PAGE_SIZE - 1) || !in_space(virt, size)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pte_t hw = hw_flags(flags);
+    uintptr_t start = virt;
+    size = (size + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+
+    while (size > 0) {
+        uint32_t index = PDE_INDEX(virt);
+        pte_t pde = page_directory[index];
+
+        // Вирівняну ділянку від LARGE_PAGE_SIZE відображаємо однією великою сторінкою
+        if (has_pse && !(flags & VMM_NO_LARGE) && size >= LARGE_PAGE_SIZE &&
+            ((virt | phys) & (LARGE_PAGE_SIZE - 1)) == 0) {
+            if ((pde & (PTE_PRESENT | PTE_LARGE)) == PTE_PRESENT) {
+                pte_t* table = (pte_t*)(uintptr_t)(pde & PTE_ADDR_MASK);
+                for (int i = 0; i < PT_ENTRIES; i++) {
+                    free_pte(&table[i]);
+                }
+                pmm_free_frame((uintptr_t)table);
+                page_tables--;
+            } else if (pde & PTE_PRESENT) {
+                large_mapped--;
+            }
+            page_directory[index] = (pte_t)phys | hw | PTE_LARGE;
+            large_mapped++;
+            virt += LARGE_PAGE_SIZE;
+            phys += LARGE_PAGE_SIZE;
+            size -= LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        pte_t* table = get_page_table(virt, true);
+        if (!table) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        pte_t* pte = &table[PTE_INDEX(virt)];
+        free_pte(pte);
+        *pte = (pte_t)phys | hw;
+        small_mapped++;
+
+        virt += PAGE_SIZE;
+        phys += PAGE_SIZE;
+        size -= PAGE_SIZE;
+    }
+
+    vmm_flush_range(start, virt - start);
+    return SUCCESS;
+}
+
+int vmm_unmap(uintptr_t virt, size_t size) {
+    if (!page_directory || virt & (PAGE_SIZE - 1) || !in_space(virt, size)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    uintptr_t start = virt;
+    size = (size + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+
+    while (size > 0) {
+        uint32_t index = PDE_INDEX(virt);
+        pte_t pde = page_directory[index];
+
+        if ((pde & (PTE_PRESENT | PTE_LARGE)) == (PTE_PRESENT | PTE_LARGE) &&
+            (virt & (LARGE_PAGE_SIZE - 1)) == 0 && size >= LARGE_PAGE_SIZE) {
+            page_directory[index] = 0;
+            large_mapped--;
+            virt += LARGE_PAGE_SIZE;
+            size -= LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        pte_t* table = NULL;
+        if (pde & PTE_PRESENT) {
+            table = (pde & PTE_LARGE) ? split_large(index) : (pte_t*)(uintptr_t)(pde & PTE_ADDR_MASK);
+        }
+        if (table) {
+            free_pte(&table[PTE_INDEX(virt)]);
+        }
+
+        virt += PAGE_SIZE;
+        size -= PAGE_SIZE;
+    }
+
+    vmm_flush_range(start, virt - start);
+    return SUCCESS;
+}
+
+int vmm_protect(uintptr_t virt, size_t size, uint32_t flags) {
+    if (!page_directory || virt & (PAGE_SIZE - 1) || !in_space(virt, size)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pte_t hw = hw_flags(flags);
+    uintptr_t start = virt;
+    size = (size + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+
+    while (size > 0) {
+        uint32_t index = PDE_INDEX(virt);
+        pte_t pde = page_directory[index];
+
+        if (!(pde & PTE_PRESENT)) {
+            return ERROR_INVALID_INPUT;
+        }
+        if ((pde & PTE_LARGE) && (virt & (LARGE_PAGE_SIZE - 1)) == 0 && size >= LARGE_PAGE_SIZE) {
+            page_directory[index] = (pde & PDE_LARGE_ADDR_MASK) | hw | PTE_LARGE;
+            virt += LARGE_PAGE_SIZE;
+            size -= LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        pte_t* table = get_page_table(virt, true);
+        if (!table) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        pte_t* pte = &table[PTE_INDEX(virt)];
+        if (*pte & PTE_PRESENT) {
+            *pte = (*pte & (PTE_ADDR_MASK | PTE_OWNED)) | hw;
+        } else if (*pte & PTE_DEMAND_ZERO) {
+            *pte = PTE_DEMAND_ZERO | (hw & ~PTE_PRESENT);
+        }
+
+        virt += PAGE_SIZE;
+        size -= PAGE_SIZE;
+    }
+
+    vmm_flush_range(start, virt - start);
+    return SUCCESS;
+}
+
+uintptr_t vmm_translate(uintptr_t virt) {
+    if (!page_directory || !in_space(virt, 1)) {
+        return 0;
+    }
+    pte_t pde = page_directory[PDE_INDEX(virt)];
+    if (!(pde & PTE_PRESENT)) {
+        return 0;
+    }
+    if (pde & PTE_LARGE) {
+        return (pde & PDE_LARGE_ADDR_MASK) | (virt & (LARGE_PAGE_SIZE - 1));
+    }
+    pte_t pte = ((pte_t*)(uintptr_t)(pde & PTE_ADDR_MASK))[PTE_INDEX(virt)];
+    if (!(pte & PTE_PRESENT)) {
+        return 0;
+    }
+    return (pte & PTE_ADDR_MASK) | (virt & (PAGE_SIZE - 1));
+}
+
+void* vmm_map_mmio(uintptr_t phys, size_t size, uint32_t flags) {
+    uintptr_t base = phys & ~(uintptr_t)(PAGE_SIZE - 1);
+    size += phys - base;
+    if (vmm_map(base, base, size, flags | VMM_WRITE | VMM_GLOBAL) != SUCCESS) {
+        return NULL;
+    }
+    return (void*)phys;
+}
+
+// === DEMAND-ZERO ===
+
+int vmm_map_demand_zero(uintptr_t virt, size_t size, uint32_t flags) {
+    if (!page_directory || virt & (PAGE_SIZE - 1) || !in_space(virt, size)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Непрезентний PTE зберігає майбутні атрибути сторінки
+    pte_t marker = PTE_DEMAND_ZERO | (hw_flags(flags) & ~PTE_PRESENT);
+    size = (size + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+
+    for (uintptr_t addr = virt; addr < virt + size; addr += PAGE_SIZE) {
+        pte_t* table = get_page_table(addr, true);
+        if (!table) {
+            return ERROR_BUFFER_OVERFLOW;
+        }
+        pte_t* pte = &table[PTE_INDEX(addr)];
+        free_pte(pte);
+        *pte = marker;
+    }
+
+    vmm_flush_range(virt, size);
+    return SUCCESS;
+}
+
+void* vmm_heap_expand(size_t size) {
+    size = (size + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+    if (size == 0 || size > VMM_HEAP_LIMIT - heap_end) {
+        return NULL;
+    }
+    if (vmm_map_demand_zero(heap_end, size, VMM_WRITE | VMM_GLOBAL) != SUCCESS) {
+        return NULL;
+    }
+    void* ptr = (void*)heap_end;
+    heap_end += size;
+    return ptr;
+}
+
+// === ОБЛАСТЬ КІЛЬЦЯ 3 ===
+
+uintptr_t vmm_user_table_create(void) {
+    return (uintptr_t)alloc_page_table();
+}
+
+int vmm_user_map(uintptr_t table, uintptr_t virt, uintptr_t phys, uint32_t flags) {
+    if (!table || virt < VMM_USER_BASE || virt - VMM_USER_BASE >= VMM_USER_SIZE || (virt | phys) & (PAGE_SIZE - 1)) {
+        return ERROR_INVALID_INPUT;
+    }
+    pte_t* pte = &((pte_t*)table)[PTE_INDEX(virt)];
+    // Той самий кадр ще раз - лише нові права (сегменти ELF на спільній сторінці)
+    if (!(*pte & PTE_PRESENT) || (uintptr_t)(*pte & PTE_ADDR_MASK) != phys) {
+        free_pte(pte);
+        small_mapped++;
+    }
+    *pte = (pte_t)phys | hw_flags((flags | VMM_USER) & ~VMM_GLOBAL) | PTE_OWNED;
+    return SUCCESS;
+}
+
+uintptr_t vmm_user_lookup(uintptr_t table, uintptr_t virt) {
+    if (!table || virt < VMM_USER_BASE || virt - VMM_USER_BASE >= VMM_USER_SIZE) {
+        return 0;
+    }
+    pte_t pte = ((pte_t*)table)[PTE_INDEX(virt)];
+    return (pte & PTE_PRESENT) ? (uintptr_t)(pte & PTE_ADDR_MASK) : 0;
+}
+
+void vmm_user_table_free(uintptr_t table) {
+    if (!table) {
+        return;
+    }
+    pte_t* entries = (pte_t*)table;
+    for (int i = 0; i < PT_ENTRIES; i++) {
+        free_pte(&entries[i]);
+    }
+    pmm_free_frame(table);
+    page_tables--;
+}
+
+// Задачі виконуються лише на BSP, тож інвалідація локальна: записи області
+// не глобальні, їх скидає перезавантаження CR3, а ядро (VMM_GLOBAL) лишається в TLB
+void vmm_user_activate(uintptr_t table) {
+    pte_t* pde = &page_directory[PDE_INDEX(VMM_USER_BASE)];
+    pte_t value = table ? (pte_t)table | PTE_PRESENT | PTE_WRITE | PTE_USER : 0;
+    if (*pde == value) {
+        return;
+    }
+    *pde = value;
+    write_cr3(page_root);
+}
+
+int vmm_user_access_ok(uintptr_t virt, size_t size, int write) {
+    if (!page_directory || !size || !in_space(virt, size)) {
+        return false;
+    }
+    uintptr_t end = virt + size;
+    for (uintptr_t page = virt & ~(uintptr_t)(PAGE_SIZE - 1); page < end; page += PAGE_SIZE) {
+        pte_t pde = page_directory[PDE_INDEX(page)];
+        pte_t entry = pde;
+        if ((pde & (PTE_PRESENT | PTE_LARGE)) == PTE_PRESENT) {
+            entry = ((pte_t*)(uintptr_t)(pde & PTE_ADDR_MASK))[PTE_INDEX(page)];
+        }
+        if (!(entry & PTE_PRESENT) || !(entry & PTE_USER) || (write && !(entry & PTE_WRITE))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// === PAGE FAULT ===
+
+int vmm_page_fault(uintptr_t addr, uint32_t error_code) {
+    pte_t pde = in_space(addr, 1) ? page_directory[PDE_INDEX(addr)] : 0;
+
+    if ((pde & (PTE_PRESENT | PTE_LARGE)) == PTE_PRESENT) {
+        pte_t* pte = &((pte_t*)(uintptr_t)(pde & PTE_ADDR_MASK))[PTE_INDEX(addr)];
+        if (!(*pte & PTE_PRESENT) && (*pte & PTE_DEMAND_ZERO)) {
+            uint32_t* frame = (uint32_t*)pmm_alloc_frame();
+            if (!frame) {
+                kernel_panic("немає пам'яті для demand-zero сторінки");
+            }
+            for (int i = 0; i < 1024; i++) {
+                frame[i] = 0;
+            }
+            *pte = (uintptr_t)frame | (*pte & (PTE_FLAGS_MASK & ~PTE_DEMAND_ZERO)) | PTE_PRESENT | PTE_OWNED;
+            small_mapped++;
+            demand_faults++;
+            invlpg(addr & ~(uintptr_t)(PAGE_SIZE - 1));
+            return SUCCESS;
+        }
+    }
+    if (error_code & VMM_PF_USER) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    char buffer[24];
+    terminal_setcolor(vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
+    terminal_writestring("\nPage fault: адреса 0x");
+    uint64toa(addr, buffer, 16);
+    terminal_writestring(buffer);
+    terminal_writestring(", код помилки 0x");
+    uint64toa(error_code, buffer, 16);
+    terminal_writestring(buffer);
+    kernel_panic("необроблений page fault");
+    return ERROR_INVALID_INPUT;
+}
+
+// === ІНІЦІАЛІЗАЦІЯ ===
+
+// Корінь трансляції: на i386 це сам каталог, на x86_64 - PML4 і PDPT над
+// чотирма суміжними каталогами
+static int alloc_root(void) {
+#ifdef __x86_64__
+    pte_t* pml4 = alloc_page_table();
+    pte_t* pdpt = alloc_page_table();
+    uintptr_t directories = pmm_alloc_frames(PD_PAGES);
+    if (!pml4 || !pdpt || !directories) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    page_directory = (pte_t*)directories;
+    for (int i = 0; i < PD_PAGES * PT_ENTRIES; i++) {
+        page_directory[i] = 0;
+    }
+    for (int i = 0; i < PD_PAGES; i++) {
+        pdpt[i] = (directories + i * PAGE_SIZE) | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    }
+    pml4[0] = (uintptr_t)pdpt | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    page_tables += PD_PAGES;
+    page_root = (uintptr_t)pml4;
+#else
+    page_directory = alloc_page_table();
+    if (!page_directory) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    page_root = (uintptr_t)page_directory;
+#endif
+    return SUCCESS;
+}
+
+int vmm_init(void) {
+    uint32_t a, b, c, d;
+    cpuid(1, &a, &b, &c, &d);
+    has_pse = (d & CPUID_EDX_PSE) != 0;
+    has_pge = (d & CPUID_EDX_PGE) != 0;
+    has_pat = (d & CPUID_EDX_PAT) != 0;
+
+    if (alloc_root() != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    if (has_pat) {
+        wrmsr(MSR_IA32_PAT, PAT_VALUE);
+    }
+
+    // Першу велику сторінку дрібними: сторінка 0 не відображена (ловить NULL),
+    // VGA-пам'ять 0xA0000-0xBFFFF - write-combining
+    uint32_t kernel_flags = VMM_WRITE | VMM_GLOBAL;
+    if (vmm_map(PAGE_SIZE, PAGE_SIZE, LARGE_PAGE_SIZE - PAGE_SIZE, kernel_flags | VMM_NO_LARGE) != SUCCESS ||
+        vmm_protect(0xA0000, 0x20000, kernel_flags | VMM_WC) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    // Решта RAM - великими сторінками
+    uintptr_t memory_end = (pmm_memory_end() + LARGE_PAGE_SIZE - 1) & ~(uintptr_t)(LARGE_PAGE_SIZE - 1);
+    if (memory_end > LARGE_PAGE_SIZE &&
+        vmm_map(LARGE_PAGE_SIZE, LARGE_PAGE_SIZE, memory_end - LARGE_PAGE_SIZE, kernel_flags) != SUCCESS) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    unsigned long cr4 = read_cr4();
+    if (has_pse) cr4 |= CR4_PSE;
+    if (has_pge) cr4 |= CR4_PGE;
+    write_cr4(cr4);
+    write_cr3(page_root);
+    write_cr0(read_cr0() | CR0_PG | CR0_WP);
+    paging_enabled = true;
+
+    return SUCCESS;
+}
+
+void vmm_init_cpu(void) {
+    // PAT окремий на кожному процесорі
+    if (has_pat) {
+        wrmsr(MSR_IA32_PAT, PAT_VALUE);
+    }
+}
+
+uint32_t vmm_page_directory(void) {
+    return (uint32_t)page_root;
+}
+
+// === СТАТИСТИКА ===
+
+void vmm_print_stats(void) {
+    terminal_writestring("Сторінки: ");
+    terminal_writeuint(large_mapped);
+    terminal_writestring(" по ");
+    terminal_writeuint(LARGE_PAGE_SIZE >> 20);
+    terminal_writestring(" МБ, ");
+    terminal_writeuint(small_mapped);
+    terminal_writestring(" по 4 КБ, таблиць: ");
+    terminal_writeuint(page_tables);
+    terminal_writestring("\nPSE: ");
+    terminal_writestring(has_pse ? "так" : "ні");
+    terminal_writestring(", PGE: ");
+    terminal_writestring(has_pge ? "так" : "ні");
+    terminal_writestring(", PAT (WC): ");
+    terminal_writestring(has_pat ? "так" : "ні");
+    terminal_writestring("\nDemand-zero купа: ");
+    terminal_writeuint((heap_end - VMM_HEAP_BASE) >> 10);
+    terminal_writestring(" КБ зарезервовано, ");
+    terminal_writeuint(demand_faults);
+    terminal_writestring(" сторінок виділено за запитом\n");
+    terminal_writestring("TLB: invlpg ");
+    terminal_writeuint(invlpg_count);
+    terminal_writestring(", повних скидань ");
+    terminal_writeuint(full_flushes);
+    terminal_writestring("\n");
+}
+
+// === БЕНЧМАРК ===
+
+// 16 МБ: великі сторінки проти 4096 дрібних, що не вміщаються в TLB
+#define VMM_BENCH_BLOCKS    4
+#define VMM_BENCH_BLOCK     (PAGE_SIZE << PMM_MAX_ORDER)
+#define VMM_BENCH_SIZE      (VMM_BENCH_BLOCKS * VMM_BENCH_BLOCK)
+#define VMM_BENCH_LARGE     VMM_BENCH_BASE
+#define VMM_BENCH_SMALL     (VMM_BENCH_BASE + VMM_BENCH_SIZE)
+#define VMM_BENCH_PASSES    8
+
+static volatile uint32_t bench_sink;
+
+static uint64_t scan_sequential(uintptr_t base, size_t size) {
+    vmm_flush_all();
+    uint64_t start = rdtsc();
+    uint32_t sum = 0;
+    const uint32_t* p = (const uint32_t*)base;
+    for (size_t i = 0; i < size / sizeof(uint32_t); i += 4) {
+        sum += p[i] + p[i + 1] + p[i + 2] + p[i + 3];
+    }
+    bench_sink = sum;
+    return rdtsc() - start;
+}
+
+static uint64_t scan_stride(uintptr_t base, size_t size) {
+    vmm_flush_all();
+    uint64_t start = rdtsc();
+    uint32_t sum = 0;
+    for (int pass = 0; pass < VMM_BENCH_PASSES; pass++) {
+        // Одне читання на сторінку: вартість визначає TLB, а не кеш
+        for (size_t offset = (pass * 64) & (PAGE_SIZE - 1); offset < size; offset += PAGE_SIZE) {
+            sum += *(const volatile uint32_t*)(base + offset);
+        }
+    }
+    bench_sink = sum;
+    return rdtsc() - start;
+}
+
+static void report_scan(const char* label, uint64_t large, uint64_t small, int bandwidth) {
+    uint32_t accesses = VMM_BENCH_PASSES * (VMM_BENCH_SIZE / PAGE_SIZE);
+    terminal_writestring(label);
+    terminal_writeuint(LARGE_PAGE_SIZE >> 20);
+    terminal_writestring(" МБ: ");
+    if (bandwidth) {
+        terminal_writeuint(tsc_per_second(VMM_BENCH_SIZE, large) >> 20);
+        terminal_writestring(" МБ/с, 4 КБ: ");
+        terminal_writeuint(tsc_per_second(VMM_BENCH_SIZE, small) >> 20);
+        terminal_writestring(" МБ/с\n");
+    } else {
+        terminal_writeuint(div64_u32(large, accesses, NULL));
+        terminal_writestring(" тактів/доступ, 4 КБ: ");
+        terminal_writeuint(div64_u32(small, accesses, NULL));
+        terminal_writestring(" тактів/доступ\n");
+    }
+}
+
+void vmm_benchmark(void) {
+    uintptr_t blocks[VMM_BENCH_BLOCKS];
+
+    if (!paging_enabled) {
+        terminal_writestring("Paging не увімкнено\n");
+        return;
+    }
+
+    // Блоки порядку 10 вирівняні на 4 МБ - придатні для великих сторінок обох форматів
+    for (int i = 0; i < VMM_BENCH_BLOCKS; i++) {
+        blocks[i] = pmm_alloc_order(PMM_MAX_ORDER);
+        if (!blocks[i]) {
+            for (int j = 0; j < i; j++) {
+                pmm_free_order(blocks[j], PMM_MAX_ORDER);
+            }
+            terminal_writestring("Недостатньо пам'яті для бенчмарку\n");
+            return;
+        }
+    }
+
+    for (int i = 0; i < VMM_BENCH_BLOCKS; i++) {
+        vmm_map(VMM_BENCH_LARGE + i * VMM_BENCH_BLOCK, blocks[i], VMM_BENCH_BLOCK, VMM_WRITE);
+        vmm_map(VMM_BENCH_SMALL + i * VMM_BENCH_BLOCK, blocks[i], VMM_BENCH_BLOCK, VMM_WRITE | VMM_NO_LARGE);
+    }
+
+    // Прогрів кешів даних однаковий для обох відображень
+    scan_sequential(VMM_BENCH_LARGE, VMM_BENCH_SIZE);
+    uint64_t seq_large = scan_sequential(VMM_BENCH_LARGE, VMM_BENCH_SIZE);
+    uint64_t seq_small = scan_sequential(VMM_BENCH_SMALL, VMM_BENCH_SIZE);
+    uint64_t stride_large = scan_stride(VMM_BENCH_LARGE, VMM_BENCH_SIZE);
+    uint64_t stride_small = scan_stride(VMM_BENCH_SMALL, VMM_BENCH_SIZE);
+
+    vmm_unmap(VMM_BENCH_LARGE, VMM_BENCH_SIZE);
+    vmm_unmap(VMM_BENCH_SMALL, VMM_BENCH_SIZE);
+    for (int i = 0; i < VMM_BENCH_BLOCKS; i++) {
+        pmm_free_order(blocks[i], PMM_MAX_ORDER);
+    }
+
+    report_scan("Послідовне читання 16 МБ, ", seq_large, seq_small, true);
+    report_scan("Крок 4 КБ (TLB), ", stride_large, stride_small, false);
+}
@@ -0,0 +1,83 @@
+#ifndef VMM_H
+#define VMM_H
+
+#include "kernel.h"
+
+#ifdef __x86_64__
+// Розмір великої сторінки (2 МБ, чотирирівнева трансляція long mode)
+#define LARGE_PAGE_SIZE     0x200000
+#define LARGE_PAGE_SHIFT    21
+#else
+// Розмір великої сторінки (PSE, 32-бітна двохрівнева трансляція)
+#define LARGE_PAGE_SIZE     0x400000
+#define LARGE_PAGE_SHIFT    22
+#endif
+
+// Прапори відображення (не залежать від формату таблиць)
+#define VMM_WRITE           0x01
+#define VMM_USER            0x02
+#define VMM_WC              0x04    // write-combining через PAT
+#define VMM_UC              0x08    // некешована пам'ять (MMIO регістри)
+#define VMM_GLOBAL          0x10    // не скидається при зміні CR3
+#define VMM_NO_LARGE        0x20    // лише 4 КБ сторінки
+
+// Віртуальні області поза identity-відображенням RAM
+#define VMM_BENCH_BASE      0xC0000000
+#define VMM_HEAP_BASE       0xD0000000
+#define VMM_HEAP_LIMIT      0xE0000000
+
+// Область задач кільця 3: один запис каталогу, таблицю сторінок під нього має
+// кожна задача своя, і вона підставляється при перемиканні. Далі - сторінка
+// vDSO, спільна для всіх (адреси збігаються з user/nexus.h)
+#define VMM_USER_BASE       0xA0000000
+#define VMM_USER_SIZE       LARGE_PAGE_SIZE
+#define VMM_VDSO_BASE       0xA0400000
+
+// Код помилки #PF: доступ з кільця 3
+#define VMM_PF_USER         0x04
+
+// Ініціалізація та увімкнення сторінкової адресації
+int vmm_init(void);
+void vmm_init_cpu(void);
+// Значення CR3 ядра (каталог на i386, PML4 на x86_64)
+uint32_t vmm_page_directory(void);
+
+// Відображення, зняття відображення та зміна прав
+int vmm_map(uintptr_t virt, uintptr_t phys, size_t size, uint32_t flags);
+int vmm_unmap(uintptr_t virt, size_t size);
+int vmm_protect(uintptr_t virt, size_t size, uint32_t flags);
+uintptr_t vmm_translate(uintptr_t virt);
+
+// MMIO з потрібним типом кешування (identity)
+void* vmm_map_mmio(uintptr_t phys, size_t size, uint32_t flags);
+
+// Сторінки, що заповнюються нулями при першому доступі
+int vmm_map_demand_zero(uintptr_t virt, size_t size, uint32_t flags);
+void* vmm_heap_expand(size_t size);
+
+// Інвалідація TLB; всі зміни таблиць проходять через цю функцію
+void vmm_flush_range(uintptr_t virt, size_t size);
+void vmm_flush_all(void);
+void vmm_flush_local(uintptr_t virt, size_t size);
+
+// Таблиця сторінок області задачі: кадри, відображені через vmm_user_map,
+// належать таблиці й звільняються разом з нею
+uintptr_t vmm_user_table_create(void);
+int vmm_user_map(uintptr_t table, uintptr_t virt, uintptr_t phys, uint32_t flags);
+uintptr_t vmm_user_lookup(uintptr_t table, uintptr_t virt);
+void vmm_user_table_free(uintptr_t table);
+
+// Підставити таблицю задачі в каталог (0 - прибрати) на цьому процесорі
+void vmm_user_activate(uintptr_t table);
+
+// Діапазон доступний кільцю 3 (для запису, якщо write) у поточному відображенні
+int vmm_user_access_ok(uintptr_t virt, size_t size, int write);
+
+// Обробник #PF (irq.c); не SUCCESS - помилка кільця 3, задачу завершує викликач
+int vmm_page_fault(uintptr_t addr, uint32_t error_code);
+
+// Статистика та бенчмарк
+void vmm_print_stats(void);
+void vmm_benchmark(void);
+
+#endif